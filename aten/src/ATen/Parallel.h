@@ -125,6 +125,32 @@ CAFFE2_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 CAFFE2_API int intraop_default_num_threads();
 
+// Placement of the intra-op worker threads
+enum class IntraOpAffinity {
+  // Workers are left to the OS scheduler
+  NONE,
+  // Each worker is pinned to its own core
+  CORE,
+  // Workers are pinned to cores and grouped by NUMA node; each node gets a
+  // contiguous share of the chunks of a parallel region
+  NUMA,
+};
+
+// Sets the placement of the intra-op threads. It has to be called before the
+// first parallel region: once the intra-op pool exists, setting a different
+// placement throws. Only the native parallel backend pins threads. The
+// default can be set with the ATEN_INTRAOP_AFFINITY environment variable
+// (none, core or numa).
+CAFFE2_API void set_intraop_affinity(IntraOpAffinity affinity);
+
+// Returns the placement of the intra-op threads
+CAFFE2_API IntraOpAffinity get_intraop_affinity();
+
+// Returns the placement of the intra-op threads, which can no longer be
+// changed afterwards. Called by the parallel backend when it creates the
+// intra-op pool.
+CAFFE2_API IntraOpAffinity _consume_intraop_affinity();
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
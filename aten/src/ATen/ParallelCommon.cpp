@@ -4,6 +4,9 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -40,6 +43,37 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+IntraOpAffinity get_env_intraop_affinity() {
+  const char* value = std::getenv("ATEN_INTRAOP_AFFINITY");
+  if (!value || strcmp(value, "none") == 0) {
+    return IntraOpAffinity::NONE;
+  } else if (strcmp(value, "core") == 0) {
+    return IntraOpAffinity::CORE;
+  } else if (strcmp(value, "numa") == 0) {
+    return IntraOpAffinity::NUMA;
+  }
+  TORCH_WARN("Invalid ATEN_INTRAOP_AFFINITY variable value ", value,
+             ", expected none, core or numa");
+  return IntraOpAffinity::NONE;
+}
+
+// Guards intraop_affinity, which can no longer change once the intra-op pool
+// has been created with it.
+std::mutex intraop_affinity_mutex;
+IntraOpAffinity intraop_affinity = get_env_intraop_affinity();
+bool intraop_affinity_consumed = false;
+
+const char* intraop_affinity_name(IntraOpAffinity affinity) {
+  switch (affinity) {
+    case IntraOpAffinity::CORE:
+      return "core";
+    case IntraOpAffinity::NUMA:
+      return "numa";
+    default:
+      return "none";
+  }
+}
+
 } // namespace
 
 std::string get_parallel_info() {
@@ -49,6 +83,8 @@ std::string get_parallel_info() {
      << at::get_num_threads() << std::endl;
   ss << "\tat::get_num_interop_threads() : "
      << at::get_num_interop_threads() << std::endl;
+  ss << "\tat::get_intraop_affinity() : "
+     << intraop_affinity_name(at::get_intraop_affinity()) << std::endl;
 
   ss << at::get_openmp_version() << std::endl;
 #ifdef _OPENMP
@@ -107,4 +143,29 @@ int intraop_default_num_threads() {
 #endif
 }
 
+void set_intraop_affinity(IntraOpAffinity affinity) {
+#if !AT_PARALLEL_NATIVE
+  if (affinity != IntraOpAffinity::NONE) {
+    TORCH_WARN("set_intraop_affinity only pins threads with the native "
+               "parallel backend");
+  }
+#endif
+  std::lock_guard<std::mutex> lock(intraop_affinity_mutex);
+  TORCH_CHECK(!intraop_affinity_consumed || affinity == intraop_affinity,
+      "Error: cannot set the intra-op affinity after parallel work "
+      "has started");
+  intraop_affinity = affinity;
+}
+
+IntraOpAffinity get_intraop_affinity() {
+  std::lock_guard<std::mutex> lock(intraop_affinity_mutex);
+  return intraop_affinity;
+}
+
+IntraOpAffinity _consume_intraop_affinity() {
+  std::lock_guard<std::mutex> lock(intraop_affinity_mutex);
+  intraop_affinity_consumed = true;
+  return intraop_affinity;
+}
+
 } // namespace at
@@ -10,6 +10,8 @@
 #endif // C10_MOBILE
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -65,13 +67,125 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
-TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
+// Intra-op worker threads. With IntraOpAffinity::NONE this is the single pool
+// from ThreadPoolRegistry; otherwise workers are pinned to cores and there is
+// one pool per NUMA node (a single one for IntraOpAffinity::CORE).
+struct IntraOpPool {
+  std::vector<std::shared_ptr<TaskThreadPoolBase>> nodes;
+  // Threads per node; the calling thread counts towards the first node.
+  std::vector<size_t> node_threads;
+  std::atomic<size_t> next_node{0};
+
+  size_t size() const {
+    size_t total = 0;
+    for (const auto& node : nodes) {
+      total += node->size();
+    }
+    return total;
+  }
+
+  bool inThreadPool() const {
+    for (const auto& node : nodes) {
+      if (node->inThreadPool()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(const std::function<void()>& func) {
+    // Round-robin over the nodes that have workers.
+    for (size_t attempt = 0; attempt < nodes.size(); ++attempt) {
+      auto& node = nodes[next_node++ % nodes.size()];
+      if (node->size() > 0) {
+        node->run(func);
+        return;
+      }
+    }
+    nodes[0]->run(func);
+  }
+};
+
+// Splits `nthreads` threads over the NUMA nodes in proportion to the number
+// of cores each node has, and creates pinned pools for them.
+void _create_pinned_pools(IntraOpPool& pool, int nthreads, bool per_node) {
+  std::vector<std::vector<int>> cpus_by_node;
+  std::vector<int> node_ids;
+  int node_id = 0;
+  for (auto& cpus : c10::GetCPUsByNUMANode()) {
+    if (!cpus.empty()) {
+      if (per_node || cpus_by_node.empty()) {
+        cpus_by_node.push_back(std::move(cpus));
+        node_ids.push_back(per_node ? node_id : -1);
+      } else {
+        cpus_by_node[0].insert(cpus_by_node[0].end(), cpus.begin(), cpus.end());
+      }
+    }
+    ++node_id;
+  }
+  if (cpus_by_node.empty()) {
+    cpus_by_node.emplace_back();
+    node_ids.push_back(-1);
+  }
+
+  size_t total_cpus = 0;
+  for (const auto& cpus : cpus_by_node) {
+    total_cpus += cpus.size();
+  }
+  std::vector<size_t> node_threads(cpus_by_node.size(), 0);
+  size_t assigned = 0;
+  for (size_t i = 0; i < cpus_by_node.size(); ++i) {
+    node_threads[i] = total_cpus > 0 ? nthreads * cpus_by_node[i].size() / total_cpus : 0;
+    assigned += node_threads[i];
+  }
+  for (size_t i = 0; assigned < (size_t)nthreads; i = (i + 1) % node_threads.size()) {
+    ++node_threads[i];
+    ++assigned;
+  }
+
+  for (size_t i = 0; i < cpus_by_node.size(); ++i) {
+    if (node_threads[i] == 0) {
+      continue;
+    }
+    // The calling thread takes the first slot of the first node.
+    size_t first_slot = pool.nodes.empty() ? 1 : 0;
+    auto cpus = std::make_shared<std::vector<int>>(std::move(cpus_by_node[i]));
+    auto next_slot = std::make_shared<std::atomic<size_t>>(first_slot);
+    int numa_node_id = node_ids[i];
+    pool.nodes.push_back(std::make_shared<c10::ThreadPool>(
+        node_threads[i] - first_slot,
+        numa_node_id,
+        [cpus, next_slot, numa_node_id]() {
+          c10::setThreadName("PTThreadPool");
+          at::init_num_threads();
+          if (!cpus->empty()) {
+            size_t slot = (*next_slot)++;
+            c10::PinCurrentThreadToCPU((*cpus)[slot % cpus->size()]);
+          }
+          c10::NUMABind(numa_node_id);
+        }));
+    pool.node_threads.push_back(node_threads[i]);
+  }
+}
+
+IntraOpPool& _get_intraop_pool() {
+  static std::unique_ptr<IntraOpPool> pool = []() {
+    auto pool = std::make_unique<IntraOpPool>();
+    // plus one because of the master thread
+    int nthreads = _num_pool_threads(num_intraop_threads.exchange(CONSUMED)) + 1;
+    auto affinity = _consume_intraop_affinity();
+    if (affinity == IntraOpAffinity::NONE) {
+      pool->nodes.push_back(ThreadPoolRegistry()->Create(
           "C10",
           /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+          /* pool_size */ nthreads - 1,
+          /* create_new */ true)); // create a separate thread pool for intra-op
+      pool->node_threads.push_back(nthreads);
+    } else {
+      _create_pinned_pools(*pool, nthreads, affinity == IntraOpAffinity::NUMA);
+    }
+    return pool;
+  }();
   return *pool;
 }
 
@@ -81,11 +195,42 @@ TaskThreadPoolBase& _get_intraop_pool() {
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #ifndef C10_MOBILE
-  for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+  auto& pool = _get_intraop_pool();
+  if (pool.nodes.size() == 1) {
+    for (size_t i = 1; i < range; ++i) {
+      pool.nodes[0]->run([fn, i]() { fn((int)i, i); });
+    }
+    // Run the first task on the current thread directly.
+    fn(0, 0);
+    return;
+  }
+  // Give each NUMA node a contiguous block of tasks, sized by its share of
+  // the threads, so that neighbouring chunks are processed on the same node.
+  size_t total_threads = 0;
+  for (auto n : pool.node_threads) {
+    total_threads += n;
   }
-  // Run the first task on the current thread directly.
+  size_t node_begin = 0, cumulative_threads = 0;
+  std::vector<size_t> inline_tasks;
+  for (size_t node = 0; node < pool.nodes.size(); ++node) {
+    cumulative_threads += pool.node_threads[node];
+    size_t node_end = range * cumulative_threads / total_threads;
+    auto& node_pool = *pool.nodes[node];
+    for (size_t i = std::max(node_begin, (size_t)1); i < node_end; ++i) {
+      if (node_pool.size() > 0) {
+        node_pool.run([fn, i]() { fn((int)i, i); });
+      } else {
+        inline_tasks.push_back(i);
+      }
+    }
+    node_begin = node_end;
+  }
+  // Run the first task, and those of a node without workers, on the current
+  // thread directly.
   fn(0, 0);
+  for (auto i : inline_tasks) {
+    fn(0, i);
+  }
 #else
   caffe2::ThreadPool* pool = caffe2::mobile_threadpool();
   if (pool) {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ATen/cpu/vec256/vec256_base.h>
+
+#include <type_traits>
+
+#if defined(__GNUC__)
+#define __at_align64__ __attribute__((aligned(64)))
+#elif defined(_WIN32)
+#define __at_align64__ __declspec(align(64))
+#else
+#define __at_align64__
+#endif
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Vec512<T> is the 512-bit counterpart of Vec256<T> and exposes the same
+// interface. Unlike Vec256 there is no generic emulated implementation: a
+// Vec512<T> only exists for the types specialized in the vec512_*.h headers,
+// and only when they are compiled for the AVX512 CPU capability.
+// is_vec512_type<T> tells which types those are; kernels should not name
+// Vec512 directly but use Vectorized<T> (see vec512.h), which falls back to
+// Vec256<T> everywhere else.
+template <class T>
+struct Vec512;
+
+template <typename T>
+struct is_vec512_type : std::false_type {};
+
+}}}
@@ -11,10 +11,12 @@
 #include <caffe2/perfkernels/embedding_lookup_idx.h>
 #endif
 
+#include <array>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <tuple>
 #include <vector>
 #include <algorithm>
 
@@ -45,38 +47,92 @@ bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor&
   return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
 }
 
-// This function combines index_select (using select_indices as the index) and
-// index_add (using add_indices as the index), without creating an intermediary
-// tensor to hold the selected embeddings
+// Hints the next row that a bag will read into the cache; the rows of a bag
+// are scattered over the table, which defeats the hardware prefetcher.
+inline void prefetch_row(const void* row) {
+#ifdef __GNUC__
+  __builtin_prefetch(row, 0, 1);
+#endif
+}
+
+// Calls fn(bag, begin, end) for every bag in parallel, where [begin, end) are
+// the positions of the bag's indices. Bags write disjoint output rows, so no
+// synchronization is needed.
+template <typename F>
+void parallel_for_each_bag(
+    const Tensor& offsets,
+    int64_t num_indices,
+    bool include_last_offset,
+    const F& fn) {
+  auto* offsets_data = offsets.data_ptr<int64_t>();
+  int64_t num_offsets = offsets.numel();
+  int64_t num_bags = include_last_offset ? num_offsets - 1 : num_offsets;
+  // The bags are read without bounds checks below, so malformed offsets must
+  // be rejected up front rather than from inside a worker thread.
+  for (int64_t i = 0; i < num_offsets; i++) {
+    TORCH_CHECK(
+        offsets_data[i] >= 0 && offsets_data[i] <= num_indices,
+        "embedding_bag: offsets[", i, "] = ", offsets_data[i],
+        " is out of range for ", num_indices, " indices");
+    TORCH_CHECK(
+        i == 0 || offsets_data[i - 1] <= offsets_data[i],
+        "embedding_bag: offsets must be non-decreasing, but offsets[", i - 1,
+        "] = ", offsets_data[i - 1], " > offsets[", i, "] = ", offsets_data[i]);
+  }
+  at::parallel_for(0, num_bags, 1, [&](int64_t start_bag, int64_t end_bag) {
+    for (int64_t bag = start_bag; bag < end_bag; bag++) {
+      int64_t begin = offsets_data[bag];
+      int64_t end = bag + 1 < num_offsets ? offsets_data[bag + 1] : num_indices;
+      fn(bag, begin, end);
+    }
+  });
+}
+
+// Sums the rows of every bag, for any dtype and strides. Each bag prefetches
+// its next row while adding the current one.
 template<typename T>
-void index_select_add(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output,
-                             const Tensor& /*offsets*/,
-                             bool /*include_last_offset*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
+void index_select_add_strided(const Tensor &select_indices,
+                              const Tensor &src,
+                              Tensor &output,
+                              const Tensor& offsets,
+                              bool include_last_offset) {
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
   auto* src_data = src.data_ptr<T>();
   auto* output_data = output.data_ptr<T>();
-  auto numel = add_indices.numel();
+  auto numel = select_indices.numel();
   int64_t ddim = src.size(1);
   auto src_stride0 = src.stride(0);
   auto src_stride1 = src.stride(1);
   auto output_stride0 = output.stride(0);
   auto output_stride1 = output.stride(1);
 
-  for (int64_t i = 0; i < numel; i++) {
-    THBlas_axpy<T>(ddim, 1,
-            src_data + src_stride0 * select_indices_data[i], src_stride1,
-            output_data + output_stride0 * add_indices_data[i], output_stride1);
-  }
+  parallel_for_each_bag(
+      offsets, numel, include_last_offset, [&](int64_t bag, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          if (i + 1 < end) {
+            prefetch_row(src_data + src_stride0 * select_indices_data[i + 1]);
+          }
+          THBlas_axpy<T>(ddim, 1,
+                  src_data + src_stride0 * select_indices_data[i], src_stride1,
+                  output_data + output_stride0 * bag, output_stride1);
+        }
+      });
+}
+
+// This function combines index_select (using select_indices as the index) and
+// index_add (adding up the rows of every bag), without creating an
+// intermediary tensor to hold the selected embeddings
+template<typename T>
+void index_select_add(const Tensor &select_indices,
+                      const Tensor &src,
+                      Tensor &output,
+                      const Tensor& offsets,
+                      bool include_last_offset) {
+  index_select_add_strided<T>(select_indices, src, output, offsets, include_last_offset);
 }
 
 template<>
 void index_select_add<float>(const Tensor &select_indices,
-                             const Tensor &add_indices,
                              const Tensor &src,
                              Tensor &output,
                              const Tensor& offsets,
@@ -143,43 +199,22 @@ void index_select_add<float>(const Tensor &select_indices,
 #endif
         });
   } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(
-          ddim,
-          1,
-          src_data + src_stride0 * select_indices_data[i],
-          src_stride1,
-          output_data + output_stride0 * add_indices_data[i],
-          output_stride1);
-    }
+    index_select_add_strided<float>(select_indices, src, output, offsets, include_last_offset);
   }
 }
 
-// This function fuses the following three fns:
-// index_select (using select_indices as the index)
-// mul (scaling by per_sample_weights)
-// index_add (using add_indices as the index)
+// Scaled counterpart of index_select_add_strided.
 template<typename T>
-static void index_select_scale_add(const Tensor &select_indices,
-                                   const Tensor &add_indices,
-                                   const Tensor &scale,
-                                   const Tensor &src,
-                                   Tensor &output,
-                                   const Tensor& /*offsets*/,
-                                   bool /*include_last_offset*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
+void index_select_scale_add_strided(const Tensor &select_indices,
+                                    const Tensor &scale,
+                                    const Tensor &src,
+                                    Tensor &output,
+                                    const Tensor& offsets,
+                                    bool include_last_offset) {
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
   auto* src_data = src.data_ptr<T>();
   auto* output_data = output.data_ptr<T>();
-  auto numel = add_indices.numel();
+  auto numel = select_indices.numel();
   int64_t ddim = src.size(1);
   auto src_stride0 = src.stride(0);
   auto src_stride1 = src.stride(1);
@@ -189,19 +224,36 @@ static void index_select_scale_add(const Tensor &select_indices,
   auto* scale_data = scale.data_ptr<T>();
   auto scale_stride = scale.stride(0);
 
-  for (int64_t i = 0; i < numel; i++) {
-    auto* src_base = src_data + src_stride0 * select_indices_data[i];
-    auto* output_base = output_data + output_stride0 * add_indices_data[i];
-    auto scale = scale_data[i * scale_stride];
-    for (int64_t j = 0; j < ddim; j++) {
-      output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-    }
-  }
+  parallel_for_each_bag(
+      offsets, numel, include_last_offset, [&](int64_t bag, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          if (i + 1 < end) {
+            prefetch_row(src_data + src_stride0 * select_indices_data[i + 1]);
+          }
+          THBlas_axpy<T>(ddim, scale_data[i * scale_stride],
+                  src_data + src_stride0 * select_indices_data[i], src_stride1,
+                  output_data + output_stride0 * bag, output_stride1);
+        }
+      });
+}
+
+// This function fuses the following three fns:
+// index_select (using select_indices as the index)
+// mul (scaling by per_sample_weights)
+// index_add (adding up the rows of every bag)
+template<typename T>
+static void index_select_scale_add(const Tensor &select_indices,
+                                   const Tensor &scale,
+                                   const Tensor &src,
+                                   Tensor &output,
+                                   const Tensor& offsets,
+                                   bool include_last_offset) {
+  index_select_scale_add_strided<T>(
+      select_indices, scale, src, output, offsets, include_last_offset);
 }
 
 template<>
 void index_select_scale_add<float>(const Tensor &select_indices,
-                                          const Tensor &add_indices,
                                           const Tensor &scale,
                                           const Tensor &src,
                                           Tensor &output,
@@ -270,24 +322,8 @@ void index_select_scale_add<float>(const Tensor &select_indices,
 #endif
         });
   } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto scale_stride = scale.stride(0);
-    auto numel = add_indices.numel();
-
-
-    for (int64_t i = 0; i < numel; i++) {
-      auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
-      for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-      }
-    }
+    index_select_scale_add_strided<float>(
+        select_indices, scale, src, output, offsets, include_last_offset);
   }
 }
 
@@ -335,24 +371,6 @@ static Tensor apply_bag_size(const Tensor &offsets, const Tensor &indices,
   return output;
 }
 
-static Tensor apply_bag_size_backward(const Tensor &offsets,
-                                      const Tensor &indices, const int64_t mode,
-                                      Tensor &output, const Tensor &offset2bag,
-                                      const Tensor &bag_size) {
-  if (mode == MODE_MEAN) {
-    if (offsets.size(0) == 1) {
-      auto bag_size_ = indices.size(0);
-      output /= bag_size_;
-    } else {
-      auto inv_bag_size_ = (1 / bag_size.to(output.options()))
-                             .unsqueeze(1)
-                             .index_select(0, offset2bag);
-      output *= inv_bag_size_;
-    }
-  }
-  return output;
-}
-
 
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
@@ -361,14 +379,14 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
     const Tensor& offset2bag,
     const Tensor& output,
     const Tensor& bag_size,
-    const Tensor& offsets) {
+    const Tensor& offsets,
+    bool include_last_offset) {
 
     auto max_indices = at::zeros({offsets.size(0), weight.size(1)}, indices.options());
 
     int64_t numel = indices.numel();
     int64_t dims = weight.size(1);
     auto* indices_data = indices.data_ptr<int64_t>();
-    auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
 
     auto* max_indices_data = max_indices.data_ptr<int64_t>();
     auto max_indices_stride = max_indices.stride(0);
@@ -379,21 +397,23 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
     auto weight_stride1 = weight.stride(1);
     auto output_stride = output.stride(0);
 
-    for (int i = 0; i < numel; i++) {
-      auto bag = offset2bag_data[i];
-      auto word_idx = indices_data[i];
-
-      for (int dim = 0; dim < dims; dim++) {
-        auto& current_item = output_data[output_stride * bag + dim];
-        auto weight_item = weight_data[weight_stride0 * word_idx + dim * weight_stride1];
-        bool is_first_for_bag = (i == 0) || offset2bag_data[i - 1] != bag;
-
-        if (is_first_for_bag || weight_item > current_item) {
-          current_item = weight_item;
-          max_indices_data[max_indices_stride * bag + dim] = word_idx;
-        }
-      }
-    }
+    parallel_for_each_bag(
+        offsets, numel, include_last_offset, [&](int64_t bag, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            auto word_idx = indices_data[i];
+            if (i + 1 < end) {
+              prefetch_row(weight_data + weight_stride0 * indices_data[i + 1]);
+            }
+            for (int64_t dim = 0; dim < dims; dim++) {
+              auto& current_item = output_data[output_stride * bag + dim];
+              auto weight_item = weight_data[weight_stride0 * word_idx + dim * weight_stride1];
+              if (i == begin || weight_item > current_item) {
+                current_item = weight_item;
+                max_indices_data[max_indices_stride * bag + dim] = word_idx;
+              }
+            }
+          }
+        });
 
     return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
 }
@@ -456,41 +476,21 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
        weight.size(1)},
       weight.options());
 
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
-      return isFastPathIndexSelectScale(weight, per_sample_weights, output);
-    } else {
-      return isFastPathIndexSelect(weight, output);
-    }
-  };
-
-  // Use an empty 0-element tensor as a sentinel that we have skipped the
-  // creation of offset2bag because autograd chokes when trying to use an
-  // undefined tensor as an input to a backward op.
+  // All the forward kernels walk the bags through offsets, so offset2bag is
+  // never computed here. Use an empty 0-element tensor as a sentinel that we
+  // have skipped its creation because autograd chokes when trying to use an
+  // undefined tensor as an input to a backward op; the backward builds it
+  // when it needs it.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
-    // If the last entries are empty, that the last offsets are irrelevant as they
-    // won't change anything in the assignment of ID -> bag, but index_add would
-    // throw out of bounds error. So to keep it simple we just add one more
-    // entry to the end then get rid of it after make_offset2bag.
-    offset2bag = at::zeros(
-       {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
-
-    make_offset2bag(offsets, indices, offset2bag);
-
-    offset2bag.resize_({indices.sizes()[0]});
-  }
 
   if (mode == MODE_MEAN || mode == MODE_SUM) {
     AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu", [&]() {
       if (per_sample_weights.defined()) {
         AT_ASSERT(mode == MODE_SUM);
         index_select_scale_add<scalar_t>(
-            indices, offset2bag, per_sample_weights, weight, output, offsets, include_last_offset);
+            indices, per_sample_weights, weight, output, offsets, include_last_offset);
       } else {
-        index_select_add<scalar_t>(indices, offset2bag, weight, output, offsets, include_last_offset);
+        index_select_add<scalar_t>(indices, weight, output, offsets, include_last_offset);
       }
     });
     auto ret = apply_bag_size(offsets, indices, mode, output, bag_size);
@@ -503,7 +503,7 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
     return AT_DISPATCH_FLOATING_TYPES_AND_HALF(
       weight.scalar_type(), "embedding_bag_cpu_max", [&]() {
         return embedding_bag_cpu_max<scalar_t>(
-            weight, indices, offset2bag, output, bag_size, offsets);
+            weight, indices, offset2bag, output, bag_size, offsets, include_last_offset);
       }
     );
   }
@@ -571,120 +571,148 @@ static Tensor _embedding_bag_dense_backward_cpu_max(
   return index_grad_weight;
 }
 
-static std::vector<int64_t> compute_counts(
-    int64_t num_weights,
-    int64_t* indices_data,
-    int64_t indices_length) {
-  std::vector<int64_t> counts(num_weights, 0);
-  for (int i = 0; i < indices_length; i++) {
-    counts[indices_data[i]]++;
-  }
-  return counts;
-}
-
-// counts_uniq stores the index of the NEXT unique element
-// of the (sorted) indices vector.
+// Sorts the indices and splits them into runs of equal values ("segments"),
+// so that every embedding row receiving gradient is owned by exactly one
+// segment and the segments can be reduced in parallel without atomics.
 //
 // For example:
-// indices: [0, 0, 0, 1, 3, 3, 4]
-// counts: [3, 1, 0, 2, 1, 0]
-// counts_uniq: [3, 4, 6, 7]
-//
-// The unique indices can be found at index 0, 3, 4, 6.
-static std::vector<int64_t> compute_counts_uniq(
-    int64_t num_weights,
-    int64_t* indices_data,
-    int64_t indices_length,
-    const std::vector<int64_t>& counts) {
-  std::vector<int64_t> counts_uniq;
-  counts_uniq.reserve(num_weights);
-  int64_t o = 0;
-  for (int64_t i = 0; i < indices_length; i += counts[indices_data[i]]) {
-    counts_uniq.push_back(counts[indices_data[i]]);
-    if (o > 0) {
-      counts_uniq[o] += counts_uniq[o - 1];
+// indices: [3, 0, 4, 0, 3, 1, 0]
+// sorted_indices: [0, 0, 0, 1, 3, 3, 4]
+// segment_starts: [0, 3, 4, 6, 7]  (the last entry is numel)
+struct IndexSegments {
+  Tensor sorted_indices;
+  // Position in the unsorted indices of every entry of sorted_indices.
+  Tensor permutation;
+  std::vector<int64_t> segment_starts;
+
+  int64_t num_segments() const {
+    return static_cast<int64_t>(segment_starts.size()) - 1;
+  }
+};
+
+static IndexSegments sort_and_segment(const Tensor& indices) {
+  IndexSegments result;
+  std::tie(result.sorted_indices, result.permutation) = indices.sort();
+  auto* sorted_data = result.sorted_indices.data_ptr<int64_t>();
+  int64_t numel = indices.numel();
+
+  // Two passes over fixed chunks: count the segment boundaries in every
+  // chunk, then write them out at the chunk's offset.
+  constexpr int64_t kChunkSize = 32768;
+  int64_t num_chunks = (numel + kChunkSize - 1) / kChunkSize;
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  auto is_boundary = [&](int64_t i) {
+    return i == 0 || sorted_data[i] != sorted_data[i - 1];
+  };
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      int64_t count = 0;
+      for (int64_t i = chunk * kChunkSize; i < std::min(numel, (chunk + 1) * kChunkSize); i++) {
+        count += is_boundary(i);
+      }
+      chunk_offsets[chunk + 1] = count;
     }
-    o++;
+  });
+  for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+    chunk_offsets[chunk + 1] += chunk_offsets[chunk];
   }
-  return counts_uniq;
+
+  result.segment_starts.resize(chunk_offsets[num_chunks] + 1);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      int64_t out = chunk_offsets[chunk];
+      for (int64_t i = chunk * kChunkSize; i < std::min(numel, (chunk + 1) * kChunkSize); i++) {
+        if (is_boundary(i)) {
+          result.segment_starts[out++] = i;
+        }
+      }
+    }
+  });
+  result.segment_starts.back() = numel;
+  return result;
 }
 
-template <typename scalar_t>
-void _embedding_bag_dense_backward_cpu_sum_mean(
+// Accumulates into dst (one row per segment, at the position given by
+// dst_row(segment)) the rows of grad of the bags its indices belong to,
+// scaled by per_sample_weights, the bag size in MODE_MEAN and the segment
+// length if scale_grad_by_freq.
+template <typename scalar_t, typename RowFn>
+static void embedding_bag_segment_reduce(
     const Tensor& grad,
-    const Tensor& indices_,
-    const Tensor& offsets_,
-    const Tensor& offset2bag__,
-    int64_t num_weights,
+    const IndexSegments& segments,
+    const Tensor& offsets,
+    const Tensor& offset2bag_,
     bool scale_grad_by_freq,
     int64_t mode,
     const Tensor& per_sample_weights_,
-    Tensor& index_grad_weight) {
-
-  Tensor &offset2bag_ = const_cast<Tensor &>(offset2bag__);
-
-  auto ind_sort_ = indices_.sort();
-  auto indices = std::get<0>(ind_sort_);
-  auto ind_sort = std::get<1>(ind_sort_);
-  auto offset2bag = offset2bag_.index_select(0, ind_sort);
+    scalar_t* dst,
+    const RowFn& dst_row) {
+  auto offset2bag = offset2bag_.index_select(0, segments.permutation);
+  auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
+  auto* offsets_data = offsets.data_ptr<int64_t>();
+  int64_t num_offsets = offsets.size(0);
+  int64_t numel = segments.sorted_indices.numel();
 
-  optional<Tensor> per_sample_weights;
-  scalar_t* per_sample_weights_data;
-  optional<int64_t> per_sample_weights_stride;
+  Tensor per_sample_weights;
+  scalar_t* per_sample_weights_data = nullptr;
+  int64_t per_sample_weights_stride = 0;
   if (per_sample_weights_.defined()) {
-    per_sample_weights = per_sample_weights_.index_select(0, ind_sort);
-    per_sample_weights_data = per_sample_weights->data_ptr<scalar_t>();
-    per_sample_weights_stride = per_sample_weights->stride(0);
+    AT_ASSERT(mode == MODE_SUM);
+    per_sample_weights = per_sample_weights_.index_select(0, segments.permutation);
+    per_sample_weights_data = per_sample_weights.data_ptr<scalar_t>();
+    per_sample_weights_stride = per_sample_weights.stride(0);
   }
 
-  auto* indices_data = indices.data_ptr<int64_t>();
-  auto* offsets_data = offsets_.data_ptr<int64_t>();
-  auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
-  int64_t numel = indices.numel();
+  int64_t ddim = grad.size(1);
+  auto* gd = grad.data_ptr<scalar_t>();
+  const auto& starts = segments.segment_starts;
 
-  auto counts = compute_counts(num_weights, indices_data, numel);
-  auto next_unique_index_idx =
-      compute_counts_uniq(num_weights, indices_data, numel, counts);
-
-  auto loop = [&](int64_t start, int64_t end) {
-    for (int64_t i = start; i < end; i++) {
-      int64_t start = i == 0 ? 0 : next_unique_index_idx[i - 1];
-      int64_t index = indices_data[start];
-      for (int64_t j = start; j < next_unique_index_idx[i]; j++) {
+  at::parallel_for(0, segments.num_segments(), 64, [&](int64_t begin, int64_t end) {
+    for (int64_t seg = begin; seg < end; seg++) {
+      scalar_t* dst_base = dst + ddim * dst_row(seg);
+      for (int64_t j = starts[seg]; j < starts[seg + 1]; j++) {
         int64_t source = offset2bag_data[j];
+        if (j + 1 < starts[seg + 1]) {
+          prefetch_row(gd + ddim * offset2bag_data[j + 1]);
+        }
         double scale = 1.0;
-        if (per_sample_weights) {
-          AT_ASSERT(mode == MODE_SUM);
-          scale = per_sample_weights_data[*per_sample_weights_stride * j];
+        if (per_sample_weights_data) {
+          scale = per_sample_weights_data[per_sample_weights_stride * j];
         }
         if (scale_grad_by_freq) {
-          scale /= counts[indices_data[i]];
+          scale /= starts[seg + 1] - starts[seg];
         }
-        if (mode == 1) { // MODE_MEAN
-          if (offsets_.size(0) == 1) {
-            auto bag_size = indices.size(0);
-            scale /= bag_size;
+        if (mode == MODE_MEAN) {
+          if (source == num_offsets - 1) {
+            scale /= numel - offsets_data[num_offsets - 1];
           } else {
-            if (source == offsets_.size(0) - 1) {
-              scale /= indices.size(0) - offsets_data[offsets_.size(0) - 1];
-            } else {
-              scale /= offsets_data[source + 1] - offsets_data[source];
-            }
+            scale /= offsets_data[source + 1] - offsets_data[source];
           }
         }
-        int64_t ddim = grad.size(1);
-        auto igwd = index_grad_weight.data_ptr<scalar_t>();
-        auto gd = grad.data_ptr<scalar_t>();
         THBlas_axpy<scalar_t>(ddim, (scalar_t)scale, gd + ddim * source, 1,
-                    igwd + ddim * index, 1);
+                    dst_base, 1);
       }
     }
-  };
-  if (numel > 1000) {
-    at::parallel_for(0, (int64_t)next_unique_index_idx.size(), 0, loop);
-  } else {
-    loop(0, (int64_t)next_unique_index_idx.size());
-  }
+  });
+}
+
+template <typename scalar_t>
+void _embedding_bag_dense_backward_cpu_sum_mean(
+    const Tensor& grad,
+    const Tensor& indices_,
+    const Tensor& offsets_,
+    const Tensor& offset2bag_,
+    bool scale_grad_by_freq,
+    int64_t mode,
+    const Tensor& per_sample_weights_,
+    Tensor& index_grad_weight) {
+  auto segments = sort_and_segment(indices_);
+  auto* indices_data = segments.sorted_indices.data_ptr<int64_t>();
+  const auto& starts = segments.segment_starts;
+  embedding_bag_segment_reduce<scalar_t>(
+      grad, segments, offsets_, offset2bag_, scale_grad_by_freq, mode,
+      per_sample_weights_, index_grad_weight.data_ptr<scalar_t>(),
+      [&](int64_t seg) { return indices_data[starts[seg]]; });
 }
 
 Tensor _embedding_bag_dense_backward_cpu(const Tensor &grad_, const Tensor &indices_,
@@ -713,7 +741,7 @@ Tensor _embedding_bag_dense_backward_cpu(const Tensor &grad_, const Tensor &indi
 
   AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "embedding_bag_backward", [&] {
       _embedding_bag_dense_backward_cpu_sum_mean<scalar_t>(
-          grad, indices_, offsets_, offset2bag__, num_weights,
+          grad, indices_, offsets_, offset2bag__,
           scale_grad_by_freq, mode, per_sample_weights_, index_grad_weight);
   });
   return index_grad_weight;
@@ -805,6 +833,58 @@ Tensor _embedding_bag_per_sample_weights_backward_cpu(
   );
 }
 
+static Tensor apply_bag_size_backward(const Tensor &offsets,
+                                      const Tensor &indices, const int64_t mode,
+                                      Tensor &output, const Tensor &offset2bag,
+                                      const Tensor &bag_size) {
+  if (mode == MODE_MEAN) {
+    if (offsets.size(0) == 1) {
+      auto bag_size_ = indices.size(0);
+      output /= bag_size_;
+    } else {
+      auto inv_bag_size_ = (1 / bag_size.to(output.options()))
+                             .unsqueeze(1)
+                             .index_select(0, offset2bag);
+      output *= inv_bag_size_;
+    }
+  }
+  return output;
+}
+
+// Reduces the gradient of every distinct index into a single row, which
+// yields an already coalesced sparse gradient.
+static Tensor _embedding_bag_sparse_backward_cpu(
+    const Tensor &grad_, const Tensor &indices, const Tensor &offsets,
+    const Tensor &offset2bag, int64_t num_weights, int64_t mode,
+    const Tensor& per_sample_weights) {
+  auto grad = grad_.contiguous();
+  int64_t num_features = grad.size(1);
+  auto weight_size = std::array<int64_t, 2>{{ num_weights, num_features }};
+  if (indices.numel() == 0) {
+    return at::_sparse_coo_tensor_unsafe(at::empty({1, 0}, indices.options()),
+                                         at::empty({0, num_features}, grad.options()),
+                                         weight_size);
+  }
+
+  auto segments = sort_and_segment(indices);
+  int64_t num_segments = segments.num_segments();
+  auto sparse_indices = at::empty({1, num_segments}, indices.options());
+  auto values = at::zeros({num_segments, num_features}, grad.options());
+  auto* sorted_data = segments.sorted_indices.data_ptr<int64_t>();
+  auto* sparse_indices_data = sparse_indices.data_ptr<int64_t>();
+  for (int64_t seg = 0; seg < num_segments; seg++) {
+    sparse_indices_data[seg] = sorted_data[segments.segment_starts[seg]];
+  }
+
+  AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "embedding_bag_sparse_backward", [&] {
+    embedding_bag_segment_reduce<scalar_t>(
+        grad, segments, offsets, offset2bag, /* scale_grad_by_freq */ false,
+        mode, per_sample_weights, values.data_ptr<scalar_t>(),
+        [](int64_t seg) { return seg; });
+  });
+  return at::_sparse_coo_tensor_unsafe(sparse_indices, values, weight_size)._coalesced_(true);
+}
+
 Tensor _embedding_bag_sparse_backward(
     const Tensor &grad_, const Tensor &indices, const Tensor &offsets,
     const Tensor &offset2bag, const Tensor &bag_size_, int64_t num_weights,
@@ -814,6 +894,16 @@ Tensor _embedding_bag_sparse_backward(
   // Also see NOTE [ embedding_bag Native Functions ] in native_functions.yaml
   // for more details.
 
+  // This function has no per-device dispatch, so only float and double CPU
+  // gradients take the segment reduction; embedding_backward below handles
+  // the other devices and dtypes, and rejects scale_grad_by_freq.
+  if (grad_.device().is_cpu() && !scale_grad_by_freq &&
+      (grad_.scalar_type() == kFloat || grad_.scalar_type() == kDouble)) {
+    return _embedding_bag_sparse_backward_cpu(
+        grad_, indices, offsets, offset2bag, num_weights, mode,
+        per_sample_weights);
+  }
+
   Tensor grad = grad_;
   Tensor index_grad = grad_.index_select(0, offset2bag);
   index_grad = apply_bag_size_backward(offsets, indices, mode, index_grad,
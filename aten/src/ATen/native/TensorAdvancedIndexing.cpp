@@ -58,6 +58,7 @@
 #include <ATen/native/BinaryOps.h>
 #include <ATen/native/Copy.h>
 #include <ATen/Parallel.h>
+#include <ATen/NamedTensorUtils.h>
 
 #include <algorithm>
 #include <functional>
@@ -70,6 +71,9 @@ DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
 DEFINE_DISPATCH(index_put_accum_stub);
 DEFINE_DISPATCH(masked_fill_stub);
+DEFINE_DISPATCH(masked_select_stub);
+DEFINE_DISPATCH(masked_scatter_stub);
+DEFINE_DISPATCH(nonzero_stub);
 REGISTER_NO_CPU_DISPATCH(index_put_accum_stub, index_put_accum_fn);
 
 DEFINE_DISPATCH(gather_stub);
@@ -555,6 +559,31 @@ Tensor scatter_add(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone(at::MemoryFormat::Preserve).scatter_add_(dim, index, source);
 }
 
+Tensor & masked_scatter__cpu(Tensor& self, const Tensor & mask, const Tensor & source) {
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Byte || mask.scalar_type() == ScalarType::Bool,
+              "masked_scatter_: expected BoolTensor or ByteTensor for mask");
+  TORCH_CHECK(self.scalar_type() == source.scalar_type(),
+              "masked_scatter_: expected self and source to have same dtypes but got ",
+              self.scalar_type(), " and ", source.scalar_type());
+  if (mask.dtype() == ScalarType::Byte) {
+    TORCH_WARN("masked_scatter_ received a mask with dtype torch.uint8, this behavior is now deprecated," \
+            "please use a mask with dtype torch.bool instead.");
+  }
+  Tensor b_mask;
+  std::tie(b_mask) = expand_inplace(self, mask, "masked_scatter_");
+
+  auto iter = TensorIterator();
+  iter.enforce_linear_iteration();
+  iter.dont_compute_common_dtype();
+  iter.dont_resize_outputs();
+  iter.add_output(self);
+  iter.add_input(b_mask);
+  iter.build();
+
+  masked_scatter_stub(iter.device_type(), iter, source.contiguous());
+  return self;
+}
+
 Tensor masked_scatter(const Tensor & self, const Tensor & mask, const Tensor & source) {
   Tensor _mask, _self;
   std::tie(_mask, _self) = expand_outplace(mask, self);
@@ -625,6 +654,57 @@ Tensor masked_fill(const Tensor & self, const Tensor & mask, const Tensor & sour
   return result;
 }
 
+static Tensor & masked_select_out_impl_cpu(Tensor & result, const Tensor & self, const Tensor & mask) {
+  NoNamesGuard guard;
+  TORCH_CHECK(mask.scalar_type() == ScalarType::Byte || mask.scalar_type() == ScalarType::Bool,
+              "masked_select: expected BoolTensor or ByteTensor for mask");
+  TORCH_CHECK(self.scalar_type() == result.scalar_type(),
+              "masked_select(): self and result must have the same scalar type");
+  if (mask.dtype() == ScalarType::Byte) {
+    TORCH_WARN("masked_select received a mask with dtype torch.uint8, this behavior is now deprecated," \
+            "please use a mask with dtype torch.bool instead.");
+  }
+
+  // self and mask are broadcast together by the iterator
+  auto iter = TensorIterator();
+  iter.enforce_linear_iteration();
+  iter.dont_compute_common_dtype();
+  iter.add_input(self);
+  iter.add_input(mask);
+  iter.build();
+
+  masked_select_stub(iter.device_type(), iter, result);
+  return result;
+}
+
+Tensor & masked_select_out_cpu(Tensor & result, const Tensor & self, const Tensor & mask) {
+  namedinference::compute_broadcast_outnames(self, mask);
+  return masked_select_out_impl_cpu(result, self, mask);
+}
+
+Tensor masked_select_cpu(const Tensor & self, const Tensor & mask) {
+  Tensor result = at::empty({0}, self.options());
+  return masked_select_out_cpu(result, self, mask);
+}
+
+Tensor & nonzero_out_cpu(Tensor & result, const Tensor & self) {
+  TORCH_CHECK(result.scalar_type() == ScalarType::Long,
+              "nonzero: expected out tensor to have scalar type Long but got scalar type ", result.scalar_type());
+
+  auto iter = TensorIterator();
+  iter.enforce_linear_iteration();
+  iter.add_input(self);
+  iter.build();
+
+  nonzero_stub(iter.device_type(), iter, self.sizes(), result);
+  return result;
+}
+
+Tensor nonzero_cpu(const Tensor & self) {
+  Tensor result = at::empty({0}, self.options().dtype(kLong));
+  return nonzero_out_cpu(result, self);
+}
+
 Tensor _gather_sparse_backward(const Tensor& self, int64_t dim, const Tensor& index, const Tensor& grad){
 // special case scalar input and/or index
     if (self.ndimension() == 0) return at::_sparse_coo_tensor_unsafe(at::empty({0,grad.numel()}, index.options()), grad, self.sizes());
@@ -27,6 +27,12 @@ void TensorIterator::reorder_dimensions() {
   // initialize perm with n-1, n-2, ..., 1, 0
   std::iota(perm_.rbegin(), perm_.rend(), 0);
 
+  // Reordering dimensions would change the order in which elements are visited
+  if (enforce_linear_iteration_) {
+    permute_dimensions(perm_);
+    return;
+  }
+
   // returns 1 if the dim0 should come after dim1, -1 if dim0 should come
   // before dim1, and 0 if the comparison is ambiguous.
   auto should_swap = [&](size_t dim0, size_t dim1) {
@@ -1013,6 +1019,10 @@ FastSetupType TensorIterator::compute_fast_setup_type() {
   if (is_contiguous) {
     return FastSetupType::CONTIGUOUS;
   }
+  // The remaining fast setups iterate in memory order
+  if (enforce_linear_iteration_) {
+    return FastSetupType::NONE;
+  }
   if (is_channels_last) {
     return FastSetupType::CHANNELS_LAST;
   }
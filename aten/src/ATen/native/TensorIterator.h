@@ -357,6 +357,14 @@ struct CAFFE2_API TensorIterator {
     resize_outputs_ = false;
   }
 
+  /// Iterate over the elements in their logical (row-major) order instead of
+  /// reordering dimensions to follow the operands' memory layout. Needed by
+  /// kernels whose result depends on the position of each element, such as
+  /// nonzero and masked_select.
+  void enforce_linear_iteration() {
+    enforce_linear_iteration_ = true;
+  }
+
   void build();
 
 protected:
@@ -394,6 +402,7 @@ protected:
   bool promote_gpu_output_dtypes_ = false;
   bool final_output_ = true;
   bool check_mem_overlap_ = false;
+  bool enforce_linear_iteration_ = false;
   bool all_ops_same_shape_ = false;
   bool requires_channels_last_output_ = false;
   bool requires_channels_last_3d_output_ = false;
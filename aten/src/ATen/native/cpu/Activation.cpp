@@ -8,7 +8,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Config.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/Parallel.h>
@@ -24,7 +24,7 @@ namespace {
 
 template <typename scalar_t>
 inline void _vec_log_sigmoid(Tensor& output, Tensor& buffer, const Tensor& input) {
-  using Vec = Vec256<scalar_t>;
+  using Vec = Vectorized<scalar_t>;
   scalar_t* output_data = output.data_ptr<scalar_t>();
   scalar_t* buffer_data = buffer.data_ptr<scalar_t>();
   scalar_t* input_data = input.data_ptr<scalar_t>();
@@ -58,7 +58,7 @@ static void log_sigmoid_cpu_kernel(Tensor& output, Tensor& buffer, const Tensor&
 
 static void log_sigmoid_backward_cpu_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "log_sigmoid_backward_cpu", [&]() {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto zero_val = scalar_t(0);
     auto zero_vec = Vec(zero_val);
     auto one_val = scalar_t(1);
@@ -87,7 +87,7 @@ static void threshold_kernel(
     Scalar threshold_scalar,
     Scalar value_scalar) {
   AT_DISPATCH_ALL_TYPES(iter.dtype(), "threshold_cpu", [&] {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     scalar_t threshold = threshold_scalar.to<scalar_t>();
     Vec threshold_v = Vec(threshold);
     scalar_t value = value_scalar.to<scalar_t>();
@@ -200,7 +200,7 @@ void GeluBackwardMKLKernelImpl(TensorIterator* /* it */) {
 
 void elu_kernel(TensorIterator& it, Scalar alpha, Scalar scale, Scalar input_scale) {
   AT_DISPATCH_FLOATING_TYPES(it.dtype(), "elu_cpu", [&]() {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto negcoef = alpha.to<scalar_t>() * scale.to<scalar_t>();
     auto poscoef = scale.to<scalar_t>();
     auto negiptcoef = input_scale.to<scalar_t>();
@@ -227,7 +227,7 @@ void elu_kernel(TensorIterator& it, Scalar alpha, Scalar scale, Scalar input_sca
 
 void elu_backward_kernel(TensorIterator& it, Scalar alpha, Scalar scale, Scalar input_scale) {
   AT_DISPATCH_FLOATING_TYPES(it.dtype(), "elu_backward_cpu", [&]() {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto negcoef = alpha.to<scalar_t>() * scale.to<scalar_t>();
     auto poscoef = scale.to<scalar_t>();
     auto negiptcoef = input_scale.to<scalar_t>();
@@ -262,7 +262,7 @@ void GeluKernelImpl(TensorIterator& it) {
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluKernelImpl", [&]() {
-      using Vec = vec256::Vec256<scalar_t>;
+      using Vec = vec256::Vectorized<scalar_t>;
       const Vec kAlphaVec(M_SQRT1_2);
       const Vec kOneVec(1);
       const Vec kPointFiveVec(0.5);
@@ -287,7 +287,7 @@ void GeluBackwardKernelImpl(TensorIterator& it) {
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(it.dtype(), "GeluBackwardKernelImpl", [&]() {
-      using Vec = vec256::Vec256<scalar_t>;
+      using Vec = vec256::Vectorized<scalar_t>;
       const Vec kAlphaVec(M_SQRT1_2);
       const Vec kBetaVec(M_2_SQRTPI * M_SQRT1_2 * 0.5);
       const Vec kOneVec(1);
@@ -319,7 +319,7 @@ void hardsigmoid_kernel(TensorIterator& iter) {
     const scalar_t zero(0.0f);
     const scalar_t three(3.0f);
     const scalar_t six(6.0f);
-    using Vec = vec256::Vec256<scalar_t>;
+    using Vec = vec256::Vectorized<scalar_t>;
     const Vec kZeroVec(zero);
     const Vec kThreeVec(three);
     const Vec kSixVec(six);
@@ -343,7 +343,7 @@ void hardsigmoid_backward_kernel(TensorIterator& iter) {
     const scalar_t three(3.0f);
     const scalar_t neg_three(-3.0f);
     const scalar_t one_sixth(1.0f / 6.0f);
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     Vec kZeroVec(0.0f);
     Vec kOneSixthVec(1.0f / 6.0f);
     cpu_kernel_vec(
@@ -369,7 +369,7 @@ void hardshrink_kernel(TensorIterator& iter, Scalar lambd) {
           return (self_val >= -lambd_val && self_val <= lambd_val) ? scalar_t(0)
                                                                    : self_val;
         },
-        [=](Vec256<scalar_t> self_val) {
+        [=](Vectorized<scalar_t> self_val) {
           return ((self_val < -lambd_val) | (self_val > lambd_val)) & self_val;
         });
   });
@@ -393,7 +393,7 @@ void shrink_backward_kernel(TensorIterator& iter, Scalar lambd) {
           return (self_val >= -lambd_val && self_val <= lambd_val) ? scalar_t(0)
                                                                    : grad_val;
         },
-        [=](Vec256<scalar_t> grad_val, Vec256<scalar_t> self_val) {
+        [=](Vectorized<scalar_t> grad_val, Vectorized<scalar_t> self_val) {
           return ((self_val < -lambd_val) | (self_val > lambd_val)) & grad_val;
         });
   });
@@ -408,7 +408,7 @@ void hardtanh_backward_kernel(TensorIterator& iter, Scalar min, Scalar max) {
         [=](scalar_t grad_val, scalar_t self_val) {
           return (self_val <= min_val || self_val >= max_val) ? scalar_t(0) : grad_val;
         },
-        [=](Vec256<scalar_t> grad_val, Vec256<scalar_t> self_val) {
+        [=](Vectorized<scalar_t> grad_val, Vectorized<scalar_t> self_val) {
           return ((self_val > min_val) & (self_val < max_val)) & grad_val;
         });
   });
@@ -419,7 +419,7 @@ void hardswish_kernel(TensorIterator& iter) {
     const scalar_t zero(0.0f);
     const scalar_t three(3.0f);
     const scalar_t six(6.0f);
-    using Vec = vec256::Vec256<scalar_t>;
+    using Vec = vec256::Vectorized<scalar_t>;
     const Vec kZeroVec(zero);
     const Vec kThreeVec(three);
     const Vec kSixVec(six);
@@ -444,7 +444,7 @@ void hardswish_backward_kernel(TensorIterator& iter) {
     const scalar_t three(3.0f);
     const scalar_t neg_three(-3.0f);
     const scalar_t one_half(0.5f);
-    using Vec = vec256::Vec256<scalar_t>;
+    using Vec = vec256::Vectorized<scalar_t>;
     const Vec kZeroVec(zero);
     const Vec kThreeVec(three);
     const Vec kNegThreeVec(neg_three);
@@ -477,7 +477,7 @@ void hardswish_backward_kernel(TensorIterator& iter) {
 
 static void leaky_relu_kernel(TensorIterator& iter, Scalar negval_) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "leaky_relu_cpu", [&] {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto zero_vec = Vec((scalar_t)(0));
     auto one_vec = Vec((scalar_t)(1));
     scalar_t negval = negval_.to<scalar_t>();
@@ -496,7 +496,7 @@ static void leaky_relu_kernel(TensorIterator& iter, Scalar negval_) {
 
 static void leaky_relu_backward_kernel(TensorIterator& iter, Scalar negval_) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "leaky_relu_backward_cpu", [&] {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto zero_vec = Vec((scalar_t)(0));
     auto one_vec = Vec((scalar_t)(1));
     scalar_t negval = negval_.to<scalar_t>();
@@ -515,7 +515,7 @@ static void leaky_relu_backward_kernel(TensorIterator& iter, Scalar negval_) {
 
 void softplus_kernel(TensorIterator& iter, Scalar beta_, Scalar threshold_) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "softplus_cpu", [&]() {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto beta = beta_.to<scalar_t>();
     auto threshold = threshold_.to<scalar_t>();
     const Vec beta_vec(beta);
@@ -535,7 +535,7 @@ void softplus_kernel(TensorIterator& iter, Scalar beta_, Scalar threshold_) {
 
 void softplus_backward_kernel(TensorIterator& iter, Scalar beta_, Scalar threshold_) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "softplus_backward_cpu", [&]() {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     auto beta = beta_.to<scalar_t>();
     auto threshold = threshold_.to<scalar_t>();
     const Vec beta_vec(beta);
@@ -557,7 +557,7 @@ void softplus_backward_kernel(TensorIterator& iter, Scalar beta_, Scalar thresho
 
 void glu_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "glu_cpu", [&] {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     const scalar_t one_val(1);
     const Vec one_vec(one_val);
     cpu_kernel_vec(
@@ -574,7 +574,7 @@ void glu_kernel(TensorIterator& iter) {
 
 void glu_backward_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "glu_backward_cpu", [&] {
-    using Vec = Vec256<scalar_t>;
+    using Vec = Vectorized<scalar_t>;
     const scalar_t one_val(1);
     const Vec one_vec(one_val);
     cpu_kernel_vec(
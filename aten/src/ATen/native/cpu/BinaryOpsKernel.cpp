@@ -2,7 +2,7 @@
 #include <iostream>
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/BinaryOps.h>
@@ -25,10 +25,10 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "add_cpu/sub_cpu", [&]() {
       auto alpha = alpha_scalar.to<scalar_t>();
-      auto alpha_vec = Vec256<scalar_t>(alpha);
+      auto alpha_vec = Vectorized<scalar_t>(alpha);
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) __ubsan_ignore_undefined__ -> scalar_t { return a + alpha * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) __ubsan_ignore_undefined__ {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) __ubsan_ignore_undefined__ {
           return vec256::fmadd(b, alpha_vec, a);
         });
       });
@@ -40,7 +40,7 @@ void atan2_kernel(TensorIterator& iter) {
     cpu_kernel_vec(iter, [=](scalar_t a, scalar_t b) -> scalar_t {
     return std::atan2(a, b);
   },
-    [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+    [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
       return a.atan2(b);
     });
   });
@@ -59,7 +59,7 @@ void mul_kernel(TensorIterator& iter) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "mul_cpu", [&]() {
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a * b;
         });
     });
@@ -82,7 +82,7 @@ void div_kernel(TensorIterator& iter) {
           [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
              return a / b;
           },
-          [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
             return a / b;
           });
       });
@@ -92,7 +92,7 @@ void div_kernel(TensorIterator& iter) {
         [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
            return a / b;
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a / b;
         });
     });
@@ -117,8 +117,8 @@ void remainder_kernel(TensorIterator& iter) {
         [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
           return a - b * at::native::floor_impl(a / b);
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
-          Vec256<scalar_t> r = a - b * (a / b).floor();
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
+          Vectorized<scalar_t> r = a - b * (a / b).floor();
           return r;
         });
     });
@@ -139,7 +139,7 @@ void bitwise_and_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a & b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
             return a & b;
           });
     });
@@ -160,7 +160,7 @@ void bitwise_or_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a | b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
             return a | b;
           });
     });
@@ -183,7 +183,7 @@ void bitwise_xor_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a ^ b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
             return a ^ b;
           });
     });
@@ -193,13 +193,13 @@ void bitwise_xor_kernel(TensorIterator& iter) {
 void lshift_kernel(TensorIterator& iter) {
   if (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double) {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "lshift_cpu", [&]() {
-      auto base_vec = Vec256<scalar_t>((scalar_t)(2));
+      auto base_vec = Vectorized<scalar_t>((scalar_t)(2));
       cpu_kernel_vec(
         iter,
         [=](scalar_t a, scalar_t b) -> scalar_t {
           return a * std::pow((scalar_t)(2), b);
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a * base_vec.pow(b);
       });
     });
@@ -276,13 +276,13 @@ void logical_xor_kernel(TensorIterator& iter) {
 void rshift_kernel(TensorIterator& iter) {
   if (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double) {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "rshift_cpu", [&]() {
-      auto base_vec = Vec256<scalar_t>((scalar_t)(2));
+      auto base_vec = Vectorized<scalar_t>((scalar_t)(2));
       cpu_kernel_vec(
         iter,
         [=](scalar_t a, scalar_t b) -> scalar_t {
           return a / std::pow((scalar_t)(2), b);
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a / base_vec.pow(b);
       });
     });
@@ -311,7 +311,7 @@ void lt_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a < b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.lt(b);
         });
       });
@@ -333,7 +333,7 @@ void le_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a <= b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.le(b);
         });
       });
@@ -355,7 +355,7 @@ void gt_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a > b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.gt(b);
         });
       });
@@ -377,7 +377,7 @@ void ge_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a >= b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.ge(b);
         });
       });
@@ -399,7 +399,7 @@ void eq_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a == b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.eq(b);
         });
       });
@@ -421,7 +421,7 @@ void ne_kernel(TensorIterator& iter) {
         [](scalar_t a, scalar_t b) -> scalar_t {
           return a != b;
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) -> Vec256<scalar_t> {
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) -> Vectorized<scalar_t> {
           return a.ne(b);
         });
       });
@@ -438,7 +438,7 @@ void max_elementwise_kernel(TensorIterator& iter) {
     AT_DISPATCH_INTEGRAL_TYPES(iter.dtype(), "max_lementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t { return std::max(a, b); },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::maximum(a, b); });
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return at::vec256::maximum(a, b); });
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "max_elementwise_cpu", [&]() {
@@ -450,7 +450,7 @@ void max_elementwise_kernel(TensorIterator& iter) {
             return std::max(a, b);
           }
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::maximum(a, b); });
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return at::vec256::maximum(a, b); });
     });
   }
 }
@@ -465,7 +465,7 @@ void min_elementwise_kernel(TensorIterator& iter) {
     AT_DISPATCH_INTEGRAL_TYPES(iter.dtype(), "min_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t { return std::min(a, b); },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::minimum(a, b); });
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return at::vec256::minimum(a, b); });
     });
   } else {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "min_elementwise_cpu", [&]() {
@@ -477,7 +477,7 @@ void min_elementwise_kernel(TensorIterator& iter) {
             return std::min(a, b);
           }
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::minimum(a, b); });
+        [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return at::vec256::minimum(a, b); });
     });
   }
 }
@@ -493,12 +493,12 @@ void smooth_l1_kernel(TensorIterator& iter) {
 
 void sigmoid_backward_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "sigmoid_backward_cpu", [&]() {
-    auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+    auto one_vec = Vectorized<scalar_t>((scalar_t)(1));
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) -> scalar_t {
         return a * (scalar_t(1) - b) * b;
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
         return a * (one_vec - b) * b;
       });
   });
@@ -506,12 +506,12 @@ void sigmoid_backward_kernel(TensorIterator& iter) {
 
 void tanh_backward_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "tanh_backward_cpu", [&]() {
-    auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+    auto one_vec = Vectorized<scalar_t>((scalar_t)(1));
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) -> scalar_t {
         return a * (scalar_t(1) - b * b);
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
         return a * (one_vec - b * b);
       });
   });
@@ -529,7 +529,7 @@ void mse_kernel(TensorIterator& iter) {
         auto diff = a - b;
         return diff * diff;
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
       auto diff =  a - b;
       return diff * diff;
       });
@@ -550,7 +550,7 @@ void fmod_kernel(TensorIterator& iter) {
         [](scalar_t x, scalar_t d) -> scalar_t {
           return std::fmod(x, d);
         },
-        [](Vec256<scalar_t> x, Vec256<scalar_t> d) {
+        [](Vectorized<scalar_t> x, Vectorized<scalar_t> d) {
           return x.fmod(d);
         });
       });
@@ -568,13 +568,13 @@ void fmod_scalar_kernel(TensorIterator& iter, Scalar divisor) {
   } else {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fmod_scalar_cpu", [&]() {
       const auto div = divisor.to<scalar_t>();
-      const auto div_vec = Vec256<scalar_t>(div);
+      const auto div_vec = Vectorized<scalar_t>(div);
       cpu_kernel_vec(
         iter,
         [=](scalar_t x) -> scalar_t {
           return std::fmod(x, div);
         },
-        [=](Vec256<scalar_t> x) {
+        [=](Vectorized<scalar_t> x) {
           return x.fmod(div_vec);
         });
       });
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <numeric>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
@@ -163,11 +164,192 @@ void masked_fill_kernel(TensorIterator& iter, Scalar value) {
     });
 }
 
+// nonzero, masked_select and masked_scatter_ write each selected element at a
+// position given by the number of elements selected before it. They run in two
+// parallel passes over fixed-size chunks of the linear iteration space: the
+// first counts the selected elements of every chunk, an exclusive prefix sum
+// turns the counts into per-chunk output offsets, and the second pass writes
+// every chunk independently starting at its offset. The iterator must have
+// been built with enforce_linear_iteration().
+constexpr int64_t MASKED_CHUNK_SIZE = internal::GRAIN_SIZE;
+
+template <typename count_fn_t>
+std::vector<int64_t> masked_chunk_offsets(const TensorIterator& iter, const count_fn_t& count_fn) {
+  const int64_t numel = iter.numel();
+  const int64_t num_chunks = divup(numel, MASKED_CHUNK_SIZE);
+  std::vector<int64_t> offsets(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      int64_t count = 0;
+      auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+        count += count_fn(data, strides, n);
+      };
+      iter.serial_for_each(loop, {chunk * MASKED_CHUNK_SIZE, std::min(numel, (chunk + 1) * MASKED_CHUNK_SIZE)});
+      offsets[chunk + 1] = count;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  return offsets;
+}
+
+// Calls write_fn(range, offset) in parallel for every chunk that selects at
+// least one element, where offset is the number selected by preceding chunks.
+template <typename write_fn_t>
+void masked_chunk_for_each(const TensorIterator& iter, const std::vector<int64_t>& offsets, const write_fn_t& write_fn) {
+  const int64_t numel = iter.numel();
+  const int64_t num_chunks = offsets.size() - 1;
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      if (offsets[chunk + 1] == offsets[chunk]) {
+        continue;
+      }
+      write_fn(Range(chunk * MASKED_CHUNK_SIZE, std::min(numel, (chunk + 1) * MASKED_CHUNK_SIZE)), offsets[chunk]);
+    }
+  });
+}
+
+template <typename mask_t>
+int64_t count_mask(const char* mask, int64_t stride, int64_t n) {
+  int64_t count = 0;
+  if (std::is_same<mask_t, bool>::value) {
+    for (int64_t i = 0; i < n; i++) {
+      count += *(bool*)(mask + stride * i);
+    }
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      mask_t mask_value = *(mask_t*)(mask + stride * i);
+      TORCH_CHECK(mask_value == 0 || mask_value == 1, "Mask tensor can take 0 and 1 values only");
+      count += mask_value;
+    }
+  }
+  return count;
+}
+
+template <typename scalar_t, typename mask_t>
+void cpu_masked_select_kernel(TensorIterator& iter, Tensor& result) {
+  auto offsets = masked_chunk_offsets(iter, [](char** data, const int64_t* strides, int64_t n) {
+    return count_mask<mask_t>(data[1], strides[1], n);
+  });
+  result.resize_({offsets.back()});
+  auto result_data = result.data_ptr<scalar_t>();
+  auto result_stride = result.stride(0);
+  masked_chunk_for_each(iter, offsets, [&](Range range, int64_t offset) {
+    scalar_t* dst = result_data + offset * result_stride;
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      char* src = data[0];
+      char* mask = data[1];
+      for (int64_t i = 0; i < n; i++) {
+        if (*(mask_t*)(mask + strides[1] * i)) {
+          *dst = *(scalar_t*)(src + strides[0] * i);
+          dst += result_stride;
+        }
+      }
+    };
+    iter.serial_for_each(loop, range);
+  });
+}
+
+void masked_select_kernel(TensorIterator& iter, Tensor& result) {
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Bool, at::ScalarType::BFloat16,
+    iter.input_dtype(0), "masked_select", [&] {
+      if (iter.input_dtype(1) == at::ScalarType::Bool) {
+        cpu_masked_select_kernel<scalar_t, bool>(iter, result);
+      } else {
+        cpu_masked_select_kernel<scalar_t, unsigned char>(iter, result);
+      }
+    });
+}
+
+template <typename scalar_t, typename mask_t>
+void cpu_masked_scatter_kernel(TensorIterator& iter, const Tensor& source) {
+  auto offsets = masked_chunk_offsets(iter, [](char** data, const int64_t* strides, int64_t n) {
+    return count_mask<mask_t>(data[1], strides[1], n);
+  });
+  TORCH_CHECK(offsets.back() <= source.numel(), "Number of elements of source < number of ones in mask");
+  auto source_data = source.data_ptr<scalar_t>();
+  masked_chunk_for_each(iter, offsets, [&](Range range, int64_t offset) {
+    const scalar_t* src = source_data + offset;
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      char* dst = data[0];
+      char* mask = data[1];
+      for (int64_t i = 0; i < n; i++) {
+        if (*(mask_t*)(mask + strides[1] * i)) {
+          *(scalar_t*)(dst + strides[0] * i) = *src++;
+        }
+      }
+    };
+    iter.serial_for_each(loop, range);
+  });
+}
+
+void masked_scatter_kernel(TensorIterator& iter, const Tensor& source) {
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Bool, at::ScalarType::BFloat16,
+    iter.dtype(), "masked_scatter_", [&] {
+      if (iter.input_dtype(0) == at::ScalarType::Bool) {
+        cpu_masked_scatter_kernel<scalar_t, bool>(iter, source);
+      } else {
+        cpu_masked_scatter_kernel<scalar_t, unsigned char>(iter, source);
+      }
+    });
+}
+
+template <typename scalar_t>
+void cpu_nonzero_kernel(TensorIterator& iter, IntArrayRef sizes, Tensor& result) {
+  auto offsets = masked_chunk_offsets(iter, [](char** data, const int64_t* strides, int64_t n) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; i++) {
+      count += *(scalar_t*)(data[0] + strides[0] * i) != scalar_t(0);
+    }
+    return count;
+  });
+  const int64_t ndim = sizes.size();
+  result.resize_({offsets.back(), ndim});
+  auto result_data = result.data_ptr<int64_t>();
+  auto row_stride = result.stride(0);
+  auto col_stride = result.stride(1);
+  masked_chunk_for_each(iter, offsets, [&](Range range, int64_t offset) {
+    // the subscript of the first element of the chunk, with the last dimension
+    // moving fastest; it is then advanced alongside the iterator
+    DimVector subscript(ndim, 0);
+    int64_t linear_index = range.begin;
+    for (int64_t dim = ndim - 1; dim >= 0; dim--) {
+      subscript[dim] = linear_index % sizes[dim];
+      linear_index /= sizes[dim];
+    }
+    int64_t* dst = result_data + offset * row_stride;
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      char* src = data[0];
+      for (int64_t i = 0; i < n; i++) {
+        if (*(scalar_t*)(src + strides[0] * i) != scalar_t(0)) {
+          for (int64_t dim = 0; dim < ndim; dim++) {
+            dst[dim * col_stride] = subscript[dim];
+          }
+          dst += row_stride;
+        }
+        for (int64_t dim = ndim - 1; dim >= 0 && ++subscript[dim] == sizes[dim]; dim--) {
+          subscript[dim] = 0;
+        }
+      }
+    };
+    iter.serial_for_each(loop, range);
+  });
+}
+
+void nonzero_kernel(TensorIterator& iter, IntArrayRef sizes, Tensor& result) {
+  AT_DISPATCH_ALL_TYPES_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
+    iter.dtype(), "nonzero", [&] {
+      cpu_nonzero_kernel<scalar_t>(iter, sizes, result);
+    });
+}
+
 } // anonymous namespace
 
 
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
 REGISTER_DISPATCH(masked_fill_stub, &masked_fill_kernel);
+REGISTER_DISPATCH(masked_select_stub, &masked_select_kernel);
+REGISTER_DISPATCH(masked_scatter_stub, &masked_scatter_kernel);
+REGISTER_DISPATCH(nonzero_stub, &nonzero_kernel);
 
 }} // namespace at::native
@@ -20,7 +20,11 @@
 //
 //   cpu_kernel_vec(iter,
 //     [](float a, float b) { return a * b; },
-//     [](Vec256<float> a, Vec256<float> b) { return a * b; });
+//     [](Vectorized<float> a, Vectorized<float> b) { return a * b; });
+//
+// The vector type is taken from the signature of the vectorized lambda, so
+// kernels that use Vectorized<scalar_t> get 512-bit vectors in the AVX512
+// build and Vec256 in the others.
 //
 // See BinaryOpsKernel.cpp for the complete implementation
 //
@@ -31,7 +35,7 @@
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/native/cpu/IsContiguous.h>
 #include <ATen/native/TensorIterator.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 
 #ifndef _MSC_VER
 #pragma GCC diagnostic push
@@ -135,7 +139,7 @@ static inline void
 vectorized_loop(char** C10_RESTRICT data_, int64_t n, int64_t S, func_t&& op, vec_func_t&& vop) {
   using traits = function_traits<vec_func_t>;
   using scalar_t = typename function_traits<func_t>::result_type;
-  using Vec = Vec256<scalar_t>;
+  using Vec = typename traits::result_type;
   constexpr int ntensors = traits::arity + 1;
 
   char* C10_RESTRICT data[ntensors];
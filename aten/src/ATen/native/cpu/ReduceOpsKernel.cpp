@@ -3,7 +3,7 @@
 #include <algorithm>
 
 #include <ATen/Dispatch.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
@@ -110,7 +110,7 @@ static void sum_kernel_impl(TensorIterator& iter) {
       ScalarType::BFloat16, ScalarType::Bool, iter.dtype(), "sum_cpu", [&] {
         binary_kernel_reduce_vec(
             iter, [=](scalar_t a, scalar_t b) -> scalar_t { return a + b; },
-            [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; });
+            [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a + b; });
       });
 }
 
@@ -140,7 +140,7 @@ static void prod_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a * b; },
       /*identity=*/1);
   });
 }
@@ -252,7 +252,7 @@ static void min_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return minimum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return minimum(a, b); });
   });
 }
 
@@ -261,7 +261,7 @@ static void max_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return maximum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return maximum(a, b); });
   });
 }
 
@@ -4,11 +4,350 @@
 #include <ATen/NumericUtils.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
+#include <ATen/native/ReduceOpsUtils.h>
+#include <ATen/native/TensorIterator.h>
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 namespace at { namespace native {
 
 namespace {
 
+// Slices shorter than this are sorted with a comparison sort, longer ones with
+// an LSD radix sort over an order-preserving unsigned encoding of the values.
+constexpr int64_t RADIX_SORT_MIN_SIZE = 256;
+
+// When there are fewer slices than threads, slices at least this long are
+// split across the intra-op thread pool and finished with a parallel merge.
+constexpr int64_t PARALLEL_SORT_MIN_SIZE = 1 << 16;
+
+// Maps a value to an unsigned key whose natural ordering is the ordering
+// sort() must produce: ascending with NaNs last, or the exact reverse when
+// descending. Equal values map to equal keys so that radix sort stays stable.
+template <typename scalar_t, typename = void>
+struct RadixKey;
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<
+    std::is_integral<scalar_t>::value && !std::is_same<scalar_t, bool>::value>::type> {
+  using type = typename std::make_unsigned<scalar_t>::type;
+
+  static type encode(scalar_t value, bool descending) {
+    constexpr type sign_bit = std::is_signed<scalar_t>::value
+        ? static_cast<type>(type(1) << (sizeof(type) * 8 - 1))
+        : type(0);
+    type key = static_cast<type>(static_cast<type>(value) ^ sign_bit);
+    return descending ? static_cast<type>(~key) : key;
+  }
+};
+
+template <typename scalar_t, typename bits_t>
+struct FloatingRadixKey {
+  using type = bits_t;
+
+  static type encode(scalar_t value, bool descending) {
+    constexpr type sign_bit = type(1) << (sizeof(type) * 8 - 1);
+    type key;
+    if (_isnan<scalar_t>(value)) {
+      // we want NaN to be sorted as top for numpy compatibility
+      key = std::numeric_limits<type>::max();
+    } else {
+      // -0.0 == 0.0, so both must produce the same key
+      if (value == 0) {
+        value = 0;
+      }
+      std::memcpy(&key, &value, sizeof(key));
+      key = (key & sign_bit) ? static_cast<type>(~key) : static_cast<type>(key | sign_bit);
+    }
+    return descending ? static_cast<type>(~key) : key;
+  }
+};
+
+template <>
+struct RadixKey<float> : FloatingRadixKey<float, uint32_t> {};
+
+template <>
+struct RadixKey<double> : FloatingRadixKey<double, uint64_t> {};
+
+// Stable LSD radix sort of (key, index) pairs on 8-bit digits. `tmp` must have
+// room for n elements; the result always ends up in `data`.
+template <typename key_t>
+void radix_sort(
+    std::pair<key_t, int64_t>* data,
+    std::pair<key_t, int64_t>* tmp,
+    int64_t n) {
+  constexpr int RADIX_BITS = 8;
+  constexpr int RADIX_SIZE = 1 << RADIX_BITS;
+  constexpr int NUM_PASSES = sizeof(key_t) * 8 / RADIX_BITS;
+  if (n < 2) {
+    return;
+  }
+
+  // Histograms for every digit are gathered in a single sweep.
+  std::array<int64_t, NUM_PASSES * RADIX_SIZE> counts;
+  counts.fill(0);
+  for (int64_t i = 0; i < n; i++) {
+    auto key = data[i].first;
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+      counts[pass * RADIX_SIZE + ((key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1))]++;
+    }
+  }
+
+  auto* src = data;
+  auto* dst = tmp;
+  for (int pass = 0; pass < NUM_PASSES; pass++) {
+    const int shift = pass * RADIX_BITS;
+    int64_t* offsets = counts.data() + pass * RADIX_SIZE;
+    // Every key shares this digit, so the pass would not move anything.
+    if (offsets[(src[0].first >> shift) & (RADIX_SIZE - 1)] == n) {
+      continue;
+    }
+    int64_t sum = 0;
+    for (int digit = 0; digit < RADIX_SIZE; digit++) {
+      auto count = offsets[digit];
+      offsets[digit] = sum;
+      sum += count;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      dst[offsets[(src[i].first >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != data) {
+    std::copy(src, src + n, data);
+  }
+}
+
+// Returns how many elements of `a` precede output position d when a[0, na)
+// and b[0, nb) are merged stably, i.e. with ties taken from `a` first.
+template <typename elem_t, typename Comp>
+int64_t merge_path_split(
+    const elem_t* a, int64_t na,
+    const elem_t* b, int64_t nb,
+    int64_t d, const Comp& comp) {
+  int64_t lo = std::max<int64_t>(0, d - nb);
+  int64_t hi = std::min(d, na);
+  while (lo < hi) {
+    int64_t i = lo + (hi - lo) / 2;
+    if (!comp(b[d - i - 1], a[i])) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// Sorts data[0, n) by sorting one run per thread with `sort_run` and then
+// merging runs pairwise. Each merge is split along its merge path so that
+// the final passes still use every thread. Stable if `sort_run` is.
+template <typename elem_t, typename Comp, typename SortRun>
+void parallel_merge_sort(
+    elem_t* data,
+    elem_t* tmp,
+    int64_t n,
+    const Comp& comp,
+    const SortRun& sort_run) {
+  const int64_t num_runs = std::min<int64_t>(
+      at::get_num_threads(), divup(n, internal::GRAIN_SIZE));
+  const int64_t run_size = divup(n, num_runs);
+  at::parallel_for(0, num_runs, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t run = begin; run < end; run++) {
+      int64_t lo = run * run_size;
+      int64_t hi = std::min(n, lo + run_size);
+      sort_run(data + lo, tmp + lo, hi - lo);
+    }
+  });
+
+  elem_t* src = data;
+  elem_t* dst = tmp;
+  for (int64_t width = run_size; width < n; width *= 2) {
+    at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t lo = begin - begin % (2 * width); lo < end; lo += 2 * width) {
+        int64_t mid = std::min(n, lo + width);
+        int64_t hi = std::min(n, lo + 2 * width);
+        int64_t d_begin = std::max(begin, lo) - lo;
+        int64_t d_end = std::min(end, hi) - lo;
+        const elem_t* a = src + lo;
+        const elem_t* b = src + mid;
+        int64_t i_begin = merge_path_split(a, mid - lo, b, hi - mid, d_begin, comp);
+        int64_t i_end = merge_path_split(a, mid - lo, b, hi - mid, d_end, comp);
+        std::merge(
+            a + i_begin, a + i_end,
+            b + (d_begin - i_begin), b + (d_end - i_end),
+            dst + lo + d_begin, comp);
+      }
+    });
+    std::swap(src, dst);
+  }
+  if (src != data) {
+    at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      std::copy(src + begin, src + end, data + begin);
+    });
+  }
+}
+
+// Sorts one strided slice at a time, keeping its scratch buffers alive so
+// that consecutive slices handled by the same thread do not reallocate.
+template <typename scalar_t>
+class SliceSorter {
+ public:
+  SliceSorter(bool descending, bool stable)
+      : descending_(descending), stable_(stable) {}
+
+  void operator()(
+      scalar_t* values, int64_t values_stride,
+      int64_t* indices, int64_t indices_stride,
+      int64_t n, bool parallel) {
+    vals_.resize(n);
+    if (n < RADIX_SORT_MIN_SIZE) {
+      for (int64_t i = 0; i < n; i++) {
+        vals_[i] = values[i * values_stride];
+      }
+      comparison_sort(n);
+      write_back(pairs_, 0, n, values, values_stride, indices, indices_stride);
+      return;
+    }
+
+    // radix sort is stable, so `stable_` needs no special handling here
+    keys_.resize(n);
+    keys_tmp_.resize(n);
+    auto encode = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        vals_[i] = values[i * values_stride];
+        keys_[i] = key_elem_t(RadixKey<scalar_t>::encode(vals_[i], descending_), i);
+      }
+    };
+    auto decode = [&](int64_t begin, int64_t end) {
+      write_back(keys_, begin, end, values, values_stride, indices, indices_stride);
+    };
+    if (parallel) {
+      at::parallel_for(0, n, internal::GRAIN_SIZE, encode);
+      parallel_merge_sort(
+          keys_.data(), keys_tmp_.data(), n,
+          [](const key_elem_t& x, const key_elem_t& y) -> bool {
+            return x.first < y.first;
+          },
+          [](key_elem_t* data, key_elem_t* tmp, int64_t size) {
+            radix_sort(data, tmp, size);
+          });
+      at::parallel_for(0, n, internal::GRAIN_SIZE, decode);
+    } else {
+      encode(0, n);
+      radix_sort(keys_.data(), keys_tmp_.data(), n);
+      decode(0, n);
+    }
+  }
+
+ private:
+  using key_elem_t = std::pair<typename RadixKey<scalar_t>::type, int64_t>;
+  using value_elem_t = std::pair<scalar_t, int64_t>;
+
+  void comparison_sort(int64_t n) {
+    pairs_.resize(n);
+    for (int64_t i = 0; i < n; i++) {
+      pairs_[i] = value_elem_t(vals_[i], i);
+    }
+    // we want NaN to be sorted as top for numpy compatibility
+    if (descending_) {
+      sort_pairs([](const value_elem_t& x, const value_elem_t& y) -> bool {
+        return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+      });
+    } else {
+      sort_pairs([](const value_elem_t& x, const value_elem_t& y) -> bool {
+        return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+      });
+    }
+  }
+
+  template <typename Comp>
+  void sort_pairs(const Comp& comp) {
+    if (stable_) {
+      std::stable_sort(pairs_.begin(), pairs_.end(), comp);
+    } else {
+      std::sort(pairs_.begin(), pairs_.end(), comp);
+    }
+  }
+
+  template <typename elem_t>
+  void write_back(
+      const std::vector<elem_t>& sorted, int64_t begin, int64_t end,
+      scalar_t* values, int64_t values_stride,
+      int64_t* indices, int64_t indices_stride) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t index = sorted[i].second;
+      values[i * values_stride] = vals_[index];
+      indices[i * indices_stride] = index;
+    }
+  }
+
+  bool descending_;
+  bool stable_;
+  std::vector<scalar_t> vals_;
+  std::vector<key_elem_t> keys_;
+  std::vector<key_elem_t> keys_tmp_;
+  std::vector<value_elem_t> pairs_;
+};
+
+// `values` holds a copy of the input and is sorted in place along `dim`.
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    int64_t dim,
+    bool descending,
+    bool stable) {
+  dim = maybe_wrap_dim(dim, values.dim());
+  if (values.numel() == 0) {
+    return;
+  }
+
+  // `dim` is traversed by the sorter, so it is restrided to size 1 / stride 0
+  // and TensorIterator only walks the slices.
+  auto slice_sizes = ensure_nonempty_vec(values.sizes().vec());
+  slice_sizes[dim] = 1;
+  auto values_restrided = restride_dim(values, dim, slice_sizes);
+  auto indices_restrided = restride_dim(indices, dim, slice_sizes);
+
+  auto iter = TensorIterator();
+  iter.dont_compute_common_dtype();
+  iter.dont_resize_outputs();
+  iter.add_output(values_restrided);
+  iter.add_output(indices_restrided);
+  iter.build();
+
+  auto dim_size = values.size(dim);
+  auto values_dim_stride = values.stride(dim);
+  auto indices_dim_stride = indices.stride(dim);
+  auto num_slices = iter.numel();
+  // Too few slices to occupy the thread pool: parallelize within each slice.
+  bool parallel_slice = dim_size >= PARALLEL_SORT_MIN_SIZE &&
+      num_slices < at::get_num_threads();
+
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "sort_cpu", [&] {
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      SliceSorter<scalar_t> sorter(descending, stable);
+      auto* values_data_bytes = data[0];
+      auto* indices_data_bytes = data[1];
+      for (int64_t i = 0; i < n; i++) {
+        sorter(
+            (scalar_t*)values_data_bytes, values_dim_stride,
+            (int64_t*)indices_data_bytes, indices_dim_stride,
+            dim_size, parallel_slice);
+        values_data_bytes += strides[0];
+        indices_data_bytes += strides[1];
+      }
+    };
+    if (parallel_slice) {
+      iter.serial_for_each(loop, {0, num_slices});
+    } else {
+      iter.for_each(loop, /*grain_size=*/std::max<int64_t>(1, internal::GRAIN_SIZE / dim_size));
+    }
+  });
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -85,6 +424,7 @@ static void topk_kernel(
 
 } // anonymous namespace
 
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
 
 }} //at::native
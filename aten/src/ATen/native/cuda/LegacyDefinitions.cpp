@@ -69,4 +69,10 @@ Tensor gather_cuda(const Tensor & self, int64_t dim, const Tensor & index, bool
   return gather_out_cuda(result, self, dim, index, sparse_grad);
 }
 
+std::tuple<Tensor, Tensor> sort_stable_cuda(const Tensor & self, c10::optional<bool> stable, int64_t dim, bool descending) {
+  // The bitonic sort THC uses for short slices does not preserve the order of equal elements.
+  TORCH_CHECK(!stable.value_or(false), "stable=True is not supported by sort on CUDA yet");
+  return legacy::cuda::_th_sort(self, dim, descending);
+}
+
 }} // namespace at::native
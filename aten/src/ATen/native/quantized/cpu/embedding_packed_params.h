@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <cstring>
+
+namespace at {
+namespace native {
+
+// Row-wise quantized embedding tables are plain uint8 tensors of shape
+// [num_embeddings, packed_dim] in which every row carries its own
+// quantization parameters after the quantized values:
+//
+// - 8-bit: embedding_dim uint8 values, then float scale and float bias
+//   (the layout of caffe2's Fused8BitRowwiseQuantized ops);
+// - 4-bit: embedding_dim / 2 bytes holding two values each, the even
+//   element in the low nibble, then at::Half scale and at::Half bias;
+//   embedding_dim has to be even.
+//
+// A value q dequantizes to scale * q + bias.
+constexpr int64_t kEmbeddingByteRowPadding = 2 * sizeof(float);
+constexpr int64_t kEmbedding4BitRowPadding = 2 * sizeof(at::Half);
+
+inline float embedding_4bit_scale_or_bias(const uint8_t* row_params, int i) {
+  at::Half value;
+  std::memcpy(&value, row_params + i * sizeof(at::Half), sizeof(at::Half));
+  return value;
+}
+
+} // namespace native
+} // namespace at
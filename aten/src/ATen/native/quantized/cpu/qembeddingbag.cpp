@@ -0,0 +1,252 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/embedding_packed_params.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+const int64_t MODE_SUM = 0;
+const int64_t MODE_MEAN = 1;
+
+// Checks the arguments shared by the 8-bit and 4-bit ops and returns the
+// offsets as int64 with num_bags + 1 entries, the last one being the total
+// number of indices.
+std::vector<int64_t> prepare_embedding_bag(
+    const char* op_name,
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == at::kByte,
+      op_name, " expects a 2D uint8 weight created by its prepack op");
+  TORCH_CHECK(
+      indices.scalar_type() == at::kInt || indices.scalar_type() == at::kLong,
+      op_name, " expects int32 or int64 indices, got ", indices.scalar_type());
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN,
+      op_name, " only supports sum (0) and mean (1) modes, got ", mode);
+  if (per_sample_weights.has_value()) {
+    TORCH_CHECK(
+        mode == MODE_SUM,
+        op_name, ": per_sample_weights are only supported for mode='sum'");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == at::kFloat,
+        op_name, " expects float per_sample_weights, got ",
+        per_sample_weights->scalar_type());
+    TORCH_CHECK(
+        per_sample_weights->numel() == indices.numel(),
+        op_name, " expects per_sample_weights to have as many elements as ",
+        "indices, got ", per_sample_weights->numel(), " and ", indices.numel());
+  }
+
+  std::vector<int64_t> offsets;
+  if (offsets_in.has_value()) {
+    TORCH_CHECK(
+        indices.dim() == 1,
+        op_name, " expects 1D indices when offsets are given, got ",
+        indices.dim(), "D");
+    TORCH_CHECK(offsets_in->dim() == 1, op_name, " expects 1D offsets");
+    auto offsets_long = offsets_in->to(at::kLong).contiguous();
+    const int64_t* offsets_data = offsets_long.data_ptr<int64_t>();
+    offsets.assign(offsets_data, offsets_data + offsets_long.numel());
+    if (!include_last_offset) {
+      offsets.push_back(indices.numel());
+    }
+    TORCH_CHECK(
+        offsets.size() >= 1 && offsets.front() == 0,
+        op_name, ": offsets have to start at 0");
+    TORCH_CHECK(
+        offsets.back() == indices.numel(),
+        op_name, ": the last offset has to equal the number of indices");
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      TORCH_CHECK(
+          offsets[i - 1] <= offsets[i],
+          op_name, ": offsets have to be non-decreasing");
+    }
+  } else {
+    // Fixed-length bags given as a 2D [num_bags, bag_size] tensor.
+    TORCH_CHECK(
+        indices.dim() == 2,
+        op_name, " expects 2D indices when offsets are not given, got ",
+        indices.dim(), "D");
+    const int64_t num_bags = indices.size(0);
+    const int64_t bag_size = indices.size(1);
+    offsets.resize(num_bags + 1);
+    for (int64_t i = 0; i <= num_bags; ++i) {
+      offsets[i] = i * bag_size;
+    }
+  }
+  return offsets;
+}
+
+template <typename IndexType>
+void embedding_bag_byte_impl(
+    Tensor& output,
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& offsets,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths) {
+  const int64_t num_bags = offsets.size() - 1;
+  const int64_t embedding_dim = packed_weight.size(1) - kEmbeddingByteRowPadding;
+  const uint8_t* weight_data = packed_weight.data_ptr<uint8_t>();
+  const IndexType* indices_data = indices.data_ptr<IndexType>();
+  float* output_data = output.data_ptr<float>();
+  const int64_t* offsets_data = offsets.data();
+
+  at::parallel_for(0, num_bags, 1, [&](int64_t start_idx, int64_t end_idx) {
+    // Throws if an index is out of range.
+    caffe2::Fused8BitRowwiseEmbeddingLookupIdx<
+        IndexType, uint8_t, float>(
+        /*block_size=*/embedding_dim,
+        /*output_size=*/end_idx - start_idx,
+        /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+        /*data_size=*/packed_weight.size(0),
+        /*input=*/weight_data,
+        /*indices=*/indices_data + offsets_data[start_idx],
+        /*offsets=*/offsets_data + start_idx,
+        /*weights=*/per_sample_weights_data
+            ? per_sample_weights_data + offsets_data[start_idx]
+            : nullptr,
+        /*normalize_by_lengths=*/normalize_by_lengths,
+        /*out=*/output_data + start_idx * embedding_dim);
+  });
+}
+
+template <typename IndexType>
+void embedding_bag_4bit_impl(
+    Tensor& output,
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& offsets,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths) {
+  const int64_t num_bags = offsets.size() - 1;
+  const int64_t num_embeddings = packed_weight.size(0);
+  const int64_t packed_dim = packed_weight.size(1);
+  const int64_t embedding_dim = (packed_dim - kEmbedding4BitRowPadding) * 2;
+  const uint8_t* weight_data = packed_weight.data_ptr<uint8_t>();
+  const IndexType* indices_data = indices.data_ptr<IndexType>();
+  float* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, num_bags, 1, [&](int64_t start_idx, int64_t end_idx) {
+    for (int64_t bag = start_idx; bag < end_idx; ++bag) {
+      float* out = output_data + bag * embedding_dim;
+      std::fill(out, out + embedding_dim, 0.f);
+      for (int64_t i = offsets[bag]; i < offsets[bag + 1]; ++i) {
+        const int64_t idx = indices_data[i];
+        TORCH_CHECK(
+            idx >= 0 && idx < num_embeddings,
+            "quantized::embedding_bag_4bit: index ", idx,
+            " out of range [0, ", num_embeddings, ")");
+#ifdef __GNUC__
+        if (i + 1 < offsets[bag + 1]) {
+          // Rows are scattered, so help the hardware prefetcher.
+          __builtin_prefetch(weight_data + indices_data[i + 1] * packed_dim, 0, 1);
+        }
+#endif // __GNUC__
+        const uint8_t* row = weight_data + idx * packed_dim;
+        const uint8_t* row_params = row + embedding_dim / 2;
+        float weight = per_sample_weights_data ? per_sample_weights_data[i] : 1.f;
+        const float scale = weight * embedding_4bit_scale_or_bias(row_params, 0);
+        const float bias = weight * embedding_4bit_scale_or_bias(row_params, 1);
+        for (int64_t j = 0; j < embedding_dim / 2; ++j) {
+          out[2 * j] += scale * (row[j] & 0xF) + bias;
+          out[2 * j + 1] += scale * (row[j] >> 4) + bias;
+        }
+      }
+      const int64_t length = offsets[bag + 1] - offsets[bag];
+      if (normalize_by_lengths && length > 0) {
+        const float inverse_length = 1.f / length;
+        for (int64_t j = 0; j < embedding_dim; ++j) {
+          out[j] *= inverse_length;
+        }
+      }
+    }
+  });
+}
+
+template <bool is_4bit>
+Tensor qembeddingbag(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    bool /* scale_grad_by_freq */,
+    int64_t mode,
+    bool /* sparse */,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  const char* op_name = is_4bit ? "quantized::embedding_bag_4bit"
+                                : "quantized::embedding_bag_byte";
+  const auto offsets = prepare_embedding_bag(
+      op_name,
+      packed_weight,
+      indices,
+      offsets_in,
+      mode,
+      per_sample_weights,
+      include_last_offset);
+  const int64_t row_padding =
+      is_4bit ? kEmbedding4BitRowPadding : kEmbeddingByteRowPadding;
+  TORCH_CHECK(
+      packed_weight.size(1) >= row_padding,
+      op_name, ": weight rows are too short to hold scale and bias");
+  const int64_t embedding_dim = is_4bit
+      ? (packed_weight.size(1) - row_padding) * 2
+      : packed_weight.size(1) - row_padding;
+
+  const auto weight_contig = packed_weight.contiguous();
+  const auto indices_contig = indices.contiguous();
+  Tensor per_sample_weights_contig;
+  const float* per_sample_weights_data = nullptr;
+  if (per_sample_weights.has_value()) {
+    per_sample_weights_contig = per_sample_weights->contiguous();
+    per_sample_weights_data = per_sample_weights_contig.data_ptr<float>();
+  }
+  auto output = at::empty(
+      {static_cast<int64_t>(offsets.size()) - 1, embedding_dim},
+      packed_weight.options().dtype(at::kFloat));
+
+  const bool normalize_by_lengths = mode == MODE_MEAN;
+  if (indices.scalar_type() == at::kInt) {
+    if (is_4bit) {
+      embedding_bag_4bit_impl<int32_t>(
+          output, weight_contig, indices_contig, offsets,
+          per_sample_weights_data, normalize_by_lengths);
+    } else {
+      embedding_bag_byte_impl<int32_t>(
+          output, weight_contig, indices_contig, offsets,
+          per_sample_weights_data, normalize_by_lengths);
+    }
+  } else {
+    if (is_4bit) {
+      embedding_bag_4bit_impl<int64_t>(
+          output, weight_contig, indices_contig, offsets,
+          per_sample_weights_data, normalize_by_lengths);
+    } else {
+      embedding_bag_byte_impl<int64_t>(
+          output, weight_contig, indices_contig, offsets,
+          per_sample_weights_data, normalize_by_lengths);
+    }
+  }
+  return output;
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte", qembeddingbag</*is_4bit=*/false>);
+  m.impl("embedding_bag_4bit", qembeddingbag</*is_4bit=*/true>);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
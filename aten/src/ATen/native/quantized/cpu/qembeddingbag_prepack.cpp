@@ -0,0 +1,104 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/embedding_packed_params.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace at {
+namespace native {
+namespace {
+
+Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_byte_prepack expects a 2D weight, got ",
+      weight.dim(),
+      "D");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kFloat,
+      "quantized::embedding_bag_byte_prepack expects a float weight, got ",
+      weight.scalar_type());
+  const auto weight_contig = weight.contiguous();
+  const int64_t num_embeddings = weight.size(0);
+  const int64_t embedding_dim = weight.size(1);
+  auto output = at::empty(
+      {num_embeddings, embedding_dim + kEmbeddingByteRowPadding},
+      weight.options().dtype(at::kByte));
+  const float* weight_data = weight_contig.data_ptr<float>();
+  uint8_t* output_data = output.data_ptr<uint8_t>();
+  at::parallel_for(
+      0, num_embeddings, 1, [&](int64_t start_idx, int64_t end_idx) {
+        caffe2::FloatToFused8BitRowwiseQuantized(
+            weight_data + start_idx * embedding_dim,
+            end_idx - start_idx,
+            embedding_dim,
+            output_data + start_idx * output.size(1));
+      });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_4bit_prepack expects a 2D weight, got ",
+      weight.dim(),
+      "D");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kFloat,
+      "quantized::embedding_bag_4bit_prepack expects a float weight, got ",
+      weight.scalar_type());
+  TORCH_CHECK(
+      weight.size(1) % 2 == 0,
+      "quantized::embedding_bag_4bit_prepack expects an even embedding_dim, got ",
+      weight.size(1));
+  const auto weight_contig = weight.contiguous();
+  const int64_t num_embeddings = weight.size(0);
+  const int64_t embedding_dim = weight.size(1);
+  const int64_t packed_dim = embedding_dim / 2 + kEmbedding4BitRowPadding;
+  auto output = at::empty(
+      {num_embeddings, packed_dim}, weight.options().dtype(at::kByte));
+  const float* weight_data = weight_contig.data_ptr<float>();
+  uint8_t* output_data = output.data_ptr<uint8_t>();
+  at::parallel_for(
+      0, num_embeddings, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const float* input_row = weight_data + row * embedding_dim;
+          uint8_t* output_row = output_data + row * packed_dim;
+          const auto minmax =
+              std::minmax_element(input_row, input_row + embedding_dim);
+          float min = embedding_dim > 0 ? *minmax.first : 0.f;
+          float max = embedding_dim > 0 ? *minmax.second : 0.f;
+          // Round the parameters to half first, so that quantization uses
+          // exactly the values the kernels will see.
+          at::Half scale = (max - min) < 1e-8f ? 1.0f : (max - min) / 15.0f;
+          at::Half bias = min;
+          const float inverse_scale = 1.0f / static_cast<float>(scale);
+          std::fill(output_row, output_row + embedding_dim / 2, 0);
+          for (int64_t col = 0; col < embedding_dim; ++col) {
+            float q = std::nearbyint(
+                (input_row[col] - static_cast<float>(bias)) * inverse_scale);
+            uint8_t quantized = static_cast<uint8_t>(
+                std::max(0.0f, std::min(q, 15.0f)));
+            output_row[col / 2] |= quantized << ((col % 2) * 4);
+          }
+          uint8_t* row_params = output_row + embedding_dim / 2;
+          std::memcpy(row_params, &scale, sizeof(at::Half));
+          std::memcpy(row_params + sizeof(at::Half), &bias, sizeof(at::Half));
+        }
+      });
+  return output;
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
+  m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,79 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/embedding_packed_params.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+
+namespace at {
+namespace native {
+namespace {
+
+Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == at::kByte,
+      "quantized::embedding_bag_byte_unpack expects a 2D uint8 tensor");
+  TORCH_CHECK(
+      packed_weight.size(1) >= kEmbeddingByteRowPadding,
+      "quantized::embedding_bag_byte_unpack: rows are too short to hold ",
+      "scale and bias");
+  const auto packed_contig = packed_weight.contiguous();
+  const int64_t num_embeddings = packed_weight.size(0);
+  const int64_t packed_dim = packed_weight.size(1);
+  const int64_t embedding_dim = packed_dim - kEmbeddingByteRowPadding;
+  auto output = at::empty(
+      {num_embeddings, embedding_dim}, packed_weight.options().dtype(at::kFloat));
+  const uint8_t* input_data = packed_contig.data_ptr<uint8_t>();
+  float* output_data = output.data_ptr<float>();
+  at::parallel_for(
+      0, num_embeddings, 1, [&](int64_t start_idx, int64_t end_idx) {
+        caffe2::Fused8BitRowwiseQuantizedToFloat(
+            input_data + start_idx * packed_dim,
+            end_idx - start_idx,
+            packed_dim,
+            output_data + start_idx * embedding_dim);
+      });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == at::kByte,
+      "quantized::embedding_bag_4bit_unpack expects a 2D uint8 tensor");
+  TORCH_CHECK(
+      packed_weight.size(1) >= kEmbedding4BitRowPadding,
+      "quantized::embedding_bag_4bit_unpack: rows are too short to hold ",
+      "scale and bias");
+  const auto packed_contig = packed_weight.contiguous();
+  const int64_t num_embeddings = packed_weight.size(0);
+  const int64_t packed_dim = packed_weight.size(1);
+  const int64_t embedding_dim = (packed_dim - kEmbedding4BitRowPadding) * 2;
+  auto output = at::empty(
+      {num_embeddings, embedding_dim}, packed_weight.options().dtype(at::kFloat));
+  const uint8_t* input_data = packed_contig.data_ptr<uint8_t>();
+  float* output_data = output.data_ptr<float>();
+  at::parallel_for(
+      0, num_embeddings, 1, [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const uint8_t* input_row = input_data + row * packed_dim;
+          const uint8_t* row_params = input_row + embedding_dim / 2;
+          const float scale = embedding_4bit_scale_or_bias(row_params, 0);
+          const float bias = embedding_4bit_scale_or_bias(row_params, 1);
+          float* output_row = output_data + row * embedding_dim;
+          for (int64_t col = 0; col < embedding_dim; ++col) {
+            uint8_t quantized = (input_row[col / 2] >> ((col % 2) * 4)) & 0xF;
+            output_row[col] = scale * quantized + bias;
+          }
+        }
+      });
+  return output;
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_unpack", qembeddingbag_byte_unpack);
+  m.impl("embedding_bag_4bit_unpack", qembeddingbag_4bit_unpack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
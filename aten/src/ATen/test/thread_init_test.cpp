@@ -1,8 +1,37 @@
 #include <ATen/ATen.h>
 #include <ATen/Parallel.h>
 #include <test/cpp/jit/test_base.h>
+#include <atomic>
 #include <thread>
 
+#if AT_PARALLEL_NATIVE && defined(__linux__)
+#include <sched.h>
+#endif
+
+
+#if AT_PARALLEL_NATIVE && defined(__linux__)
+// Checks that the workers of the intra-op pool are each pinned to one CPU.
+void test_pinned() {
+  auto caller = std::this_thread::get_id();
+  std::atomic<int> num_workers{0};
+  std::atomic<int> num_unpinned{0};
+  at::parallel_for(0, 64, 1, [&](int64_t begin, int64_t end) {
+    if (std::this_thread::get_id() == caller) {
+      return;
+    }
+    ++num_workers;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0 ||
+        CPU_COUNT(&mask) != 1) {
+      ++num_unpinned;
+    }
+  });
+  // The calling thread only runs the first chunk.
+  ASSERT_TRUE(num_workers.load() > 0);
+  ASSERT_EQ(num_unpinned.load(), 0);
+}
+#endif
 
 // This checks whether threads can see the global
 // numbers of threads set and also whether the scheduler
@@ -21,6 +50,10 @@ void test(int given_num_threads) {
 int main() {
   at::init_num_threads();
 
+  // NUMA placement falls back to pinning to cores on single-node machines
+  at::set_intraop_affinity(at::IntraOpAffinity::NUMA);
+  ASSERT_TRUE(at::get_intraop_affinity() == at::IntraOpAffinity::NUMA);
+
   at::set_num_threads(4);
   test(4);
   std::thread t1([](){
@@ -29,6 +62,15 @@ int main() {
   });
   t1.join();
 
+  #if AT_PARALLEL_NATIVE
+  // The pool exists now, so its placement can no longer change.
+  ASSERT_ANY_THROW(at::set_intraop_affinity(at::IntraOpAffinity::NONE));
+  at::set_intraop_affinity(at::IntraOpAffinity::NUMA);
+  #ifdef __linux__
+  test_pinned();
+  #endif
+  #endif
+
   #if !AT_PARALLEL_NATIVE
   at::set_num_threads(5);
   ASSERT_TRUE(at::get_num_threads() == 5);
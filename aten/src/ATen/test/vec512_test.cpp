@@ -0,0 +1,347 @@
+#include <gtest/gtest.h>
+
+// Only built when the compiler supports AVX512, with the flags and the
+// CPU_CAPABILITY the AVX512 kernels are compiled with (see
+// caffe2/CMakeLists.txt). The tests return early on CPUs without AVX512.
+#include <ATen/cpu/vec512/vec512.h>
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace at::vec256;
+
+namespace {
+
+bool cpu_has_avx512() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512vl");
+}
+
+#define SKIP_WITHOUT_AVX512() \
+  if (!cpu_has_avx512()) {    \
+    return;                   \
+  }
+
+template <typename T>
+bool all_ones(T value) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  for (unsigned char byte : bytes) {
+    if (byte != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool all_zeros(T value) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  for (unsigned char byte : bytes) {
+    if (byte != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+T lane_mask(bool set) {
+  T value;
+  std::memset(&value, set ? 0xFF : 0, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void test_masked_load_store() {
+  using Vec = Vec512<T>;
+  constexpr int n = Vec::size();
+  __at_align64__ T src[n];
+  for (int i = 0; i < n; ++i) {
+    src[i] = static_cast<T>(i + 1);
+  }
+
+  // The lanes past `count` of a partial load are zero, and a partial store
+  // leaves the memory past `count` alone.
+  for (int count = 0; count <= n; ++count) {
+    __at_align64__ T out[n];
+    Vec::loadu(src, count).store(out);
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(out[i], i < count ? src[i] : static_cast<T>(0))
+          << "count " << count << ", lane " << i;
+    }
+
+    __at_align64__ T dst[n];
+    for (int i = 0; i < n; ++i) {
+      dst[i] = static_cast<T>(-1);
+    }
+    Vec(static_cast<T>(42)).store(dst, count);
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(dst[i], static_cast<T>(i < count ? 42 : -1))
+          << "count " << count << ", lane " << i;
+    }
+  }
+
+  // Nor does either touch the memory past `count`: here it is not mapped.
+  const size_t page = sysconf(_SC_PAGESIZE);
+  void* pages = mmap(
+      nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+      -1, 0);
+  ASSERT_NE(pages, MAP_FAILED);
+  ASSERT_EQ(mprotect(static_cast<char*>(pages) + page, page, PROT_NONE), 0);
+  for (int count = 0; count < n; ++count) {
+    T* tail = reinterpret_cast<T*>(static_cast<char*>(pages) + page) - count;
+    for (int i = 0; i < count; ++i) {
+      tail[i] = src[i];
+    }
+    auto v = Vec::loadu(tail, count);
+    (v + v).store(tail, count);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(tail[i], static_cast<T>(2 * src[i]));
+    }
+  }
+  munmap(pages, 2 * page);
+}
+
+template <typename T>
+void test_blend() {
+  using Vec = Vec512<T>;
+  constexpr int n = Vec::size();
+  constexpr int64_t mask = 0xA5C3A5C3;
+  __at_align64__ T a_vals[n];
+  __at_align64__ T b_vals[n];
+  __at_align64__ T mask_vals[n];
+  for (int i = 0; i < n; ++i) {
+    a_vals[i] = static_cast<T>(i);
+    b_vals[i] = static_cast<T>(100 + i);
+    mask_vals[i] = lane_mask<T>(i % 3 == 0);
+  }
+  auto a = Vec::loadu(a_vals, n);
+  auto b = Vec::loadu(b_vals, n);
+
+  __at_align64__ T out[n];
+  Vec::template blend<mask>(a, b).store(out);
+  for (int i = 0; i < n; ++i) {
+    ASSERT_EQ(out[i], (mask >> i) & 1 ? b_vals[i] : a_vals[i]) << "lane " << i;
+  }
+
+  // blendv selects on the most significant bit of each lane of the mask.
+  Vec::blendv(a, b, Vec::loadu(mask_vals, n)).store(out);
+  for (int i = 0; i < n; ++i) {
+    ASSERT_EQ(out[i], i % 3 == 0 ? b_vals[i] : a_vals[i]) << "lane " << i;
+  }
+
+  // set takes the first `count` lanes from b.
+  for (int count = 0; count <= n; ++count) {
+    Vec::set(a, b, count).store(out);
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(out[i], i < count ? b_vals[i] : a_vals[i])
+          << "count " << count << ", lane " << i;
+    }
+  }
+}
+
+// Comparisons give all-ones or all-zeros lanes, like Vec256. As with the
+// _CMP_*_OQ predicates Vec256 uses, any comparison with a NaN is false,
+// including !=.
+template <typename T>
+void test_comparisons(const T* a_vals, const T* b_vals) {
+  using Vec = Vec512<T>;
+  constexpr int n = Vec::size();
+  auto a = Vec::loadu(a_vals, n);
+  auto b = Vec::loadu(b_vals, n);
+
+  auto check = [&](const Vec& result, const char* name, auto expected) {
+    __at_align64__ T out[n];
+    result.store(out);
+    for (int i = 0; i < n; ++i) {
+      if (expected(a_vals[i], b_vals[i])) {
+        ASSERT_TRUE(all_ones(out[i])) << name << ", lane " << i;
+      } else {
+        ASSERT_TRUE(all_zeros(out[i])) << name << ", lane " << i;
+      }
+    }
+  };
+  auto ordered = [](T x, T y) {
+    return !std::isnan(static_cast<double>(x)) &&
+        !std::isnan(static_cast<double>(y));
+  };
+  check(a == b, "==", [](T x, T y) { return x == y; });
+  check(a != b, "!=", [&](T x, T y) { return ordered(x, y) && x != y; });
+  check(a < b, "<", [](T x, T y) { return x < y; });
+  check(a <= b, "<=", [](T x, T y) { return x <= y; });
+  check(a > b, ">", [](T x, T y) { return x > y; });
+  check(a >= b, ">=", [](T x, T y) { return x >= y; });
+
+  // eq() and friends give 1 or 0 instead.
+  __at_align64__ T out[n];
+  a.lt(b).store(out);
+  for (int i = 0; i < n; ++i) {
+    ASSERT_EQ(out[i], static_cast<T>(a_vals[i] < b_vals[i] ? 1 : 0))
+        << "lt, lane " << i;
+  }
+}
+
+template <typename T>
+void test_float_comparisons() {
+  constexpr int n = Vec512<T>::size();
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  const T inf = std::numeric_limits<T>::infinity();
+  const T values[] = {-inf, -1, -0.0, 0, 0.5, 1, inf, nan};
+  __at_align64__ T a_vals[n];
+  __at_align64__ T b_vals[n];
+  for (int i = 0; i < n; ++i) {
+    a_vals[i] = values[i % 8];
+    b_vals[i] = values[(i * 3 + i / 8) % 8];
+  }
+  test_comparisons(a_vals, b_vals);
+}
+
+template <typename T>
+void test_int_comparisons() {
+  constexpr int n = Vec512<T>::size();
+  const T values[] = {std::numeric_limits<T>::min(), -7, -1, 0, 1, 7,
+                      std::numeric_limits<T>::max()};
+  __at_align64__ T a_vals[n];
+  __at_align64__ T b_vals[n];
+  for (int i = 0; i < n; ++i) {
+    a_vals[i] = values[i % 7];
+    b_vals[i] = values[(i * 3 + i / 7) % 7];
+  }
+  test_comparisons(a_vals, b_vals);
+}
+
+// maximum and minimum propagate NaN from either operand, unlike the
+// max/min instructions, which return the second operand.
+template <typename T>
+void test_nan_minimum_maximum() {
+  using Vec = Vec512<T>;
+  constexpr int n = Vec::size();
+  const T nan = std::numeric_limits<T>::quiet_NaN();
+  __at_align64__ T a_vals[n];
+  __at_align64__ T b_vals[n];
+  for (int i = 0; i < n; ++i) {
+    a_vals[i] = i % 4 == 1 ? nan : static_cast<T>(i);
+    b_vals[i] = i % 4 == 2 ? nan : static_cast<T>(n - i);
+  }
+  if (n > 3) {
+    a_vals[3] = b_vals[3] = nan;
+  }
+  auto a = Vec::loadu(a_vals, n);
+  auto b = Vec::loadu(b_vals, n);
+
+  __at_align64__ T max_out[n];
+  __at_align64__ T min_out[n];
+  maximum(a, b).store(max_out);
+  minimum(a, b).store(min_out);
+  for (int i = 0; i < n; ++i) {
+    if (std::isnan(a_vals[i]) || std::isnan(b_vals[i])) {
+      ASSERT_TRUE(std::isnan(max_out[i])) << "lane " << i;
+      ASSERT_TRUE(std::isnan(min_out[i])) << "lane " << i;
+    } else {
+      ASSERT_EQ(max_out[i], std::max(a_vals[i], b_vals[i])) << "lane " << i;
+      ASSERT_EQ(min_out[i], std::min(a_vals[i], b_vals[i])) << "lane " << i;
+    }
+  }
+}
+
+template <typename T>
+void test_int_ops() {
+  using Vec = Vec512<T>;
+  constexpr int n = Vec::size();
+  __at_align64__ T a_vals[n];
+  __at_align64__ T b_vals[n];
+  for (int i = 0; i < n; ++i) {
+    a_vals[i] = static_cast<T>((i % 2 ? -1 : 1) * (i * 37 + 5));
+    b_vals[i] = static_cast<T>((i % 3 ? 1 : -1) * (i % 11 + 1));
+  }
+  auto a = Vec::loadu(a_vals, n);
+  auto b = Vec::loadu(b_vals, n);
+  const T lo = -50;
+  const T hi = 60;
+
+  auto check = [&](const Vec& result, const char* name, auto expected) {
+    __at_align64__ T out[n];
+    result.store(out);
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(out[i], static_cast<T>(expected(a_vals[i], b_vals[i])))
+          << name << ", lane " << i;
+    }
+  };
+  check(a + b, "+", [](T x, T y) { return x + y; });
+  check(a - b, "-", [](T x, T y) { return x - y; });
+  check(a * b, "*", [](T x, T y) { return x * y; });
+  check(a / b, "/", [](T x, T y) { return x / y; });
+  check(a & b, "&", [](T x, T y) { return x & y; });
+  check(a | b, "|", [](T x, T y) { return x | y; });
+  check(a ^ b, "^", [](T x, T y) { return x ^ y; });
+  check(maximum(a, b), "maximum", [](T x, T y) { return std::max(x, y); });
+  check(minimum(a, b), "minimum", [](T x, T y) { return std::min(x, y); });
+  check(clamp(a, Vec(lo), Vec(hi)), "clamp", [&](T x, T) {
+    return std::min(hi, std::max(lo, x));
+  });
+  check(clamp_min(a, Vec(lo)), "clamp_min", [&](T x, T) {
+    return std::max(lo, x);
+  });
+  check(clamp_max(a, Vec(hi)), "clamp_max", [&](T x, T) {
+    return std::min(hi, x);
+  });
+  check(a.abs(), "abs", [](T x, T) { return x < 0 ? -x : x; });
+  check(a.neg(), "neg", [](T x, T) { return -x; });
+  check(fmadd(a, b, a), "fmadd", [](T x, T y) { return x * y + x; });
+}
+
+} // namespace
+
+TEST(Vec512Test, MaskedLoadStore) {
+  SKIP_WITHOUT_AVX512();
+  test_masked_load_store<float>();
+  test_masked_load_store<double>();
+  test_masked_load_store<int64_t>();
+  test_masked_load_store<int32_t>();
+  test_masked_load_store<int16_t>();
+}
+
+TEST(Vec512Test, Blend) {
+  SKIP_WITHOUT_AVX512();
+  test_blend<float>();
+  test_blend<double>();
+  test_blend<int64_t>();
+  test_blend<int32_t>();
+  test_blend<int16_t>();
+}
+
+TEST(Vec512Test, Comparisons) {
+  SKIP_WITHOUT_AVX512();
+  test_float_comparisons<float>();
+  test_float_comparisons<double>();
+  test_int_comparisons<int64_t>();
+  test_int_comparisons<int32_t>();
+  test_int_comparisons<int16_t>();
+}
+
+TEST(Vec512Test, NaNPropagatingMinimumMaximum) {
+  SKIP_WITHOUT_AVX512();
+  test_nan_minimum_maximum<float>();
+  test_nan_minimum_maximum<double>();
+}
+
+TEST(Vec512Test, Integer) {
+  SKIP_WITHOUT_AVX512();
+  test_int_ops<int64_t>();
+  test_int_ops<int32_t>();
+  test_int_ops<int16_t>();
+}
+
+#endif
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+#
+# Measure allreduce latency and bandwidth of ProcessGroupGloo.
+#
+# This program compares the flat allreduce with the hierarchical one, which
+# reduces within every host before allreducing across hosts, over a range
+# of tensor sizes.
+#
+
+import argparse
+import json
+import os
+import socket
+import time
+
+import numpy as np
+import torch
+import torch.distributed as dist
+
+
+def create_process_group(store, rank, world_size, args, hierarchical):
+    prefix = "hierarchical" if hierarchical else "flat"
+    opts = dist.ProcessGroupGloo.Options()
+    if args.interface:
+        device = dist.ProcessGroupGloo.create_device(interface=args.interface)
+    else:
+        device = dist.ProcessGroupGloo.create_device(hostname=socket.gethostname())
+    opts.devices = [device]
+    opts.timeout = 60.0
+    opts.threads = 2
+    opts.hierarchical_allreduce = hierarchical
+    if args.processes_per_host:
+        # Group the ranks as if every block of processes ran on its own host,
+        # to try out the hierarchy on a single machine.
+        opts.hostname = "host%d" % (rank // args.processes_per_host)
+    else:
+        opts.hostname = socket.gethostname()
+    return dist.ProcessGroupGloo(
+        dist.PrefixStore(prefix, store), rank, world_size, opts)
+
+
+def benchmark_allreduce(pg, numel, iterations):
+    tensor = torch.ones(numel, dtype=torch.float)
+    warmup_iterations = 5
+    measurements = []
+    for i in range(warmup_iterations + iterations):
+        start = time.time()
+        pg.allreduce([tensor]).wait()
+        measurements.append(time.time() - start)
+
+    # Throw away measurements for warmup iterations
+    return measurements[warmup_iterations:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Gloo allreduce benchmark')
+    parser.add_argument("--rank", type=int, default=os.environ.get("RANK"))
+    parser.add_argument("--world-size", type=int, required=True)
+    parser.add_argument("--master-addr", type=str, required=True)
+    parser.add_argument("--master-port", type=int, required=True)
+    parser.add_argument("--interface", type=str, default="",
+                        help="Network interface to use (default: hostname)")
+    parser.add_argument("--processes-per-host", type=int, default=0,
+                        help="Group ranks into hosts of this size instead of using the hostname")
+    parser.add_argument("--min-size", type=int, default=1 << 10, help="Smallest tensor size in bytes")
+    parser.add_argument("--max-size", type=int, default=1 << 28, help="Largest tensor size in bytes")
+    parser.add_argument("--iterations", type=int, default=20)
+    parser.add_argument("--json", type=str, metavar="PATH", help="Write file with benchmark results")
+    args = parser.parse_args()
+
+    store = dist.TCPStore(
+        args.master_addr, args.master_port, args.world_size, args.rank == 0)
+    flat = create_process_group(store, args.rank, args.world_size, args, False)
+    hierarchical = create_process_group(store, args.rank, args.world_size, args, True)
+
+    if args.rank == 0:
+        print("%12s  %24s  %24s" % ("", "flat", "hierarchical"))
+        print("%12s  %12s%12s  %12s%12s" % ("bytes", "p50 (us)", "GB/s", "p50 (us)", "GB/s"))
+
+    results = []
+    size = args.min_size
+    while size <= args.max_size:
+        numel = size // 4
+        row = {"bytes": size}
+        line = "%12d" % size
+        for name, pg in [("flat", flat), ("hierarchical", hierarchical)]:
+            measurements = benchmark_allreduce(pg, numel, args.iterations)
+            p50 = np.percentile(measurements, 50)
+            # Algorithm bandwidth: the bytes of the tensor over the time it
+            # takes to allreduce them.
+            bandwidth = size / p50 / 1e9
+            row[name] = measurements
+            line += "  %12.1f%12.3f" % (p50 * 1e6, bandwidth)
+        results.append(row)
+        if args.rank == 0:
+            print(line, flush=True)
+        size *= 2
+
+    if args.rank == 0 and args.json:
+        report = {
+            "pytorch_version": torch.__version__,
+            "world_size": args.world_size,
+            "results": results,
+        }
+        with open(args.json, 'w') as f:
+            json.dump(report, f)
+
+
+if __name__ == '__main__':
+    main()
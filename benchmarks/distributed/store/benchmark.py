@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# Measure how TCPStore copes with rendezvous traffic from many clients.
+#
+# This program connects thousands of local clients to a single TCPStore,
+# from a few processes with many threads each, and times the storms of
+# requests they send at rendezvous: connecting, a barrier, and exchanging
+# keys with a peer set, one get at a time and with a single multi_get.
+#
+
+import argparse
+import json
+import multiprocessing
+import threading
+import time
+from datetime import timedelta
+
+import torch
+import torch.distributed as dist
+
+
+PHASES = ["barrier", "get", "multi_get"]
+
+
+def run_client(args, rank):
+    store = dist.TCPStore(
+        args.master_addr, args.master_port, args.clients + 1, False)
+    store.set_timeout(timedelta(seconds=args.timeout))
+    for phase in PHASES:
+        store.wait(["%s/start" % phase])
+        if phase in ("get", "multi_get"):
+            store.set("%s/%d" % (phase, rank), "value%d" % rank)
+            keys = [
+                "%s/%d" % (phase, (rank + i) % args.clients)
+                for i in range(1, args.peers + 1)
+            ]
+            if phase == "get":
+                for key in keys:
+                    store.get(key)
+            else:
+                store.multi_get(keys)
+        if store.add("%s/count" % phase, 1) == args.clients:
+            store.set("%s/done" % phase, "")
+        if phase == "barrier":
+            store.wait(["barrier/done"])
+
+
+def run_process(args, ranks):
+    threads = [
+        threading.Thread(target=run_client, args=(args, rank))
+        for rank in ranks
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='TCPStore scale benchmark')
+    parser.add_argument("--master-addr", type=str, default="127.0.0.1")
+    parser.add_argument("--master-port", type=int, default=29500)
+    parser.add_argument("--clients", type=int, default=4096)
+    parser.add_argument("--processes", type=int, default=min(multiprocessing.cpu_count(), 32),
+                        help="Number of processes the clients are spread over")
+    parser.add_argument("--peers", type=int, default=64, help="Number of keys every client reads")
+    parser.add_argument("--timeout", type=int, default=600, help="Store timeout in seconds")
+    parser.add_argument("--json", type=str, metavar="PATH", help="Write file with benchmark results")
+    args = parser.parse_args()
+    args.peers = min(args.peers, args.clients - 1)
+
+    processes = [
+        multiprocessing.Process(
+            target=run_process,
+            args=(args, range(i, args.clients, args.processes)))
+        for i in range(args.processes)
+    ]
+    for process in processes:
+        process.start()
+
+    # The server returns once all clients have connected.
+    start = time.time()
+    store = dist.TCPStore(
+        args.master_addr, args.master_port, args.clients + 1, True)
+    store.set_timeout(timedelta(seconds=args.timeout))
+    results = {"connect": time.time() - start}
+
+    for phase in PHASES:
+        start = time.time()
+        store.set("%s/start" % phase, "")
+        store.wait(["%s/done" % phase])
+        results[phase] = time.time() - start
+
+    for process in processes:
+        process.join()
+
+    print("%12s  %12s" % ("phase", "seconds"))
+    for phase in ["connect"] + PHASES:
+        print("%12s  %12.3f" % (phase, results[phase]))
+
+    if args.json:
+        report = {
+            "pytorch_version": torch.__version__,
+            "clients": args.clients,
+            "processes": args.processes,
+            "peers": args.peers,
+            "results": results,
+        }
+        with open(args.json, 'w') as f:
+            json.dump(report, f)
+
+
+if __name__ == '__main__':
+    main()
@@ -9,7 +9,8 @@ from pt_wrapper_module import WrapperModule
 """ Framework overhead benchmark script.
 Benchmark framework overhead.
 Currently supported ops: add.
-As of now runs only forward pass.
+Runs the forward pass, and with --backward the backward pass as well, which
+measures the per-node overhead of the autograd engine.
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
 Graph can be saved via save option. Saved in the directory where benchmark is run.
@@ -19,6 +20,8 @@ buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_ben
  --add_op --graph_mode --eager_mode (Runs both graph mode and eager mode)
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --graph_mode (Runs only graph mode)
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --add_op --eager_mode --backward (Runs forward and backward in eager mode)
 To run C2 benchmark:
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --benchmark_c2_net
@@ -58,7 +61,9 @@ def benchmark_simple_fn(args, config, module_config, module_type, result):
         f_name = module_config.pt_fn.__name__ + ":Num Operands=" + str(module_config.num_params)
         graph_mode_str = "Graph mode" + ":" + str(module_config.graph_mode)
         result_key = ','.join((f_name, graph_mode_str))
-        module = WrapperModule(module_type, module_config, args.debug, args.save)
+        if args.backward:
+            result_key += ",Backward"
+        module = WrapperModule(module_type, module_config, args.debug, args.save, args.backward)
         latency_per_iter_ms = benchmark_module(config, module, args.use_throughput_benchmark)
         result[result_key] = latency_per_iter_ms
 
@@ -70,6 +75,7 @@ def main():
     parser.add_argument("--debug", default=False, dest="debug", action="store_true")
     parser.add_argument("--save", default=False, dest="save", action="store_true")
     parser.add_argument("--eager_mode", default=False, dest="eager_mode", action="store_true")
+    parser.add_argument("--backward", default=False, dest="backward", action="store_true")
     parser.add_argument("--num_warmup_iters", type=int, default=100)
     parser.add_argument("--num_iters", type=int, default=1000)
     args = parser.parse_args()
@@ -79,6 +85,8 @@ def main():
         return
     assert not (args.benchmark_c2_net and args.use_throughput_benchmark), \
         "Benchmarking of C2 net via throughput benchmarking is not yet supported"
+    assert not (args.backward and (args.benchmark_c2_net or args.use_throughput_benchmark)), \
+        "Benchmarking the backward pass is only supported for PyTorch modules"
 
     num_warmup_iters = args.num_warmup_iters
     num_iters = args.num_iters
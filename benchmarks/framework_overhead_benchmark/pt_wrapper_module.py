@@ -19,14 +19,18 @@ class WrapperModule(object):
             - Whether debug mode is enabled.
         save:
             - In graph mode, whether graph is to be saved.
+        backward:
+            - Whether each iteration also runs the backward pass, which
+              measures the overhead of the autograd engine.
     """
-    def __init__(self, wrapped_type, module_config, debug, save=False):
+    def __init__(self, wrapped_type, module_config, debug, save=False, backward=False):
         pt_fn = module_config.pt_fn
         self.module = wrapped_type(pt_fn)
         self.tensor_inputs = []
         self.module_name = wrapped_type.__name__
+        self.backward = backward
         for _ in range(module_config.num_params):
-            self.tensor_inputs.append(torch.randn(1))
+            self.tensor_inputs.append(torch.randn(1, requires_grad=backward))
         if module_config.graph_mode:
             self.module = torch.jit.trace(self.module, self.tensor_inputs)
             if save:
@@ -39,6 +43,10 @@ class WrapperModule(object):
             print(self.module.code)
 
     def forward(self, niters):
+        if self.backward:
+            for _ in range(niters):
+                self.module.forward(*self.tensor_inputs).backward()
+            return
         with torch.no_grad():
             for _ in range(niters):
                 self.module.forward(*self.tensor_inputs)
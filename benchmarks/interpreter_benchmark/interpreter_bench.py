@@ -0,0 +1,110 @@
+import argparse
+import timeit
+
+import torch
+
+# Scalar-, list- and string-heavy programs where the interpreter loop, rather
+# than kernels, dominates the run time.
+PROGRAMS = '''
+def fib(n: int):
+    a = 0
+    b = 1
+    for _ in range(n):
+        a, b = b, a + b
+    return a
+
+def collatz(n: int):
+    total = 0
+    for start in range(1, n):
+        x = start
+        while x != 1:
+            if x % 2 == 0:
+                x = x // 2
+            else:
+                x = 3 * x + 1
+            total += 1
+    return total
+
+def list_ops(n: int):
+    xs: List[int] = []
+    for i in range(n):
+        xs.append(i * 7 % 13)
+    evens = [x for x in xs if x % 2 == 0]
+    total = 0
+    for x in evens:
+        total += x
+    return total
+
+def tokenize(text: str, n: int):
+    counts: Dict[str, int] = {}
+    for _ in range(n):
+        for word in text.split(" "):
+            if word in counts:
+                counts[word] += 1
+            else:
+                counts[word] = 1
+    return len(counts)
+
+def beam_search(scores: List[float], beam: int, steps: int):
+    beams: List[float] = [0.0]
+    for _ in range(steps):
+        candidates: List[float] = []
+        for b in beams:
+            for s in scores:
+                candidates.append(b + s)
+        candidates.sort(reverse=True)
+        beams = candidates[:beam]
+    return beams[0]
+'''
+
+INPUTS = {
+    "fib": lambda: (2000,),
+    "collatz": lambda: (300,),
+    "list_ops": lambda: (2000,),
+    "tokenize": lambda: ("the quick brown fox jumps over the lazy dog the end", 100),
+    "beam_search": lambda: ([-0.1 * i for i in range(16)], 4, 20),
+}
+
+
+def compile_programs(superinstructions):
+    """
+    Code objects pick up the superinstruction mode when they are created, so
+    each mode gets its own compilation unit and graph executors.
+    """
+    old = torch._C._jit_set_superinstruction_mode(superinstructions)
+    try:
+        cu = torch.jit.CompilationUnit(PROGRAMS)
+        # The first runs profile and optimize the graphs; compile the final
+        # plans while the mode is set.
+        for name, inputs in INPUTS.items():
+            for _ in range(3):
+                getattr(cu, name)(*inputs())
+    finally:
+        torch._C._jit_set_superinstruction_mode(old)
+    return cu
+
+
+def run_benchmark(args):
+    units = {mode: compile_programs(mode) for mode in (False, True)}
+    print("{:>12} {:>12} {:>16} {:>8}".format(
+        "program", "plain (us)", "superinstr (us)", "speedup"))
+    for name in args.programs:
+        inputs = INPUTS[name]()
+        times = {}
+        for mode, cu in units.items():
+            fn = getattr(cu, name)
+            times[mode] = min(timeit.repeat(
+                lambda: fn(*inputs), repeat=args.repeat, number=args.number)) / args.number
+        print("{:>12} {:>12.1f} {:>16.1f} {:>8.2f}".format(
+            name, times[False] * 1e6, times[True] * 1e6, times[False] / times[True]))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description="TorchScript interpreter dispatch overhead")
+    parser.add_argument("--programs", nargs="+", default=list(INPUTS.keys()),
+                        choices=list(INPUTS.keys()))
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--number", type=int, default=20)
+    args = parser.parse_args()
+    run_benchmark(args)
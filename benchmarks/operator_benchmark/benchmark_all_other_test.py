@@ -8,7 +8,8 @@ from pt import ( # noqa
     add_test, as_strided_test, batchnorm_test, binary_test, cat_test,  # noqa
     chunk_test, conv_test, diag_test, embeddingbag_test, fill_test,  # noqa
     gather_test, linear_test, matmul_test, pool_test,  # noqa
-    softmax_test, hardsigmoid_test, hardswish_test, layernorm_test  # noqa
+    softmax_test, hardsigmoid_test, hardswish_test, layernorm_test,  # noqa
+    sort_test  # noqa
 )
 
 if __name__ == "__main__":
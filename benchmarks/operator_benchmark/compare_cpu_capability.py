@@ -0,0 +1,95 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+"""Compare the operator benchmarks across ATen CPU capabilities.
+
+Runs a benchmark module once per capability, forcing the kernels with the
+ATEN_CPU_CAPABILITY environment variable, and reports the per-test speedup
+over the baseline capability. Example:
+
+    python compare_cpu_capability.py --module pt.unary_test -- --omp_num_threads 1
+
+Arguments after `--` are passed to the benchmark module unchanged.
+"""
+
+NAME_RE = re.compile(r"^# Name: (\S+)")
+MODE_RE = re.compile(r"^# Mode: (\S+)")
+TIME_RE = re.compile(r"^(?:Run: \d+, )?(Forward|Backward) Execution Time \(us\) : ([0-9.]+)")
+
+
+def parse_results(output):
+    """Map (test name, mode, direction) to the mean execution time in us."""
+    times = {}
+    name, mode = None, ""
+    for line in output.splitlines():
+        m = MODE_RE.match(line)
+        if m:
+            mode = m.group(1)
+            continue
+        m = NAME_RE.match(line)
+        if m:
+            name = m.group(1)
+            continue
+        m = TIME_RE.match(line)
+        if m and name is not None:
+            times.setdefault((name, mode, m.group(1)), []).append(float(m.group(2)))
+    return {key: sum(runs) / len(runs) for key, runs in times.items()}
+
+
+def used_capability(env):
+    code = ("import torch; "
+            "print([l for l in torch.__config__.show().splitlines() "
+            "if 'CPU capability usage' in l][0].split(':')[1].strip())")
+    return subprocess.check_output([sys.executable, "-c", code], env=env).decode().strip()
+
+
+def run(module, capability, benchmark_args):
+    env = dict(os.environ, ATEN_CPU_CAPABILITY=capability)
+    actual = used_capability(env)
+    if actual.lower() != capability:
+        raise RuntimeError(
+            "Asked for the {} kernels but PyTorch used {}; this machine or build "
+            "does not support them".format(capability, actual))
+    output = subprocess.check_output(
+        [sys.executable, "-m", module] + benchmark_args, env=env).decode()
+    return parse_results(output)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Report operator speedups of one CPU capability over another.")
+    parser.add_argument("--module", default="benchmark_all_test",
+                        help="benchmark module to run, e.g. pt.add_test")
+    parser.add_argument("--baseline", default="avx2",
+                        help="ATEN_CPU_CAPABILITY used as the reference")
+    parser.add_argument("--capability", default="avx512",
+                        help="ATEN_CPU_CAPABILITY to compare against the baseline")
+    args, benchmark_args = parser.parse_known_args()
+    benchmark_args = [a for a in benchmark_args if a != "--"]
+
+    baseline = run(args.module, args.baseline, benchmark_args)
+    target = run(args.module, args.capability, benchmark_args)
+
+    header = "{:<60} {:>8} {:>12} {:>12} {:>8}".format(
+        "Name", "Mode", args.baseline + " (us)", args.capability + " (us)", "Speedup")
+    print(header)
+    print("-" * len(header))
+    for key in sorted(baseline):
+        if key not in target:
+            continue
+        name, mode, direction = key
+        label = name if direction == "Forward" else name + " (backward)"
+        print("{:<60} {:>8} {:>12.3f} {:>12.3f} {:>7.2f}x".format(
+            label, mode, baseline[key], target[key], baseline[key] / target[key]))
+
+
+if __name__ == "__main__":
+    main()
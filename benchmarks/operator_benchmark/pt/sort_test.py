@@ -0,0 +1,63 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import operator_benchmark as op_bench
+import torch
+
+
+"""Microbenchmarks for sort operator."""
+
+# An example input from this configuration is M=64, N=1024, dim=1.
+sort_configs_short = op_bench.config_list(
+    attr_names=["M", "N", "dim"],
+    attrs=[
+        [64, 1024, 1],
+        [1024, 64, 0],
+    ],
+    cross_product_configs={
+        'descending': [False, True],
+        'dtype': [torch.float, torch.long],
+        'device': ['cpu', 'cuda'],
+    },
+    tags=["short"]
+)
+
+
+# Batches of long slices, and a single slice long enough to be sorted in parallel.
+sort_configs_long = op_bench.config_list(
+    attr_names=["M", "N", "dim"],
+    attrs=[
+        [2048, 4096, 1],
+        [1, 1 << 22, 1],
+    ],
+    cross_product_configs={
+        'descending': [False],
+        'dtype': [torch.float, torch.int],
+        'device': ['cpu', 'cuda'],
+    },
+    tags=["long"]
+)
+
+
+class SortBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, dim, descending, dtype, device):
+        if dtype.is_floating_point:
+            self.input_one = torch.randn(M, N, device=device).to(dtype)
+        else:
+            self.input_one = torch.randint(-(1 << 20), 1 << 20, (M, N), device=device, dtype=dtype)
+        self.dim = dim
+        self.descending = descending
+        self.set_module_name("sort")
+
+    def forward(self):
+        return torch.sort(self.input_one, self.dim, self.descending)
+
+
+op_bench.generate_pt_test(sort_configs_short + sort_configs_long,
+                          SortBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
@@ -0,0 +1,58 @@
+import argparse
+import os
+import tempfile
+import timeit
+
+import torch
+
+
+class Weights(torch.nn.Module):
+    def __init__(self, num_tensors, numel, sparsity):
+        super(Weights, self).__init__()
+        for i in range(num_tensors):
+            # Zero out a fraction of the values so that the compression ratio
+            # can be varied, as pruned or quantized models would.
+            t = torch.randn(numel)
+            t[torch.rand(numel) < sparsity] = 0
+            self.register_buffer("w{}".format(i), t)
+
+    def forward(self, x):
+        return x
+
+
+def run_load_benchmark(args):
+    """
+    Save a module holding only tensors at each compression level and report
+    the size of the archive against the time to load it, with and without
+    mmap. Compressed tensors are decompressed in parallel on load, so the
+    number of intra-op threads matters.
+    """
+    m = torch.jit.script(Weights(args.num_tensors, args.numel, args.sparsity))
+    raw_size = args.num_tensors * args.numel * 4
+    print("{:>6} {:>10} {:>8} {:>10} {:>10}".format(
+        "level", "size (MB)", "ratio", "load (s)", "mmap (s)"))
+    with tempfile.TemporaryDirectory() as tmp:
+        for level in args.levels:
+            path = os.path.join(tmp, "model_{}.pt".format(level))
+            torch.jit.save(m, path, compression_level=level)
+            size = os.path.getsize(path)
+            load = min(timeit.repeat(
+                lambda: torch.jit.load(path), repeat=args.repeat, number=1))
+            mmap = min(timeit.repeat(
+                lambda: torch.jit.load(path, mmap=True), repeat=args.repeat, number=1))
+            print("{:>6} {:>10.1f} {:>8.2f} {:>10.3f} {:>10.3f}".format(
+                level, size / 1e6, raw_size / size, load, mmap))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="TorchScript load time vs. compression")
+    parser.add_argument("--num-tensors", type=int, default=64)
+    parser.add_argument("--numel", type=int, default=1 << 20)
+    parser.add_argument("--sparsity", type=float, default=0.5)
+    parser.add_argument("--levels", type=int, nargs="+", default=[0, 1, 6, 10])
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--num-threads", type=int, default=None)
+    args = parser.parse_args()
+    if args.num_threads is not None:
+        torch.set_num_threads(args.num_threads)
+    run_load_benchmark(args)
@@ -3,6 +3,7 @@ import itertools
 from . import benchmark
 import os
 from . import tensor_engine
+import torch
 
 from . import attention      # noqa: F401
 from . import broadcast      # noqa: F401
@@ -78,7 +79,16 @@ Works only with Python3.\n A few examples:
         "--cuda_fuser",
         type=str,
         default="te",
-        help="The Cuda fuser backend to use: one of {te, old, none}",
+        help="The Cuda fuser backend to use: one of {te, old, none}. "
+        "A comma separated list runs every benchmark with each of them, "
+        "e.g. 'te,none' compares fused kernels against unfused ATen",
+    )
+    parser.add_argument(
+        "--cpu_threads",
+        type=str,
+        default=None,
+        help="a comma separated list of intra-op thread counts to run the CPU "
+        "benchmarks with, e.g. 1,4,16",
     )
     parser.add_argument(
         "--output",
@@ -89,9 +99,8 @@ Works only with Python3.\n A few examples:
 
     args = parser.parse_args()
 
-    if args.cuda_fuser == "te":
-        import torch
-
+    fusers = args.cuda_fuser.split(",")
+    if "te" in fusers:
         torch._C._jit_set_texpr_fuser_enabled(True)
 
     def set_global_threads(num_threads):
@@ -99,6 +108,9 @@ Works only with Python3.\n A few examples:
         os.environ["MKL_NUM_THREADS"] = str(num_threads)
         os.environ["TVM_NUM_THREADS"] = str(num_threads)
         os.environ["NNC_NUM_THREADS"] = str(num_threads)
+        # The variables above only take effect at startup; parallel loops in
+        # fused kernels and ATen ops both run on the intra-op pool.
+        torch.set_num_threads(num_threads)
 
     devices = args.device.split(",")
     # accept 'gpu' as an alternative as the 'cuda' device
@@ -126,6 +138,22 @@ Works only with Python3.\n A few examples:
 
     tensor_engine.set_engine_mode(args.engine)
 
+    if args.cpu_threads:
+        cpu_threads = [int(n) for n in args.cpu_threads.split(",")]
+    else:
+        cpu_threads = [None]
+
+    def run_bench(bench):
+        thread_counts = cpu_threads if bench.device == "cpu" else [None]
+        for num_threads, fuser in itertools.product(thread_counts, fusers):
+            if num_threads is not None:
+                set_global_threads(num_threads)
+            if len(fusers) > 1:
+                bench.fuser = fuser
+            bench_args = argparse.Namespace(**vars(args))
+            bench_args.cuda_fuser = fuser
+            bench.run(bench_args)
+
     def run_default_configs(bench_cls, allow_skip=True):
         for mode, device, config in itertools.product(
             modes, devices, bench_cls.default_configs()
@@ -140,7 +168,7 @@ Works only with Python3.\n A few examples:
                     raise ValueError(
                         "attempted to run an unsupported benchmark: %s" % (bench.desc())
                     )
-            bench.run(args)
+            run_bench(bench)
 
     benchmark_classes = benchmark.benchmark_classes
     if not args.benchmark_names:
@@ -184,7 +212,7 @@ Works only with Python3.\n A few examples:
                     bench = bench_cls(*config)
                     bench.jit_mode = args.jit_mode
                     bench.output_type = args.output_type
-                    bench.run(args)
+                    run_bench(bench)
 
             if not match_class_name:
                 available_classes = ", ".join(
@@ -13,6 +13,8 @@ class Benchmark(object):
         self.deterministic = False
         self.device = device
         self.output_type = "stdout"
+        # Set when several fusers are compared in one run.
+        self.fuser = None
         if mode == "both":
             self.requires_grad = True
         elif mode == "fwd":
@@ -63,8 +65,11 @@ class Benchmark(object):
         if "NNC_NUM_THREADS" in os.environ:
             num_threads_str = os.environ["NNC_NUM_THREADS"]
             device += num_threads_str
+        engine_mode = self.engine.mode
+        if self.fuser:
+            engine_mode += "+" + self.fuser
         return "%s: %s_%s_%s_%s" % (
-            self.engine.mode,
+            engine_mode,
             self.module(),
             self.mode,
             device,
@@ -127,6 +132,7 @@ class Benchmark(object):
         engine = tensor_engine.get_engine()
 
         self.bm_jit = None
+        torch._C._jit_reset_texpr_compile_stats()
         for i in range(warmups + iters):
             if i == warmups:
                 if self.device == "cuda":
@@ -164,6 +170,10 @@ class Benchmark(object):
         }
         if compute_workload:
             result_dict["compute_workload"] = compute_workload / iter_time / 1e9
+        compile_stats = torch._C._jit_texpr_compile_stats()
+        if compile_stats["kernels"]:
+            result_dict["compile_ms"] = compile_stats["compile_time_us"] / 1e3
+            result_dict["arena_kb"] = compile_stats["arena_bytes"] / 1024
         self.dump_result(result_dict)
 
     def dump_result(self, result_dict):
@@ -178,6 +188,11 @@ class Benchmark(object):
             )
             if "compute_workload" in result_dict:
                 msg += ", compute %.2f Gops/s" % result_dict["compute_workload"]
+            if "compile_ms" in result_dict:
+                msg += ", compile %.2f ms (arena %.0f KB)" % (
+                    result_dict["compile_ms"],
+                    result_dict["arena_kb"],
+                )
             print(msg)
         else:
             raise Exception("Unknown output_type " + self.output_type)
@@ -1,5 +1,6 @@
 #include <torch/torch.h>
 #include <torch/csrc/autograd/record_function.h>
+#include <torch/csrc/autograd/sampling_profiler.h>
 
 #include "c10/util/Flags.h"
 
@@ -9,6 +10,18 @@
 
 C10_DEFINE_int(iter, 100, "Number of iterations");
 C10_DEFINE_int(warmup_iter, 10, "Number of warmup iterations")
+C10_DEFINE_bool(
+    sampling_profiler,
+    false,
+    "Measure the sampling profiler instead of the test callbacks");
+C10_DEFINE_double(
+    sampling_rate,
+    0.001,
+    "Sampling rate of the sampling profiler");
+C10_DEFINE_bool(
+    record_shapes,
+    false,
+    "Whether the sampling profiler records input shapes");
 
 namespace {
 const int kInnerIter = 100;
@@ -62,7 +75,14 @@ int main(int argc, char** argv) {
     return -1;
   }
 
-  setupCallbacks();
+  if (FLAGS_sampling_profiler) {
+    profiler::SamplingProfilerConfig config;
+    config.sampling_rate = FLAGS_sampling_rate;
+    config.record_shapes = FLAGS_record_shapes;
+    profiler::enableSamplingProfiler(config);
+  } else {
+    setupCallbacks();
+  }
 
   auto duration = runBench(kSmallTensorSize, FLAGS_warmup_iter);
   std::cout << "Warmup time: " << duration << " us." << std::endl;
@@ -77,5 +97,18 @@ int main(int argc, char** argv) {
               << " us." << std::endl;
   }
 
+  if (FLAGS_sampling_profiler) {
+    typedef std::chrono::high_resolution_clock clock;
+    auto start_time = clock::now();
+    auto profile = profiler::disableSamplingProfiler();
+    auto flush_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        clock::now() - start_time)
+                        .count();
+    std::cout << "Flushed " << profile.events().size() << " samples ("
+              << profile.stats().size() << " aggregated, "
+              << profile.num_dropped() << " dropped) in " << flush_us
+              << " us." << std::endl;
+  }
+
   return 0;
 }
@@ -23,6 +23,9 @@
 #include "torch/csrc/autograd/grad_mode.h"
 #include "torch/csrc/jit/serialization/import.h"
 #include "torch/script.h"
+#ifndef C10_MOBILE
+#include "torch/csrc/jit/runtime/static/impl.h"
+#endif
 
 #include <chrono>
 using namespace std::chrono;
@@ -58,6 +61,11 @@ C10_DEFINE_bool(
   "Whether to print performance stats for AI-PEP.");
 
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
+C10_DEFINE_bool(
+  static_runtime,
+  false,
+  "Run the frozen forward method with the static runtime instead of the "
+  "graph executor. Requires a model without control flow.");
 
 std::vector<std::string>
 split(char separator, const std::string& string, bool ignore_empty = true) {
@@ -157,8 +165,23 @@ int main(int argc, char** argv) {
   }
 
   module.eval();
+
+  std::function<c10::IValue()> forward = [&]() {
+    return module.forward(inputs);
+  };
+#ifndef C10_MOBILE
+  std::unique_ptr<torch::jit::StaticRuntime> static_runtime;
+  if (FLAGS_static_runtime) {
+    static_runtime = std::make_unique<torch::jit::StaticRuntime>(module);
+    forward = [&]() { return static_runtime->run(inputs); };
+  }
+#else
+  CAFFE_ENFORCE(
+      !FLAGS_static_runtime, "The static runtime is not built for mobile.");
+#endif
+
   if (FLAGS_print_output) {
-    std::cout << module.forward(inputs) << std::endl;
+    std::cout << forward() << std::endl;
   }
 
   std::cout << "Starting benchmark." << std::endl;
@@ -169,7 +192,7 @@ int main(int argc, char** argv) {
       FLAGS_warmup,
       ".");
   for (int i = 0; i < FLAGS_warmup; ++i) {
-    module.forward(inputs);
+    forward();
   }
 
   std::cout << "Main runs." << std::endl;
@@ -183,7 +206,7 @@ int main(int argc, char** argv) {
   auto millis = timer.MilliSeconds();
   for (int i = 0; i < FLAGS_iter; ++i) {
     auto start = high_resolution_clock::now();
-    module.forward(inputs);
+    forward();
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
     times.push_back(duration.count());
@@ -0,0 +1,65 @@
+#include <c10/core/thread_pool.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int kTasksPerBatch = 1000;
+
+c10::ThreadPool& pool() {
+  static c10::ThreadPool pool(
+      std::max(2u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+// Many threads submitting small tasks at once, as with at::launch, JIT fork
+// and RPC handlers sharing the inter-op pool.
+static void BM_ThreadPoolExternalSubmit(benchmark::State& state) {
+  auto& p = pool();
+  std::atomic<int> done{0};
+  int submitted = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < kTasksPerBatch; ++i) {
+      p.run([&done]() { ++done; });
+    }
+    submitted += kTasksPerBatch;
+    wait_for(done, submitted);
+  }
+  state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+}
+BENCHMARK(BM_ThreadPoolExternalSubmit)->ThreadRange(1, 16)->UseRealTime();
+
+// Tasks spawning their subtasks from inside the pool, which only touches the
+// spawning worker's queue.
+static void BM_ThreadPoolNestedSubmit(benchmark::State& state) {
+  auto& p = pool();
+  std::atomic<int> done{0};
+  int submitted = 0;
+  const int fanout = state.range(0);
+  for (auto _ : state) {
+    for (int i = 0; i < kTasksPerBatch / fanout; ++i) {
+      p.run([&p, &done, fanout]() {
+        for (int j = 0; j < fanout; ++j) {
+          p.run([&done]() { ++done; });
+        }
+      });
+    }
+    submitted += kTasksPerBatch / fanout * fanout;
+    wait_for(done, submitted);
+  }
+  state.SetItemsProcessed(state.iterations() * (kTasksPerBatch / fanout) * fanout);
+}
+BENCHMARK(BM_ThreadPoolNestedSubmit)->Arg(10)->Arg(100)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
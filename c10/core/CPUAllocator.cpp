@@ -1,6 +1,9 @@
 #include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#include <cstdlib>
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -160,7 +163,16 @@ at::Allocator* GetDefaultCPUAllocator() {
   return &g_cpu_alloc;
 }
 
-REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc);
+// PYTORCH_CPU_CACHING_ALLOCATOR=1 makes the caching allocator the default.
+static at::Allocator* GetInitialCPUAllocator() {
+  const char* env = std::getenv("PYTORCH_CPU_CACHING_ALLOCATOR");
+  if (env != nullptr && std::strcmp(env, "1") == 0) {
+    return CPUCachingAllocator::get();
+  }
+  return &g_cpu_alloc;
+}
+
+REGISTER_ALLOCATOR(DeviceType::CPU, GetInitialCPUAllocator());
 
 void MemoryAllocationReporter::New(void* ptr, size_t nbytes) {
   std::lock_guard<std::mutex> guard(mutex_);
@@ -0,0 +1,352 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+#include <c10/util/numa.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+// Every block starts with a header, so that the deleter can find the size of
+// the block from the data pointer alone. Keeping it gAlignment bytes long
+// preserves the alignment of the data that follows.
+struct BlockHeader {
+  // Total size of the block, header included.
+  size_t size;
+  // Index of the size class for small blocks, -1 for large ones.
+  int size_class;
+  // Whether the block was obtained with mmap rather than alloc_cpu.
+  bool mmapped;
+};
+
+constexpr size_t kHeaderSize = gAlignment;
+static_assert(sizeof(BlockHeader) <= kHeaderSize, "BlockHeader too large");
+
+// Requests up to kSmallLimit bytes use the size classes; larger ones are
+// rounded up to kLargeRounding, the size of a huge page on x86.
+constexpr size_t kMinSize = 64;
+constexpr size_t kSmallLimit = 1 << 20;
+constexpr size_t kLargeRounding = 2 << 20;
+
+// The classes are kMinSize, then four per power of two:
+// (2^k, 2^k * 1.25, 2^k * 1.5, 2^k * 1.75] for k from 6 to 19.
+constexpr int kNumSmallClasses = 1 + (20 - 6) * 4;
+
+int size_class(size_t nbytes) {
+  if (nbytes <= kMinSize) {
+    return 0;
+  }
+  // 2^shift < nbytes <= 2^(shift + 1)
+  int shift = static_cast<int>(llvm::Log2_64(nbytes - 1));
+  size_t step = size_t(1) << (shift - 2);
+  size_t quarter = (nbytes - (size_t(1) << shift) + step - 1) / step;
+  return 1 + (shift - 6) * 4 + static_cast<int>(quarter) - 1;
+}
+
+size_t class_size(int size_class) {
+  if (size_class == 0) {
+    return kMinSize;
+  }
+  int shift = 6 + (size_class - 1) / 4;
+  size_t quarter = (size_class - 1) % 4 + 1;
+  return (size_t(1) << shift) + quarter * (size_t(1) << (shift - 2));
+}
+
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+
+  void increase(int64_t amount) {
+    int64_t value = current.fetch_add(amount, std::memory_order_relaxed) + amount;
+    int64_t peak_value = peak.load(std::memory_order_relaxed);
+    while (value > peak_value &&
+           !peak.compare_exchange_weak(peak_value, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  void decrease(int64_t amount) {
+    current.fetch_sub(amount, std::memory_order_relaxed);
+  }
+};
+
+struct GlobalStats {
+  AtomicStat allocated_bytes;
+  AtomicStat reserved_bytes;
+  std::atomic<int64_t> num_cache_hits{0};
+  std::atomic<int64_t> num_cache_misses{0};
+};
+
+GlobalStats stats;
+
+// Bumped by emptyCache(); threads compare it against the value they last saw
+// to find out that they should release their cache.
+std::atomic<uint64_t> flush_epoch{0};
+
+BlockHeader* new_block(size_t size, int size_class) {
+  void* base = nullptr;
+  bool mmapped = false;
+#if defined(__linux__)
+  if (size_class < 0) {
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      base = nullptr;
+    } else {
+      mmapped = true;
+#ifdef MADV_HUGEPAGE
+      // Best effort: fewer page faults and TLB misses on large activations.
+      madvise(base, size, MADV_HUGEPAGE);
+#endif
+      NUMAMove(base, size, GetCurrentNUMANode());
+    }
+  }
+#endif
+  if (!base) {
+    base = alloc_cpu(size);
+  }
+  auto* block = static_cast<BlockHeader*>(base);
+  block->size = size;
+  block->size_class = size_class;
+  block->mmapped = mmapped;
+  stats.reserved_bytes.increase(size);
+  stats.num_cache_misses.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+void release_block(BlockHeader* block) {
+  stats.reserved_bytes.decrease(block->size);
+#if defined(__linux__)
+  if (block->mmapped) {
+    munmap(block, block->size);
+    return;
+  }
+#endif
+  free_cpu(block);
+}
+
+struct SharedPool {
+  std::mutex mutex;
+  std::vector<BlockHeader*> small[kNumSmallClasses];
+  std::multimap<size_t, BlockHeader*> large;
+
+  BlockHeader* take_small(int size_class) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto& bin = small[size_class];
+    if (bin.empty()) {
+      return nullptr;
+    }
+    BlockHeader* block = bin.back();
+    bin.pop_back();
+    return block;
+  }
+
+  BlockHeader* take_large(size_t size) {
+    std::lock_guard<std::mutex> guard(mutex);
+    // The smallest block that fits, if it wastes at most a fifth of itself.
+    auto it = large.lower_bound(size);
+    if (it == large.end() || it->first > size + size / 4) {
+      return nullptr;
+    }
+    BlockHeader* block = it->second;
+    large.erase(it);
+    return block;
+  }
+
+  void put(BlockHeader* block) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (block->size_class >= 0) {
+      small[block->size_class].push_back(block);
+    } else {
+      large.emplace(block->size, block);
+    }
+  }
+
+  void release_all() {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto& bin : small) {
+      for (BlockHeader* block : bin) {
+        release_block(block);
+      }
+      bin.clear();
+    }
+    for (auto& entry : large) {
+      release_block(entry.second);
+    }
+    large.clear();
+  }
+};
+
+// Leaked on purpose: tensors may still be freed during static destruction.
+SharedPool& shared_pool() {
+  static SharedPool* pool = new SharedPool();
+  return *pool;
+}
+
+struct ThreadCache {
+  std::vector<BlockHeader*> bins[kNumSmallClasses];
+  size_t cached_bytes = 0;
+  uint64_t epoch = 0;
+
+  void release_all() {
+    for (auto& bin : bins) {
+      for (BlockHeader* block : bin) {
+        release_block(block);
+      }
+      bin.clear();
+    }
+    cached_bytes = 0;
+  }
+};
+
+// Set once the thread's cache has been destroyed, so that tensors freed later
+// during thread exit go straight to the shared pool.
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCacheHolder {
+  ThreadCache cache;
+
+  ~ThreadCacheHolder() {
+    thread_cache_destroyed = true;
+    auto& pool = shared_pool();
+    for (auto& bin : cache.bins) {
+      for (BlockHeader* block : bin) {
+        pool.put(block);
+      }
+    }
+  }
+};
+
+ThreadCache* thread_cache() {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCacheHolder holder;
+  uint64_t epoch = flush_epoch.load(std::memory_order_relaxed);
+  if (holder.cache.epoch != epoch) {
+    holder.cache.release_all();
+    holder.cache.epoch = epoch;
+  }
+  return &holder.cache;
+}
+
+void* allocate_block(size_t nbytes) {
+  if (nbytes == 0) {
+    return nullptr;
+  }
+  CAFFE_ENFORCE(
+      ((ptrdiff_t)nbytes) >= 0,
+      "CPUCachingAllocator: allocate() seems to have been called with negative number: ",
+      nbytes);
+
+  BlockHeader* block = nullptr;
+  if (nbytes <= kSmallLimit) {
+    int cls = size_class(nbytes);
+    ThreadCache* cache = thread_cache();
+    if (cache && !cache->bins[cls].empty()) {
+      block = cache->bins[cls].back();
+      cache->bins[cls].pop_back();
+      cache->cached_bytes -= block->size;
+    } else {
+      block = shared_pool().take_small(cls);
+    }
+    if (block) {
+      stats.num_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      block = new_block(class_size(cls) + kHeaderSize, cls);
+    }
+  } else {
+    size_t size = (nbytes + kHeaderSize + kLargeRounding - 1) / kLargeRounding * kLargeRounding;
+    block = shared_pool().take_large(size);
+    if (block) {
+      stats.num_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      block = new_block(size, -1);
+    }
+  }
+  stats.allocated_bytes.increase(block->size);
+
+  void* data = reinterpret_cast<char*>(block) + kHeaderSize;
+  CHECK(
+      !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
+      !FLAGS_caffe2_cpu_allocator_do_junk_fill)
+    << "Cannot request both zero-fill and junk-fill at the same time";
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+  return data;
+}
+
+void free_block(void* data) {
+  if (!data) {
+    return;
+  }
+  auto* block = reinterpret_cast<BlockHeader*>(static_cast<char*>(data) - kHeaderSize);
+  stats.allocated_bytes.decrease(block->size);
+  if (block->size_class >= 0) {
+    ThreadCache* cache = thread_cache();
+    if (cache && cache->cached_bytes + block->size <= kMaxThreadCacheBytes) {
+      cache->bins[block->size_class].push_back(block);
+      cache->cached_bytes += block->size;
+      return;
+    }
+  }
+  shared_pool().put(block);
+}
+
+struct CachingAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    void* data = allocate_block(nbytes);
+    return {data, data, &free_block, at::Device(at::DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &free_block;
+  }
+};
+
+} // namespace
+
+Allocator* get() {
+  static CachingAllocator allocator;
+  return &allocator;
+}
+
+void emptyCache() {
+  flush_epoch.fetch_add(1, std::memory_order_relaxed);
+  // Picks up the new epoch and releases this thread's cache.
+  thread_cache();
+  shared_pool().release_all();
+}
+
+AllocatorStats getStats() {
+  AllocatorStats result;
+  result.allocated_bytes.current = stats.allocated_bytes.current.load();
+  result.allocated_bytes.peak = stats.allocated_bytes.peak.load();
+  result.reserved_bytes.current = stats.reserved_bytes.current.load();
+  result.reserved_bytes.peak = stats.reserved_bytes.peak.load();
+  result.num_cache_hits = stats.num_cache_hits.load();
+  result.num_cache_misses = stats.num_cache_misses.load();
+  return result;
+}
+
+void resetPeakStats() {
+  stats.allocated_bytes.peak = stats.allocated_bytes.current.load();
+  stats.reserved_bytes.peak = stats.reserved_bytes.current.load();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+
+namespace c10 {
+
+// A caching allocator for CPU tensors, along the lines of
+// CUDACachingAllocator.
+//
+// - Requests up to 1 MiB are rounded up to one of a set of size classes
+//   (four per power of two) and freed blocks are kept on per-thread free
+//   lists, so the common case of allocating and freeing short-lived
+//   intermediates on the same thread takes no lock. A thread keeps at most
+//   kMaxThreadCacheBytes cached; beyond that, and when the thread exits,
+//   blocks go to a shared pool that all threads draw from.
+// - Larger requests are rounded up to a multiple of 2 MiB and, on Linux,
+//   mmap'ed and advised to use transparent huge pages. They are cached in the
+//   shared pool and reused for requests they exceed by at most 25%, i.e.
+//   requests up to 20% smaller than the block.
+//
+// Memory is only returned to the system by emptyCache(). Blocks cached by
+// other threads are released the next time those threads allocate or free.
+//
+// The allocator is opt-in: install it with SetCPUAllocator(
+// CPUCachingAllocator::get()), or set PYTORCH_CPU_CACHING_ALLOCATOR=1 to make
+// it the default CPU allocator at startup. Tensors allocated before the
+// switch are still freed by the allocator that created them.
+namespace CPUCachingAllocator {
+
+constexpr size_t kMaxThreadCacheBytes = 32 << 20;
+
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+};
+
+struct AllocatorStats {
+  // SUM: bytes in blocks handed out to client code (after rounding up to the
+  // block size)
+  Stat allocated_bytes;
+  // SUM: bytes obtained from the system, both in use and cached
+  Stat reserved_bytes;
+  // COUNT: allocations served from a cache
+  int64_t num_cache_hits = 0;
+  // COUNT: allocations that had to go to the system
+  int64_t num_cache_misses = 0;
+};
+
+C10_API Allocator* get();
+C10_API void emptyCache();
+C10_API AllocatorStats getStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
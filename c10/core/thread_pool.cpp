@@ -1,17 +1,215 @@
 #include <c10/core/thread_pool.h>
 
+#include <deque>
+
 namespace c10 {
 
+namespace {
+
+// The pool and worker index of the current thread, if it is a pool worker.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+
+} // namespace
+
+// Chase-Lev deque with a fixed capacity, see "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013). Only the
+// owning worker pushes and pops at the bottom; any thread steals at the top.
+class ThreadPool::WorkStealingDeque {
+ public:
+  WorkStealingDeque() : top_(0), bottom_(0) {
+    for (auto& slot : buffer_) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns false if the deque is full.
+  bool push(task_element_t* task) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= kCapacity) {
+      return false;
+    }
+    buffer_[b & kMask].store(task, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  task_element_t* pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    task_element_t* task = nullptr;
+    if (t <= b) {
+      task = buffer_[b & kMask].load(std::memory_order_relaxed);
+      if (t == b) {
+        // Last task: race against thieves for it.
+        if (!top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          task = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // May return nullptr when losing a race, even if the deque is not empty.
+  task_element_t* steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    task_element_t* task = buffer_[t & kMask].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return task;
+  }
+
+  bool empty() const {
+    return bottom_.load(std::memory_order_relaxed) <=
+        top_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int64_t kCapacity = 1024;
+  static constexpr int64_t kMask = kCapacity - 1;
+
+  std::atomic<int64_t> top_;
+  // Keep the ends on separate cache lines.
+  char padding_[64];
+  std::atomic<int64_t> bottom_;
+  std::atomic<task_element_t*> buffer_[kCapacity];
+};
+
+// Bounded multi-producer multi-consumer queue (D. Vyukov's design), backed
+// by a locked queue for when it is full.
+class ThreadPool::InjectionQueue {
+ public:
+  InjectionQueue() : enqueue_pos_(0), dequeue_pos_(0), overflow_size_(0) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  void push(task_element_t* task) {
+    if (try_push(task)) {
+      return;
+    }
+    std::lock_guard<std::mutex> guard(overflow_mutex_);
+    overflow_.push_back(task);
+    overflow_size_.fetch_add(1);
+  }
+
+  task_element_t* pop() {
+    if (auto* task = try_pop()) {
+      return task;
+    }
+    if (overflow_size_.load() == 0) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> guard(overflow_mutex_);
+    if (overflow_.empty()) {
+      return nullptr;
+    }
+    auto* task = overflow_.front();
+    overflow_.pop_front();
+    overflow_size_.fetch_sub(1);
+    return task;
+  }
+
+  // Conservative: a push that is in progress already makes it non-empty.
+  bool empty() const {
+    return enqueue_pos_.load() == dequeue_pos_.load() &&
+        overflow_size_.load() == 0;
+  }
+
+ private:
+  static constexpr size_t kCapacity = 1024;
+  static constexpr size_t kMask = kCapacity - 1;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    task_element_t* task;
+  };
+
+  bool try_push(task_element_t* task) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & kMask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->task = task;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  task_element_t* try_pop() {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & kMask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    task_element_t* task = cell->task;
+    cell->sequence.store(pos + kCapacity, std::memory_order_release);
+    return task;
+  }
+
+  Cell cells_[kCapacity];
+  std::atomic<size_t> enqueue_pos_;
+  char padding_[64];
+  std::atomic<size_t> dequeue_pos_;
+  std::mutex overflow_mutex_;
+  std::deque<task_element_t*> overflow_;
+  std::atomic<size_t> overflow_size_;
+};
+
 ThreadPool::ThreadPool(
       int pool_size,
       int numa_node_id,
       std::function<void()> init_thread)
-    : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
+    : injection_queue_(new InjectionQueue()),
+      threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
       running_(true),
-      complete_(true),
-      available_(threads_.size()),
+      sleeping_(0),
+      pending_(0),
+      active_(0),
       total_(threads_.size()),
       numa_node_id_(numa_node_id) {
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    queues_.emplace_back(new WorkStealingDeque());
+  }
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread([this, i, init_thread](){
       if (init_thread) {
@@ -24,9 +222,9 @@ ThreadPool::ThreadPool(
 
 ThreadPool::~ThreadPool() {
   // Set running flag to false then notify all threads.
+  running_ = false;
   {
     std::unique_lock<std::mutex> lock(mutex_);
-    running_ = false;
     condition_.notify_all();
   }
 
@@ -36,6 +234,16 @@ ThreadPool::~ThreadPool() {
     } catch (const std::exception&) {
     }
   }
+
+  // Drop the tasks that were never run.
+  while (auto* task = injection_queue_->pop()) {
+    delete task;
+  }
+  for (auto& queue : queues_) {
+    while (auto* task = queue->pop()) {
+      delete task;
+    }
+  }
 }
 
 size_t ThreadPool::size() const {
@@ -43,93 +251,111 @@ size_t ThreadPool::size() const {
 }
 
 size_t ThreadPool::numAvailable() const {
-  return available_;
+  return total_ - active_.load();
 }
 
 bool ThreadPool::inThreadPool() const {
-  for (auto& thread : threads_) {
-    if (thread.get_id() == std::this_thread::get_id()) {
-      return true;
-    }
-  }
-  return false;
+  return current_pool == this;
 }
 
 void ThreadPool::run(const std::function<void()>& func) {
+  enqueue(new task_element_t(func));
+}
+
+void ThreadPool::enqueue(task_element_t* task) {
   if (threads_.size() == 0) {
+    delete task;
     throw std::runtime_error("No threads to run a task");
   }
-  std::unique_lock<std::mutex> lock(mutex_);
-
-  // Set task and signal condition variable so that a worker thread will
-  // wake up and use the task.
-  tasks_.push(task_element_t(func));
-  complete_ = false;
-  condition_.notify_one();
+  ++pending_;
+  // Workers keep the tasks they spawn, unless their deque is full.
+  if (current_pool != this || !queues_[current_worker]->push(task)) {
+    injection_queue_->push(task);
+  }
+  // Pairs with the fence in main_loop: either we see the sleeping worker
+  // here, or it sees the new task before going to sleep.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_one();
+  }
 }
 
 void ThreadPool::waitWorkComplete() {
   std::unique_lock<std::mutex> lock(mutex_);
-  while (!complete_) {
+  while (pending_.load() != 0) {
     completed_.wait(lock);
   }
 }
 
+ThreadPool::task_element_t* ThreadPool::find_task(std::size_t index) {
+  if (auto* task = queues_[index]->pop()) {
+    return task;
+  }
+  if (auto* task = injection_queue_->pop()) {
+    return task;
+  }
+  for (std::size_t i = 1; i < queues_.size(); ++i) {
+    if (auto* task = queues_[(index + i) % queues_.size()]->steal()) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+bool ThreadPool::has_tasks() const {
+  if (!injection_queue_->empty()) {
+    return true;
+  }
+  for (const auto& queue : queues_) {
+    if (!queue->empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ThreadPool::main_loop(std::size_t index) {
-  std::unique_lock<std::mutex> lock(mutex_);
+  current_pool = this;
+  current_worker = index;
   while (running_) {
-    // Wait on condition variable while the task is empty and
-    // the pool is still running.
-    while (tasks_.empty() && running_) {
-      condition_.wait(lock);
-    }
-    // If pool is no longer running, break out of loop.
-    if (!running_) {
-      break;
-    }
-
-    // Copy task locally and remove from the queue.  This is
-    // done within its own scope so that the task object is
-    // destructed immediately after running the task.  This is
-    // useful in the event that the function contains
-    // shared_ptr arguments bound via bind.
-    {
-      auto tasks = tasks_.front();
-      tasks_.pop();
-      // Decrement count, indicating thread is no longer available.
-      --available_;
-
-      lock.unlock();
-
-      // Run the task.
-      try {
-        if (tasks.run_with_id) {
-          tasks.with_id(index);
-        } else {
-          tasks.no_id();
-        }
-      } catch (const std::exception& e) {
-        LOG(ERROR) << "Exception in thread pool task: " << e.what();
-      } catch (...) {
-        LOG(ERROR) << "Exception in thread pool task: unknown";
+    task_element_t* task = find_task(index);
+    if (!task) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++sleeping_;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // Look again now that submitters know we may be asleep; a steal that
+      // lost a race also ends up here and just retries.
+      if (running_ && !has_tasks()) {
+        condition_.wait(lock);
       }
+      --sleeping_;
+      continue;
+    }
 
-      // Update status of empty, maybe
-      // Need to recover the lock first
-      lock.lock();
-
-      // Increment count, indicating thread is available.
-      ++available_;
-      if (tasks_.empty() && available_ == total_) {
-        complete_ = true;
-        completed_.notify_one();
+    ++active_;
+    // Run the task.
+    try {
+      if (task->run_with_id) {
+        task->with_id(index);
+      } else {
+        task->no_id();
       }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception in thread pool task: " << e.what();
+    } catch (...) {
+      LOG(ERROR) << "Exception in thread pool task: unknown";
+    }
+    // Destroy the task right away, in case it holds shared_ptr arguments
+    // bound via bind.
+    delete task;
+    --active_;
 
-      // Deliberately hold the lock on the backedge, so this thread has an
-      // opportunity to acquire a new task before another thread acquires
-      // the lock.
+    if (--pending_ == 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completed_.notify_all();
     }
-  } // while running_
+  }
 }
 
 C10_DEFINE_SHARED_REGISTRY(
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
@@ -42,6 +44,12 @@ class C10_API TaskThreadPoolBase {
   }
 };
 
+// A work-stealing thread pool. Each worker owns a lock-free deque: tasks
+// submitted from a worker go to its own deque, and are popped by it in LIFO
+// order or stolen by idle workers in FIFO order. Tasks submitted from other
+// threads go to a shared lock-free injection queue (with a locked overflow
+// queue behind it). Idle workers sleep on a condition variable, which
+// submitters only touch when some worker is actually asleep.
 class C10_API ThreadPool : public c10::TaskThreadPoolBase {
  protected:
   struct task_element_t {
@@ -55,14 +63,24 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
         : run_with_id(true), no_id(nullptr), with_id(f) {}
   };
 
-  std::queue<task_element_t> tasks_;
+  // Defined in thread_pool.cpp.
+  class WorkStealingDeque;
+  class InjectionQueue;
+
+  std::vector<std::unique_ptr<WorkStealingDeque>> queues_;
+  std::unique_ptr<InjectionQueue> injection_queue_;
   std::vector<std::thread> threads_;
+  // Guards sleeping and waking up; not taken to submit or run tasks.
   std::mutex mutex_;
   std::condition_variable condition_;
   std::condition_variable completed_;
   std::atomic_bool running_;
-  bool complete_;
-  std::size_t available_;
+  // Number of workers waiting on condition_.
+  std::atomic<std::size_t> sleeping_;
+  // Number of tasks submitted but not finished yet.
+  std::atomic<std::size_t> pending_;
+  // Number of workers running a task.
+  std::atomic<std::size_t> active_;
   std::size_t total_;
   int numa_node_id_;
 
@@ -86,20 +104,23 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
 
   template <typename Task>
   void runTaskWithID(Task task) {
-    std::unique_lock<std::mutex> lock(mutex_);
-
-    // Set task and signal condition variable so that a worker thread will
-    // wake up and use the task.
-    tasks_.push(
-        task_element_t(static_cast<std::function<void(std::size_t)>>(task)));
-    complete_ = false;
-    condition_.notify_one();
+    enqueue(new task_element_t(
+        static_cast<std::function<void(std::size_t)>>(task)));
   }
 
   /// @brief Wait for queue to be empty
   void waitWorkComplete();
 
  private:
+  // @brief Hands a task over to the workers, taking ownership of it.
+  void enqueue(task_element_t* task);
+
+  // @brief Finds a task for worker `index`, or returns nullptr.
+  task_element_t* find_task(std::size_t index);
+
+  // @brief Whether any queue may have a task in it.
+  bool has_tasks() const;
+
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
 };
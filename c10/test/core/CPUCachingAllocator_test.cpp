@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <cstdint>
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUCachingAllocator, ReusesFreedBlock) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  void* first = nullptr;
+  {
+    DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+  }
+  DataPtr ptr = allocator->allocate(1000);
+  ASSERT_EQ(ptr.get(), first);
+  ASSERT_EQ(ptr.device(), Device(DeviceType::CPU));
+}
+
+TEST(CPUCachingAllocator, Alignment) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  for (size_t size : {1, 63, 65, 4097, 1 << 20, (1 << 20) + 1, 5 << 20}) {
+    DataPtr ptr = allocator->allocate(size);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr.get()) % 64, 0);
+  }
+}
+
+TEST(CPUCachingAllocator, ZeroSize) {
+  DataPtr ptr = CPUCachingAllocator::get()->allocate(0);
+  ASSERT_EQ(ptr.get(), nullptr);
+}
+
+TEST(CPUCachingAllocator, Stats) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  CPUCachingAllocator::resetPeakStats();
+  auto before = CPUCachingAllocator::getStats();
+  {
+    DataPtr a = allocator->allocate(3000);
+    DataPtr b = allocator->allocate(3000);
+    auto stats = CPUCachingAllocator::getStats();
+    ASSERT_GE(stats.allocated_bytes.current - before.allocated_bytes.current, 6000);
+    ASSERT_GE(stats.reserved_bytes.current, stats.allocated_bytes.current);
+  }
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.allocated_bytes.current, before.allocated_bytes.current);
+  ASSERT_GT(after.allocated_bytes.peak, after.allocated_bytes.current);
+  ASSERT_GT(after.reserved_bytes.current, before.reserved_bytes.current);
+
+  CPUCachingAllocator::resetPeakStats();
+  after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.allocated_bytes.peak, after.allocated_bytes.current);
+
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(
+      CPUCachingAllocator::getStats().reserved_bytes.current,
+      before.reserved_bytes.current);
+}
+
+TEST(CPUCachingAllocator, LargeBlockReuse) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  void* first = nullptr;
+  {
+    DataPtr ptr = allocator->allocate(8 << 20);
+    first = ptr.get();
+  }
+  // Slightly smaller requests are served from the same block...
+  {
+    DataPtr ptr = allocator->allocate(7 << 20);
+    ASSERT_EQ(ptr.get(), first);
+  }
+  // ...but much smaller ones are not.
+  DataPtr ptr = allocator->allocate(2 << 20);
+  ASSERT_NE(ptr.get(), first);
+}
+
+TEST(CPUCachingAllocator, CrossThreadFree) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  DataPtr ptr = allocator->allocate(12345);
+  std::thread([&]() { ptr.clear(); }).join();
+  ASSERT_EQ(ptr.get(), nullptr);
+
+  int64_t hits = CPUCachingAllocator::getStats().num_cache_hits;
+  std::thread([&]() {
+    for (int i = 0; i < 100; i++) {
+      DataPtr p = allocator->allocate(12345);
+    }
+  }).join();
+  ASSERT_GE(CPUCachingAllocator::getStats().num_cache_hits - hits, 99);
+}
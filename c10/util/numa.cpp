@@ -9,6 +9,13 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 #define C10_ENABLE_NUMA
 #endif
 
+#if defined(__linux__) && !defined(C10_MOBILE)
+#include <sched.h>
+#define C10_ENABLE_AFFINITY
+#endif
+
+#include <thread>
+
 // This code used to have a lot of VLOGs. However, because allocation might be
 // triggered during static initialization, it's unsafe to invoke VLOG here
 
@@ -129,4 +136,61 @@ int GetCurrentNUMANode() {
 
 #endif // C10_NUMA_ENABLED
 
+#ifdef C10_ENABLE_AFFINITY
+std::vector<std::vector<int>> GetCPUsByNUMANode() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+#ifdef C10_ENABLE_NUMA
+  if (numa_available() >= 0) {
+    std::vector<std::vector<int>> cpus_by_node(numa_max_node() + 1);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (!CPU_ISSET(cpu, &allowed)) {
+        continue;
+      }
+      int node = numa_node_of_cpu(cpu);
+      if (node >= 0 && node < static_cast<int>(cpus_by_node.size())) {
+        cpus_by_node[node].push_back(cpu);
+      }
+    }
+    return cpus_by_node;
+  }
+#endif
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return {cpus};
+}
+
+bool PinCurrentThreadToCPU(int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(cpu, &mask);
+  return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+}
+
+#else // C10_ENABLE_AFFINITY
+
+std::vector<std::vector<int>> GetCPUsByNUMANode() {
+  std::vector<int> cpus(std::thread::hardware_concurrency());
+  for (size_t cpu = 0; cpu < cpus.size(); ++cpu) {
+    cpus[cpu] = static_cast<int>(cpu);
+  }
+  return {cpus};
+}
+
+bool PinCurrentThreadToCPU(int cpu) {
+  return false;
+}
+
+#endif // C10_ENABLE_AFFINITY
+
 } // namespace c10
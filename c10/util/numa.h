@@ -3,6 +3,8 @@
 #include <c10/util/Logging.h>
 #include <c10/util/Optional.h>
 
+#include <vector>
+
 C10_DECLARE_bool(caffe2_cpu_numa_enabled);
 
 namespace c10 {
@@ -37,4 +39,18 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Get the CPUs the current process may run on, grouped by NUMA node and
+ * ordered by node id. Returns a single group if the topology is unknown.
+ * Unlike the functions above, this does not depend on
+ * caffe2_cpu_numa_enabled, as it only reads the topology.
+ */
+C10_API std::vector<std::vector<int>> GetCPUsByNUMANode();
+
+/**
+ * Pin the calling thread to a given CPU. Returns false if that is not
+ * supported on this platform or fails.
+ */
+C10_API bool PinCurrentThreadToCPU(int cpu);
+
 } // namespace c10
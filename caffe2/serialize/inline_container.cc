@@ -5,6 +5,7 @@
 #include <ostream>
 #include <fstream>
 
+#include <ATen/Parallel.h>
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
 
@@ -217,6 +218,18 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  // Records written uncompressed are kFieldAlignment-aligned in the file, so
+  // adapters that can alias their data (see MmapAdapter) hand them out
+  // without a copy.
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size) {
+    size_t offset = getRecordOffset(name);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr aliased = in_->getDataPtr(offset, stat.m_uncomp_size);
+      if (aliased) {
+        return std::make_tuple(std::move(aliased), stat.m_uncomp_size);
+      }
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file ", name.c_str());
@@ -225,6 +238,85 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
+at::DataPtr PyTorchStreamReader::readCompressedRecord(
+    size_t key,
+    const std::string& name) {
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  size_t offset = getRecordOffset(name);
+  at::DataPtr aliased = in_->getDataPtr(offset, stat.m_comp_size);
+  if (aliased) {
+    return aliased;
+  }
+  void* ptr = malloc(stat.m_comp_size);
+  at::DataPtr retval(ptr, ptr, free, at::kCPU);
+  size_t n = in_->read(offset, ptr, stat.m_comp_size, "reading file");
+  if (n != stat.m_comp_size) {
+    CAFFE_THROW("PytorchStreamReader failed reading file ", name, ": file truncated");
+  }
+  return retval;
+}
+
+std::vector<std::tuple<at::DataPtr, size_t>> PyTorchStreamReader::getRecords(
+    const std::vector<std::string>& names) {
+  std::vector<std::tuple<at::DataPtr, size_t>> records(names.size());
+  // The archive and the adapter are not thread safe, so the records are read
+  // here and only the deflate streams are decoded in parallel.
+  std::vector<size_t> compressed;
+  std::vector<at::DataPtr> compressed_data;
+  std::vector<mz_zip_archive_file_stat> compressed_stats;
+  for (size_t i = 0; i < names.size(); i++) {
+    size_t key = getRecordID(names[i]);
+    mz_zip_archive_file_stat stat;
+    mz_zip_reader_file_stat(ar_.get(), key, &stat);
+    valid("retrieving file meta-data for ", names[i].c_str());
+    if (stat.m_method == MZ_DEFLATED && stat.m_uncomp_size > 0) {
+      compressed.push_back(i);
+      compressed_data.push_back(readCompressedRecord(key, names[i]));
+      compressed_stats.push_back(stat);
+    } else {
+      records[i] = getRecord(names[i]);
+    }
+  }
+
+  at::parallel_for(0, compressed.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      const auto& stat = compressed_stats[j];
+      void* ptr = malloc(stat.m_uncomp_size);
+      at::DataPtr retval(ptr, ptr, free, at::kCPU);
+      // Zip entries hold raw deflate streams, without a zlib header.
+      size_t n = tinfl_decompress_mem_to_mem(
+          ptr,
+          stat.m_uncomp_size,
+          compressed_data[j].get(),
+          stat.m_comp_size,
+          0);
+      if (n != stat.m_uncomp_size) {
+        CAFFE_THROW(
+            "PytorchStreamReader failed decompressing file ",
+            names[compressed[j]]);
+      }
+      compressed_data[j].clear();
+      records[compressed[j]] =
+          std::make_tuple(std::move(retval), stat.m_uncomp_size);
+    }
+  });
+  return records;
+}
+
+std::vector<std::string> PyTorchStreamReader::getRecordsInDirectory(
+    const std::string& dir) {
+  std::string prefix = archive_name_plus_slash_ + dir + "/";
+  std::vector<std::string> out;
+  for (const auto& name : getAllRecords()) {
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+      out.push_back(name.substr(archive_name_plus_slash_.size()));
+    }
+  }
+  return out;
+}
+
 static int64_t read_le_16(uint8_t* buf) {
   return buf[0] + (buf[1] << 8);
 }
@@ -317,9 +409,46 @@ void PyTorchStreamWriter::writeRecord(
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
   std::string full_name = archive_name_plus_slash_ + name;
+  int level = compression_level_;
+  if (compress && level == 0) {
+    level = MZ_BEST_COMPRESSION;
+  }
+  if (level > 0 && size > 0 && (compress || size >= min_size_to_compress_)) {
+    // Deflate the record up front rather than letting miniz do it, so that
+    // records that do not shrink can still be stored, and stay aligned.
+    size_t compressed_size = 0;
+    void* compressed = tdefl_compress_mem_to_heap(
+        data,
+        size,
+        &compressed_size,
+        tdefl_create_comp_flags_from_zip_params(
+            level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+    if (compressed && compressed_size < size) {
+      mz_zip_writer_add_mem_ex_v2(
+          ar_.get(),
+          full_name.c_str(),
+          compressed,
+          compressed_size,
+          nullptr,
+          0,
+          MZ_ZIP_FLAG_COMPRESSED_DATA,
+          size,
+          mz_crc32(
+              MZ_CRC32_INIT, static_cast<const mz_uint8*>(data), size),
+          nullptr,
+          nullptr,
+          0,
+          nullptr,
+          0);
+      mz_free(compressed);
+      valid("writing file ", name.c_str());
+      return;
+    }
+    mz_free(compressed);
+  }
+
   size_t padding_size =
       getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
-  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
@@ -327,7 +456,7 @@ void PyTorchStreamWriter::writeRecord(
       size,
       nullptr,
       0,
-      flags,
+      0,
       0,
       0,
       nullptr,
@@ -338,6 +467,18 @@ void PyTorchStreamWriter::writeRecord(
   valid("writing file ", name.c_str());
 }
 
+void PyTorchStreamWriter::setCompression(int level, size_t min_size) {
+  TORCH_CHECK(
+      level >= 0 && level <= MZ_UBER_COMPRESSION,
+      "Invalid compression_level ",
+      level,
+      ": expected a value between 0 (no compression) and ",
+      MZ_UBER_COMPRESSION,
+      " (smallest output)");
+  compression_level_ = level;
+  min_size_to_compress_ = min_size;
+}
+
 void PyTorchStreamWriter::writeEndOfFile() {
   AT_ASSERT(!finalized_);
   finalized_ = true;
@@ -6,6 +6,9 @@
 #include <fstream>
 #include <istream>
 #include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
@@ -39,16 +42,17 @@ typedef struct mz_zip_archive mz_zip_archive;
 //
 // The PyTorchStreamWriter also ensures additional useful properties for these
 // files
-// 1. All files are stored uncompressed.
-// 2. All files in the archive are aligned to 64 byte boundaries such that
-//    it is possible to mmap the entire file and get an aligned pointer to
-//    tensor data.
+// 1. Files are stored uncompressed, unless compression was asked for (see
+//    writeRecord and setCompression) and deflating them saves space.
+// 2. All uncompressed files in the archive are aligned to 64 byte boundaries
+//    such that it is possible to mmap the entire file and get an aligned
+//    pointer to tensor data.
 // 3. We universally write in ZIP64 format for consistency.
 
 // The PyTorchStreamReader also provides additional properties:
 // 1. It can read zip files that are created with common
-//    zip tools. This means that even though our writer doesn't compress files,
-//    the reader can still read files that were compressed.
+//    zip tools, with or without compression. getRecords decompresses many
+//    compressed files in parallel.
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with
 //    PyTorchStreamWriter it is guaranteed to be 64 byte aligned.
@@ -102,6 +106,9 @@ constexpr uint64_t kProducedFileFormatVersion = 0x3L;
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+// Records below this size are not worth the cost of a deflate stream.
+constexpr size_t kMinSizeToCompress = 4096;
+
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
@@ -110,6 +117,13 @@ class CAFFE2_API PyTorchStreamReader final {
 
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // Reads several records at once. Compressed records are decompressed in
+  // parallel, which is much faster than calling getRecord on each of them.
+  std::vector<std::tuple<at::DataPtr, size_t>> getRecords(
+      const std::vector<std::string>& names);
+  // Names of the records in the directory dir, relative to the archive like
+  // those passed to getRecord, e.g. "data/0" for dir "data".
+  std::vector<std::string> getRecordsInDirectory(const std::string& dir);
   size_t getRecordOffset(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
@@ -124,6 +138,7 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  at::DataPtr readCompressedRecord(size_t key, const std::string& name);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -140,11 +155,19 @@ class CAFFE2_API PyTorchStreamWriter final {
   explicit PyTorchStreamWriter(
       const std::function<size_t(const void*, size_t)>& writer_func);
 
+  // Records written with compress = true, and all records of at least
+  // min_size bytes once setCompression has been called, are deflated. Those
+  // that do not shrink are stored as is; stored records always start at a
+  // kFieldAlignment-aligned offset so that they can be used in place from a
+  // memory-mapped archive.
   void writeRecord(
       const std::string& name,
       const void* data,
       size_t size,
       bool compress = false);
+  // level is the deflate level, from 1 (fastest) to 10 (smallest); 0 turns
+  // compression off for records written without compress = true.
+  void setCompression(int level, size_t min_size = kMinSizeToCompress);
   void writeEndOfFile();
 
   bool finalized() const {
@@ -169,6 +192,8 @@ class CAFFE2_API PyTorchStreamWriter final {
   std::function<size_t(const void*, size_t)> writer_func_;
   bool finalized_ = false;
   bool err_seen_ = false;
+  int compression_level_ = 0;
+  size_t min_size_to_compress_ = kMinSizeToCompress;
   friend size_t ostream_write_func(
       void* pOpaque,
       uint64_t file_ofs,
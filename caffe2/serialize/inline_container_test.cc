@@ -1,10 +1,13 @@
+#include <algorithm>
+#include <array>
 #include <cstdio>
 #include <string>
-#include <array>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +66,91 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, CompressedRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  writer.setCompression(1, 1000);
+
+  // Compressible, large enough: deflated.
+  std::vector<char> zeros(100000, 0);
+  writer.writeRecord("data/0", zeros.data(), zeros.size());
+  // Incompressible: stored, and still aligned.
+  std::vector<char> noise(5000);
+  uint32_t state = 1;
+  for (auto& c : noise) {
+    state = state * 1664525 + 1013904223;
+    c = static_cast<char>(state >> 24);
+  }
+  writer.writeRecord("data/1", noise.data(), noise.size());
+  // Below the threshold: stored.
+  std::vector<char> small(500, 7);
+  writer.writeRecord("data/2", small.data(), small.size());
+  writer.writeRecord("other", small.data(), small.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  ASSERT_LT(the_file.size(), zeros.size());
+  std::istringstream iss(the_file);
+  PyTorchStreamReader reader(&iss);
+  ASSERT_EQ(reader.getRecordOffset("data/1") % kFieldAlignment, 0);
+  ASSERT_EQ(reader.getRecordOffset("data/2") % kFieldAlignment, 0);
+
+  auto names = reader.getRecordsInDirectory("data");
+  std::sort(names.begin(), names.end());
+  ASSERT_EQ(names, std::vector<std::string>({"data/0", "data/1", "data/2"}));
+  auto records = reader.getRecords(names);
+  std::vector<std::vector<char>*> expected = {&zeros, &noise, &small};
+  for (size_t i = 0; i < names.size(); i++) {
+    ASSERT_EQ(std::get<1>(records[i]), expected[i]->size());
+    ASSERT_EQ(
+        memcmp(std::get<0>(records[i]).get(), expected[i]->data(), expected[i]->size()),
+        0);
+  }
+
+  // getRecord still handles compressed records.
+  at::DataPtr data_ptr;
+  int64_t size;
+  std::tie(data_ptr, size) = reader.getRecord("data/0");
+  ASSERT_EQ(size, zeros.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), zeros.data(), zeros.size()), 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, MmapZeroCopy) {
+  const std::string file_name = "output_mmap.zip";
+  std::array<char, 300> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = i % 100;
+  }
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(std::make_unique<MmapAdapter>(file_name));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+    // The record is handed out in place, so it is aligned like in the file.
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % kFieldAlignment, 0);
+  }
+
+  // The mapping outlives the reader, and writes do not reach the file.
+  static_cast<char*>(data_ptr.get())[0] = 42;
+  PyTorchStreamReader reader(file_name);
+  at::DataPtr reread_ptr;
+  std::tie(reread_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(reread_ptr.get(), data1.data(), data1.size()), 0);
+  data_ptr.clear();
+  std::remove(file_name.c_str());
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
@@ -0,0 +1,140 @@
+#include "caffe2/serialize/mmap_adapter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <c10/util/Exception.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapRegion {
+  char* base = nullptr;
+  size_t size = 0;
+
+  explicit MmapRegion(const std::string& file_name);
+  ~MmapRegion();
+};
+
+#ifdef _WIN32
+
+MmapRegion::MmapRegion(const std::string& file_name) {
+  HANDLE file = CreateFileA(
+      file_name.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    AT_ERROR("reading the size of ", file_name, " failed");
+  }
+  size = static_cast<size_t>(file_size.QuadPart);
+  if (size > 0) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping) {
+      base = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+      // The view keeps the mapping object alive.
+      CloseHandle(mapping);
+    }
+    if (!base) {
+      CloseHandle(file);
+      AT_ERROR("mapping ", file_name, " failed, error code: ", GetLastError());
+    }
+  }
+  CloseHandle(file);
+}
+
+MmapRegion::~MmapRegion() {
+  if (base) {
+    UnmapViewOfFile(base);
+  }
+}
+
+#else
+
+MmapRegion::MmapRegion(const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    AT_ERROR("reading the size of ", file_name, " failed: ", strerror(errno));
+  }
+  size = static_cast<size_t>(st.st_size);
+  if (size > 0) {
+    // PROT_WRITE on a MAP_PRIVATE mapping of a read-only file descriptor is
+    // allowed: writes go to private copies of the pages, never to the file.
+    void* ptr = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      AT_ERROR("mapping ", file_name, " failed: ", strerror(errno));
+    }
+    base = static_cast<char*>(ptr);
+  }
+  // The mapping keeps its own reference to the file.
+  close(fd);
+}
+
+MmapRegion::~MmapRegion() {
+  if (base) {
+    munmap(base, size);
+  }
+}
+
+#endif
+
+MmapAdapter::MmapAdapter(const std::string& file_name)
+    : region_(std::make_shared<MmapRegion>(file_name)) {}
+
+size_t MmapAdapter::size() const {
+  return region_->size;
+}
+
+size_t MmapAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= region_->size) {
+    return 0;
+  }
+  n = std::min(n, static_cast<size_t>(region_->size - pos));
+  std::memcpy(buf, region_->base + pos, n);
+  return n;
+}
+
+static void deleteRegionRef(void* ctx) {
+  delete static_cast<std::shared_ptr<MmapRegion>*>(ctx);
+}
+
+at::DataPtr MmapAdapter::getDataPtr(uint64_t pos, size_t n) const {
+  if (n == 0 || pos + n > region_->size) {
+    return at::DataPtr();
+  }
+  auto* ref = new std::shared_ptr<MmapRegion>(region_);
+  return at::DataPtr(
+      region_->base + pos, ref, &deleteRegionRef, at::DeviceType::CPU);
+}
+
+MmapAdapter::~MmapAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapRegion;
+
+// this is a reader backed by a private (copy-on-write) mapping of the whole
+// file. getDataPtr() hands out pointers into the mapping, so that records
+// stored uncompressed can be used in place: pages are only read from disk
+// when touched, and only copied when written to. The mapping stays alive
+// until both the adapter and every DataPtr into it are gone.
+class CAFFE2_API MmapAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapAdapter);
+  explicit MmapAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getDataPtr(uint64_t pos, size_t n) const override;
+  ~MmapAdapter();
+
+ private:
+  std::shared_ptr<MmapRegion> region_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,11 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Adapters whose data stays addressable for their whole lifetime (e.g. a
+  // file mapping) can return a DataPtr aliasing the n bytes at pos instead of
+  // copying them. The DataPtr keeps that memory alive on its own. Returns an
+  // empty DataPtr if the adapter cannot do so, which is the default.
+  virtual at::DataPtr getDataPtr(uint64_t pos, size_t n) const;
   virtual ~ReadAdapterInterface();
 };
 
@@ -4,6 +4,7 @@
 #include "ATen/core/interned_strings.h"
 #include "torch/csrc/autograd/generated/variable_factories.h"
 #include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/jit/codegen/fuser/disk_cache.h"
 #include "torch/csrc/jit/codegen/fuser/interface.h"
 #include "torch/csrc/jit/frontend/code_template.h"
 #include "torch/csrc/jit/frontend/tracer.h"
@@ -42,8 +43,13 @@
 
 #include <c10/util/Exception.h>
 
+#include <dirent.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -224,5 +230,56 @@ void testRegisterFusionCachesKernel() {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+void testKernelDiskCache() {
+  using namespace torch::jit::fuser;
+  // A fresh directory, so entries left by earlier runs are not hits.
+  const char* tmpdir = std::getenv("TMPDIR");
+  std::string dir_template =
+      std::string(tmpdir ? tmpdir : "/tmp") + "/torch_kernel_cache_XXXXXX";
+  ASSERT_NE(mkdtemp(&dir_template[0]), nullptr);
+  const std::string dir = dir_template;
+  setKernelCacheDir(dir);
+  ASSERT_TRUE(kernelCacheEnabled());
+  resetKernelCacheStats();
+
+  const std::string key = "kernel source\ncompiler flags";
+  const std::string object = std::string("\x7f" "ELF\0object", 11);
+
+  // Nothing stored yet.
+  ASSERT_FALSE(loadCachedKernel(key, ".o"));
+  storeCachedKernel(key, ".o", object);
+  auto loaded = loadCachedKernel(key, ".o");
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(*loaded, object);
+  auto path = lookupCachedKernel(key, ".o");
+  ASSERT_TRUE(path);
+  ASSERT_EQ(path->rfind(dir, 0), 0u);
+
+  // A different key, or a different kind of object, is a different entry.
+  ASSERT_FALSE(loadCachedKernel(key + " -O3", ".o"));
+  ASSERT_FALSE(loadCachedKernel(key, ".so"));
+
+  auto stats = getKernelCacheStats();
+  ASSERT_EQ(stats.hits, 2);
+  ASSERT_EQ(stats.misses, 3);
+  ASSERT_EQ(stats.stores, 1);
+
+  // Disabling the cache turns every lookup into an uncounted miss.
+  setKernelCacheDir("");
+  ASSERT_FALSE(kernelCacheEnabled());
+  ASSERT_FALSE(loadCachedKernel(key, ".o"));
+  ASSERT_EQ(getKernelCacheStats().misses, 3);
+
+  DIR* entries = opendir(dir.c_str());
+  ASSERT_NE(entries, nullptr);
+  while (struct dirent* entry = readdir(entries)) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..") {
+      std::remove((dir + "/" + name).c_str());
+    }
+  }
+  closedir(entries);
+  ASSERT_EQ(rmdir(dir.c_str()), 0);
+}
 } // namespace jit
 } // namespace torch
@@ -1,6 +1,10 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
 
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/runtime/instruction.h>
+#include <torch/jit.h>
+
 namespace torch {
 namespace jit {
 
@@ -27,5 +31,154 @@ void testInterp() {
   ASSERT_TRUE(exactlyEqual(outputs[0], hx));
   ASSERT_TRUE(exactlyEqual(outputs[1], cx));
 }
+
+void testInterpOutVariant() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %c : Tensor = aten::mul(%a, %b)
+  %d : Tensor = aten::add(%c, %b, %one)
+  return (%d))IR",
+      &*graph);
+  auto count_out_variants = [](const Code& code) {
+    size_t num_out_variants = 0;
+    for (const Instruction& inst : code.instructions()) {
+      num_out_variants += inst.op == OP_OUT;
+    }
+    return num_out_variants;
+  };
+
+  // Out variants are opt-in.
+  bool old_mode = getOutVariantMode();
+  getOutVariantMode() = false;
+  ASSERT_EQ(count_out_variants(Code(graph, "")), 0);
+  getOutVariantMode() = true;
+  Code code(graph, "");
+  getOutVariantMode() = old_mode;
+  ASSERT_EQ(count_out_variants(code), 2);
+
+  auto a = at::randn({4, 4});
+  auto b = at::randn({4, 4});
+  auto expected = at::add(at::mul(a, b), b);
+
+  InterpreterState first_interp(code);
+  auto first = run(first_interp, {a, b})[0];
+  ASSERT_TRUE(exactlyEqual(first, expected));
+  void* first_data = first.data_ptr();
+  first.reset();
+
+  // The previous output was dropped, so it is written in place.
+  InterpreterState second_interp(code);
+  auto second = run(second_interp, {a, b})[0];
+  ASSERT_TRUE(exactlyEqual(second, expected));
+  ASSERT_EQ(second.data_ptr(), first_data);
+
+  // `second` is still alive, so it must not be overwritten.
+  InterpreterState third_interp(code);
+  auto third = run(third_interp, {b, a})[0];
+  ASSERT_NE(third.data_ptr(), second.data_ptr());
+  ASSERT_TRUE(exactlyEqual(second, expected));
+  ASSERT_TRUE(exactlyEqual(third, at::add(at::mul(b, a), a)));
+  third.reset();
+
+  // A 0-dim input does not take part in type promotion, so the buffer of a
+  // run with a 0-dim double input has the wrong dtype for a run where the
+  // same input has dimensions.
+  auto scalar = at::randn({}, at::kDouble);
+  InterpreterState fourth_interp(code);
+  auto fourth = run(fourth_interp, {a, scalar})[0];
+  ASSERT_EQ(fourth.scalar_type(), at::kFloat);
+  fourth.reset();
+  auto matrix = at::randn({4, 4}, at::kDouble);
+  InterpreterState fifth_interp(code);
+  auto fifth = run(fifth_interp, {a, matrix})[0];
+  ASSERT_EQ(fifth.scalar_type(), at::kDouble);
+  ASSERT_TRUE(exactlyEqual(fifth, at::add(at::mul(a, matrix), matrix)));
+  fifth.reset();
+
+  // The result of a run with transposed inputs is transposed too, so its
+  // buffer has the wrong strides for a run with contiguous inputs.
+  InterpreterState sixth_interp(code);
+  auto sixth = run(sixth_interp, {a.t(), b.t()})[0];
+  ASSERT_EQ(sixth.strides(), expected.t().strides());
+  sixth.reset();
+  InterpreterState seventh_interp(code);
+  auto seventh = run(seventh_interp, {a, b})[0];
+  ASSERT_TRUE(exactlyEqual(seventh, expected));
+  ASSERT_EQ(seventh.strides(), expected.strides());
+
+  // Arguments that are not tensors, like dtype=, are part of the key too.
+  auto sum_graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor, %dims : int[], %keepdim : bool, %dtype : int?):
+  %b : Tensor = aten::sum(%a, %dims, %keepdim, %dtype)
+  return (%b))IR",
+      &*sum_graph);
+  getOutVariantMode() = true;
+  Code sum_code(sum_graph, "");
+  getOutVariantMode() = old_mode;
+  ASSERT_EQ(count_out_variants(sum_code), 1);
+  auto run_sum = [&](bool keepdim, IValue dtype) {
+    Stack stack{a, c10::List<int64_t>({1}), keepdim, std::move(dtype)};
+    InterpreterState(sum_code).run(stack);
+    return stack.at(0).toTensor();
+  };
+  auto sum_double = run_sum(false, static_cast<int64_t>(at::kDouble));
+  ASSERT_EQ(sum_double.scalar_type(), at::kDouble);
+  sum_double.reset();
+  auto sum_float = run_sum(false, IValue());
+  ASSERT_EQ(sum_float.scalar_type(), at::kFloat);
+  ASSERT_TRUE(exactlyEqual(sum_float, a.sum({1})));
+  sum_float.reset();
+  auto sum_keepdim = run_sum(true, IValue());
+  ASSERT_TRUE(exactlyEqual(sum_keepdim, a.sum({1}, true)));
+}
+
+void testInterpSuperinstructions() {
+  auto cu = compile(R"JIT(
+def collatz(n: int):
+    steps = 0
+    while n != 1:
+        if n % 2 == 0:
+            n = n // 2
+        else:
+            n = 3 * n + 1
+        steps += 1
+    return steps
+
+def buckets(xs: List[int], k: int):
+    out: List[List[int]] = []
+    for _ in range(k):
+        out.append([])
+    for x in xs:
+        out[x % k].append(x)
+    return [len(b) for b in out]
+)JIT");
+
+  auto run = [&](const std::string& name, Stack stack, bool fuse) {
+    bool old_mode = getSuperinstructionMode();
+    getSuperinstructionMode() = fuse;
+    Code code(cu->get_function(name).graph(), name);
+    getSuperinstructionMode() = old_mode;
+    InterpreterState(code).run(stack);
+    return stack.at(0);
+  };
+
+  for (int64_t n : {1, 6, 27, 97}) {
+    ASSERT_EQ(
+        run("collatz", {n}, true).toInt(), run("collatz", {n}, false).toInt());
+  }
+  ASSERT_EQ(run("collatz", {27}, true).toInt(), 111);
+
+  c10::List<int64_t> xs({3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5});
+  auto fused = run("buckets", {xs, 4}, true).toIntVector();
+  auto unfused = run("buckets", {xs, 4}, false).toIntVector();
+  ASSERT_EQ(fused, unfused);
+  ASSERT_EQ(fused, std::vector<int64_t>({1, 6, 2, 2}));
+}
+
 } // namespace jit
 } // namespace torch
@@ -971,6 +971,26 @@ void testRecordFunction() {
   TORCH_CHECK(fn_names.size() == 1);
   TORCH_CHECK(fn_names[0] == "B");
   cleanUpScopeCallbacks();
+
+  // check that removeCallback removes the given callbacks, not the last ones
+  int first_cb_ctr = 0;
+  int second_cb_ctr = 0;
+  auto first_handle = autograd::profiler::pushCallback(
+      [&first_cb_ctr](const autograd::profiler::RecordFunction&) {
+        ++first_cb_ctr;
+        return true;
+      });
+  autograd::profiler::pushCallback(
+      [&second_cb_ctr](const autograd::profiler::RecordFunction&) {
+        ++second_cb_ctr;
+        return true;
+      });
+  autograd::profiler::removeCallback(first_handle);
+  { RECORD_USER_SCOPE("E"); }
+  TORCH_CHECK(first_cb_ctr == 0);
+  TORCH_CHECK(second_cb_ctr == 1);
+  cleanUpScopeCallbacks();
+  TORCH_CHECK(!autograd::profiler::hasCallbacks());
 }
 
 class TestThreadLocalDebugInfo : public at::DebugInfoBase {
@@ -29,6 +29,7 @@ namespace jit {
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
+  _(KernelDiskCache)                   \
   _(SchemaParser)                      \
   _(TopologicalIndex)                  \
   _(TopologicalMove)                   \
@@ -87,7 +88,9 @@ namespace jit {
   _(LiteInterpreterParams)             \
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
-  _(LiteInterpreterDict)
+  _(LiteInterpreterDict)               \
+  _(InterpOutVariant)                  \
+  _(InterpSuperinstructions)
 
 #if defined(USE_CUDA)
 #define TH_FORALL_TESTS_CUDA(_)  \
@@ -14,6 +14,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
@@ -274,6 +275,58 @@ void testExprSubstitute01() {
   ASSERT_EQ(e2_str, e2_ref_str);
 }
 
+void testExprHashConsing() {
+  KernelScope kernel_scope;
+  KernelArena* arena = KernelArena::GetCurrentKernelArena();
+  const Var* x = new Var("x", kFloat);
+  const Var* y = new Var("y", kFloat);
+  const Var* z = new Var("z", kFloat);
+  const Expr* e1 = new Add(x, new FloatImm(1.0f));
+  const Expr* e2 = new Add(x, new FloatImm(1.0f));
+  ASSERT_NE(e1, e2);
+
+  // Rewriting two copies of an expression the same way yields a single node.
+  const Expr* r1 = Substitute(e1, {{x, y}});
+  const Expr* r2 = Substitute(e2, {{x, y}});
+  ASSERT_EQ(r1, r2);
+  ASSERT_EQ(arena->num_interned(), 1u);
+  ASSERT_NE(Substitute(e1, {{x, z}}), r1);
+
+  // Variables keep their identity even when they look the same.
+  const Var* y2 = new Var("y", kFloat);
+  ASSERT_EQ(arena->intern(y2), y2);
+
+  // Max nodes only differing in NaN propagation are different.
+  const Expr* m1 = arena->intern(new Max(x, y, true));
+  const Expr* m2 = arena->intern(new Max(x, y, false));
+  ASSERT_NE(m1, m2);
+  ASSERT_EQ(arena->intern(new Max(x, y, true)), m1);
+  ASSERT_EQ(arena->num_interned(), 2u);
+
+  // Expressions with the same structure are merged however their leaves
+  // were created, and different ones never are, even when their hashes
+  // collide. Sweeping many similar expressions runs into collisions without
+  // depending on the hash function.
+  const Var* i = new Var("i", kInt);
+  const Var* j = new Var("j", kInt);
+  const Var* m = new Var("m", kLong);
+  const Var* n = new Var("n", kLong);
+  std::vector<const Expr*> distinct;
+  for (int k = 0; k < 1 << 16; k++) {
+    distinct.push_back(arena->intern(new Add(i, new IntImm(k))));
+    distinct.push_back(arena->intern(new Add(j, new IntImm(k))));
+    distinct.push_back(arena->intern(new Add(m, new LongImm(k))));
+    distinct.push_back(arena->intern(new Add(n, new LongImm(k))));
+  }
+  ASSERT_EQ(arena->num_interned(), 2u);
+  std::unordered_set<const Expr*> unique(distinct.begin(), distinct.end());
+  ASSERT_EQ(unique.size(), distinct.size());
+  ASSERT_EQ(arena->intern(new Add(j, new IntImm(123))), distinct[4 * 123 + 1]);
+  ASSERT_EQ(
+      arena->intern(new Add(n, new LongImm(4567))), distinct[4 * 4567 + 3]);
+  ASSERT_EQ(arena->num_interned(), 4u);
+}
+
 void testExprMath01() {
   KernelScope kernel_scope;
   ExprHandle v = sin(ExprHandle(1.0f));
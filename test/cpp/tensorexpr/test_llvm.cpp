@@ -11,9 +11,11 @@
 #include "torch/csrc/jit/tensorexpr/ir_simplifier.h"
 #include "torch/csrc/jit/tensorexpr/llvm_codegen.h"
 #include "torch/csrc/jit/tensorexpr/loopnest.h"
+#include "torch/csrc/jit/tensorexpr/reduction.h"
 #include "torch/csrc/jit/tensorexpr/tensor.h"
 
 #include <numeric>
+#include <sstream>
 
 namespace torch {
 namespace jit {
@@ -1201,6 +1203,97 @@ void testLLVMEliminatedStmt() {
   cg.call({aData, cData});
 }
 
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  auto testWithSize = [](int32_t M, int32_t N) {
+    VarHandle m("m", kInt);
+    VarHandle n("n", kInt);
+    Buffer a(BufHandle("a", {m, n}), kFloat);
+    Buffer b(BufHandle("b", {m, n}), kFloat);
+    Tensor* c = Compute(
+        "c", {{m, "m"}, {n, "n"}}, [&](const VarHandle& i, const VarHandle& j) {
+          return a(i, j) * b(i, j) + Cast::make(kFloat, i);
+        });
+    LoopNest l({c});
+    l.setParallel(l.getLoopStmtsFor(c)[0]);
+    l.prepareForCodegen();
+    Stmt* s = l.root_stmt();
+    LLVMCodeGen cg(s, {a, b, c, m, n});
+    std::vector<float> aData(M * N, 2.0f);
+    std::vector<float> bData(M * N, 3.0f);
+    std::vector<float> cData(M * N, 0.0f);
+    cg.call({aData, bData, cData, M, N});
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        ASSERT_EQ(cData[i * N + j], 6.0f + i);
+      }
+    }
+  };
+  testWithSize(1, 8);
+  testWithSize(16, 32);
+  testWithSize(1037, 11);
+}
+
+void testLLVMParallelReduce() {
+  KernelScope kernel_scope;
+  const int M = 333;
+  const int N = 129;
+  Buffer b(BufHandle("b", {M, N}), kFloat);
+  Tensor* c = Reduce("sum", {{M, "m"}}, Sum(), b, {{N, "n"}});
+  LoopNest l({c});
+  l.setParallel(l.getLoopStmtsFor(c)[0]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  std::ostringstream oss;
+  oss << *s;
+  ASSERT_NE(oss.str().find("// parallel"), std::string::npos);
+
+  LLVMCodeGen cg(s, {b, c});
+  std::vector<float> bData(M * N);
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      bData[i * N + j] = i + j % 4;
+    }
+  }
+  std::vector<float> cData(M, -1.0f);
+  cg.call({bData, cData});
+  for (int i = 0; i < M; i++) {
+    float expected = 0;
+    for (int j = 0; j < N; j++) {
+      expected += i + j % 4;
+    }
+    ASSERT_EQ(cData[i], expected);
+  }
+}
+
+void testLLVMVectorizeReduceAxis() {
+  KernelScope kernel_scope;
+  const int M = 4;
+  const int N = 8;
+  Buffer b(BufHandle("b", {M, N}), kFloat);
+  Tensor* c = Reduce("sum", {{M, "m"}}, Sum(), b, {{N, "n"}});
+  LoopNest l({c});
+  // The reduction axis can't be turned into vector stores, so this leaves the
+  // loop nest alone.
+  l.vectorize(l.getLoopStmtsFor(c)[1]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  LLVMCodeGen cg(s, {b, c});
+  std::vector<float> bData(M * N);
+  std::iota(bData.begin(), bData.end(), 0);
+  std::vector<float> cData(M, -1.0f);
+  cg.call({bData, cData});
+  for (int i = 0; i < M; i++) {
+    float expected = 0;
+    for (int j = 0; j < N; j++) {
+      expected += bData[i * N + j];
+    }
+    ASSERT_EQ(cData[i], expected);
+  }
+}
+
 } // namespace jit
 } // namespace torch
 
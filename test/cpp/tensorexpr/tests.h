@@ -26,6 +26,7 @@ namespace jit {
   _(ExprVectorAdd01)                        \
   _(ExprCompareSelectEQ)                    \
   _(ExprSubstitute01)                       \
+  _(ExprHashConsing)                        \
   _(ExprMath01)                             \
   _(ExprUnaryMath01)                        \
   _(ExprBinaryMath01)                       \
@@ -286,7 +287,10 @@ namespace jit {
   _(LLVMEmptyStmt)                         \
   _(LLVMEliminatedStmt)                    \
   _(LLVMIfThenElseTest)                    \
-  _(LLVMVectorizerLoadStoreTest)
+  _(LLVMVectorizerLoadStoreTest)           \
+  _(LLVMParallelFor)                       \
+  _(LLVMParallelReduce)                    \
+  _(LLVMVectorizeReduceAxis)
 
 #define TH_FORALL_TENSOREXPR_TESTS_CUDA(_) \
   _(CudaTestVectorAdd01)                   \
@@ -214,6 +214,30 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", ""])
+        fs.set("key3", "value3")
+        self.assertEqual(
+            [b"value0", b"value1", b"", b"value3"],
+            fs.multi_get(["key0", "key1", "key2", "key3"]))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaisesRegex(ValueError, "as many values as keys"):
+            fs.multi_set(["key0", "key1"], ["value0"])
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
+    def _test_compare_set(self, fs):
+        # A missing key compares equal to an empty value.
+        self.assertEqual(b"", fs.compare_set("key", "other", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "", "value0"))
+        self.assertEqual(b"value0", fs.compare_set("key", "other", "value1"))
+        self.assertEqual(b"value1", fs.compare_set("key", "value0", "value1"))
+        self.assertEqual(b"value1", fs.get("key"))
+
+    def test_compare_set(self):
+        self._test_compare_set(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -272,6 +296,23 @@ class TCPStoreTest(TestCase, StoreTestBase):
             store1 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
             store2 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
 
+    def test_multi_get_waits(self):
+        port = common.find_free_port()
+        store = c10d.TCPStore('localhost', port, 1, True)
+        client = c10d.TCPStore('localhost', port, 1, False)
+
+        def set_later():
+            time.sleep(0.1)
+            client.multi_set(["key1", "key2"], ["value1", "value2"])
+
+        thread = threading.Thread(target=set_later)
+        thread.start()
+        store.set("key0", "value0")
+        self.assertEqual(
+            [b"value0", b"value1", b"value2"],
+            store.multi_get(["key0", "key1", "key2"]))
+        thread.join()
+
 
 class PrefixTCPStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -817,6 +858,40 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [torch.tensor([i + self.rank]).cuda() for i in range(1000)]
         self._test_allreduce_stress(inputs)
 
+    def test_allreduce_hierarchical(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts()
+        opts.hierarchical_allreduce = True
+        # Pretend that every pair of processes runs on its own host.
+        opts.hostname = "host%d" % (self.rank // 2)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Sizes below, at, and above (and not a multiple of) the number of
+        # processes per host, including one that falls back to a flat
+        # allreduce.
+        for numel in [1, 2, 7, 1000]:
+            for (op, expected) in [
+                (c10d.ReduceOp.SUM, sum(range(1, self.world_size + 1))),
+                (c10d.ReduceOp.MAX, self.world_size),
+                (c10d.ReduceOp.MIN, 1),
+            ]:
+                opts = c10d.AllreduceOptions()
+                opts.reduceOp = op
+                tensor = torch.arange(numel, dtype=torch.float) + self.rank + 1
+                pg.allreduce([tensor], opts).wait()
+                if op == c10d.ReduceOp.SUM:
+                    base = torch.arange(numel, dtype=torch.float) * self.world_size
+                else:
+                    base = torch.arange(numel, dtype=torch.float)
+                self.assertEqual(base + expected, tensor)
+
+        # Multiple inputs are combined before the allreduce.
+        tensors = [torch.full((10,), float(self.rank + i)) for i in range(2)]
+        pg.allreduce(tensors).wait()
+        expected = sum(2 * r + 1 for r in range(self.world_size))
+        for tensor in tensors:
+            self.assertEqual(torch.full((10,), float(expected)), tensor)
+
     def test_allreduce_coalesced_checks(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -1545,6 +1620,160 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
             del pg
 
 
+@unittest.skipIf(TEST_WITH_TSAN, "TSAN is not fork-safe since we're forking in a multi-threaded environment")
+class ProcessGroupShmTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ProcessGroupShmTest, self).setUp()
+        self._fork_processes()
+
+    def _create_process_group(self, buffer_size=None, channel_size=None):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = c10d.ProcessGroupShm.Options()
+        opts.timeout = 5.0
+        if buffer_size is not None:
+            opts.buffer_size = buffer_size
+        if channel_size is not None:
+            opts.channel_size = channel_size
+        return c10d.ProcessGroupShm(store, self.rank, self.world_size, opts)
+
+    def test_allreduce_basics(self):
+        pg = self._create_process_group()
+        for (op, input, output) in simple_reduce_tests(self.rank, self.world_size):
+            opts = c10d.AllreduceOptions()
+            opts.reduceOp = op
+            tensor = input.clone()
+            pg.allreduce([tensor], opts).wait()
+            self.assertEqual(output, tensor)
+
+    def test_allreduce_chunked(self):
+        # The tensors span several buffers, and their sizes don't divide
+        # evenly by the number of processes.
+        pg = self._create_process_group(buffer_size=64)
+        for numel in [1, 3, 16, 17, 1001]:
+            tensor = torch.arange(numel, dtype=torch.double) + self.rank
+            pg.allreduce(tensor).wait()
+            expected = (torch.arange(numel, dtype=torch.double) * self.world_size +
+                        sum(range(self.world_size)))
+            self.assertEqual(expected, tensor)
+
+    def test_allreduce_non_contiguous(self):
+        pg = self._create_process_group(buffer_size=64)
+        tensor = torch.full((10, 10), float(self.rank + 1)).t()
+        pg.allreduce(tensor).wait()
+        self.assertEqual(
+            torch.full((10, 10), float(sum(range(1, self.world_size + 1)))),
+            tensor)
+
+    def test_reduce(self):
+        pg = self._create_process_group(buffer_size=64)
+        for root in range(self.world_size):
+            tensor = torch.full((100,), float(self.rank + 1))
+            opts = c10d.ReduceOptions()
+            opts.rootRank = root
+            pg.reduce([tensor], opts).wait()
+            if self.rank == root:
+                expected = float(sum(range(1, self.world_size + 1)))
+            else:
+                expected = float(self.rank + 1)
+            self.assertEqual(torch.full((100,), expected), tensor)
+
+    def test_broadcast(self):
+        pg = self._create_process_group(buffer_size=64)
+        for root in range(self.world_size):
+            tensor = torch.full((100,), float(self.rank))
+            pg.broadcast(tensor, root=root).wait()
+            self.assertEqual(torch.full((100,), float(root)), tensor)
+
+    def test_allgather(self):
+        pg = self._create_process_group(buffer_size=64)
+        for numel in [0, 1, 100]:
+            input = torch.full((numel,), float(self.rank))
+            outputs = [torch.empty(numel) for _ in range(self.world_size)]
+            pg.allgather([outputs], [input]).wait()
+            for i, output in enumerate(outputs):
+                self.assertEqual(torch.full((numel,), float(i)), output)
+
+    def test_allgather_checks(self):
+        pg = self._create_process_group()
+        t1 = torch.zeros([1], dtype=torch.float32)
+        t2 = torch.zeros([1], dtype=torch.float64)
+
+        with self.assertRaisesRegex(ValueError, "invalid output tensor list"):
+            pg.allgather([[t1] * (self.world_size - 1)], [t1])
+
+        with self.assertRaisesRegex(ValueError, "invalid tensor type"):
+            pg.allgather([[t2] * self.world_size], [t1])
+
+    def test_barrier_implies_wait(self):
+        pg = self._create_process_group()
+        tensors = [torch.full((100, 100), float(i)) for i in range(16)]
+        for tensor in tensors:
+            pg.allreduce(tensor)
+        pg.barrier().wait()
+        for i, tensor in enumerate(tensors):
+            self.assertEqual(torch.full((100, 100), float(i * self.world_size)), tensor)
+
+    def test_send_recv_all_to_all(self):
+        # Messages are larger than the channel, so that they are streamed.
+        pg = self._create_process_group(channel_size=64)
+        inputs = [torch.full((100,), float(self.rank)) for _ in range(self.world_size)]
+        outputs = [torch.full((100,), -1.0) for _ in range(self.world_size)]
+
+        # Every process sends before it receives, which only completes if
+        # sends don't wait for the matching receives.
+        send_work = [pg.send([inputs[i]], i, 0) for i in range(self.world_size)]
+        recv_work = [pg.recv([outputs[i]], i, 0) for i in range(self.world_size)]
+        for work in send_work:
+            work.wait()
+            self.assertTrue(work.is_completed())
+        for i, work in enumerate(recv_work):
+            work.wait()
+            self.assertEqual(i, work.source_rank())
+        for i in range(self.world_size):
+            self.assertEqual(torch.full((100,), float(i)), outputs[i])
+
+    def test_send_recv_in_order(self):
+        pg = self._create_process_group(channel_size=64)
+        peer = (self.rank + 1) % self.world_size
+        source = (self.rank - 1) % self.world_size
+        send_work = [pg.send([torch.full((i + 1,), float(i))], peer, i) for i in range(10)]
+        for i in range(10):
+            output = torch.empty(i + 1)
+            pg.recv([output], source, i).wait()
+            self.assertEqual(torch.full((i + 1,), float(i)), output)
+        for work in send_work:
+            work.wait()
+
+    def test_recv_mismatch(self):
+        pg = self._create_process_group()
+        peer = (self.rank + 1) % self.world_size
+        source = (self.rank - 1) % self.world_size
+        pg.send([torch.zeros(4)], peer, 1)
+        pg.send([torch.zeros(4)], peer, 2)
+        pg.send([torch.ones(4)], peer, 3)
+
+        with self.assertRaisesRegex(RuntimeError, "expected tag 0"):
+            pg.recv([torch.empty(4)], source, 0).wait()
+        with self.assertRaisesRegex(RuntimeError, "expected 12 bytes"):
+            pg.recv([torch.empty(3)], source, 2).wait()
+
+        # The stream stays in sync after a mismatch.
+        output = torch.empty(4)
+        pg.recv([output], source, 3).wait()
+        self.assertEqual(torch.ones(4), output)
+
+    def test_init_process_group(self):
+        c10d.init_process_group(
+            backend="shm",
+            init_method="file://{}".format(self.file_name),
+            rank=self.rank,
+            world_size=self.world_size)
+        tensor = torch.tensor([float(self.rank)])
+        c10d.all_reduce(tensor)
+        self.assertEqual(torch.tensor([float(sum(range(self.world_size)))]), tensor)
+        c10d.destroy_process_group()
+
+
 @requires_nccl()
 class ProcessGroupNCCLTest(TestCase):
     MAIN_PROCESS_RANK = 0
@@ -2017,6 +2246,77 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         devices = list([torch.device('cuda:' + str(i)) for i in int_devices])
         self._test_gloo_backend(devices, [], multi_device=True)
 
+    def _test_gloo_comm_hook(self, register_hook):
+        """
+        Runs one iteration of a CPU module whose gradients are reduced by a
+        communication hook over Gloo. Returns the gradients of the DDP module
+        and those of the same module run on the global batch without DDP.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        model, ddp_model, input, target = self._prepare_single_device_module(
+            process_group, [torch.device('cpu')], [], self.world_size)
+        register_hook(ddp_model, process_group)
+
+        F.mse_loss(model(input), target).backward()
+        F.mse_loss(
+            ddp_model(input[self.rank:self.rank + 1]),
+            target[self.rank:self.rank + 1]).backward()
+        return ([p.grad for p in ddp_model.parameters()],
+                [p.grad for p in model.parameters()])
+
+    @requires_gloo()
+    def test_gloo_python_comm_hook(self):
+        def allreduce_hook(process_group, bucket):
+            return process_group.allreduce(bucket.tensors).get_future()
+
+        grads, expected = self._test_gloo_comm_hook(
+            lambda ddp, pg: ddp.register_comm_hook(pg, allreduce_hook))
+        for grad, expected_grad in zip(grads, expected):
+            self.assertEqual(grad, expected_grad)
+
+    @requires_gloo()
+    def test_gloo_fp16_compress_hook(self):
+        grads, expected = self._test_gloo_comm_hook(
+            lambda ddp, pg: ddp.register_builtin_comm_hook('fp16'))
+        for grad, expected_grad in zip(grads, expected):
+            self.assertEqual(grad.dtype, torch.float)
+            self.assertEqual(grad, expected_grad, atol=1e-3, rtol=1e-2)
+
+    @requires_gloo()
+    def test_gloo_topk_compress_hook(self):
+        ratio = 0.1
+        grads, expected = self._test_gloo_comm_hook(
+            lambda ddp, pg: ddp.register_builtin_comm_hook('topk', ratio=ratio))
+        # Every process sends at most the `ratio` largest values of a bucket,
+        # and what it sends is averaged.
+        numel = sum(grad.numel() for grad in grads)
+        nonzero = sum(int((grad != 0).sum()) for grad in grads)
+        self.assertLessEqual(nonzero, self.world_size * math.ceil(ratio * numel))
+        self.assertGreater(nonzero, 0)
+
+    @requires_gloo()
+    def test_gloo_topk_compress_hook_all_values(self):
+        grads, expected = self._test_gloo_comm_hook(
+            lambda ddp, pg: ddp.register_builtin_comm_hook('topk', ratio=1.0))
+        for grad, expected_grad in zip(grads, expected):
+            self.assertEqual(grad, expected_grad)
+
+    @requires_gloo()
+    def test_gloo_powersgd_hook(self):
+        grads, expected = self._test_gloo_comm_hook(
+            lambda ddp, pg: ddp.register_builtin_comm_hook(
+                'powersgd', matrix_approximation_rank=1))
+        for grad, expected_grad in zip(grads, expected):
+            self.assertEqual(grad.size(), expected_grad.size())
+            # Every weight of Net is large enough to be compressed, so its
+            # gradient is a rank 1 approximation of the expected one.
+            singular_values = torch.svd(grad)[1]
+            self.assertLessEqual(
+                float(singular_values[1:].max()), 1e-5 * float(singular_values[0]))
+            self.assertLess(
+                float((grad - expected_grad).norm()), float(expected_grad.norm()))
+
     def _test_nccl_backend(self, devices, device_ids, multi_device=False):
         store = c10d.FileStore(self.file_name, self.world_size)
         process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -3046,6 +3346,47 @@ class ReducerTest(TestCase):
         # is considered being globally unused, it will be kept untouched as None.
         self.assertEqual(None, model.fc3.weight.grad)
 
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        # Buckets in forward order, which is the reverse of the order in
+        # which the gradients are ready.
+        parameters = list(model.parameters())
+        reducer = dist.Reducer(
+            [parameters], [[i] for i in range(len(parameters))],
+            self.process_group)
+        loss = nn.CrossEntropyLoss()
+
+        # Nothing to rebuild from before the first backward pass.
+        self.assertFalse(reducer._rebuild_buckets())
+        for i in range(3):
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            expected_model = copy.deepcopy(model)
+            expected_output = loss(expected_model(input), target)
+            expected_output.backward()
+
+            # The buckets are rebuilt once, after the first iteration.
+            self.assertEqual(reducer._rebuild_buckets(), i == 1)
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            for parameter, expected in zip(model.parameters(), expected_model.parameters()):
+                self.assertEqual(parameter.grad, expected.grad)
+
+            stats = reducer.get_overlap_stats()
+            self.assertGreaterEqual(stats['overlap_ratio'], 0)
+            self.assertLess(stats['overlap_ratio'], 1)
+            self.assertGreaterEqual(stats['wait_time'], 0)
+            # The last bucket is kicked off once the last gradient is ready.
+            self.assertGreaterEqual(
+                max(stats['bucket_launch_times']), stats['backward_time'])
+            # One bucket per parameter, then one per dtype.
+            self.assertEqual(
+                len(stats['bucket_launch_times']), len(parameters) if i == 0 else 2)
+            for parameter in model.parameters():
+                parameter.grad = None
+
     def test_forward_backward_optimizer(self):
         batch_size = 10
         model = self._create_mixed_precision_model()
@@ -10,6 +10,7 @@ from typing import NamedTuple
 pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
 sys.path.append(pytorch_test_dir)
 from torch.testing._internal.jit_utils import JitTestCase, clear_class_registry
+from torch.testing._internal.common_utils import TemporaryFileName
 
 if __name__ == "__main__":
     raise RuntimeError(
@@ -395,3 +396,66 @@ class TestSaveLoad(JitTestCase):
         torch.jit.save(sm, contains_both)
         contains_both.seek(0)
         sm = torch.jit.load(contains_both)
+
+    def test_load_mmap(self):
+        class Linear(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.weight = torch.nn.Parameter(torch.randn(64, 32))
+
+            def forward(self, x):
+                return torch.mm(x, self.weight.t())
+
+        m = torch.jit.script(Linear())
+        x = torch.randn(3, 32)
+        with TemporaryFileName() as fname:
+            torch.jit.save(m, fname)
+            loaded = torch.jit.load(fname, mmap=True)
+            self.assertEqual(loaded(x), m(x))
+
+            # Writes land in private copies of the mapped pages.
+            with torch.no_grad():
+                loaded.weight.zero_()
+            reloaded = torch.jit.load(fname)
+            self.assertEqual(reloaded.weight, m.weight)
+            # Unmap the file before it is removed.
+            del loaded
+
+            with self.assertRaisesRegex(ValueError, "file name"):
+                with open(fname, 'rb') as f:
+                    torch.jit.load(f, mmap=True)
+
+    def test_save_load_compressed(self):
+        class Buffers(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.register_buffer("zeros", torch.zeros(10000))
+                self.register_buffer("noise", torch.randn(10000))
+                self.register_buffer("small", torch.ones(10))
+
+            def forward(self):
+                return self.zeros + self.noise
+
+        m = torch.jit.script(Buffers())
+        plain = io.BytesIO()
+        torch.jit.save(m, plain)
+        compressed = io.BytesIO()
+        torch.jit.save(m, compressed, compression_level=6)
+        self.assertLess(len(compressed.getvalue()), len(plain.getvalue()))
+
+        compressed.seek(0)
+        loaded = torch.jit.load(compressed)
+        self.assertEqual(loaded.zeros, m.zeros)
+        self.assertEqual(loaded.noise, m.noise)
+        self.assertEqual(loaded.small, m.small)
+        self.assertEqual(loaded(), m())
+
+        # Tensors that were left uncompressed can still be mapped.
+        with TemporaryFileName() as fname:
+            torch.jit.save(m, fname, compression_level=6)
+            loaded = torch.jit.load(fname, mmap=True)
+            self.assertEqual(loaded(), m())
+            del loaded
+
+        with self.assertRaisesRegex(RuntimeError, "Invalid compression_level 11"):
+            torch.jit.save(m, io.BytesIO(), compression_level=11)
@@ -2831,6 +2831,66 @@ class TestQNNPackOps(TestCase):
     def test_qhardsigmoid(self, X):
         _test_hardsigmoid(self, X, 'qnnpack')
 
+class TestQuantizedEmbeddingBag(TestCase):
+    def _test_embedding_bag(self, bit_rate, num_levels, scripted):
+        prepack = getattr(torch.ops.quantized, 'embedding_bag_{}_prepack'.format(bit_rate))
+        unpack = getattr(torch.ops.quantized, 'embedding_bag_{}_unpack'.format(bit_rate))
+        embedding_bag = getattr(torch.ops.quantized, 'embedding_bag_{}'.format(bit_rate))
+
+        weight = torch.randn(100, 16)
+        packed = prepack(weight)
+        self.assertEqual(packed.dtype, torch.uint8)
+        unpacked = unpack(packed)
+        self.assertEqual(unpacked.shape, weight.shape)
+        # Row-wise quantization is off by at most half a step per element,
+        # plus some slack for the half precision scale of the 4-bit format.
+        step = (weight.max(dim=1, keepdim=True)[0] - weight.min(dim=1, keepdim=True)[0]) / (num_levels - 1)
+        self.assertTrue(((unpacked - weight).abs() <= step * 0.51 + 1e-3).all())
+
+        indices = torch.randint(0, 100, (25,))
+        offsets = torch.tensor([0, 3, 3, 10, 19])
+        per_sample_weights = torch.rand(25)
+        for index_dtype in (torch.int32, torch.int64):
+            for mode, mode_id in (('sum', 0), ('mean', 1)):
+                ref = F.embedding_bag(indices, unpacked, offsets, mode=mode)
+                out = embedding_bag(packed, indices.to(index_dtype), offsets, mode=mode_id)
+                self.assertEqual(out, ref)
+
+            ref = F.embedding_bag(indices, unpacked, offsets, mode='sum',
+                                  per_sample_weights=per_sample_weights)
+            out = embedding_bag(packed, indices.to(index_dtype), offsets,
+                                per_sample_weights=per_sample_weights)
+            self.assertEqual(out, ref)
+
+        # include_last_offset, and fixed-size bags given as 2D indices
+        out = embedding_bag(packed, indices, torch.tensor([0, 3, 3, 10, 19, 25]),
+                            include_last_offset=True)
+        self.assertEqual(out, F.embedding_bag(indices, unpacked, offsets, mode='sum'))
+        out = embedding_bag(packed, indices.view(5, 5))
+        self.assertEqual(out, F.embedding_bag(indices.view(5, 5), unpacked, mode='sum'))
+
+        with self.assertRaises(RuntimeError):
+            embedding_bag(packed, torch.tensor([100]), torch.tensor([0]))
+        with self.assertRaises(RuntimeError):
+            embedding_bag(packed, indices, offsets, mode=2)
+
+        # Usable from TorchScript
+        self.assertEqual(scripted(weight, indices, offsets), embedding_bag(packed, indices, offsets))
+
+    def test_embedding_bag_byte(self):
+        @torch.jit.script
+        def scripted(weight, indices, offsets):
+            packed = torch.ops.quantized.embedding_bag_byte_prepack(weight)
+            return torch.ops.quantized.embedding_bag_byte(packed, indices, offsets)
+        self._test_embedding_bag('byte', 256, scripted)
+
+    def test_embedding_bag_4bit(self):
+        @torch.jit.script
+        def scripted(weight, indices, offsets):
+            packed = torch.ops.quantized.embedding_bag_4bit_prepack(weight)
+            return torch.ops.quantized.embedding_bag_4bit(packed, indices, offsets)
+        self._test_embedding_bag('4bit', 16, scripted)
+
 """Tests the correctness of the tensor comparators."""
 class TestComparatorOps(TestCase):
     """Tests the element-wise equality ops."""
@@ -51,6 +51,7 @@ TESTS = [
     'test_numba_integration',
     'test_optim',
     'test_mobile_optimizer',
+    'test_static_runtime',
     'quantization/test_fake_quant',
     'quantization/test_numerics',
     'quantization/test_qat',
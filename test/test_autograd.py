@@ -2764,6 +2764,58 @@ class TestAutograd(TestCase):
         self.assertTrue('cpu' in prof_str.lower())
         self.assertTrue('cuda' not in prof_str.lower())
 
+    @unittest.skipIf(IS_WINDOWS, """File open permission error on Windows,
+            https://github.com/pytorch/pytorch/issues/34086""")
+    def test_sampling_profiler(self):
+        x = torch.randn(5, 7)
+        y = torch.randn(7, 3)
+        with torch.autograd.profiler.sampling_profile(
+                sampling_rate=1.0, record_shapes=True) as prof:
+            self.assertTrue(torch.autograd._sampling_profiler_enabled())
+            for _ in range(10):
+                x.mm(y)
+            profile = prof.flush()
+            # Flushing drains the buffers.
+            self.assertEqual(prof.flush().events(), [])
+            for _ in range(3):
+                x.mm(y)
+        self.assertFalse(torch.autograd._sampling_profiler_enabled())
+
+        self.assertEqual(profile.sampling_rate, 1.0)
+        self.assertEqual(profile.num_dropped, 0)
+        mm_stats = [s for s in profile.stats() if s['stack'] == ['mm']]
+        self.assertEqual(len(mm_stats), 1)
+        self.assertEqual(mm_stats[0]['count'], 10)
+        # The shapes are rounded up to powers of two.
+        self.assertEqual(mm_stats[0]['shapes'], '[[8, 8], [8, 4]]')
+        self.assertLessEqual(mm_stats[0]['min_ns'], mm_stats[0]['max_ns'])
+        self.assertEqual(
+            len([e for e in profile.events() if e['stack'][-1] == 'mm']), 10)
+        self.assertEqual(
+            len([e for e in prof.profile.events() if e['stack'][-1] == 'mm']), 3)
+
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            profile.export_chrome_trace(f.name)
+            trace = json.load(f)
+            self.assertEqual(len(trace['traceEvents']), len(profile.events()))
+        with tempfile.NamedTemporaryFile(mode="rb") as f:
+            profile.export_pprof(f.name)
+            self.assertIn(b'mm', f.read())
+
+        # Few samples when sampling.
+        with torch.autograd.profiler.sampling_profile(sampling_rate=0.01) as prof:
+            for _ in range(100):
+                x.mm(y)
+        self.assertLess(len(prof.profile.events()), 100)
+
+        # A full buffer drops samples.
+        with torch.autograd.profiler.sampling_profile(
+                sampling_rate=1.0, buffer_size=4) as prof:
+            for _ in range(10):
+                x.mm(y)
+        self.assertEqual(len(prof.profile.events()), 4)
+        self.assertGreater(prof.profile.num_dropped, 0)
+
     def test_profiler_aggregation_lstm(self):
         print("")
         rnn = torch.nn.LSTM(10, 20, 2)
@@ -3358,6 +3410,203 @@ for shape in [(1,), ()]:
         s = TestCase.runWithPytorchAPIUsageStderr(code)
         self.assertRegex(s, "PYTORCH_API_USAGE torch.autograd.thread_shutdown")
 
+    def test_long_chain_backward_order(self):
+        # The engine runs a node's only ready successor inline instead of
+        # queueing it; the nodes must still run once each, in order.
+        order = []
+
+        class Record(Function):
+            @staticmethod
+            def forward(ctx, x, i):
+                ctx.i = i
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                order.append(ctx.i)
+                return grad, None
+
+        x = torch.ones(1, requires_grad=True)
+        y = x
+        n = 5000
+        for i in range(n):
+            y = Record.apply(y, i)
+        # A second path to x, so that not every node has a single successor.
+        (y + x).sum().backward()
+        self.assertEqual(order, list(reversed(range(n))))
+        self.assertEqual(x.grad, torch.full((1,), 2.))
+
+    def test_parallel_cpu_backward(self):
+        torch.manual_seed(0)
+        x = torch.randn(64, 64, requires_grad=True)
+        ws = [torch.randn(64, 64, requires_grad=True) for _ in range(8)]
+
+        def run():
+            x.grad = None
+            for w in ws:
+                w.grad = None
+            # Independent branches that all accumulate into x.grad.
+            out = sum((x.mm(w).tanh() * (i + 1)).sum() for i, w in enumerate(ws))
+            out.backward()
+            return [x.grad.clone()] + [w.grad.clone() for w in ws]
+
+        expected = run()
+        with torch.autograd.set_cpu_backward_threads(4):
+            self.assertEqual(torch._C._get_num_cpu_backward_threads(), 4)
+            results = [run() for _ in range(5)]
+        self.assertEqual(torch._C._get_num_cpu_backward_threads(), 0)
+
+        for result in results:
+            self.assertEqual(result, expected)
+            # The summation order does not depend on the thread timing.
+            for a, b in zip(result, results[0]):
+                self.assertTrue(torch.equal(a, b))
+
+        # Errors, and reentrant backward calls from a worker, still work.
+        class Reentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                ctx.save_for_backward(x)
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                x, = ctx.saved_tensors
+                with torch.enable_grad():
+                    y = x.detach().requires_grad_()
+                    (y * y).sum().backward()
+                return grad * y.grad
+
+        class Fail(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                raise RuntimeError("Simulate error")
+
+        with torch.autograd.set_cpu_backward_threads(2):
+            a = torch.rand(5, requires_grad=True)
+            (Reentrant.apply(a).sum() + (a * 3).sum()).backward()
+            self.assertEqual(a.grad, 2 * a.detach() + 3)
+
+            with self.assertRaisesRegex(RuntimeError, "Simulate error"):
+                (Fail.apply(a).sum() + (a * 3).sum()).backward()
+
+        with self.assertRaises(RuntimeError):
+            torch._C._set_num_cpu_backward_threads(-1)
+
+    def test_parallel_cpu_backward_checkpoint(self):
+        # The reentrant backward of checkpoint runs its nodes on the thread
+        # that calls it, so the sums within it are deterministic too.
+        torch.manual_seed(0)
+        x = torch.randn(32, 32, requires_grad=True)
+        ws = [torch.randn(32, 32, requires_grad=True) for _ in range(8)]
+
+        def segment(inp, *weights):
+            # Independent branches that all accumulate into inp's gradient.
+            return sum((inp.mm(w).tanh() * (i + 1)) for i, w in enumerate(weights))
+
+        def run():
+            x.grad = None
+            for w in ws:
+                w.grad = None
+            outs = [checkpoint(segment, x * (i + 1), *ws) for i in range(4)]
+            sum(out.sum() for out in outs).backward()
+            return [x.grad.clone()] + [w.grad.clone() for w in ws]
+
+        expected = run()
+        with torch.autograd.set_cpu_backward_threads(4):
+            results = [run() for _ in range(10)]
+
+        for result in results:
+            self.assertEqual(result, expected)
+            for a, b in zip(result, results[0]):
+                self.assertTrue(torch.equal(a, b))
+
+    def test_saved_tensor_budget(self):
+        def forward(x, w):
+            # neg() does not save its input, so once it ran the result of
+            # softmax is only used by SoftmaxBackward.
+            return x.matmul(w).softmax(-1).neg().matmul(w).log_softmax(-1)
+
+        def run(budget=None):
+            torch.manual_seed(0)
+            x = torch.randn(4, 16, 16, requires_grad=True)
+            w = torch.randn(16, 16, requires_grad=True)
+            if budget is None:
+                out = forward(x, w)
+            else:
+                with budget:
+                    out = forward(x, w)
+            out.sum().backward()
+            return x.grad, w.grad
+
+        x_grad, w_grad = run()
+
+        # Without a budget, the pool only measures.
+        measure = torch.autograd.saved_tensor_budget(-1)
+        self.assertEqual(run(measure), (x_grad, w_grad))
+        stats = measure.stats()
+        self.assertEqual(stats['num_recomputable'], 2)
+        self.assertEqual(stats['num_dropped'], 0)
+        self.assertGreater(stats['peak_bytes'], 0)
+        # The graph is gone, and so are the saved tensors.
+        self.assertEqual(stats['saved_bytes'], 0)
+
+        # The result of softmax is dropped and recomputed. The one of
+        # log_softmax is not, as `out` still refers to it.
+        budget = torch.autograd.saved_tensor_budget(0)
+        with torch.autograd.profiler.profile() as prof:
+            self.assertEqual(run(budget), (x_grad, w_grad))
+        stats = budget.stats()
+        self.assertEqual(stats['num_dropped'], 1)
+        self.assertEqual(stats['num_recomputed'], 1)
+        self.assertLess(stats['peak_bytes'], measure.stats()['peak_bytes'])
+        names = [evt.name for evt in prof.function_events]
+        self.assertEqual(names.count('autograd::recompute_saved_tensor'), 1)
+
+        # Tensors sharing a storage are counted once.
+        a = torch.randn(64, requires_grad=True)
+        measure = torch.autograd.saved_tensor_budget(-1)
+        with measure:
+            out = (a * a[:32].repeat(2)).sum() + (a * a).sum()
+        self.assertEqual(measure.stats()['saved_bytes'], 2 * 64 * 4)
+
+        # A saved output that is still used elsewhere is kept.
+        x = torch.randn(8, 8, requires_grad=True)
+        budget = torch.autograd.saved_tensor_budget(0)
+        with budget:
+            y = x.softmax(0)
+            out = y.exp().sum()
+        self.assertEqual(budget.stats()['num_dropped'], 0)
+        del y
+
+        # Backward twice through a retained graph recomputes again.
+        budget = torch.autograd.saved_tensor_budget(0)
+        with budget:
+            out = x.softmax(0).neg().exp().sum()
+        self.assertEqual(budget.stats()['num_dropped'], 1)
+        g, = torch.autograd.grad(out * 2, x, retain_graph=True)
+        self.assertEqual(torch.autograd.grad(out * 2, x)[0], g)
+        self.assertEqual(budget.stats()['num_recomputed'], 2)
+
+        self.assertIsNone(torch.autograd._get_saved_tensor_pool())
+
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    def test_saved_tensor_budget_offload(self):
+        x = torch.randn(64, 64, device='cuda', requires_grad=True)
+        expected, = torch.autograd.grad(x.mm(x).tanh().sum(), x)
+
+        budget = torch.autograd.saved_tensor_budget(0, offload=True)
+        with budget:
+            out = x.mm(x).tanh().sum()
+        self.assertEqual(torch.autograd.grad(out, x)[0], expected)
+        stats = budget.stats()
+        self.assertGreater(stats['num_offloaded'], 0)
+        self.assertEqual(stats['num_reloaded'], stats['num_offloaded'])
+
     @unittest.skipIf(IS_MACOS, "Fails with SIGBUS on macOS; https://github.com/pytorch/pytorch/issues/25941")
     def test_deep_reentrant(self):
 
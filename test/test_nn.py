@@ -49,7 +49,7 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
     ctcloss_reference, new_module_tests
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
-    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA
+    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, onlyCPU
 
 from torch.nn import MultiheadAttention
 
@@ -10143,6 +10143,70 @@ class TestNNDeviceType(NNTestCase):
                     itertools.product(dtypes, modes, sparsity, trainable_scale):
                 run_tests(dtype, mode, sparse, trainable_per_sample_weights)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_EmbeddingBag_scale_grad_by_freq(self, device, dtype):
+        # Every bag holds a single index, so the gradient must match the one
+        # of nn.Embedding, which scales by the frequency of each index.
+        N, D, B = 11, 7, 1500
+        es = nn.EmbeddingBag(N, D, mode='sum', scale_grad_by_freq=True).to(device, dtype)
+        e = nn.Embedding(N, D, scale_grad_by_freq=True).to(device, dtype)
+        e.weight.data.copy_(es.weight)
+        input = torch.randint(N, (B,), device=device, dtype=torch.long)
+        offsets = torch.arange(0, B, device=device, dtype=torch.long)
+        grad_output = torch.rand(B, D, device=device, dtype=dtype)
+
+        es(input, offsets).backward(grad_output)
+        e(input).backward(grad_output)
+        self.assertEqual(es.weight.grad, e.weight.grad, dtype2prec_DONTUSE[dtype])
+
+    @onlyCPU
+    def test_EmbeddingBag_noncontiguous_weight(self, device):
+        # Strided weights bypass the fast path and use the per-bag kernels, so
+        # compare them against bags reduced by hand from F.embedding.
+        weight = torch.randn(10, 6, dtype=torch.double, device=device)
+        input = torch.randint(10, (17,), dtype=torch.long, device=device)
+        offsets = torch.tensor([0, 3, 3, 9, 17], dtype=torch.long, device=device)
+        per_sample_weights = torch.rand(17, dtype=torch.double, device=device)
+        grad_output = torch.randn(4, 6, dtype=torch.double, device=device)
+        bounds = offsets.tolist()
+        for mode in ('sum', 'mean', 'max'):
+            strided_weight = weight.t().contiguous().t().requires_grad_()
+            self.assertFalse(strided_weight.is_contiguous())
+            psw = per_sample_weights if mode == 'sum' else None
+            actual = F.embedding_bag(input, strided_weight, offsets, mode=mode,
+                                     per_sample_weights=psw, include_last_offset=True)
+            actual.backward(grad_output)
+
+            ref_weight = weight.clone().requires_grad_()
+            embedded = F.embedding(input, ref_weight)
+            bags = []
+            for begin, end in zip(bounds[:-1], bounds[1:]):
+                rows = embedded[begin:end]
+                if begin == end:
+                    bags.append(torch.zeros(6, dtype=torch.double, device=device))
+                elif mode == 'sum':
+                    bags.append((rows * per_sample_weights[begin:end].unsqueeze(1)).sum(0))
+                elif mode == 'mean':
+                    bags.append(rows.mean(0))
+                else:
+                    bags.append(rows.max(0)[0])
+            expected = torch.stack(bags)
+            expected.backward(grad_output)
+
+            self.assertEqual(actual.size(), (4, 6))
+            self.assertEqual(expected, actual)
+            self.assertEqual(ref_weight.grad, strided_weight.grad)
+
+    @onlyCPU
+    def test_EmbeddingBag_decreasing_offsets(self, device):
+        weight = torch.randn(10, 6, dtype=torch.double, device=device).t().contiguous().t()
+        input = torch.randint(10, (8,), dtype=torch.long, device=device)
+        offsets = torch.tensor([0, 5, 3], dtype=torch.long, device=device)
+        for mode in ('sum', 'mean', 'max'):
+            with self.assertRaisesRegex(RuntimeError, "offsets must be non-decreasing"):
+                F.embedding_bag(input, weight, offsets, mode=mode)
+
     def _test_EmbeddingBag(self, device, mode, sparse, dtype=torch.double, test_backward=True):
         # check a known test example
         es = nn.EmbeddingBag(5, 2, mode=mode, sparse=sparse).to(device, dtype)
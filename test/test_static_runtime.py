@@ -0,0 +1,141 @@
+import threading
+
+import torch
+from torch import nn
+from torch.testing._internal.common_utils import TestCase, run_tests
+
+
+class StaticRuntime(object):
+    def __init__(self, scripted):
+        if hasattr(scripted, "_c"):
+            self.static_runtime = torch._C._jit_to_static_runtime(scripted._c)
+        else:
+            self.static_runtime = torch._C._jit_to_static_runtime(scripted.graph)
+
+    def __call__(self, *inputs):
+        return self.static_runtime.run(list(inputs))
+
+    def num_managed_tensors(self):
+        return self.static_runtime.num_managed_tensors()
+
+    def managed_bytes(self):
+        return self.static_runtime.managed_bytes()
+
+
+# nn.Linear branches on the input rank, so the layers are spelled out with
+# addmm to keep the graph straight-line.
+class MLP(nn.Module):
+    def __init__(self):
+        super(MLP, self).__init__()
+        self.w1 = nn.Parameter(torch.randn(8, 16))
+        self.b1 = nn.Parameter(torch.randn(16))
+        self.w2 = nn.Parameter(torch.randn(16, 4))
+        self.b2 = nn.Parameter(torch.randn(4))
+
+    def forward(self, x):
+        x = torch.relu(torch.addmm(self.b1, x, self.w1))
+        return torch.relu(torch.addmm(self.b2, x, self.w2))
+
+
+def residual(a, b, c):
+    d = torch.mm(a, b) + c
+    e = torch.sigmoid(d) * d
+    f = torch.tanh(e) - d
+    return torch.cat([e, f], dim=1), f.exp()
+
+
+class TestStaticRuntime(TestCase):
+    def test_function(self):
+        scripted = torch.jit.script(residual)
+        runtime = StaticRuntime(scripted)
+        for _ in range(3):
+            a, b, c = torch.randn(4, 5), torch.randn(5, 6), torch.randn(4, 6)
+            expected = residual(a, b, c)
+            actual = runtime(a, b, c)
+            self.assertEqual(len(actual), 2)
+            for x, y in zip(expected, actual):
+                self.assertEqual(x, y)
+        # d, e and f are only used inside the graph, so they live in the arena.
+        self.assertGreater(runtime.num_managed_tensors(), 0)
+        self.assertGreater(runtime.managed_bytes(), 0)
+
+    def test_module(self):
+        model = torch.jit.script(MLP()).eval()
+        runtime = StaticRuntime(model)
+        x = torch.randn(3, 8)
+        with torch.no_grad():
+            expected = model(x)
+        for _ in range(3):
+            self.assertEqual(runtime(x)[0], expected)
+
+    def test_arena_reuse(self):
+        scripted = torch.jit.script(residual)
+        runtime = StaticRuntime(scripted)
+        small = (torch.randn(2, 3), torch.randn(3, 4), torch.randn(2, 4))
+        large = (torch.randn(8, 3), torch.randn(3, 4), torch.randn(8, 4))
+
+        runtime(*small)
+        small_bytes = runtime.managed_bytes()
+        runtime(*large)
+        large_bytes = runtime.managed_bytes()
+        self.assertGreater(large_bytes, small_bytes)
+
+        # Shrinking the inputs keeps the larger arena.
+        for x, y in zip(residual(*small), runtime(*small)):
+            self.assertEqual(x, y)
+        self.assertEqual(runtime.managed_bytes(), large_bytes)
+
+    def test_outputs_not_overwritten(self):
+        scripted = torch.jit.script(residual)
+        runtime = StaticRuntime(scripted)
+        a, b, c = torch.randn(4, 5), torch.randn(5, 6), torch.randn(4, 6)
+        first = runtime(a, b, c)
+        first_copy = [t.clone() for t in first]
+        runtime(torch.randn(4, 5), torch.randn(5, 6), torch.randn(4, 6))
+        for x, y in zip(first, first_copy):
+            self.assertEqual(x, y)
+
+    def test_concurrent_runs(self):
+        # run() releases the GIL; runs on the same runtime are serialized.
+        scripted = torch.jit.script(residual)
+        runtime = StaticRuntime(scripted)
+        inputs = [(torch.randn(4, 5), torch.randn(5, 6), torch.randn(4, 6))
+                  for _ in range(4)]
+        results = [None] * len(inputs)
+
+        def worker(i):
+            for _ in range(20):
+                results[i] = [t.clone() for t in runtime(*inputs[i])]
+
+        threads = [threading.Thread(target=worker, args=(i,))
+                   for i in range(len(inputs))]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for args, actual in zip(inputs, results):
+            for x, y in zip(residual(*args), actual):
+                self.assertEqual(x, y)
+
+    def test_matmul(self):
+        def f(a, b):
+            return torch.matmul(a, b).relu() + 1
+
+        runtime = StaticRuntime(torch.jit.script(f))
+        a, b = torch.randn(3, 4, 5), torch.randn(5, 6)
+        for _ in range(3):
+            self.assertEqual(runtime(a, b)[0], f(a, b))
+
+    def test_control_flow_rejected(self):
+        @torch.jit.script
+        def branchy(x, flag: bool):
+            if flag:
+                x = x + 1
+            return x
+
+        with self.assertRaisesRegex(RuntimeError, "straight-line"):
+            StaticRuntime(branchy)
+
+
+if __name__ == "__main__":
+    run_tests()
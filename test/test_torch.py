@@ -4708,6 +4708,15 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
     def test_parallel_info(self):
         torch.__config__.parallel_info()
 
+    def test_intraop_affinity(self):
+        affinity = torch.get_intraop_affinity()
+        self.assertIn(affinity, ('none', 'core', 'numa'))
+        with self.assertRaisesRegex(ValueError, "expects 'none', 'core' or 'numa'"):
+            torch.set_intraop_affinity('socket')
+        # Setting the current placement is always allowed.
+        torch.set_intraop_affinity(affinity)
+        self.assertEqual(torch.get_intraop_affinity(), affinity)
+
     @slowTest
     def test_slow_test(self):
         # Just a smoketest to make sure our slowTest decorator works.
@@ -11828,6 +11837,28 @@ class TestTorchDeviceType(TestCase):
         nz = x.nonzero()
         self.assertFalse(nz.requires_grad)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @onlyCPU
+    def test_nonzero_masked_large_noncontiguous(self, device):
+        # large enough to be split into several chunks, and laid out so that
+        # the results must still come out in row-major order
+        x = torch.randn(64, 3, 97, device=device)
+        x[x.abs() < 0.5] = 0
+        inputs = [x, x.transpose(0, 2), x[:, 1], x[::2, :, ::3],
+                  x.unsqueeze(-1).contiguous(memory_format=torch.channels_last)]
+        for t in inputs:
+            expected = torch.from_numpy(np.stack(t.numpy().nonzero(), axis=1))
+            self.assertEqual(t.nonzero(), expected)
+
+            mask = t != 0
+            self.assertEqual(t.masked_select(mask), t.contiguous().view(-1)[mask.contiguous().view(-1)])
+
+            source = torch.arange(t.numel(), dtype=t.dtype, device=device)
+            result = torch.zeros_like(t).masked_scatter_(mask, source)
+            expected = torch.zeros(t.numel(), dtype=t.dtype, device=device)
+            expected[mask.contiguous().view(-1)] = source[:int(mask.sum())]
+            self.assertEqual(result, expected.view(t.shape))
+
     def _brute_pdist(self, inp, p=2):
         """Computes the same as torch.pdist using primitives"""
         n = inp.shape[-2]
@@ -12967,6 +12998,40 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(top1, top2)
         self.assertEqual(idx1, idx2)
 
+    @onlyCPU
+    @dtypes(torch.uint8, torch.int16, torch.int64, torch.float, torch.double)
+    def test_sort_stable(self, device, dtype):
+        # long enough slices to be radix sorted, short ones to be comparison sorted
+        for size in (10, 1000):
+            x = torch.randint(0, 4, (3, size), device=device).to(dtype)
+            for descending in (False, True):
+                values, indices = torch.sort(x, stable=True, descending=descending)
+                self.assertEqual(values, x.gather(1, indices))
+                self.assertEqual(values, torch.sort(x, descending=descending)[0])
+                # equal elements keep their relative order
+                ties = values[:, 1:] == values[:, :-1]
+                self.assertTrue((indices[:, 1:] > indices[:, :-1])[ties].all())
+
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_sort_large_slice(self, device, dtype):
+        # a single slice this long is sorted in parallel across threads
+        x = torch.randn(1 << 17, device=device, dtype=dtype)
+        x[::97] = float('nan')
+        x[1::89] = -0.0
+        num_nan = int(torch.isnan(x).sum())
+        for descending in (False, True):
+            values, indices = torch.sort(x, descending=descending)
+            self.assertEqual(values[~torch.isnan(values)], x[indices][~torch.isnan(values)])
+            expected = torch.from_numpy(np.sort(x[~torch.isnan(x)].numpy()))
+            if descending:
+                self.assertTrue(torch.isnan(values[:num_nan]).all())
+                self.assertEqual(values[num_nan:], expected.flip(0))
+            else:
+                self.assertTrue(torch.isnan(values[-num_nan:]).all())
+                self.assertEqual(values[:-num_nan], expected)
+
     @dtypes(torch.int8, torch.uint8, torch.int16, torch.int32, torch.int64)
     def test_topk_integral(self, device, dtype):
         a = torch.randint(torch.iinfo(dtype).min, torch.iinfo(dtype).max, size=(10,),
@@ -56,6 +56,8 @@ libtorch_core_sources = [
     "torch/csrc/autograd/profiler.cpp",
     "torch/csrc/autograd/record_function.cpp",
     "torch/csrc/autograd/record_function_ops.cpp",
+    "torch/csrc/autograd/sampling_profiler.cpp",
+    "torch/csrc/autograd/saved_tensor_budget.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
     "torch/csrc/autograd/variable.cpp",
     "torch/csrc/jit/api/function_impl.cpp",
@@ -63,6 +65,7 @@ libtorch_core_sources = [
     "torch/csrc/jit/api/object.cpp",
     "torch/csrc/jit/codegen/fuser/codegen.cpp",
     "torch/csrc/jit/codegen/fuser/compiler.cpp",
+    "torch/csrc/jit/codegen/fuser/disk_cache.cpp",
     "torch/csrc/jit/codegen/fuser/executor.cpp",
     "torch/csrc/jit/codegen/fuser/fallback.cpp",
     "torch/csrc/jit/codegen/fuser/interface.cpp",
@@ -242,6 +245,8 @@ libtorch_extra_sources = libtorch_core_jit_sources + [
     "torch/csrc/jit/mobile/module.cpp",
     "torch/csrc/jit/mobile/register_mobile_autograd.cpp",
     "torch/csrc/jit/mobile/register_mobile_ops.cpp",
+    "torch/csrc/jit/runtime/static/impl.cpp",
+    "torch/csrc/jit/runtime/static/ops.cpp",
     "torch/csrc/jit/serialization/export.cpp",
     "torch/csrc/jit/serialization/export_module.cpp",
     "torch/csrc/jit/serialization/import_legacy.cpp",
@@ -391,6 +396,7 @@ def glob_libtorch_python_sources():
         "torch/csrc/autograd/python_variable_indexing.cpp",
         "torch/csrc/distributed/autograd/init.cpp",
         "torch/csrc/distributed/c10d/comm.cpp",
+        "torch/csrc/distributed/c10d/comm_hooks.cpp",
         "torch/csrc/distributed/c10d/init.cpp",
         "torch/csrc/distributed/c10d/reducer.cpp",
         "torch/csrc/distributed/rpc/init.cpp",
@@ -429,6 +435,7 @@ def glob_libtorch_python_sources():
         "torch/csrc/jit/python/python_sugared_value.cpp",
         "torch/csrc/jit/python/python_tree_views.cpp",
         "torch/csrc/jit/runtime/register_distributed_ops.cpp",
+        "torch/csrc/jit/runtime/static/init.cpp",
         "torch/csrc/multiprocessing/init.cpp",
         "torch/csrc/onnx/init.cpp",
         "torch/csrc/serialization.cpp",
@@ -434,6 +434,8 @@ def gen_pyi(declarations_path, out):
         'set_num_threads': ['def set_num_threads(num: _int) -> None: ...'],
         'get_num_interop_threads': ['def get_num_interop_threads() -> _int: ...'],
         'set_num_interop_threads': ['def set_num_interop_threads(num: _int) -> None: ...'],
+        'get_intraop_affinity': ['def get_intraop_affinity() -> str: ...'],
+        'set_intraop_affinity': ['def set_intraop_affinity(affinity: str) -> None: ...'],
         # These functions are explicitly disabled by
         # SKIP_PYTHON_BINDINGS because they are hand bound.
         # Correspondingly, we must hand-write their signatures.
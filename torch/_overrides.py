@@ -49,6 +49,7 @@ def get_ignored_functions():
         torch.set_printoptions,
         torch.fork,
         torch.get_default_dtype,
+        torch.get_intraop_affinity,
         torch.get_num_interop_threads,
         torch.get_num_threads,
         torch.import_ir_module,
@@ -61,6 +62,7 @@ def get_ignored_functions():
         torch.parse_type_comment,
         torch.set_anomaly_enabled,
         torch.set_flush_denormal,
+        torch.set_intraop_affinity,
         torch.set_num_interop_threads,
         torch.set_num_threads,
         torch.wait,
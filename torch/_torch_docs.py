@@ -2443,6 +2443,14 @@ Returns the number of threads used for inter-op parallelism on CPU
 (e.g. in JIT interpreter)
 """)
 
+add_docstr(torch.get_intraop_affinity,
+           r"""
+get_intraop_affinity() -> str
+
+Returns the placement of the threads used for intraop parallelism on CPU:
+``'none'``, ``'core'`` or ``'numa'``. See :func:`torch.set_intraop_affinity`.
+""")
+
 add_docstr(torch.gt,
            r"""
 gt(input, other, out=None) -> Tensor
@@ -5096,6 +5104,21 @@ WARNING: Can only be called once and before any inter-op parallel work
 is started (e.g. JIT execution).
 """)
 
+add_docstr(torch.set_intraop_affinity,
+           r"""
+set_intraop_affinity(str)
+
+Sets the placement of the threads used for intraop parallelism on CPU.
+With ``'none'`` (the default) the threads are left to the OS scheduler,
+with ``'core'`` each of them is pinned to its own core, and with ``'numa'``
+they are also grouped by NUMA node, each node processing a contiguous share
+of a parallel region. Only the native parallel backend pins threads. The
+default can also be set with the ``ATEN_INTRAOP_AFFINITY`` environment
+variable.
+WARNING: Must be called before any intraop parallel work is started; a
+different placement cannot be set afterwards.
+""")
+
 add_docstr(torch.sigmoid,
            r"""
 sigmoid(input, out=None) -> Tensor
@@ -5197,6 +5220,11 @@ If :attr:`dim` is not given, the last dimension of the `input` is chosen.
 If :attr:`descending` is ``True`` then the elements are sorted in descending
 order by value.
 
+If the keyword-only argument :attr:`stable` is ``True`` then the sorting
+routine preserves the order of equivalent elements. When :attr:`stable` is
+given, :attr:`dim` and :attr:`descending` must be passed as keyword arguments
+too. Stable sorting is currently only supported on CPU.
+
 A namedtuple of (values, indices) is returned, where the `values` are the
 sorted values and `indices` are the indices of the elements in the original
 `input` tensor.
@@ -5205,6 +5233,8 @@ Args:
     {input}
     dim (int, optional): the dimension to sort along
     descending (bool, optional): controls the sorting order (ascending or descending)
+    stable (bool, optional): makes the sorting routine stable, which guarantees that the order
+        of equivalent elements is preserved
     out (tuple, optional): the output tuple of (`Tensor`, `LongTensor`) that can
         be optionally given to be used as output buffers
 
@@ -12,6 +12,8 @@ from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
 from .grad_mode import no_grad, enable_grad, set_grad_enabled
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .parallel_mode import set_cpu_backward_threads
+from .memory_budget import saved_tensor_budget
 from . import profiler
 from . import functional
 
@@ -0,0 +1,63 @@
+import torch
+
+
+class saved_tensor_budget(object):
+    r"""Context-manager that puts a budget on the memory used by the tensors
+    saved for the backward pass.
+
+    The tensors that the operations run inside the context save for backward
+    are accounted for, and whenever they exceed :attr:`budget_bytes`, the
+    oldest ones (the ones the backward pass needs last) are evicted:
+
+    * saved outputs that are cheap to recompute from the other tensors their
+      backward saves, such as the result of softmax, log_softmax or softplus,
+      are dropped and recomputed by the backward pass;
+    * then, if :attr:`offload` is ``True``, tensors that are not on the CPU
+      are copied to pinned host memory, and copied back by the backward pass.
+
+    Tensors that can be neither dropped nor offloaded are kept, so the budget
+    is a target rather than a hard limit. Memory is accounted for by storage:
+    saved tensors that share a storage count once, and are only evicted
+    together, once nothing but the saved tensors refers to the storage. For
+    example, the result of softmax is kept while the forward pass still uses
+    it, or while another operation saved it too.
+
+    The time spent recomputing and copying back shows up in the autograd
+    profiler as ``autograd::recompute_saved_tensor`` and
+    ``autograd::reload_saved_tensor``. :meth:`stats` also reports it, together
+    with the peak of the memory used by the saved tensors.
+
+    Arguments:
+        budget_bytes (int): The budget, in bytes. A negative budget never
+            evicts anything, which is still useful to measure the saved tensors.
+        offload (bool, optional): Whether to offload saved tensors to pinned
+            host memory once the tensors that can be recomputed have been
+            dropped. Default: ``False``.
+
+    Example::
+
+        >>> with torch.autograd.saved_tensor_budget(2 ** 30) as budget:
+        ...     loss = model(input).sum()
+        >>> loss.backward()
+        >>> budget.stats()['peak_bytes']
+
+    """
+
+    def __init__(self, budget_bytes, offload=False):
+        self.pool = torch.autograd._SavedTensorPool(budget_bytes, offload)
+
+    def __enter__(self):
+        self.prev = torch.autograd._get_saved_tensor_pool()
+        torch.autograd._set_saved_tensor_pool(self.pool)
+        return self
+
+    def __exit__(self, *args):
+        torch.autograd._set_saved_tensor_pool(self.prev)
+        return False
+
+    def stats(self):
+        r"""Returns a dictionary with the bytes of saved tensors held
+        (``saved_bytes``) and their peak (``peak_bytes``), the number of
+        saved tensors dropped, offloaded, recomputed and reloaded, and the
+        time spent recomputing and reloading them, in microseconds."""
+        return self.pool.stats()
@@ -0,0 +1,44 @@
+import torch
+
+
+class set_cpu_backward_threads(object):
+    r"""Context-manager that sets the number of threads helping to run the CPU
+    part of the backward pass.
+
+    By default, the CPU functions of a backward pass all run on the thread
+    that called :func:`torch.autograd.backward` or :func:`torch.autograd.grad`.
+    With ``num_threads > 0``, that many workers from the inter-op thread pool
+    (see :func:`torch.set_num_interop_threads`) run them too, so independent
+    branches of the graph are computed concurrently. This helps graphs with
+    several branches made of small operations, which do not use the intra-op
+    parallelism well.
+
+    The gradients do not depend on the number of threads: the gradients flowing
+    into a function are always summed in the same order. Reentrant backward
+    calls (a backward call made from a backward function, as in
+    :func:`torch.utils.checkpoint.checkpoint`) run entirely on the thread that
+    makes them.
+
+    It can be used as a context-manager or as a function.
+
+    Arguments:
+        num_threads (int): Number of helper threads, ``0`` to run the CPU part
+                           of the backward pass on the calling thread only.
+
+    Example::
+
+        >>> with torch.autograd.set_cpu_backward_threads(4):
+        ...     loss.backward()
+
+    """
+
+    def __init__(self, num_threads):
+        self.prev = torch._C._get_num_cpu_backward_threads()
+        torch._C._set_num_cpu_backward_threads(num_threads)
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *args):
+        torch._C._set_num_cpu_backward_threads(self.prev)
+        return False
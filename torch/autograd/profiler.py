@@ -517,6 +517,60 @@ class emit_nvtx(object):
         return False
 
 
+class sampling_profile(object):
+    """Context manager that samples a fraction of the functions the profiler
+    can see, at an overhead low enough to leave it running in production.
+
+    Each sampled function records its duration, its enclosing functions and,
+    optionally, the shapes of its inputs rounded up to powers of two, into a
+    buffer of the thread that ran it. :meth:`flush` can be called periodically
+    to collect the samples recorded since the previous flush. The object it
+    returns lists the samples (``events()``) and their aggregation by stack and
+    shapes (``stats()``), and can write them with ``export_chrome_trace(path)``
+    or ``export_pprof(path)``. The pprof profile estimates the number of calls
+    and the time spent by dividing the sampled values by the sampling rate.
+
+    Like :class:`profile`, this sees the operators run by the thread that
+    entered it, and by the threads it hands work to.
+
+    Arguments:
+        sampling_rate (float, optional): Probability that a function is sampled.
+            Default: ``0.001``.
+        buffer_size (int, optional): Number of samples each thread can hold
+            between two flushes. Samples that find the buffer full are dropped
+            and counted in ``num_dropped``. Default: ``4096``.
+        record_shapes (bool, optional): Whether to record the bucketed shapes of
+            the inputs. This makes every function collect its inputs, sampled
+            or not. Default: ``False``.
+
+    Example:
+        >>> with torch.autograd.profiler.sampling_profile(sampling_rate=0.01) as prof:
+        ...     for step in range(steps):
+        ...         model(x)
+        ...         if step % 1000 == 0:
+        ...             prof.flush().export_pprof('step{}.pb'.format(step))
+        >>> prof.profile.stats()
+    """
+    def __init__(self, sampling_rate=0.001, buffer_size=4096, record_shapes=False):
+        self.sampling_rate = sampling_rate
+        self.buffer_size = buffer_size
+        self.record_shapes = record_shapes
+        self.profile = None
+
+    def __enter__(self):
+        torch.autograd._enable_sampling_profiler(
+            self.sampling_rate, self.buffer_size, self.record_shapes)
+        return self
+
+    def flush(self):
+        return torch.autograd._flush_sampling_profiler()
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        # What was not flushed yet.
+        self.profile = torch.autograd._disable_sampling_profiler()
+        return False
+
+
 def load_nvprof(path):
     """Opens an nvprof trace file and parses autograd annotations.
 
@@ -189,6 +189,40 @@ static PyObject * THPModule_setNumInteropThreads(PyObject *module, PyObject *arg
   Py_RETURN_NONE;
 }
 
+static PyObject * THPModule_getIntraopAffinity(PyObject *module, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  switch (at::get_intraop_affinity()) {
+    case at::IntraOpAffinity::CORE:
+      return THPUtils_packString("core");
+    case at::IntraOpAffinity::NUMA:
+      return THPUtils_packString("numa");
+    default:
+      return THPUtils_packString("none");
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_setIntraopAffinity(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkString(arg), "set_intraop_affinity expects a str, "
+          "but got %s", THPUtils_typename(arg));
+  auto affinity = THPUtils_unpackString(arg);
+  if (affinity == "none") {
+    at::set_intraop_affinity(at::IntraOpAffinity::NONE);
+  } else if (affinity == "core") {
+    at::set_intraop_affinity(at::IntraOpAffinity::CORE);
+  } else if (affinity == "numa") {
+    at::set_intraop_affinity(at::IntraOpAffinity::NUMA);
+  } else {
+    throw torch::ValueError("set_intraop_affinity expects 'none', 'core' or "
+        "'numa', but got '%s'", affinity.c_str());
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THPModule_setDefaultTensorType(PyObject *_unused, PyObject *type)
 {
   HANDLE_TH_ERRORS
@@ -548,6 +582,8 @@ static PyMethodDef TorchMethods[] = {
   {"set_num_threads", (PyCFunction)THPModule_setNumThreads,     METH_O,       nullptr},
   {"get_num_interop_threads", (PyCFunction)THPModule_getNumInteropThreads,     METH_NOARGS,  nullptr},
   {"set_num_interop_threads", (PyCFunction)THPModule_setNumInteropThreads,     METH_O,       nullptr},
+  {"get_intraop_affinity", (PyCFunction)THPModule_getIntraopAffinity,         METH_NOARGS,  nullptr},
+  {"set_intraop_affinity", (PyCFunction)THPModule_setIntraopAffinity,         METH_O,       nullptr},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
   {"_get_mkldnn_enabled", (PyCFunction)THPModule_userEnabledMkldnn, METH_NOARGS,     nullptr},
@@ -17,11 +17,13 @@
 #include <c10/util/Optional.h>
 #include <c10/core/StreamGuard.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -155,6 +157,43 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [Parallel CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default the CPU nodes of a backward pass all run on the thread that
+// called backward(), so independent branches of the graph run one after the
+// other. With set_num_cpu_backward_threads(n), n > 0, a non-reentrant
+// backward call gets a ready queue of its own, and n workers launched on the
+// inter-op thread pool pop ready CPU nodes from it alongside the calling
+// thread. The dependency counting is unchanged: whichever thread decrements
+// a node's count to zero pushes it, and it runs on whichever thread pops it
+// first.
+//
+// The workers behave like the calling thread (worker_device is CPU_DEVICE),
+// so a backward call from within a node is handled as a reentrant one. Such
+// a nested GraphTask is not parallel, and the calling thread runs it from a
+// private ready queue, as the workers do, so that no other thread takes its
+// nodes and its gradients are summed in a fixed order. The workers never
+// take the empty NodeTasks used to wake up the owner of a GraphTask, and they
+// leave once the GraphTask is completed.
+//
+// Summing the gradients a node receives in the order they arrive would make
+// the result depend on thread timing. Instead, a parallel GraphTask keeps the
+// gradients of nodes that are not ready in pending_inputs_, and sums them
+// once the node is ready, in the order of the sequence numbers of the nodes
+// that produced them. So the gradients are the same from run to run, and
+// they do not depend on the number of threads.
+
+static std::atomic<int> num_cpu_backward_threads{0};
+
+void set_num_cpu_backward_threads(int num_threads) {
+  TORCH_CHECK(num_threads >= 0, "number of threads must be non-negative");
+  num_cpu_backward_threads = num_threads;
+}
+
+int get_num_cpu_backward_threads() {
+  return num_cpu_backward_threads;
+}
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   if (graph_task) {
@@ -172,7 +211,20 @@ bool graph_task_completed(const std::shared_ptr<GraphTask>& graph_task) {
       (graph_task->exit_on_error_ && graph_task->has_error_.load());
 }
 
+void ReadyQueue::notify(size_t num_pushed, int waiters) {
+  if (waiters == 0) {
+    return;
+  }
+  if (num_pushed > 1 && waiters > 1) {
+    not_empty_.notify_all();
+  } else {
+    not_empty_.notify_one();
+  }
+}
+
 auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
+  int waiters;
+  bool wake_up_owner;
   {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
@@ -181,38 +233,100 @@ auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
       TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
       ++graph_task->outstanding_tasks_;
     }
+    wake_up_owner = !item.fn_;
     heap_.push(std::move(item));
+    size_.store(heap_.size(), std::memory_order_release);
+    waiters = waiters_;
+  }
+  // A parallel CPU queue also has workers waiting in pop_unless(), which do
+  // not take the empty task that wakes up the owner. Wake everybody up so
+  // that the owner gets it.
+  if (wake_up_owner && waiters > 1) {
+    not_empty_.notify_all();
+  } else {
+    notify(1, waiters);
   }
-  not_empty_.notify_one();
+}
+
+auto ReadyQueue::push_batch(std::vector<NodeTask>& items) -> void {
+  if (items.empty()) {
+    return;
+  }
+  int waiters;
+  {
+    // Lock mutex for writing to heap_
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : items) {
+      std::shared_ptr<GraphTask> graph_task = item.base_.lock();
+      TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
+      ++graph_task->outstanding_tasks_;
+      heap_.push(std::move(item));
+    }
+    size_.store(heap_.size(), std::memory_order_release);
+    waiters = waiters_;
+  }
+  notify(items.size(), waiters);
+  items.clear();
 }
 
 auto ReadyQueue::pushShutdownTask() -> void {
+  int waiters;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     heap_.push(NodeTask({}, nullptr, InputBuffer(0), true));
+    size_.store(heap_.size(), std::memory_order_release);
+    waiters = waiters_;
   }
-  not_empty_.notify_one();
+  notify(1, waiters);
 }
 
 size_t ReadyQueue::size() const {
-  // Lock mutex for accesses to heap_
-  std::unique_lock<std::mutex> lock(mutex_);
-  return heap_.size();
+  return size_.load(std::memory_order_acquire);
 }
 
 auto ReadyQueue::pop() -> NodeTask {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  not_empty_.wait(lock, [this]{ return !heap_.empty(); });
+  if (heap_.empty()) {
+    ++waiters_;
+    not_empty_.wait(lock, [this]{ return !heap_.empty(); });
+    --waiters_;
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  size_.store(heap_.size(), std::memory_order_release);
   return task;
 }
 
-bool ReadyQueue::empty() const {
+auto ReadyQueue::pop_unless(const std::function<bool()>& stop)
+    -> c10::optional<NodeTask> {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  return heap_.empty();
+  auto has_task = [this] { return !heap_.empty() && heap_.top().fn_; };
+  if (!has_task() && !stop()) {
+    ++waiters_;
+    not_empty_.wait(lock, [&] { return has_task() || stop(); });
+    --waiters_;
+  }
+  if (!has_task()) {
+    return c10::nullopt;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  size_.store(heap_.size(), std::memory_order_release);
+  return task;
+}
+
+void ReadyQueue::wake_all() {
+  {
+    // Taking the lock orders this with waiters checking their condition.
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  not_empty_.notify_all();
+}
+
+bool ReadyQueue::empty() const {
+  return size() == 0;
 }
 
 Engine::Engine() : max_recursion_depth_(MAX_DEPTH), non_reentrant_device_thread_count_(0) {}
@@ -385,19 +499,7 @@ auto Engine::thread_main(
         continue;
       }
 
-      if (task.fn_ && !local_graph_task->has_error_.load()) {
-        AutoGradMode grad_mode(local_graph_task->grad_mode_);
-        try {
-          // The guard sets the thread_local current_graph_task on construction
-          // and restores it on exit. The current_graph_task variable helps
-          // queue_callback() to find the target GraphTask to append final
-          // callbacks.
-          GraphTaskGuard guard(local_graph_task);
-          evaluate_function(local_graph_task, task.fn_.get(), task.inputs_);
-        } catch (std::exception& e) {
-          thread_on_exception(local_graph_task, task.fn_, e);
-        }
-      }
+      run_node_task(local_graph_task, task);
     }
 
     // Decrement the outstanding tasks.
@@ -435,6 +537,65 @@ auto Engine::thread_main(
 }
 
 
+void Engine::run_node_task(
+    std::shared_ptr<GraphTask>& graph_task,
+    NodeTask& task) {
+  // Runs the task, then any successor evaluate_function hands back to be
+  // run inline. All of them share the outstanding task count of `task`.
+  c10::optional<NodeTask> next_task;
+  while (task.fn_ && !graph_task->has_error_.load()) {
+    AutoGradMode grad_mode(graph_task->grad_mode_);
+    try {
+      // The guard sets the thread_local current_graph_task on construction
+      // and restores it on exit. The current_graph_task variable helps
+      // queue_callback() to find the target GraphTask to append final
+      // callbacks.
+      GraphTaskGuard guard(graph_task);
+      evaluate_function(graph_task, task.fn_.get(), task.inputs_, &next_task);
+    } catch (std::exception& e) {
+      thread_on_exception(graph_task, task.fn_, e);
+    }
+    if (!next_task) {
+      break;
+    }
+    task = std::move(*next_task);
+    next_task.reset();
+  }
+}
+
+void Engine::cpu_backward_worker(const std::shared_ptr<GraphTask>& graph_task) {
+  // Behave like the thread that called backward(): a backward call from
+  // within a node is then handled as a reentrant one, and gets a CPU queue
+  // of its own so that the tasks of the two graphs do not get mixed up.
+  auto prev_ready_queue = std::move(local_ready_queue);
+  auto prev_device = worker_device;
+  local_ready_queue = std::make_shared<ReadyQueue>();
+  worker_device = CPU_DEVICE;
+
+  const auto& queue = graph_task->cpu_ready_queue_;
+  auto stop = [&graph_task] { return graph_task->future_completed_.load(); };
+  while (auto task = queue->pop_unless(stop)) {
+    std::shared_ptr<GraphTask> local_graph_task;
+    if (!(local_graph_task = task->base_.lock())) {
+      continue;
+    }
+    run_node_task(local_graph_task, *task);
+    task.reset();
+
+    --local_graph_task->outstanding_tasks_;
+    if (graph_task_completed(local_graph_task)) {
+      mark_graph_task_completed(local_graph_task);
+      // Wake up the owning thread, see thread_main.
+      std::atomic_thread_fence(std::memory_order_release);
+      ready_queue_by_index(local_graph_task, local_graph_task->owner_)
+          ->push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
+    }
+  }
+
+  local_ready_queue = std::move(prev_ready_queue);
+  worker_device = prev_device;
+}
+
 // Reentrant call will re-use the graph_task's owner thread ready_queue for
 // queueing tasks (NOTE: this is not true in the async_mode of the engine).
 // While we can create separate ready queue for each new reentrant
@@ -486,6 +647,9 @@ void GraphTask::set_exception(
     const std::shared_ptr<Node>& fn) {
   set_exception_without_signal(fn);
   if (!future_completed_.exchange(true)) {
+    if (parallel_cpu_) {
+      cpu_ready_queue_->wake_all();
+    }
     future_result_->setError(e.what());
   }
 }
@@ -623,7 +787,8 @@ static variable_list call_function(
 void Engine::evaluate_function(
     std::shared_ptr<GraphTask>& graph_task,
     Node* func,
-    InputBuffer& inputs) {
+    InputBuffer& inputs,
+    c10::optional<NodeTask>* next_task) {
   // If exec_info_ is not empty, we have to instrument the execution
   auto& exec_info_ = graph_task->exec_info_;
   if (!exec_info_.empty()) {
@@ -680,8 +845,28 @@ void Engine::evaluate_function(
     }
   }
 
+  // The tasks that become ready are collected per queue and pushed once the
+  // GraphTask mutex is released, taking each queue's lock only once. There
+  // is usually a single queue, so a vector beats a map here.
+  std::vector<std::pair<std::shared_ptr<ReadyQueue>, std::vector<NodeTask>>>
+      ready_tasks;
+  auto add_ready_task = [&](InputBuffer input_buffer,
+                            std::shared_ptr<Node> next_fn) {
+    auto queue = ready_queue(graph_task, input_buffer.device());
+    auto it = std::find_if(
+        ready_tasks.begin(), ready_tasks.end(), [&](const auto& entry) {
+          return entry.first == queue;
+        });
+    if (it == ready_tasks.end()) {
+      ready_tasks.emplace_back(std::move(queue), std::vector<NodeTask>());
+      it = std::prev(ready_tasks.end());
+    }
+    it->second.emplace_back(
+        graph_task, std::move(next_fn), std::move(input_buffer));
+  };
+
   // Lock mutex for the accesses to GraphTask dependencies_, not_ready_ and cpu_ready_queue_ below
-  std::lock_guard<std::mutex> lock(graph_task->mutex_);
+  std::unique_lock<std::mutex> lock(graph_task->mutex_);
   for (int i = 0; i < num_outputs; ++i) {
     auto& output = outputs[i];
     const auto& next = fn.next_edge(i);
@@ -701,6 +886,49 @@ void Engine::evaluate_function(
       is_ready = true;
     }
 
+    if (graph_task->parallel_cpu_) {
+      // See Note [Parallel CPU backward]
+      auto& pending = graph_task->pending_inputs_;
+      auto pending_it = pending.find(next.function.get());
+      if (pending_it == pending.end()) {
+        // Skip functions that aren't supposed to be executed
+        if (!exec_info_.empty()) {
+          auto it = exec_info_.find(next.function.get());
+          if (it == exec_info_.end() || !it->second.should_execute()) {
+            continue;
+          }
+        }
+        pending_it = pending.emplace(next.function.get(), 0).first;
+      }
+      pending_it->second.push_back(GraphTask::PendingInput{
+          fn.sequence_nr(), i, next.input_nr, std::move(output),
+          opt_parent_stream});
+      if (is_ready) {
+        auto& grads = pending_it->second;
+        // The order in which the backward pass would run the producers when
+        // done serially.
+        std::stable_sort(
+            grads.begin(), grads.end(), [](const auto& a, const auto& b) {
+              return a.sequence_nr != b.sequence_nr
+                  ? a.sequence_nr > b.sequence_nr
+                  : a.output_nr < b.output_nr;
+            });
+        InputBuffer input_buffer(next.function->num_inputs());
+        const auto opt_next_stream =
+            next.function->stream(c10::DeviceType::CUDA);
+        for (auto& grad : grads) {
+          input_buffer.add(
+              grad.input_nr,
+              std::move(grad.grad),
+              grad.stream,
+              opt_next_stream);
+        }
+        pending.erase(pending_it);
+        add_ready_task(std::move(input_buffer), next.function);
+      }
+      continue;
+    }
+
     auto& not_ready = graph_task->not_ready_;
     auto not_ready_it = not_ready.find(next.function.get());
     if (not_ready_it == not_ready.end()) {
@@ -722,9 +950,7 @@ void Engine::evaluate_function(
                        opt_next_stream);
 
       if (is_ready) {
-        auto queue = ready_queue(graph_task, input_buffer.device());
-        queue->push(
-            NodeTask(graph_task, next.function, std::move(input_buffer)));
+        add_ready_task(std::move(input_buffer), next.function);
       } else {
         not_ready.emplace(next.function.get(), std::move(input_buffer));
       }
@@ -739,13 +965,26 @@ void Engine::evaluate_function(
                        opt_parent_stream,
                        opt_next_stream);
       if (is_ready) {
-        auto queue = ready_queue(graph_task, input_buffer.device());
-        queue->push(
-            NodeTask(graph_task, next.function, std::move(input_buffer)));
+        add_ready_task(std::move(input_buffer), next.function);
         not_ready.erase(not_ready_it);
       }
     }
   }
+  lock.unlock();
+
+  // Inline fast path, see the declaration. Only the worker's own queue is
+  // considered, so the task runs on the thread it was meant for, and only
+  // when that queue is empty, so no task with a higher priority is bypassed.
+  if (next_task && ready_tasks.size() == 1 &&
+      ready_tasks[0].second.size() == 1 &&
+      ready_tasks[0].first == local_ready_queue &&
+      local_ready_queue->empty()) {
+    next_task->emplace(std::move(ready_tasks[0].second[0]));
+    return;
+  }
+  for (auto& entry : ready_tasks) {
+    entry.first->push_batch(entry.second);
+  }
 }
 
 /* Computes the number of dependencies for each function which requires grad */
@@ -786,6 +1025,23 @@ auto Engine::execute(const edge_list& roots,
   init_local_ready_queue();
   bool not_reentrant_backward_call = worker_device == NO_DEVICE;
 
+  // See Note [Parallel CPU backward]. A parallel GraphTask gets a ready queue
+  // of its own, and so does a reentrant call made by the thread driving one,
+  // so that the workers never pick up the nodes of the nested GraphTask.
+  int num_threads = get_num_cpu_backward_threads();
+  const bool parallel = not_reentrant_backward_call && num_threads > 0;
+  struct RestoreReadyQueue {
+    std::shared_ptr<ReadyQueue> saved = local_ready_queue;
+    ~RestoreReadyQueue() {
+      local_ready_queue = std::move(saved);
+    }
+  } restore_ready_queue;
+  if (parallel ||
+      (current_graph_task && current_graph_task->parallel_cpu_ &&
+       current_graph_task->cpu_ready_queue_ == local_ready_queue)) {
+    local_ready_queue = std::make_shared<ReadyQueue>();
+  }
+
   auto graph_task = std::make_shared<GraphTask>(
       /* keep_graph */ keep_graph,
       /* create_graph */ create_graph,
@@ -800,6 +1056,12 @@ auto Engine::execute(const edge_list& roots,
     graph_task->init_to_execute(*graph_root, outputs);
   }
 
+  if (parallel) {
+    graph_task->parallel_cpu_ = true;
+    for (int i = 0; i < num_threads; ++i) {
+      at::launch([this, graph_task]() { cpu_backward_worker(graph_task); });
+    }
+  }
   return execute_with_graph_task(graph_task, graph_root)->wait();
 }
 
@@ -945,6 +1207,10 @@ void Engine::mark_graph_task_completed(
     graph_task->future_result_->waitNoThrow();
     return;
   }
+  if (graph_task->parallel_cpu_) {
+    // Let the workers go, there is nothing left for them to do.
+    graph_task->cpu_ready_queue_->wake_all();
+  }
 
   try {
     // Run post processing, before marking the future as complete.
@@ -965,7 +1231,7 @@ void Engine::mark_graph_task_completed(
 
 void Engine::graph_task_exec_post_processing(
     const std::shared_ptr<GraphTask>& graph_task) {
-  if (!graph_task->not_ready_.empty()) {
+  if (!graph_task->not_ready_.empty() || !graph_task->pending_inputs_.empty()) {
     throw std::runtime_error("could not compute gradients for some functions");
   }
 
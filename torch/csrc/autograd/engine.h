@@ -5,6 +5,7 @@
 
 #include <ATen/Tensor.h>
 #include <ATen/ThreadLocalState.h>
+#include <c10/util/Optional.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 #include <torch/csrc/autograd/function.h>
@@ -12,6 +13,7 @@
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/utils/future.h>
 
+#include <atomic>
 #include <deque>
 #include <exception>
 #include <functional>
@@ -63,6 +65,22 @@ struct GraphTask {
   std::unordered_map<Node*, InputBuffer> not_ready_;
   std::unordered_map<Node*, int> dependencies_;
 
+  // Set when the CPU nodes of this GraphTask run on several threads, see
+  // Note [Parallel CPU backward]. Such a GraphTask gets a cpu_ready_queue_
+  // of its own.
+  bool parallel_cpu_ = false;
+  // A gradient sent to a node that is not ready yet. With parallel_cpu_,
+  // these are kept in pending_inputs_ instead of being summed into not_ready_
+  // right away, and summed in a fixed order once the node is ready.
+  struct PendingInput {
+    uint64_t sequence_nr; // of the node that produced the gradient
+    int output_nr; // within the outputs of that node
+    int input_nr; // within the inputs of the receiving node
+    Variable grad;
+    c10::optional<c10::Stream> stream;
+  };
+  std::unordered_map<Node*, std::vector<PendingInput>> pending_inputs_;
+
   struct ExecInfo {
     struct Capture {
       Capture(const Capture&) = delete;
@@ -219,19 +237,39 @@ struct ReadyQueue {
 
   // To notify threads waiting on the ReadyQueue of available tasks on the heap_
   std::condition_variable not_empty_;
-  // To protect read and writes to heap_
+  // To protect read and writes to heap_ and waiters_
   mutable std::mutex mutex_;
 
   std::priority_queue<NodeTask, std::vector<NodeTask>, CompareNodeTaskTime> heap_;
 
+  // Number of threads blocked in pop(). Most queues have a single consumer
+  // that is also the producer, so pushes usually find nobody to wake up and
+  // skip the notification.
+  int waiters_ = 0;
+  // Mirrors heap_.size() so that empty() and size() do not take the lock.
+  std::atomic<size_t> size_{0};
+
+  void notify(size_t num_pushed, int waiters);
+
  public:
   // incrementOutstandingTasks indicates whether or not we should increment
   // 'outstanding_tasks_' for the associated GraphTask. This should mostly
   // always be true, see the doc for 'enqueue_blocked_task_on_cpu' for when we
   // might set this to false.
   void push(NodeTask item, bool incrementOutstandingTasks = true);
+  // Pushes all the tasks under a single lock acquisition, incrementing
+  // 'outstanding_tasks_' of their GraphTasks.
+  void push_batch(std::vector<NodeTask>& items);
   void pushShutdownTask();
   NodeTask pop();
+  // Like pop(), but leaves empty NodeTasks (the wake-up calls for the owner
+  // of a GraphTask) in the queue, and returns nullopt as soon as `stop`
+  // returns true. `stop` is evaluated under the queue lock, and the condition
+  // it checks must be followed by a call to wake_all() when it changes.
+  c10::optional<NodeTask> pop_unless(const std::function<bool()>& stop);
+  void wake_all();
+  // empty() and size() are only a snapshot, which is all the engine needs:
+  // either the caller is the only consumer, or it merely reports the size.
   bool empty() const;
   size_t size() const;
 };
@@ -304,10 +342,19 @@ struct TORCH_API Engine {
  protected:
   Engine();
   void compute_dependencies(Node* root, GraphTask& task);
+  // Runs `func` and hands its outputs to its successors, queueing the ones
+  // that become ready. If `next_task` is given, the calling worker may run a
+  // successor itself: when exactly one successor became ready, and it would
+  // go to the worker's own ready queue while that queue is empty, it is
+  // returned through `next_task` instead of being queued. Running it right
+  // away is then equivalent to pushing and popping it, minus the queue
+  // overhead. Such a task does not count towards 'outstanding_tasks_'; it
+  // takes over the slot of `func`.
   void evaluate_function(
       std::shared_ptr<GraphTask>& graph_task,
       Node* func,
-      InputBuffer& inputs);
+      InputBuffer& inputs,
+      c10::optional<NodeTask>* next_task = nullptr);
 
   // initialize the thread local ready queue with the ready queue that is created
   // elsewhere (i.e. thread_init, Engine::execute, etc), or create a new
@@ -332,6 +379,9 @@ struct TORCH_API Engine {
       const std::shared_ptr<GraphTask>& task,
       bool reentrant_thread);
   void reentrant_thread_init();
+  // Helps the calling thread run the CPU nodes of a parallel_cpu_ GraphTask,
+  // see Note [Parallel CPU backward].
+  void cpu_backward_worker(const std::shared_ptr<GraphTask>& graph_task);
   void add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task);
   void set_device(int device);
   void initialize_device_threads_pool();
@@ -378,6 +428,9 @@ private:
   std::condition_variable non_reentrant_device_thread_finish_;
   std::mutex non_reentrant_device_thread_finish_mutex_;
 
+ // Runs `task`, and the successors evaluate_function hands back to run
+ // inline, on the current thread.
+ void run_node_task(std::shared_ptr<GraphTask>& graph_task, NodeTask& task);
  void execute_graph_task_with_continuation(
      const std::shared_ptr<GraphTask>& graph_task);
  void graph_task_exec_post_processing(
@@ -385,6 +438,12 @@ private:
  void mark_graph_task_completed(const std::shared_ptr<GraphTask>& graph_task);
 };
 
+// Number of threads that run the CPU nodes of a backward pass along with the
+// thread that called backward(). 0, the default, runs them all on the calling
+// thread. See Note [Parallel CPU backward].
+TORCH_API void set_num_cpu_backward_threads(int num_threads);
+TORCH_API int get_num_cpu_backward_threads();
+
 // allow python_engine to override the default engine when it loads
 using EngineStub = Engine& (*)();
 TORCH_API void set_default_engine_stub(EngineStub stub);
@@ -8,6 +8,10 @@
 #include <torch/csrc/autograd/record_function_ops.h>
 #include <torch/csrc/autograd/python_function.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/sampling_profiler.h>
+#include <torch/csrc/autograd/saved_tensor_budget.h>
+#include <torch/csrc/utils/python_numbers.h>
 #ifdef USE_DISTRIBUTED
 #include <torch/csrc/distributed/rpc/message.h>
 #endif
@@ -57,6 +61,75 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
   m.def("_disable_profiler", disableProfiler);
   m.def("_profiler_enabled", profilerEnabled);
 
+  py::class_<SampledProfile>(m, "_SampledProfile")
+      .def_property_readonly("sampling_rate", &SampledProfile::sampling_rate)
+      .def_property_readonly("num_dropped", &SampledProfile::num_dropped)
+      .def("events", [](const SampledProfile& p) {
+        py::list events;
+        for (const auto& e : p.events()) {
+          py::dict event;
+          event["stack"] = e.stack;
+          event["shapes"] = e.shapes;
+          event["thread_id"] = e.thread_id;
+          event["start_ns"] = e.start_ns;
+          event["duration_ns"] = e.duration_ns;
+          events.append(event);
+        }
+        return events;
+      })
+      .def("stats", [](const SampledProfile& p) {
+        py::list stats;
+        for (const auto& s : p.stats()) {
+          py::dict stat;
+          stat["stack"] = s.stack;
+          stat["shapes"] = s.shapes;
+          stat["count"] = s.count;
+          stat["total_ns"] = s.total_ns;
+          stat["min_ns"] = s.min_ns;
+          stat["max_ns"] = s.max_ns;
+          stats.append(stat);
+        }
+        return stats;
+      })
+      .def("export_chrome_trace", &SampledProfile::exportChromeTrace)
+      .def("export_pprof", &SampledProfile::exportPprof);
+
+  m.def(
+      "_enable_sampling_profiler",
+      [](double sampling_rate, size_t buffer_size, bool record_shapes) {
+        SamplingProfilerConfig config;
+        config.sampling_rate = sampling_rate;
+        config.buffer_size = buffer_size;
+        config.record_shapes = record_shapes;
+        enableSamplingProfiler(config);
+      });
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_flush_sampling_profiler", flushSamplingProfiler);
+  m.def("_sampling_profiler_enabled", samplingProfilerEnabled);
+
+  using torch::autograd::SavedTensorPool;
+  py::class_<SavedTensorPool, std::shared_ptr<SavedTensorPool>>(
+      m, "_SavedTensorPool")
+      .def(py::init<int64_t, bool>())
+      .def_property_readonly("budget_bytes", &SavedTensorPool::budget_bytes)
+      .def_property_readonly("offload", &SavedTensorPool::offload)
+      .def("stats", [](const SavedTensorPool& pool) {
+        auto stats = pool.stats();
+        py::dict result;
+        result["saved_bytes"] = stats.saved_bytes;
+        result["peak_bytes"] = stats.peak_bytes;
+        result["num_recomputable"] = stats.num_recomputable;
+        result["num_dropped"] = stats.num_dropped;
+        result["num_offloaded"] = stats.num_offloaded;
+        result["num_recomputed"] = stats.num_recomputed;
+        result["num_reloaded"] = stats.num_reloaded;
+        result["recompute_time_us"] = stats.recompute_time_us;
+        result["reload_time_us"] = stats.reload_time_us;
+        return result;
+      });
+  m.def("_get_saved_tensor_pool", &SavedTensorPool::current);
+  m.def("_set_saved_tensor_pool", &SavedTensorPool::set_current);
+
   // TODO: remove when jit future can hold PyObject (https://github.com/pytorch/pytorch/issues/34999)
 #ifdef USE_DISTRIBUTED
   m.def(
@@ -151,6 +224,22 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_num_cpu_backward_threads(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!THPUtils_checkLong(arg)) {
+    throw TypeError("num_threads must be an int (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  torch::autograd::set_num_cpu_backward_threads(THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_num_cpu_backward_threads(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(torch::autograd::get_num_cpu_backward_threads());
+  END_HANDLE_TH_ERRORS
+}
+
 // autograd methods on torch._C
 static PyMethodDef methods[] = {
   {"set_grad_enabled", (PyCFunction)set_grad_enabled, METH_O, nullptr},
@@ -162,6 +251,8 @@ static PyMethodDef methods[] = {
   {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
   {"set_anomaly_enabled", (PyCFunction)set_anomaly_mode_enabled, METH_O, nullptr},
   {"is_anomaly_enabled", (PyCFunction)is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_set_num_cpu_backward_threads", (PyCFunction)set_num_cpu_backward_threads, METH_O, nullptr},
+  {"_get_num_cpu_backward_threads", (PyCFunction)get_num_cpu_backward_threads, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -2,6 +2,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/utils/memory.h>
+#include <algorithm>
 #include <cstdlib>
 #include <random>
 
@@ -20,23 +21,26 @@ float sample_zero_one() {
 
 class CallbackManager {
  public:
-  void pushCallback(
+  CallbackHandle pushCallback(
       std::function<bool(const RecordFunction&)> start,
       std::function<void(const RecordFunction&)> end,
       bool needs_inputs,
       double sampling_prob,
       std::unordered_set<RecordScope, std::hash<RecordScope>> scopes) {
+    auto handle = ++next_handle_;
     callbacks_.emplace_back(
       std::move(start),
       std::move(end),
       needs_inputs,
       sampling_prob,
-      std::move(scopes)
+      std::move(scopes),
+      handle
     );
     recomputeFlags();
 
     // make sure we mark the change in callbacks
     ++callbacks_version_;
+    return handle;
   }
 
   void popCallback() {
@@ -48,6 +52,17 @@ class CallbackManager {
     ++callbacks_version_;
   }
 
+  void removeCallback(CallbackHandle handle) {
+    auto it = std::find_if(
+        callbacks_.begin(), callbacks_.end(), [handle](const Callback& cb) {
+          return cb.handle_ == handle;
+        });
+    TORCH_CHECK(it != callbacks_.end(), "No callbacks with handle ", handle);
+    callbacks_.erase(it);
+    recomputeFlags();
+    ++callbacks_version_;
+  }
+
   inline bool hasCallbacks() const {
     return !callbacks_.empty();
   }
@@ -145,18 +160,23 @@ class CallbackManager {
   // every time we push or pop callbacks, we bump this counter
   uint64_t callbacks_version_ = 0;
 
+  // the last handle returned by pushCallback
+  CallbackHandle next_handle_ = 0;
+
   struct Callback {
     Callback(
         std::function<bool(const RecordFunction&)> start_cb,
         std::function<void(const RecordFunction&)> end_cb,
         bool needs_inputs,
         double sampling_prob,
-        std::unordered_set<RecordScope, std::hash<RecordScope>> scopes
+        std::unordered_set<RecordScope, std::hash<RecordScope>> scopes,
+        CallbackHandle handle
     ) : start_cb_(std::move(start_cb)),
         end_cb_(std::move(end_cb)),
         needs_inputs_(needs_inputs),
         sampling_prob_(sampling_prob),
-        is_sampled_(sampling_prob != 1.0) {
+        is_sampled_(sampling_prob != 1.0),
+        handle_(handle) {
       if (!scopes.empty()) {
         scopes_.fill(false);
         for (auto sc : scopes) {
@@ -170,9 +190,10 @@ class CallbackManager {
     std::function<bool(const RecordFunction&)> start_cb_;
     std::function<void(const RecordFunction&)> end_cb_;
     std::array<bool, static_cast<size_t>(RecordScope::NUM_SCOPES)> scopes_;
-    const bool needs_inputs_;
-    const double sampling_prob_;
-    const bool is_sampled_;
+    bool needs_inputs_;
+    double sampling_prob_;
+    bool is_sampled_;
+    CallbackHandle handle_;
   };
 };
 
@@ -194,13 +215,13 @@ bool hasCallbacks() {
   return manager().hasCallbacks();
 }
 
-void pushCallback(
+CallbackHandle pushCallback(
     std::function<bool(const RecordFunction&)> start,
     std::function<void(const RecordFunction&)> end,
     bool needs_inputs,
     double sampling_prob,
     std::unordered_set<RecordScope, std::hash<RecordScope>> scopes) {
-  manager().pushCallback(
+  return manager().pushCallback(
       std::move(start),
       std::move(end),
       needs_inputs,
@@ -212,6 +233,10 @@ void popCallback() {
   manager().popCallback();
 }
 
+void removeCallback(CallbackHandle handle) {
+  manager().removeCallback(handle);
+}
+
 void _runBeforeCallbacks(RecordFunction* rf, const std::string& funcName) {
   TORCH_INTERNAL_ASSERT(rf != nullptr);
   rf->_before(funcName);
@@ -122,6 +122,12 @@ struct TORCH_API RecordFunction {
     return scope_;
   }
 
+  // The RecordFunction that was current() when this one was made current,
+  // see RECORD_FUNCTION.
+  inline RecordFunction* parent() const {
+    return parent_;
+  }
+
   // Current returns the currently active RecordFunction in this thread.
   static RecordFunction* current();
 
@@ -281,6 +287,9 @@ TORCH_API void TEST_unsetGlobalSamplingProbability();
   RECORD_FUNCTION_WITH_SCOPE( \
     torch::autograd::profiler::RecordScope::USER_SCOPE, fn, {})
 
+// Identifies a pair of callbacks added with pushCallback
+using CallbackHandle = uint64_t;
+
 /**
  * pushCallback adds a pair of callbacks to run with RecordFunction:
  *  start, end - the callbacks to run when entering and exiting the scope;
@@ -293,9 +302,11 @@ TORCH_API void TEST_unsetGlobalSamplingProbability();
  *    passing empty set means the callbacks will be executed for all possible
  *    scope types
  *
+ * Returns a handle that removeCallback accepts
+ *
  * WARNING: not thread safe, must not overlap with other PyTorch code execution
  */
-TORCH_API void pushCallback(
+TORCH_API CallbackHandle pushCallback(
     std::function<bool(const RecordFunction&)> start,
     std::function<void(const RecordFunction&)> end =
         [](const RecordFunction&) {},
@@ -312,5 +323,13 @@ TORCH_API void pushCallback(
  */
 TORCH_API void popCallback();
 
+/**
+ * removeCallback removes the pair of callbacks that pushCallback returned
+ *  the handle for, wherever it is in the stack
+ *
+ * WARNING: not thread safe, must not overlap with other PyTorch code execution
+ */
+TORCH_API void removeCallback(CallbackHandle handle);
+
 } // namespace profiler
 }} // namespace torch::autograd
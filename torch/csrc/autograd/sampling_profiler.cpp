@@ -0,0 +1,574 @@
+#include <torch/csrc/autograd/sampling_profiler.h>
+
+#include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/record_function.h>
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Interned ids. 0 is the empty string.
+using NameId = uint32_t;
+
+struct Sample {
+  int64_t start_ns;
+  int64_t duration_ns;
+  NameId shapes;
+  uint8_t depth;
+  // The sampled function first.
+  std::array<NameId, kSampledStackDepth> stack;
+};
+
+// A ring buffer written by the thread that owns it and drained by
+// flushSamplingProfiler(), under the registry lock.
+class SampleBuffer {
+ public:
+  SampleBuffer(size_t capacity, uint16_t thread_id, uint64_t generation)
+      : samples_(capacity), thread_id_(thread_id), generation_(generation) {}
+
+  void push(const Sample& sample) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == samples_.size()) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    samples_[head % samples_.size()] = sample;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  template <typename F>
+  void drain(F&& f) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto head = head_.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      f(samples_[tail % samples_.size()]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  int64_t take_dropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+  uint16_t thread_id() const {
+    return thread_id_;
+  }
+  uint64_t generation() const {
+    return generation_;
+  }
+
+ private:
+  std::vector<Sample> samples_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<int64_t> dropped_{0};
+  const uint16_t thread_id_;
+  const uint64_t generation_;
+};
+
+class NameTable {
+ public:
+  NameTable() : names_{""} {}
+
+  // `make_name` is only called the first time `hash` is seen.
+  template <typename F>
+  NameId intern(uint64_t hash, F&& make_name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = ids_.find(hash);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    NameId id = names_.size();
+    names_.push_back(make_name());
+    ids_.emplace(hash, id);
+    return id;
+  }
+
+  std::vector<std::string> names() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return names_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> names_;
+  std::unordered_map<uint64_t, NameId> ids_;
+};
+
+NameTable& nameTable() {
+  static NameTable table;
+  return table;
+}
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<SampleBuffer>> buffers;
+  SamplingProfilerConfig config;
+  bool enabled = false;
+  // Whether the Profiler dispatch key was included before enabling, since the
+  // regular profiler may be running too.
+  bool profiler_key_included = false;
+  // The RecordFunction callbacks of the profiler. Other callbacks may have
+  // been pushed after them, so they are removed by handle.
+  CallbackHandle callback_handle = 0;
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+// Bumped by every enableSamplingProfiler(), so that threads drop the buffers
+// of an earlier session.
+std::atomic<uint64_t> generation{0};
+std::atomic<size_t> buffer_size{0};
+
+struct ThreadState {
+  struct Open {
+    const RecordFunction* fn;
+    Sample sample;
+  };
+  std::shared_ptr<SampleBuffer> buffer;
+  std::vector<Open> open;
+  // Ids of the names this thread has interned, by hash.
+  std::unordered_map<uint64_t, NameId> ids;
+};
+
+thread_local ThreadState thread_state;
+
+constexpr size_t kMaxOpenSamples = 1024;
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t hashString(const char* str) {
+  uint64_t h = kFnvOffset;
+  for (; *str; ++str) {
+    h ^= static_cast<unsigned char>(*str);
+    h *= kFnvPrime;
+  }
+  return h;
+}
+
+uint64_t hashInt(uint64_t h, int64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    h ^= (static_cast<uint64_t>(value) >> (i * 8)) & 0xff;
+    h *= kFnvPrime;
+  }
+  return h;
+}
+
+template <typename F>
+NameId internCached(ThreadState& state, uint64_t hash, F&& make_name) {
+  auto it = state.ids.find(hash);
+  if (it != state.ids.end()) {
+    return it->second;
+  }
+  auto id = nameTable().intern(hash, std::forward<F>(make_name));
+  state.ids.emplace(hash, id);
+  return id;
+}
+
+int64_t bucket(int64_t size) {
+  int64_t b = 1;
+  while (b < size) {
+    b <<= 1;
+  }
+  return size == 0 ? 0 : b;
+}
+
+NameId internShapes(ThreadState& state, const std::vector<c10::IValue>& inputs) {
+  // The names and the shapes share the table, a distinct seed keeps apart
+  // a name and a shape that would hash the same.
+  uint64_t h = hashInt(kFnvOffset, -1);
+  for (const auto& input : inputs) {
+    if (!input.isTensor() || !input.toTensor().defined()) {
+      h = hashInt(h, -2);
+      continue;
+    }
+    for (auto size : input.toTensor().sizes()) {
+      h = hashInt(h, bucket(size));
+    }
+    h = hashInt(h, -3);
+  }
+  return internCached(state, h, [&] {
+    std::ostringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      ss << (i ? ", " : "");
+      if (!inputs[i].isTensor() || !inputs[i].toTensor().defined()) {
+        ss << "-";
+        continue;
+      }
+      ss << "[";
+      auto sizes = inputs[i].toTensor().sizes();
+      for (size_t d = 0; d < sizes.size(); ++d) {
+        ss << (d ? ", " : "") << bucket(sizes[d]);
+      }
+      ss << "]";
+    }
+    ss << "]";
+    return ss.str();
+  });
+}
+
+const std::shared_ptr<SampleBuffer>& threadBuffer(ThreadState& state) {
+  auto current = generation.load(std::memory_order_acquire);
+  if (!state.buffer || state.buffer->generation() != current) {
+    state.buffer = std::make_shared<SampleBuffer>(
+        buffer_size.load(std::memory_order_relaxed),
+        RecordFunction::currentThreadId(),
+        current);
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.buffers.push_back(state.buffer);
+  }
+  return state.buffer;
+}
+
+bool onStart(const RecordFunction& fn, bool record_shapes) {
+  auto& state = thread_state;
+  // End callbacks are skipped when the callbacks change while a function
+  // runs, do not let their samples pile up.
+  if (state.open.size() >= kMaxOpenSamples) {
+    state.open.clear();
+  }
+  ThreadState::Open open;
+  open.fn = &fn;
+  auto& sample = open.sample;
+  sample.depth = 0;
+  for (const RecordFunction* f = &fn; f && sample.depth < kSampledStackDepth;
+       f = f->parent()) {
+    const char* name = f->name().str();
+    if (!name) {
+      break;
+    }
+    sample.stack[sample.depth++] =
+        internCached(state, hashString(name), [name] { return name; });
+  }
+  sample.shapes = record_shapes ? internShapes(state, fn.inputs()) : 0;
+  sample.start_ns = getTime();
+  state.open.push_back(open);
+  return true;
+}
+
+void onEnd(const RecordFunction& fn) {
+  auto end_ns = getTime();
+  auto& state = thread_state;
+  // Usually the innermost open sample. The end callback of a function that
+  // ends on another thread finds nothing, and the sample is lost.
+  for (auto it = state.open.rbegin(); it != state.open.rend(); ++it) {
+    if (it->fn == &fn) {
+      auto sample = it->sample;
+      sample.duration_ns = end_ns - sample.start_ns;
+      state.open.erase(std::next(it).base());
+      threadBuffer(state)->push(sample);
+      return;
+    }
+  }
+}
+
+// Drains the buffers. Holds the registry lock.
+SampledProfile flushLocked(Registry& reg) {
+  std::vector<std::pair<uint16_t, Sample>> samples;
+  int64_t num_dropped = 0;
+  for (auto it = reg.buffers.begin(); it != reg.buffers.end();) {
+    auto& buffer = *it;
+    buffer->drain([&](const Sample& sample) {
+      samples.emplace_back(buffer->thread_id(), sample);
+    });
+    num_dropped += buffer->take_dropped();
+    // The thread is gone and so is its part of the ownership.
+    if (buffer.use_count() == 1) {
+      it = reg.buffers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto names = nameTable().names();
+  auto stack_of = [&](const Sample& sample) {
+    std::vector<std::string> stack;
+    for (int i = sample.depth - 1; i >= 0; --i) {
+      stack.push_back(names[sample.stack[i]]);
+    }
+    return stack;
+  };
+
+  std::vector<SampledEvent> events;
+  std::vector<SampledStats> stats;
+  std::map<std::pair<std::vector<NameId>, NameId>, size_t> stats_index;
+  events.reserve(samples.size());
+  for (const auto& entry : samples) {
+    const auto& sample = entry.second;
+    events.push_back(SampledEvent{stack_of(sample),
+                                  names[sample.shapes],
+                                  entry.first,
+                                  sample.start_ns,
+                                  sample.duration_ns});
+
+    std::vector<NameId> key_stack(
+        sample.stack.begin(), sample.stack.begin() + sample.depth);
+    auto it = stats_index.emplace(
+        std::make_pair(std::move(key_stack), sample.shapes), stats.size());
+    if (it.second) {
+      stats.emplace_back();
+      stats.back().stack = events.back().stack;
+      stats.back().shapes = events.back().shapes;
+      stats.back().min_ns = sample.duration_ns;
+      stats.back().max_ns = sample.duration_ns;
+    }
+    auto& s = stats[it.first->second];
+    ++s.count;
+    s.total_ns += sample.duration_ns;
+    s.min_ns = std::min(s.min_ns, sample.duration_ns);
+    s.max_ns = std::max(s.max_ns, sample.duration_ns);
+  }
+  return SampledProfile(
+      reg.config.sampling_rate,
+      std::move(events),
+      std::move(stats),
+      num_dropped);
+}
+
+std::string jsonString(const std::string& str) {
+  std::ostringstream ss;
+  ss << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      ss << ' ';
+    } else {
+      ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+
+std::string joinStack(const std::vector<std::string>& stack) {
+  std::string result;
+  for (const auto& name : stack) {
+    result += (result.empty() ? "" : ";") + name;
+  }
+  return result;
+}
+
+// Just enough of the protobuf wire format to write profile.proto.
+class ProtoWriter {
+ public:
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      buf_ += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    buf_ += static_cast<char>(value);
+  }
+
+  void uint64Field(int field, uint64_t value) {
+    varint(field << 3);
+    varint(value);
+  }
+
+  void bytesField(int field, const std::string& bytes) {
+    varint((field << 3) | 2);
+    varint(bytes.size());
+    buf_ += bytes;
+  }
+
+  void packedField(int field, const std::vector<uint64_t>& values) {
+    ProtoWriter packed;
+    for (auto value : values) {
+      packed.varint(value);
+    }
+    bytesField(field, packed.str());
+  }
+
+  const std::string& str() const {
+    return buf_;
+  }
+
+ private:
+  std::string buf_;
+};
+
+} // namespace
+
+SampledProfile::SampledProfile(
+    double sampling_rate,
+    std::vector<SampledEvent> events,
+    std::vector<SampledStats> stats,
+    int64_t num_dropped)
+    : sampling_rate_(sampling_rate),
+      events_(std::move(events)),
+      stats_(std::move(stats)),
+      num_dropped_(num_dropped) {}
+
+void SampledProfile::exportChromeTrace(const std::string& path) const {
+  std::ofstream out(path);
+  TORCH_CHECK(out, "Cannot open ", path);
+  out << "{\"traceEvents\": [";
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const auto& event = events_[i];
+    out << (i ? ",\n" : "\n") << "{\"name\": "
+        << jsonString(event.stack.empty() ? "" : event.stack.back())
+        << ", \"ph\": \"X\", \"ts\": " << event.start_ns / 1000.0
+        << ", \"dur\": " << event.duration_ns / 1000.0
+        << ", \"pid\": \"CPU functions\", \"tid\": " << event.thread_id
+        << ", \"args\": {\"stack\": " << jsonString(joinStack(event.stack))
+        << ", \"shapes\": " << jsonString(event.shapes) << "}}";
+  }
+  out << "\n]}\n";
+}
+
+void SampledProfile::exportPprof(const std::string& path) const {
+  std::vector<std::string> strings{""};
+  std::unordered_map<std::string, uint64_t> string_ids{{"", 0}};
+  auto string_id = [&](const std::string& str) {
+    auto it = string_ids.emplace(str, strings.size());
+    if (it.second) {
+      strings.push_back(str);
+    }
+    return it.first->second;
+  };
+  // A function and its location share their id.
+  std::unordered_map<std::string, uint64_t> function_ids;
+  std::vector<std::string> functions;
+  auto function_id = [&](const std::string& name) {
+    auto it = function_ids.emplace(name, functions.size() + 1);
+    if (it.second) {
+      functions.push_back(name);
+    }
+    return it.first->second;
+  };
+
+  ProtoWriter profile;
+  auto value_type = [&](const std::string& type, const std::string& unit) {
+    ProtoWriter vt;
+    vt.uint64Field(1, string_id(type));
+    vt.uint64Field(2, string_id(unit));
+    return vt.str();
+  };
+  profile.bytesField(1, value_type("calls", "count"));
+  profile.bytesField(1, value_type("time", "nanoseconds"));
+
+  auto shapes_key = string_id("shapes");
+  for (const auto& s : stats_) {
+    ProtoWriter sample;
+    std::vector<uint64_t> locations;
+    for (auto it = s.stack.rbegin(); it != s.stack.rend(); ++it) {
+      locations.push_back(function_id(*it));
+    }
+    sample.packedField(1, locations);
+    sample.packedField(
+        2,
+        {static_cast<uint64_t>(std::llround(s.count / sampling_rate_)),
+         static_cast<uint64_t>(std::llround(s.total_ns / sampling_rate_))});
+    if (!s.shapes.empty()) {
+      ProtoWriter label;
+      label.uint64Field(1, shapes_key);
+      label.uint64Field(2, string_id(s.shapes));
+      sample.bytesField(3, label.str());
+    }
+    profile.bytesField(2, sample.str());
+  }
+
+  for (size_t i = 0; i < functions.size(); ++i) {
+    ProtoWriter line;
+    line.uint64Field(1, i + 1);
+    ProtoWriter location;
+    location.uint64Field(1, i + 1);
+    location.bytesField(4, line.str());
+    profile.bytesField(4, location.str());
+
+    ProtoWriter function;
+    function.uint64Field(1, i + 1);
+    function.uint64Field(2, string_id(functions[i]));
+    function.uint64Field(3, string_id(functions[i]));
+    profile.bytesField(5, function.str());
+  }
+
+  // period_type and period: one sample stands for 1 / sampling_rate calls.
+  auto period_type = value_type("calls", "count");
+  for (const auto& str : strings) {
+    profile.bytesField(6, str);
+  }
+  profile.bytesField(11, period_type);
+  profile.uint64Field(12, std::llround(1 / sampling_rate_));
+
+  std::ofstream out(path, std::ios::binary);
+  TORCH_CHECK(out, "Cannot open ", path);
+  out.write(profile.str().data(), profile.str().size());
+}
+
+void enableSamplingProfiler(const SamplingProfilerConfig& config) {
+  TORCH_CHECK(
+      config.sampling_rate > 0 && config.sampling_rate <= 1,
+      "sampling_rate must be in (0, 1]");
+  TORCH_CHECK(config.buffer_size > 0, "buffer_size must be positive");
+  auto& reg = registry();
+  {
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    TORCH_CHECK(!reg.enabled, "The sampling profiler is already enabled");
+    reg.enabled = true;
+    reg.config = config;
+    reg.buffers.clear();
+    reg.profiler_key_included =
+        c10::impl::tls_is_dispatch_key_included(c10::DispatchKey::Profiler);
+    buffer_size = config.buffer_size;
+    ++generation;
+  }
+  bool record_shapes = config.record_shapes;
+  auto handle = pushCallback(
+      [record_shapes](const RecordFunction& fn) {
+        return onStart(fn, record_shapes);
+      },
+      onEnd,
+      /* needs_inputs */ record_shapes,
+      /* sampling_prob */ config.sampling_rate);
+  {
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.callback_handle = handle;
+  }
+  c10::impl::tls_set_dispatch_key_included(c10::DispatchKey::Profiler, true);
+}
+
+SampledProfile disableSamplingProfiler() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  TORCH_CHECK(reg.enabled, "The sampling profiler is not enabled");
+  removeCallback(reg.callback_handle);
+  c10::impl::tls_set_dispatch_key_included(
+      c10::DispatchKey::Profiler, reg.profiler_key_included);
+  reg.enabled = false;
+  auto profile = flushLocked(reg);
+  reg.buffers.clear();
+  return profile;
+}
+
+SampledProfile flushSamplingProfiler() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  TORCH_CHECK(reg.enabled, "The sampling profiler is not enabled");
+  return flushLocked(reg);
+}
+
+bool samplingProfilerEnabled() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  return reg.enabled;
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Note [Sampling profiler]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The regular profiler records every RecordFunction into event lists, which
+// is too expensive to leave on. The sampling profiler registers a sampled
+// RecordFunction callback instead, so that only a fraction `sampling_rate` of
+// the functions pays for more than the sampling decision, and keeps what it
+// records cheap:
+//
+//  - A sample is a small POD: start time, duration, interned ids of the
+//    function and of its enclosing RecordFunctions, and optionally of the
+//    bucketed shapes of its inputs.
+//  - Names are interned once per process into a global table. Each thread
+//    caches the ids it has seen, keyed by a hash of the name, so the table
+//    lock is only taken the first time a thread meets a name.
+//  - Each thread writes its samples into a ring buffer of its own, which
+//    flushSamplingProfiler() drains without stopping the writer. A sample
+//    that finds the buffer full is dropped and counted.
+//  - Input shapes, when recorded, are rounded up to powers of two so that
+//    samples of the same op on similar inputs are aggregated together.
+//
+// flushSamplingProfiler() can be called periodically while the profiler
+// runs. It returns the samples recorded since the previous flush, and their
+// aggregation by call stack and shapes, which can be exported as a Chrome
+// trace or as a pprof profile.
+//
+// Like the regular profiler, the sampling profiler sees the ATen ops called
+// on the thread that enabled it, and on the threads it hands work to
+// (autograd, inter-op pool). TorchScript ops are seen on every thread.
+
+constexpr size_t kSampledStackDepth = 8;
+
+struct SamplingProfilerConfig {
+  // Probability that a RecordFunction is sampled.
+  double sampling_rate = 0.001;
+  // Capacity, in samples, of the buffer of each thread.
+  size_t buffer_size = 4096;
+  // Records the bucketed shapes of the inputs. This makes every
+  // RecordFunction collect its inputs, sampled or not.
+  bool record_shapes = false;
+};
+
+// A sampled RecordFunction.
+struct SampledEvent {
+  // Enclosing functions first.
+  std::vector<std::string> stack;
+  std::string shapes;
+  uint16_t thread_id;
+  int64_t start_ns;
+  int64_t duration_ns;
+};
+
+// The samples with the same stack and shapes.
+struct SampledStats {
+  std::vector<std::string> stack;
+  std::string shapes;
+  int64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t min_ns = 0;
+  int64_t max_ns = 0;
+};
+
+class TORCH_API SampledProfile {
+ public:
+  SampledProfile(
+      double sampling_rate,
+      std::vector<SampledEvent> events,
+      std::vector<SampledStats> stats,
+      int64_t num_dropped);
+
+  double sampling_rate() const {
+    return sampling_rate_;
+  }
+  const std::vector<SampledEvent>& events() const {
+    return events_;
+  }
+  const std::vector<SampledStats>& stats() const {
+    return stats_;
+  }
+  // Samples lost to full buffers.
+  int64_t num_dropped() const {
+    return num_dropped_;
+  }
+
+  // Writes the samples in the Chrome trace event format.
+  void exportChromeTrace(const std::string& path) const;
+  // Writes the aggregated samples as an uncompressed pprof profile
+  // (profile.proto). The values are estimates of the number of calls and of
+  // the time spent, that is, the sampled values divided by the sampling rate.
+  void exportPprof(const std::string& path) const;
+
+ private:
+  double sampling_rate_;
+  std::vector<SampledEvent> events_;
+  std::vector<SampledStats> stats_;
+  int64_t num_dropped_;
+};
+
+TORCH_API void enableSamplingProfiler(const SamplingProfilerConfig& config);
+// Stops sampling and returns what was not flushed yet.
+TORCH_API SampledProfile disableSamplingProfiler();
+TORCH_API SampledProfile flushSamplingProfiler();
+TORCH_API bool samplingProfilerEnabled();
+
+}}} // namespace torch::autograd::profiler
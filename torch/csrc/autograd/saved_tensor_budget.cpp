@@ -0,0 +1,280 @@
+#include <torch/csrc/autograd/saved_tensor_budget.h>
+
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/generated/Functions.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/record_function.h>
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+#include <typeindex>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+// Recomputes an output of `node` from the tensors `node` saved itself.
+// `dtype` is the type of the output that was saved.
+using RecomputeFn = at::Tensor (*)(Node& node, at::ScalarType dtype);
+
+struct Recompute {
+  std::type_index type;
+  uint32_t output_nr;
+  RecomputeFn fn;
+};
+
+template <typename T>
+Recompute recompute(uint32_t output_nr, RecomputeFn fn) {
+  return Recompute{std::type_index(typeid(T)), output_nr, fn};
+}
+
+// The saved outputs that are cheap to recompute: the backward of these ops
+// saves their input too, so recomputing does not keep anything else alive.
+// Only outputs with a grad_fn can be looked up here, as the producer of a
+// non-differentiable one (e.g. the indices of max_pool2d) is not known.
+const std::vector<Recompute>& recomputeRegistry() {
+  using namespace generated;
+  static const std::vector<Recompute> registry = {
+      recompute<SoftmaxBackward>(0, [](Node& node, at::ScalarType dtype) {
+        auto& fn = static_cast<SoftmaxBackward&>(node);
+        auto self = fn.self_.unpack();
+        return at::_softmax(self, fn.dim, dtype != self.scalar_type());
+      }),
+      recompute<LogSoftmaxBackward>(0, [](Node& node, at::ScalarType dtype) {
+        auto& fn = static_cast<LogSoftmaxBackward&>(node);
+        auto self = fn.self_.unpack();
+        return at::_log_softmax(self, fn.dim, dtype != self.scalar_type());
+      }),
+      recompute<SoftplusBackward>(0, [](Node& node, at::ScalarType) {
+        auto& fn = static_cast<SoftplusBackward&>(node);
+        return at::softplus(fn.self_.unpack(), fn.beta, fn.threshold);
+      }),
+      recompute<LogSigmoidBackward>(1, [](Node& node, at::ScalarType) {
+        auto& fn = static_cast<LogSigmoidBackward&>(node);
+        return std::get<1>(at::log_sigmoid_forward(fn.self_.unpack()));
+      }),
+  };
+  return registry;
+}
+
+RecomputeFn findRecompute(const Node& node, uint32_t output_nr) {
+  std::type_index type(typeid(node));
+  for (const auto& entry : recomputeRegistry()) {
+    if (entry.type == type && entry.output_nr == output_nr) {
+      return entry.fn;
+    }
+  }
+  return nullptr;
+}
+
+int64_t elapsedUs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+thread_local std::shared_ptr<SavedTensorPool> current_pool;
+
+} // namespace
+
+struct SavedTensorPool::Entry {
+  enum class State { kResident, kDropped, kOffloaded };
+
+  Entry(std::shared_ptr<SavedTensorPool> pool, const at::Tensor& data)
+      : pool(std::move(pool)),
+        data(data),
+        dtype(data.scalar_type()),
+        device(data.device()),
+        storage(data.storage().unsafeGetStorageImpl()) {}
+
+  ~Entry() {
+    pool->release(*this);
+  }
+
+  // Keeps the pool alive, so its statistics outlive the guard.
+  std::shared_ptr<SavedTensorPool> pool;
+  State state = State::kResident;
+  // Set when kResident.
+  at::Tensor data;
+  // Set when kOffloaded.
+  at::Tensor host;
+  RecomputeFn recompute = nullptr;
+  at::ScalarType dtype;
+  at::Device device;
+  // Only dereferenced when kResident, as `data` keeps it alive.
+  const c10::StorageImpl* storage;
+};
+
+SavedTensorPool::SavedTensorPool(int64_t budget_bytes, bool offload)
+    : budget_bytes_(budget_bytes), offload_(offload) {}
+
+std::shared_ptr<SavedTensorPool::Entry> SavedTensorPool::add(
+    const at::Tensor& data,
+    const Node* producer,
+    uint32_t output_nr) {
+  if (!data.defined() || data.layout() != at::kStrided ||
+      !data.has_storage()) {
+    return nullptr;
+  }
+  auto entry = std::make_shared<Entry>(shared_from_this(), data);
+  if (producer) {
+    entry->recompute = findRecompute(*producer, output_nr);
+  }
+
+  // Entries promoted while evicting are only released after the lock, as
+  // releasing the last reference to one takes the lock too.
+  std::vector<std::shared_ptr<Entry>> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.push_back(entry);
+  auto& use = storages_[entry->storage];
+  if (use.entries.empty()) {
+    use.nbytes = static_cast<int64_t>(data.storage().capacity());
+    stats_.saved_bytes += use.nbytes;
+    stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.saved_bytes);
+  }
+  use.entries.push_back(entry.get());
+  if (entry->recompute) {
+    ++stats_.num_recomputable;
+  }
+  if (budget_bytes_ >= 0 && stats_.saved_bytes > budget_bytes_) {
+    evict(evicted);
+  }
+  return entry;
+}
+
+void SavedTensorPool::evict(std::vector<std::shared_ptr<Entry>>& evicted) {
+  auto fits = [this] { return stats_.saved_bytes <= budget_bytes_; };
+  // First drop what can be recomputed, then offload. Evicted entries leave
+  // the list, and so do the ones already released.
+  for (bool offloading : {false, true}) {
+    if (offloading && !offload_) {
+      break;
+    }
+    for (auto it = entries_.begin(); it != entries_.end() && !fits();) {
+      auto entry = it->lock();
+      if (entry) {
+        evicted.push_back(entry);
+      }
+      if (!entry || entry->state != Entry::State::kResident) {
+        it = entries_.erase(it);
+        continue;
+      }
+      // The tensors sharing a storage are evicted together, and only once
+      // nothing else refers to it: otherwise no memory would be freed.
+      auto& use = storages_.at(entry->storage);
+      bool evictable = holdsLastReference(use);
+      for (const Entry* e : use.entries) {
+        evictable = evictable &&
+            (e->recompute || (offloading && e->device.type() != at::kCPU));
+      }
+      if (!evictable) {
+        ++it;
+        continue;
+      }
+      // Evicting the last entry of a storage erases `use`.
+      auto entries = use.entries;
+      for (Entry* e : entries) {
+        removeResident(*e);
+        if (e->recompute) {
+          e->state = Entry::State::kDropped;
+          ++stats_.num_dropped;
+        } else {
+          e->host = at::empty(
+              e->data.sizes(),
+              e->data.options().device(at::kCPU).pinned_memory(true));
+          e->host.copy_(e->data, /*non_blocking=*/true);
+          e->state = Entry::State::kOffloaded;
+          ++stats_.num_offloaded;
+        }
+        e->data.reset();
+      }
+      it = entries_.erase(it);
+    }
+  }
+}
+
+bool SavedTensorPool::holdsLastReference(const StorageUse& use) const {
+  // Each entry has a TensorImpl of its own (see SavedVariable), so the
+  // storage is only used by the pool if it is used by as many TensorImpls as
+  // there are entries, and those are only used by their entry.
+  for (const Entry* e : use.entries) {
+    if (e->data.use_count() != 1) {
+      return false;
+    }
+  }
+  return use.entries.front()->data.storage().use_count() ==
+      use.entries.size();
+}
+
+void SavedTensorPool::removeResident(Entry& entry) {
+  auto it = storages_.find(entry.storage);
+  auto& entries = it->second.entries;
+  entries.erase(std::find(entries.begin(), entries.end(), &entry));
+  if (entries.empty()) {
+    stats_.saved_bytes -= it->second.nbytes;
+    storages_.erase(it);
+  }
+}
+
+void SavedTensorPool::release(Entry& entry) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entry.state == Entry::State::kResident) {
+    removeResident(entry);
+  }
+}
+
+at::Tensor SavedTensorPool::unpack(
+    const std::shared_ptr<Entry>& entry,
+    Node* saved_for) {
+  auto& pool = *entry->pool;
+  Entry::State state;
+  at::Tensor data;
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    state = entry->state;
+    data = state == Entry::State::kOffloaded ? entry->host : entry->data;
+  }
+  if (state == Entry::State::kResident) {
+    return data;
+  }
+
+  // The tensor is not kept resident again, so that a graph that is retained
+  // does not grow back to its full size.
+  auto start = std::chrono::steady_clock::now();
+  if (state == Entry::State::kDropped) {
+    TORCH_INTERNAL_ASSERT(saved_for, "Cannot recompute a saved tensor without its Node");
+    RECORD_FUNCTION("autograd::recompute_saved_tensor", std::vector<c10::IValue>());
+    AutoGradMode grad_mode(false);
+    data = entry->recompute(*saved_for, entry->dtype);
+  } else {
+    RECORD_FUNCTION("autograd::reload_saved_tensor", std::vector<c10::IValue>());
+    data = data.to(entry->device, /*non_blocking=*/true);
+  }
+  auto elapsed = elapsedUs(start);
+
+  std::lock_guard<std::mutex> lock(pool.mutex_);
+  if (state == Entry::State::kDropped) {
+    ++pool.stats_.num_recomputed;
+    pool.stats_.recompute_time_us += elapsed;
+  } else {
+    ++pool.stats_.num_reloaded;
+    pool.stats_.reload_time_us += elapsed;
+  }
+  return data;
+}
+
+SavedTensorPoolStats SavedTensorPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+const std::shared_ptr<SavedTensorPool>& SavedTensorPool::current() {
+  return current_pool;
+}
+
+void SavedTensorPool::set_current(std::shared_ptr<SavedTensorPool> pool) {
+  current_pool = std::move(pool);
+}
+
+}} // namespace torch::autograd
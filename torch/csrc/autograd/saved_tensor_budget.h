@@ -0,0 +1,139 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+struct Node;
+
+// Note [Saved tensor budget]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The tensors saved for backward (see SavedVariable) usually dominate the
+// memory used by training, and they are all kept until the backward pass
+// needs them. A SavedTensorPool puts a budget on them: while a pool is
+// current on a thread (SavedTensorPoolGuard), the tensors saved on that thread
+// are registered with it, and whenever the saved tensors it holds exceed the
+// budget, the oldest ones (the ones the backward pass will need last) are
+// evicted until the pool fits again:
+//
+//  - First, saved outputs that are cheap to recompute from the other saved
+//    tensors of their Node are dropped, e.g. the result of softmax, which
+//    SoftmaxBackward also saves the input of. They are computed again when
+//    the backward pass unpacks them.
+//  - Then, if the pool was created with `offload`, tensors that are not on
+//    the CPU are copied to pinned host memory, and copied back when unpacked.
+//
+// Saved tensors that can be neither dropped nor offloaded are kept, so the
+// budget is a target rather than a hard limit. The pool accounts for
+// storages rather than tensors: saved tensors sharing a storage count once,
+// with the size of the whole storage, and are only evicted together, once
+// the pool holds the last reference to the storage. Until then, e.g. while
+// the output of softmax is still used by the forward pass or saved by
+// another Node, evicting it would not free any memory.
+//
+// Recomputing and copying back run in "autograd::recompute_saved_tensor" and
+// "autograd::reload_saved_tensor" RecordFunction scopes, so the autograd
+// profiler reports the time they take, and the pool keeps statistics
+// including the peak of the saved tensors it held.
+
+struct SavedTensorPoolStats {
+  // Bytes of the storages of the saved tensors currently held by the pool,
+  // and their peak.
+  int64_t saved_bytes = 0;
+  int64_t peak_bytes = 0;
+  int64_t num_recomputable = 0;
+  int64_t num_dropped = 0;
+  int64_t num_offloaded = 0;
+  int64_t num_recomputed = 0;
+  int64_t num_reloaded = 0;
+  int64_t recompute_time_us = 0;
+  int64_t reload_time_us = 0;
+};
+
+class TORCH_API SavedTensorPool
+    : public std::enable_shared_from_this<SavedTensorPool> {
+ public:
+  // A saved tensor registered with the pool, owned by its SavedVariable.
+  struct Entry;
+
+  // A negative `budget_bytes` never evicts anything, which is still useful
+  // to measure the saved tensors.
+  SavedTensorPool(int64_t budget_bytes, bool offload);
+
+  int64_t budget_bytes() const {
+    return budget_bytes_;
+  }
+  bool offload() const {
+    return offload_;
+  }
+
+  // Registers `data`, saved by a Node. When `data` is an output of `producer`
+  // (the Node that saves it), `producer` and `output_nr` identify it so that
+  // it can be recomputed. Returns nullptr for tensors the pool does not
+  // manage; the caller keeps those itself.
+  std::shared_ptr<Entry> add(
+      const at::Tensor& data,
+      const Node* producer,
+      uint32_t output_nr);
+
+  // Returns the tensor of `entry`, recomputing it or copying it back to its
+  // device if it was evicted. `saved_for` is the Node that saved it.
+  static at::Tensor unpack(const std::shared_ptr<Entry>& entry, Node* saved_for);
+
+  SavedTensorPoolStats stats() const;
+
+  // The pool of the current thread, nullptr if there is none.
+  static const std::shared_ptr<SavedTensorPool>& current();
+  static void set_current(std::shared_ptr<SavedTensorPool> pool);
+
+ private:
+  // The resident entries of a storage, and its size.
+  struct StorageUse {
+    int64_t nbytes = 0;
+    std::vector<Entry*> entries;
+  };
+
+  void release(Entry& entry);
+  // Evicts entries until the pool fits in the budget. Called with mutex_
+  // held; the entries it looked at are returned in `evicted`.
+  void evict(std::vector<std::shared_ptr<Entry>>& evicted);
+  // Whether the entries of `use` hold the only references to its storage.
+  bool holdsLastReference(const StorageUse& use) const;
+  // Removes a resident entry from storages_, before it is evicted or
+  // released.
+  void removeResident(Entry& entry);
+
+  const int64_t budget_bytes_;
+  const bool offload_;
+
+  mutable std::mutex mutex_;
+  // Oldest first.
+  std::list<std::weak_ptr<Entry>> entries_;
+  std::unordered_map<const c10::StorageImpl*, StorageUse> storages_;
+  SavedTensorPoolStats stats_;
+};
+
+// Makes `pool` the current pool of the thread for the lifetime of the guard.
+struct TORCH_API SavedTensorPoolGuard {
+  explicit SavedTensorPoolGuard(std::shared_ptr<SavedTensorPool> pool)
+      : prev_(SavedTensorPool::current()) {
+    SavedTensorPool::set_current(std::move(pool));
+  }
+  ~SavedTensorPoolGuard() {
+    SavedTensorPool::set_current(std::move(prev_));
+  }
+
+ private:
+  std::shared_ptr<SavedTensorPool> prev_;
+};
+
+}} // namespace torch::autograd
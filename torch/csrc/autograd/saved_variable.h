@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_tensor_budget.h>
 
 #include <ATen/ATen.h>
 
@@ -29,6 +30,7 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
+    pooled_.reset();
     return data_.reset();
   }
 
@@ -38,6 +40,9 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // Holds the data instead of data_ when it was saved while a
+  // SavedTensorPool was current, see Note [Saved tensor budget].
+  std::shared_ptr<SavedTensorPool::Entry> pooled_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -0,0 +1,335 @@
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace c10d {
+namespace {
+
+// Returns a future that completes when all the given futures have, with the
+// error of one of them if any failed.
+c10::intrusive_ptr<c10::ivalue::Future> collectFutures(
+    const std::vector<c10::intrusive_ptr<c10::ivalue::Future>>& futures) {
+  auto result = c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+  auto pending = std::make_shared<std::atomic<size_t>>(futures.size());
+  auto error = std::make_shared<c10::optional<std::string>>();
+  auto error_mutex = std::make_shared<std::mutex>();
+  for (const auto& future : futures) {
+    future->addCallback([result, pending, error, error_mutex, future]() {
+      if (future->hasError()) {
+        std::lock_guard<std::mutex> lock(*error_mutex);
+        *error = future->error()->what();
+      }
+      if (--*pending > 0) {
+        return;
+      }
+      std::unique_lock<std::mutex> lock(*error_mutex);
+      if (error->has_value()) {
+        auto message = std::move(error->value());
+        lock.unlock();
+        result->setError(std::move(message));
+      } else {
+        lock.unlock();
+        result->markCompleted();
+      }
+    });
+  }
+  return result;
+}
+
+// Orthonormalizes the columns of a matrix in place (Gram-Schmidt). The
+// matrices are tall and thin, so this is cheaper than a QR decomposition
+// and doesn't need LAPACK.
+void orthogonalize(at::Tensor& matrix) {
+  constexpr double kEpsilon = 1e-8;
+  const auto columns = matrix.size(1);
+  for (int64_t i = 0; i < columns; i++) {
+    auto column = matrix.select(1, i);
+    for (int64_t j = 0; j < i; j++) {
+      auto other = matrix.select(1, j);
+      column.sub_(other.mul(at::dot(other, column)));
+    }
+    column.div_(column.norm().add_(kEpsilon));
+  }
+}
+
+} // namespace
+
+FP16CompressHook::FP16CompressHook(std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+c10::intrusive_ptr<c10::ivalue::Future> FP16CompressHook::runHook(
+    GradBucket& bucket) {
+  // The contents are already divided by the world size, so their sum has
+  // the magnitude of the gradients and doesn't overflow more easily than
+  // they do.
+  auto& compressed = compressed_[bucket.index];
+  compressed.clear();
+  for (const auto& tensor : bucket.tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  return process_group_->allreduce(compressed)->getFuture();
+}
+
+std::vector<at::Tensor> FP16CompressHook::processFuture(
+    GradBucket& bucket,
+    const c10::IValue& /* unused */) {
+  auto& compressed = compressed_.at(bucket.index);
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    bucket.tensors[i].copy_(compressed[i]);
+  }
+  compressed.clear();
+  return bucket.tensors;
+}
+
+void FP16CompressHook::resetState() {
+  compressed_.clear();
+}
+
+TopKCompressHook::TopKCompressHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double ratio)
+    : process_group_(std::move(process_group)), ratio_(ratio) {
+  TORCH_CHECK(
+      ratio_ > 0 && ratio_ <= 1,
+      "Expected the ratio of values to send to be in (0, 1], got ",
+      ratio_);
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> TopKCompressHook::runHook(
+    GradBucket& bucket) {
+  auto& state = states_[bucket.index];
+  const auto replica_count = bucket.tensors.size();
+  if (state.residuals.empty()) {
+    for (const auto& tensor : bucket.tensors) {
+      state.residuals.push_back(at::zeros_like(tensor));
+    }
+  }
+
+  // Every process sends the same number of values, which is required by
+  // allgather.
+  const auto numel = bucket.tensors[0].numel();
+  const auto k = std::min<int64_t>(
+      numel, std::max<int64_t>(1, std::ceil(ratio_ * numel)));
+
+  std::vector<at::Tensor> values;
+  std::vector<at::Tensor> indices;
+  for (size_t i = 0; i < replica_count; i++) {
+    auto& tensor = bucket.tensors[i];
+    auto& residual = state.residuals[i];
+    tensor.add_(residual);
+    auto index = std::get<1>(tensor.abs().topk(k, 0, true, false));
+    values.push_back(tensor.index_select(0, index));
+    indices.push_back(index);
+    residual.copy_(tensor);
+    residual.index_fill_(0, index, 0);
+  }
+
+  const auto output_count = replica_count * process_group_->getSize();
+  state.values.assign(replica_count, {});
+  state.indices.assign(replica_count, {});
+  for (size_t i = 0; i < replica_count; i++) {
+    for (size_t j = 0; j < output_count; j++) {
+      state.values[i].push_back(at::empty_like(values[i]));
+      state.indices[i].push_back(at::empty_like(indices[i]));
+    }
+  }
+  return collectFutures({
+      process_group_->allgather(state.values, values)->getFuture(),
+      process_group_->allgather(state.indices, indices)->getFuture(),
+  });
+}
+
+std::vector<at::Tensor> TopKCompressHook::processFuture(
+    GradBucket& bucket,
+    const c10::IValue& /* unused */) {
+  auto& state = states_.at(bucket.index);
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    auto& tensor = bucket.tensors[i];
+    tensor.zero_();
+    for (size_t j = 0; j < state.values[i].size(); j++) {
+      tensor.index_add_(0, state.indices[i][j], state.values[i][j]);
+    }
+  }
+  state.values.clear();
+  state.indices.clear();
+  return bucket.tensors;
+}
+
+void TopKCompressHook::resetState() {
+  states_.clear();
+}
+
+PowerSGDHook::PowerSGDHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank,
+    uint64_t seed)
+    : process_group_(std::move(process_group)),
+      matrix_approximation_rank_(matrix_approximation_rank),
+      seed_(seed) {
+  TORCH_CHECK(
+      matrix_approximation_rank_ > 0,
+      "Expected a positive matrix_approximation_rank, got ",
+      matrix_approximation_rank_);
+}
+
+PowerSGDHook::BucketState& PowerSGDHook::state(GradBucket& bucket) {
+  auto& state = states_[bucket.index];
+  if (!state.residuals.empty()) {
+    return state;
+  }
+
+  const auto& options = bucket.tensors[0].options();
+  TORCH_CHECK(
+      at::isFloatingType(bucket.tensors[0].scalar_type()),
+      "PowerSGD expects floating point gradients, got ",
+      bucket.tensors[0].scalar_type());
+
+  const auto r = matrix_approximation_rank_;
+  // Every process draws the initial Q matrices from the same generator.
+  auto generator = at::detail::createCPUGenerator(seed_ + bucket.index);
+  size_t p_numel = 0;
+  for (size_t i = 0; i < bucket.sizes.size(); i++) {
+    const auto& sizes = bucket.sizes[i];
+    const auto length = static_cast<int64_t>(bucket.lengths[i]);
+    bool compressed = false;
+    if (sizes.size() >= 2 && length > 0) {
+      const auto n = sizes[0];
+      const auto m = length / n;
+      compressed = (n + m) * r < n * m;
+      if (compressed) {
+        state.qs.push_back(
+            at::randn({m, r}, generator, options.device(at::kCPU))
+                .to(options.device()));
+        p_numel += n * r;
+      }
+    }
+    if (!compressed) {
+      p_numel += length;
+    }
+    state.compressed.push_back(compressed);
+  }
+
+  for (const auto& tensor : bucket.tensors) {
+    state.residuals.push_back(at::zeros_like(tensor));
+    state.ps.push_back(at::empty({static_cast<int64_t>(p_numel)}, options));
+  }
+  return state;
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> PowerSGDHook::runHook(
+    GradBucket& bucket) {
+  const auto r = matrix_approximation_rank_;
+  auto& state = this->state(bucket);
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    auto& tensor = bucket.tensors[i];
+    tensor.add_(state.residuals[i]);
+
+    // P = M Q for the compressed gradients, followed by the others.
+    int64_t offset = 0;
+    size_t q_index = 0;
+    for (size_t j = 0; j < bucket.sizes.size(); j++) {
+      auto grad = tensor.narrow(0, bucket.offsets[j], bucket.lengths[j]);
+      if (state.compressed[j]) {
+        const auto n = bucket.sizes[j][0];
+        auto p = state.ps[i].narrow(0, offset, n * r).view({n, r});
+        at::mm_out(p, grad.view({n, -1}), state.qs[q_index++]);
+        offset += n * r;
+      } else {
+        state.ps[i].narrow(0, offset, grad.numel()).copy_(grad);
+        offset += grad.numel();
+      }
+    }
+  }
+  return process_group_->allreduce(state.ps)->getFuture();
+}
+
+std::vector<at::Tensor> PowerSGDHook::processFuture(
+    GradBucket& bucket,
+    const c10::IValue& /* unused */) {
+  const auto r = matrix_approximation_rank_;
+  auto& state = states_.at(bucket.index);
+  const auto replica_count = bucket.tensors.size();
+
+  size_t q_numel = 0;
+  for (const auto& q : state.qs) {
+    q_numel += q.numel();
+  }
+  std::vector<at::Tensor> qs;
+  for (size_t i = 0; i < replica_count; i++) {
+    qs.push_back(at::empty(
+        {static_cast<int64_t>(q_numel)}, bucket.tensors[i].options()));
+  }
+
+  // Q = M^T P with P orthogonalized. What the local approximation P Q^T
+  // misses of M is kept as error feedback. Uncompressed gradients are
+  // already averaged.
+  for (size_t i = 0; i < replica_count; i++) {
+    auto& tensor = bucket.tensors[i];
+    auto& residual = state.residuals[i];
+    int64_t p_offset = 0;
+    int64_t q_offset = 0;
+    for (size_t j = 0; j < bucket.sizes.size(); j++) {
+      auto grad = tensor.narrow(0, bucket.offsets[j], bucket.lengths[j]);
+      auto error = residual.narrow(0, bucket.offsets[j], bucket.lengths[j]);
+      if (state.compressed[j]) {
+        const auto n = bucket.sizes[j][0];
+        const auto m = grad.numel() / n;
+        auto p = state.ps[i].narrow(0, p_offset, n * r).view({n, r});
+        auto q = qs[i].narrow(0, q_offset, m * r).view({m, r});
+        orthogonalize(p);
+        auto matrix = grad.view({n, m});
+        at::mm_out(q, matrix.t(), p);
+        error.view({n, m}).copy_(matrix).addmm_(p, q.t(), 1, -1);
+        p_offset += n * r;
+        q_offset += m * r;
+      } else {
+        grad.copy_(state.ps[i].narrow(0, p_offset, grad.numel()));
+        error.zero_();
+        p_offset += grad.numel();
+      }
+    }
+  }
+
+  // Second round of communication. Every process gets here in the same
+  // bucket order, see Note [DDP communication hooks].
+  process_group_->allreduce(qs)->wait();
+
+  for (size_t i = 0; i < replica_count; i++) {
+    auto& tensor = bucket.tensors[i];
+    int64_t p_offset = 0;
+    int64_t q_offset = 0;
+    size_t q_index = 0;
+    for (size_t j = 0; j < bucket.sizes.size(); j++) {
+      if (!state.compressed[j]) {
+        p_offset += bucket.lengths[j];
+        continue;
+      }
+      auto grad = tensor.narrow(0, bucket.offsets[j], bucket.lengths[j]);
+      const auto n = bucket.sizes[j][0];
+      const auto m = grad.numel() / n;
+      auto p = state.ps[i].narrow(0, p_offset, n * r).view({n, r});
+      auto q = qs[i].narrow(0, q_offset, m * r).view({m, r});
+      auto matrix = grad.view({n, m});
+      at::mm_out(matrix, p, q.t());
+      // Start the next iteration from the averaged Q.
+      if (i == 0) {
+        state.qs[q_index].copy_(q);
+      }
+      q_index++;
+      p_offset += n * r;
+      q_offset += m * r;
+    }
+  }
+  return bucket.tensors;
+}
+
+void PowerSGDHook::resetState() {
+  states_.clear();
+}
+
+} // namespace c10d
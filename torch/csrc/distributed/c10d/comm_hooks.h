@@ -0,0 +1,169 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// Note [DDP communication hooks]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default the reducer averages the gradients of a bucket by dividing its
+// flattened contents by the world size and allreducing them. A communication
+// hook replaces the allreduce, for example to compress the gradients before
+// they go over the network.
+//
+// The reducer calls `runHook` once a bucket is ready, in bucket order, from
+// the autograd thread. The hook kicks off communication and returns a future
+// that completes when it is done. Once the backward pass has finished, the
+// reducer waits on the futures and calls `processFuture`, again in bucket
+// order, which returns the averaged gradients.
+//
+// Since every process calls both functions in the same order, hooks may
+// issue collectives from either, and hooks that need more than one round of
+// communication can issue the last one from `processFuture`. They must not
+// issue collectives from future callbacks, which run in no particular order.
+//
+// Buckets that hold a sparse gradient are always allreduced.
+
+// The gradients of a bucket, as passed to a communication hook.
+struct GradBucket {
+  // Index of the bucket, in the order buckets are reduced.
+  size_t index;
+
+  // Flattened contents of the bucket, one tensor per model replica. They are
+  // already divided by the world size, so summing them across processes
+  // averages the gradients.
+  std::vector<at::Tensor> tensors;
+
+  // Offset, length and shape of every gradient in the flattened contents.
+  // They are the same for all replicas.
+  std::vector<size_t> offsets;
+  std::vector<size_t> lengths;
+  std::vector<std::vector<int64_t>> sizes;
+};
+
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() = default;
+
+  // Kicks off communication for the bucket and returns a future that
+  // completes when the hook is ready to produce the averaged gradients.
+  virtual c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      GradBucket& bucket) = 0;
+
+  // Returns the averaged gradients of the bucket, one tensor per replica,
+  // shaped like `bucket.tensors`. `value` is the value of the future
+  // returned by `runHook`, which has completed.
+  virtual std::vector<at::Tensor> processFuture(
+      GradBucket& bucket,
+      const c10::IValue& value) = 0;
+
+  // Called when the reducer assigns the gradients to buckets anew. Hooks
+  // that keep state per bucket must drop it.
+  virtual void resetState() {}
+};
+
+// Allreduces the bucket contents in half precision, which halves the bytes
+// sent, and converts the result back.
+class FP16CompressHook : public CommHookInterface {
+ public:
+  explicit FP16CompressHook(std::shared_ptr<ProcessGroup> process_group);
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(
+      GradBucket& bucket,
+      const c10::IValue& value) override;
+
+  void resetState() override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::unordered_map<size_t, std::vector<at::Tensor>> compressed_;
+};
+
+// Sends only the `ratio` fraction of the bucket contents with the largest
+// magnitude, as (value, index) pairs gathered from every process. What is
+// not sent is kept and added to the bucket in the next iteration (error
+// feedback), so that every gradient is eventually applied.
+class TopKCompressHook : public CommHookInterface {
+ public:
+  TopKCompressHook(std::shared_ptr<ProcessGroup> process_group, double ratio);
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(
+      GradBucket& bucket,
+      const c10::IValue& value) override;
+
+  void resetState() override;
+
+ private:
+  struct BucketState {
+    // Error feedback, one tensor per replica.
+    std::vector<at::Tensor> residuals;
+    std::vector<std::vector<at::Tensor>> values;
+    std::vector<std::vector<at::Tensor>> indices;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const double ratio_;
+  std::unordered_map<size_t, BucketState> states_;
+};
+
+// PowerSGD (Vogels et al., 2019): every gradient with two or more
+// dimensions is viewed as an n x m matrix M and approximated by a rank
+// `matrix_approximation_rank` (r) product P Q^T, computed by one step of
+// subspace iteration:
+//
+//   P = allreduce(M Q), orthogonalized
+//   Q = allreduce(M^T P)
+//
+// which sends (n + m) * r values instead of n * m. Q is reused as the
+// starting point of the next iteration, and the difference between M and
+// its local approximation is added to M in the next iteration (error
+// feedback). Gradients that are too small to benefit are allreduced as
+// they are, together with the P matrices.
+class PowerSGDHook : public CommHookInterface {
+ public:
+  PowerSGDHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank,
+      uint64_t seed = 0);
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+
+  std::vector<at::Tensor> processFuture(
+      GradBucket& bucket,
+      const c10::IValue& value) override;
+
+  void resetState() override;
+
+ private:
+  struct BucketState {
+    // Error feedback, one tensor per replica.
+    std::vector<at::Tensor> residuals;
+    // Per gradient, whether it is compressed.
+    std::vector<bool> compressed;
+    // Per compressed gradient, the Q matrix. It is the same on all replicas
+    // and processes, since it starts from the same seed and is updated with
+    // allreduced values.
+    std::vector<at::Tensor> qs;
+    // Per replica, the P matrices followed by the uncompressed gradients.
+    std::vector<at::Tensor> ps;
+  };
+
+  BucketState& state(GradBucket& bucket);
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const int64_t matrix_approximation_rank_;
+  const uint64_t seed_;
+  std::unordered_map<size_t, BucketState> states_;
+};
+
+} // namespace c10d
@@ -18,13 +18,16 @@
 
 #include <c10d/PrefixStore.hpp>
 #include <c10d/ProcessGroupRoundRobin.hpp>
+#include <c10d/ProcessGroupShm.hpp>
 #include <c10d/TCPStore.hpp>
 #include <pybind11/chrono.h>
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/jit/python/pybind_utils.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -36,6 +39,7 @@ namespace {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_HIERARCHICAL_ALLREDUCE_ENV = "GLOO_HIERARCHICAL_ALLREDUCE";
 #endif
 
 std::vector<std::string> split(char separator, const std::string& string) {
@@ -107,6 +111,46 @@ class PythonStore : public ::c10d::Store {
   }
 };
 
+// PythonCommHook runs a communication hook written in Python. The hook is
+// called as `hook(state, bucket)` and returns a torch._C.Future. If the value
+// of the future is a list of tensors, they are the averaged gradients.
+// Otherwise, the hook is expected to have averaged the bucket tensors in
+// place.
+class PythonCommHook : public ::c10d::CommHookInterface {
+ public:
+  PythonCommHook(py::object state, py::object hook)
+      : state_(std::move(state)), hook_(std::move(hook)) {}
+
+  ~PythonCommHook() override {
+    // The hook may be destructed without the GIL.
+    pybind11::gil_scoped_acquire gil;
+    state_.dec_ref();
+    hook_.dec_ref();
+    state_.release();
+    hook_.release();
+  }
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(
+      ::c10d::GradBucket& bucket) override {
+    pybind11::gil_scoped_acquire gil;
+    py::object result = hook_(state_, bucket);
+    return result.cast<torch::jit::PythonFutureWrapper>().fut;
+  }
+
+  std::vector<at::Tensor> processFuture(
+      ::c10d::GradBucket& bucket,
+      const c10::IValue& value) override {
+    if (value.isTensorList()) {
+      return value.toTensorVector();
+    }
+    return bucket.tensors;
+  }
+
+ private:
+  py::object state_;
+  py::object hook_;
+};
+
 PyObject* c10d_init(PyObject* _unused) {
   C10_LOG_API_USAGE_ONCE("c10d.python.import");
   auto c10d_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
@@ -122,11 +166,13 @@ PyObject* c10d_init(PyObject* _unused) {
               std::vector<std::vector<torch::autograd::Variable>>,
               std::vector<std::vector<size_t>>,
               std::shared_ptr<::c10d::ProcessGroup>,
-              std::vector<std::vector<bool>>>(),
+              std::vector<std::vector<bool>>,
+              int64_t>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
           py::arg("process_group"),
-          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>())
+          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
+          py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap)
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
@@ -140,7 +186,68 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "get_overlap_stats",
+          [](::c10d::Reducer& reducer) {
+            const auto stats = reducer.get_overlap_stats();
+            py::dict result;
+            result["backward_time"] = stats.backward_time;
+            result["bucket_launch_times"] = stats.bucket_launch_times;
+            result["wait_time"] = stats.wait_time;
+            result["overlap_ratio"] = stats.overlap_ratio;
+            return result;
+          })
+      .def(
+          "_rebuild_buckets",
+          &::c10d::Reducer::rebuild_buckets,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_register_comm_hook",
+          &::c10d::Reducer::register_comm_hook,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_register_comm_hook",
+          [](::c10d::Reducer& reducer, py::object state, py::object hook) {
+            reducer.register_comm_hook(std::make_shared<PythonCommHook>(
+                std::move(state), std::move(hook)));
+          });
+
+  py::class_<::c10d::GradBucket>(module, "GradBucket")
+      .def_readonly("index", &::c10d::GradBucket::index)
+      .def_readonly("tensors", &::c10d::GradBucket::tensors)
+      .def_readonly("offsets", &::c10d::GradBucket::offsets)
+      .def_readonly("lengths", &::c10d::GradBucket::lengths)
+      .def_readonly("sizes", &::c10d::GradBucket::sizes);
+
+  shared_ptr_class_<::c10d::CommHookInterface>(module, "_CommHookInterface");
+
+  py::class_<
+      ::c10d::FP16CompressHook,
+      ::c10d::CommHookInterface,
+      std::shared_ptr<::c10d::FP16CompressHook>>(module, "_FP16CompressHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  py::class_<
+      ::c10d::TopKCompressHook,
+      ::c10d::CommHookInterface,
+      std::shared_ptr<::c10d::TopKCompressHook>>(module, "_TopKCompressHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, double>(),
+          py::arg("process_group"),
+          py::arg("ratio"));
+
+  py::class_<
+      ::c10d::PowerSGDHook,
+      ::c10d::CommHookInterface,
+      std::shared_ptr<::c10d::PowerSGDHook>>(module, "_PowerSGDHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, int64_t, uint64_t>(),
+          py::arg("process_group"),
+          py::arg("matrix_approximation_rank"),
+          py::arg("seed") = 0);
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -254,7 +361,60 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                std::vector<py::bytes> result;
+                result.reserve(values.size());
+                for (const auto& value : values) {
+                  result.emplace_back(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size());
+                }
+                return result;
+              },
+              py::arg("keys"))
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::arg("keys"),
+              py::arg("values"),
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected,
+                 const std::string& desired) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(expected.begin(), expected.end()),
+                      std::vector<uint8_t>(desired.begin(), desired.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<const char*>(value.data()), value.size());
+              },
+              py::arg("key"),
+              py::arg("expected"),
+              py::arg("desired"));
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -557,6 +717,40 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("process_groups"),
       py::call_guard<py::gil_scoped_release>());
 
+  auto processGroupShm = shared_ptr_class_<::c10d::ProcessGroupShm>(
+      module, "ProcessGroupShm", processGroup);
+
+  shared_ptr_class_<::c10d::ProcessGroupShm::Options>(
+      processGroupShm, "Options")
+      .def(py::init<>())
+      .def_readwrite("timeout", &::c10d::ProcessGroupShm::Options::timeout)
+      .def_readwrite(
+          "buffer_size", &::c10d::ProcessGroupShm::Options::bufferSize)
+      .def_readwrite(
+          "channel_size", &::c10d::ProcessGroupShm::Options::channelSize);
+
+  processGroupShm
+      .def(
+          py::init<
+              const std::shared_ptr<::c10d::Store>&,
+              int,
+              int,
+              ::c10d::ProcessGroupShm::Options>())
+      .def(
+          py::init([](const std::shared_ptr<::c10d::Store>& store,
+                      int rank,
+                      int size,
+                      std::chrono::milliseconds timeout) {
+            ::c10d::ProcessGroupShm::Options options;
+            options.timeout = timeout;
+            return std::make_shared<::c10d::ProcessGroupShm>(
+                store, rank, size, options);
+          }),
+          py::arg("store"),
+          py::arg("rank"),
+          py::arg("size"),
+          py::arg("timeout") = std::chrono::milliseconds(10 * 1000));
+
 #ifdef USE_C10D_GLOO
   auto processGroupGloo = shared_ptr_class_<::c10d::ProcessGroupGloo>(
       module, "ProcessGroupGloo", processGroup);
@@ -568,7 +762,12 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "hierarchical_allreduce",
+          &::c10d::ProcessGroupGloo::Options::hierarchicalAllreduce)
+      .def_readwrite(
+          "hostname", &::c10d::ProcessGroupGloo::Options::hostname);
 
   processGroupGloo.def_static(
       "create_device",
@@ -614,6 +813,12 @@ They are used in specifying strategies for reduction collectives, e.g.,
                   ::c10d::ProcessGroupGloo::createDefaultDevice());
             }
 
+            // Allreduce hierarchically if "GLOO_HIERARCHICAL_ALLREDUCE" is 1.
+            char* hierarchicalEnv = getenv(GLOO_HIERARCHICAL_ALLREDUCE_ENV);
+            if (hierarchicalEnv) {
+              options.hierarchicalAllreduce = std::string(hierarchicalEnv) == "1";
+            }
+
             options.timeout = timeout;
             options.threads = options.devices.size() * 2;
             return std::make_shared<::c10d::ProcessGroupGloo>(
@@ -667,7 +872,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(
           "wait",
           &::c10d::ProcessGroup::Work::wait,
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "get_future",
+          [](::c10d::ProcessGroup::Work& work)
+              -> torch::jit::PythonFutureWrapper {
+            return torch::jit::PythonFutureWrapper(work.getFuture());
+          });
 
 #ifdef USE_CUDA
   module.def(
@@ -43,7 +43,8 @@ Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
     std::shared_ptr<c10d::ProcessGroup> process_group,
-    std::vector<std::vector<bool>> expect_sparse_gradients)
+    std::vector<std::vector<bool>> expect_sparse_gradients,
+    int64_t bucket_bytes_cap)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -52,7 +53,9 @@ Reducer::Reducer(
       next_bucket_(0),
       has_marked_unused_parameters_(false),
       local_used_maps_reduced_(false),
-      backward_stats_base_(0) {
+      backward_stats_base_(0),
+      has_rebuilt_buckets_(false),
+      bucket_bytes_cap_(bucket_bytes_cap) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
 
   TORCH_CHECK(replicas_.size() >= 1, "Expected at least one model replica.");
@@ -309,6 +312,13 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
 
+  // Record the order in which gradients are ready in the first backward
+  // pass, to rebuild the buckets in that order.
+  if (!has_rebuilt_buckets_ && replica_index == 0 &&
+      ready_order_indices_.size() < replicas_[0].size()) {
+    ready_order_indices_.push_back(variable_index);
+  }
+
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
   // this doesn't happen before the next iteration (or call to
@@ -422,7 +432,113 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    bucket.launch_time = current_time_in_nanos() - backward_stats_base_;
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      const auto& replica = bucket.replicas[0];
+      auto& grad_bucket = bucket.grad_bucket;
+      grad_bucket.index = next_bucket_;
+      grad_bucket.tensors = std::move(tensors);
+      grad_bucket.offsets = replica.offsets;
+      grad_bucket.lengths = replica.lengths;
+      grad_bucket.sizes.clear();
+      for (const auto& variable : replica.variables) {
+        grad_bucket.sizes.push_back(variable.sizes().vec());
+      }
+      bucket.future_work = comm_hook_->runHook(grad_bucket);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
+  }
+}
+
+void Reducer::register_comm_hook(
+    std::shared_ptr<CommHookInterface> comm_hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      !comm_hook_,
+      "register_comm_hook can only be called once on a reducer.");
+  TORCH_CHECK(
+      !expect_autograd_hooks_ && !require_finalize_,
+      "register_comm_hook must NOT be called during a backward pass.");
+  comm_hook_ = std::move(comm_hook);
+}
+
+bool Reducer::rebuild_buckets() {
+  std::vector<size_t> order;
+  std::vector<at::Tensor> tensors;
+  std::vector<bool> expect_sparse_gradient;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_rebuilt_buckets_ ||
+        ready_order_indices_.size() < replicas_[0].size()) {
+      return false;
+    }
+    TORCH_CHECK(
+        !expect_autograd_hooks_,
+        "`rebuild_buckets` must NOT be called during autograd execution.");
+    has_rebuilt_buckets_ = true;
+    order = std::move(ready_order_indices_);
+    for (const auto variable_index : order) {
+      tensors.push_back(replicas_[0][variable_index]);
+      expect_sparse_gradient.push_back(
+          expect_sparse_gradients_[0][variable_index]);
+    }
+  }
+
+  // Buckets are sorted by the first position in the ready order of the
+  // gradients they hold, so that they are ready in consecutive order.
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      tensors,
+      {static_cast<size_t>(kDefaultFirstBucketBytes),
+       static_cast<size_t>(bucket_bytes_cap_)},
+      expect_sparse_gradient);
+  for (auto& indices : bucket_indices) {
+    for (auto& index : indices) {
+      index = order[index];
+    }
+  }
+
+  // Processes may have seen their gradients ready in different orders.
+  sync_bucket_indices(bucket_indices);
+  initialize_buckets(std::move(bucket_indices));
+  if (comm_hook_) {
+    comm_hook_->resetState();
+  }
+  return true;
+}
+
+void Reducer::sync_bucket_indices(
+    std::vector<std::vector<size_t>>& bucket_indices) {
+  // Layout: the number of buckets, the size of every bucket, padded to
+  // the number of variables, and the variable indices, bucket after bucket.
+  const auto variable_count = static_cast<int64_t>(replicas_[0].size());
+  auto layout = at::zeros({1 + 2 * variable_count}, at::kLong);
+  auto layout_accessor = layout.accessor<int64_t, 1>();
+  layout_accessor[0] = bucket_indices.size();
+  int64_t index_offset = 1 + variable_count;
+  for (size_t i = 0; i < bucket_indices.size(); i++) {
+    layout_accessor[1 + i] = bucket_indices[i].size();
+    for (const auto variable_index : bucket_indices[i]) {
+      layout_accessor[index_offset++] = variable_index;
+    }
+  }
+  TORCH_INTERNAL_ASSERT(index_offset == layout.numel());
+
+  // Broadcast from rank 0, on the device of the variables, which the
+  // process group is expected to support.
+  std::vector<at::Tensor> tensors = {layout.to(replicas_[0][0].device())};
+  process_group_->broadcast(tensors)->wait();
+  layout.copy_(tensors[0]);
+
+  const auto bucket_count = layout_accessor[0];
+  TORCH_INTERNAL_ASSERT(bucket_count > 0 && bucket_count <= variable_count);
+  bucket_indices.assign(bucket_count, {});
+  index_offset = 1 + variable_count;
+  for (int64_t i = 0; i < bucket_count; i++) {
+    const auto bucket_size = layout_accessor[1 + i];
+    for (int64_t j = 0; j < bucket_size; j++) {
+      bucket_indices[i].push_back(layout_accessor[index_offset++]);
+    }
   }
 }
 
@@ -715,8 +831,57 @@ void Reducer::finalize_backward() {
   // Check that all buckets were completed and had their work kicked off.
   TORCH_INTERNAL_ASSERT(next_bucket_ == buckets_.size());
 
+  // Measure how the reduction overlapped with the backward pass: the
+  // reduction of buckets kicked off before the last gradient was ready ran
+  // concurrently with the backward pass.
+  overlap_stats_ = OverlapStats();
+  for (const auto& replica_stats : backward_stats_) {
+    for (const auto time : replica_stats) {
+      overlap_stats_.backward_time = std::max(overlap_stats_.backward_time, time);
+    }
+  }
+  {
+    int64_t overlapped_bytes = 0;
+    int64_t total_bytes = 0;
+    for (const auto& bucket : buckets_) {
+      const auto& contents = bucket.replicas[0].contents;
+      const auto bytes = contents.numel() * contents.element_size();
+      if (bucket.launch_time < overlap_stats_.backward_time) {
+        overlapped_bytes += bytes;
+      }
+      total_bytes += bytes;
+      overlap_stats_.bucket_launch_times.push_back(bucket.launch_time);
+    }
+    if (total_bytes > 0) {
+      overlap_stats_.overlap_ratio =
+          static_cast<double>(overlapped_bytes) / total_bytes;
+    }
+  }
+  const auto wait_start_time = current_time_in_nanos();
+
   // Wait for asynchronous reduction to complete and unflatten contents.
   for (auto& bucket : buckets_) {
+    if (bucket.future_work) {
+      bucket.future_work->wait();
+      auto& grad_bucket = bucket.grad_bucket;
+      const auto result =
+          comm_hook_->processFuture(grad_bucket, bucket.future_work->value());
+      bucket.future_work.reset();
+      TORCH_CHECK(
+          result.size() == bucket.replicas.size(),
+          "Expected the communication hook to return ",
+          bucket.replicas.size(),
+          " tensors, got ",
+          result.size());
+      for (size_t i = 0; i < result.size(); i++) {
+        auto& contents = bucket.replicas[i].contents;
+        if (!result[i].is_same(contents)) {
+          contents.copy_(result[i].view_as(contents));
+        }
+      }
+      finalize_bucket_dense(bucket);
+      continue;
+    }
     TORCH_INTERNAL_ASSERT(bucket.work);
     bucket.work->wait();
     if (bucket.expect_sparse_gradient) {
@@ -726,6 +891,8 @@ void Reducer::finalize_backward() {
     }
   }
 
+  overlap_stats_.wait_time = current_time_in_nanos() - wait_start_time;
+
   // Reset unused parameter accounting.
   for (auto& local_used : local_used_maps_) {
     local_used.fill_(0);
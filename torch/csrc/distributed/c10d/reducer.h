@@ -10,20 +10,27 @@
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 
 namespace c10d {
 
+constexpr int64_t kDefaultFirstBucketBytes = 1024 * 1024;
+constexpr int64_t kDefaultBucketBytesCap = 25 * 1024 * 1024;
+
 class Reducer {
  public:
   // The constructor takes a list of variables for every model replica.
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  // The `bucket_bytes_cap` is the bucket size limit used when the buckets
+  // are rebuilt (see `rebuild_buckets`).
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
       std::shared_ptr<c10d::ProcessGroup> process_group,
-      std::vector<std::vector<bool>> expect_sparse_gradients);
+      std::vector<std::vector<bool>> expect_sparse_gradients,
+      int64_t bucket_bytes_cap = kDefaultBucketBytesCap);
 
   ~Reducer() noexcept(false);
 
@@ -47,6 +54,39 @@ class Reducer {
     return backward_stats_;
   }
 
+  // The initial bucket assignment assumes that gradients are ready in the
+  // reverse order of the variables. The reducer records the order in which
+  // they are actually ready in the first backward pass, and this function
+  // reassigns the buckets in that order, so that they become ready one after
+  // the other. All processes use the assignment of rank 0, which is
+  // broadcast through the process group. This function must therefore be
+  // called by all processes at the same point, outside of the backward pass.
+  // Returns true if the buckets were rebuilt, which happens only once.
+  bool rebuild_buckets();
+
+  // How the reduction of the last iteration overlapped with its backward
+  // pass. Times are in nanoseconds, relative to `prepare_for_backward`.
+  struct OverlapStats {
+    // When the last gradient was ready.
+    int64_t backward_time = 0;
+    // When the reduction of every bucket was kicked off.
+    std::vector<int64_t> bucket_launch_times;
+    // How long finalizing the backward pass waited for the reductions.
+    int64_t wait_time = 0;
+    // Fraction of the gradient bytes whose reduction was kicked off before
+    // the last gradient was ready.
+    double overlap_ratio = 0;
+  };
+
+  OverlapStats get_overlap_stats() const {
+    return overlap_stats_;
+  }
+
+  // Replaces the allreduce of dense buckets with a communication hook.
+  // See Note [DDP communication hooks]. It can be registered only once,
+  // before the first backward pass.
+  void register_comm_hook(std::shared_ptr<CommHookInterface> comm_hook);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -92,6 +132,9 @@ class Reducer {
   // Work handle for allreduce on local_used_maps_
   std::shared_ptr<c10d::ProcessGroup::Work> local_used_work_;
 
+  // Communication hook that replaces the allreduce of dense buckets, if any.
+  std::shared_ptr<CommHookInterface> comm_hook_;
+
   void mark_variable_ready_dense(VariableIndex index);
 
   void mark_variable_ready_sparse(VariableIndex index);
@@ -108,6 +151,9 @@ class Reducer {
 
   void finalize_backward();
 
+  // Overwrites the bucket assignment with the one of rank 0.
+  void sync_bucket_indices(std::vector<std::vector<size_t>>& bucket_indices);
+
   // A bucket replica represents [1..N] gradients to be reduced,
   // with the same dtype, on the same device.
   //
@@ -160,6 +206,14 @@ class Reducer {
     // Keep work handle around when this set of buckets is being reduced.
     std::shared_ptr<c10d::ProcessGroup::Work> work;
 
+    // The bucket as passed to the communication hook, and the future it
+    // returned, when this bucket is reduced by a hook instead.
+    GradBucket grad_bucket;
+    c10::intrusive_ptr<c10::ivalue::Future> future_work;
+
+    // When the reduction was kicked off, relative to `prepare_for_backward`.
+    int64_t launch_time = 0;
+
     // If this bucket should expect a single sparse gradient.
     // Implies: replicas[i].variables.size() == 1.
     bool expect_sparse_gradient = false;
@@ -186,6 +240,13 @@ class Reducer {
   // the point in time buckets were ready, or ideal bucket assignment/ordering.
   int64_t backward_stats_base_;
   std::vector<std::vector<int64_t>> backward_stats_;
+  OverlapStats overlap_stats_;
+
+  // The indices of the variables of the first replica, in the order their
+  // gradients were ready in the first backward pass, to rebuild the buckets.
+  std::vector<size_t> ready_order_indices_;
+  bool has_rebuilt_buckets_;
+  const int64_t bucket_bytes_cap_;
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
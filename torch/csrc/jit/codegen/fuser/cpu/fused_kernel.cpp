@@ -1,13 +1,19 @@
 #include <torch/csrc/jit/codegen/fuser/cpu/fused_kernel.h>
+#include <ATen/native/DispatchStub.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 #include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <array>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -37,12 +43,14 @@ static const std::string check_exists_string =
 static std::vector<std::string> env_list;
 constexpr int so_suffix_len = 4;
 constexpr int cpp_suffix_len = 4;
+static const std::string so_suffix = ".dll";
 #else
 static const std::string so_template = "/tmp/pytorch_fuserXXXXXX.so";
 static const std::string cpp_template = "/tmp/pytorch_fuserXXXXXX.cpp";
 static const std::string check_exists_string = "which '${program}' > /dev/null";
 constexpr int so_suffix_len = 3;
 constexpr int cpp_suffix_len = 4;
+static const std::string so_suffix = ".so";
 #endif
 
 static bool programExists(const std::string& program) {
@@ -193,6 +201,8 @@ struct CompilerConfig {
   const std::string openmp_flags = "-fopenmp";
 #endif
   bool openmp = true;
+  // Output of the compiler's version query, read on first use.
+  c10::optional<std::string> version;
 };
 
 static CompilerConfig& getConfig() {
@@ -245,16 +255,71 @@ static const std::string compile_string =
 #endif
     "-std=c++14 -fPIC ${fopenmp} -shared \"${cpp_file}\" -o \"${so_file}\" -lm";
 #endif
-static void runCompiler(
+#ifdef _MSC_VER
+// cl prints its version banner when run without arguments.
+static const std::string version_string = "\"${cxx}\" 2>&1";
+#else
+static const std::string version_string = "\"${cxx}\" --version 2>/dev/null";
+#endif
+static const std::string& compilerVersion() {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& config = getConfig();
+  if (!config.version) {
+    TemplateEnv env;
+    env.s("cxx", config.cxx);
+    std::string cmd = format(version_string, env);
+#ifdef _MSC_VER
+    c10::optional<std::string> out = exec(cmd);
+    config.version = out ? *out : "";
+#else
+    std::string out;
+    if (FILE* pipe = popen(cmd.c_str(), "r")) {
+      std::array<char, 128> buffer;
+      while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
+        out += buffer.data();
+      }
+      pclose(pipe);
+    }
+    config.version = out;
+#endif
+  }
+  return *config.version;
+}
+
+static std::string compileCommand(
     const std::string& cpp_file,
-    const std::string& so_file) {
+    const std::string& so_file,
+    bool openmp) {
   auto& config = getConfig();
   TemplateEnv env;
   env.s("cxx", config.cxx);
-  env.s("fopenmp", config.openmp ? config.openmp_flags : "");
+  env.s("fopenmp", openmp ? config.openmp_flags : "");
   env.s("cpp_file", cpp_file);
   env.s("so_file", so_file);
-  std::string result = format(compile_string, env);
+  return format(compile_string, env);
+}
+
+// Everything the shared library built from `code` depends on: the source, the
+// compile command with `openmp`, the compiler version, and the CPU it was
+// built on.
+static std::string diskCacheKey(const std::string& code, bool openmp) {
+  std::ostringstream key;
+  key << "cpu_fuser\n"
+      << compileCommand("${cpp_file}", "${so_file}", openmp) << "\n"
+      << compilerVersion() << "\n"
+      << "capability "
+      << static_cast<int>(at::native::get_cpu_capability()) << "\n"
+      << code;
+  return key.str();
+}
+
+// Returns whether the kernel was compiled with OpenMP.
+static bool runCompiler(
+    const std::string& cpp_file,
+    const std::string& so_file) {
+  auto& config = getConfig();
+  std::string result = compileCommand(cpp_file, so_file, config.openmp);
 #ifdef _MSC_VER
   intptr_t r = run(result);
 #else
@@ -267,6 +332,7 @@ static void runCompiler(
     return runCompiler(cpp_file, so_file);
   }
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
+  return config.openmp;
 }
 
 #ifdef _MSC_VER
@@ -299,6 +365,15 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
+  const bool openmp = getConfig().openmp;
+  if (kernelCacheEnabled()) {
+    auto cached = lookupCachedKernel(diskCacheKey(code_, openmp), so_suffix);
+    if (cached) {
+      so_lib = make_unique<at::DynamicLibrary>(cached->c_str());
+      loadKernel();
+      return;
+    }
+  }
   TempFile so_file(so_template, so_suffix_len);
   TempFile cpp_file(cpp_template, cpp_suffix_len);
   cpp_file.write(code_);
@@ -307,10 +382,28 @@ FusedKernelCPU::FusedKernelCPU(
   so_file.close();
   cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
+  const bool compiled_with_openmp =
+      runCompiler(cpp_file.name(), so_file.name());
   if (debugFuser() >= 2)
     disas(so_file.name());
+  if (kernelCacheEnabled()) {
+    std::ifstream so(so_file.name(), std::ios::binary);
+    std::string data(
+        (std::istreambuf_iterator<char>(so)), std::istreambuf_iterator<char>());
+    // Stored under the key of the flags it was compiled with, and, if OpenMP
+    // had to be turned off, also under the key it was looked up with, so that
+    // the next process, which starts with OpenMP again, finds it.
+    storeCachedKernel(
+        diskCacheKey(code_, compiled_with_openmp), so_suffix, data);
+    if (compiled_with_openmp != openmp) {
+      storeCachedKernel(diskCacheKey(code_, openmp), so_suffix, data);
+    }
+  }
   so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+  loadKernel();
+}
+
+void FusedKernelCPU::loadKernel() {
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
@@ -35,6 +35,8 @@ struct TORCH_API FusedKernelCPU : public ::torch::jit::fuser::FusedKernel {
   }
 
  private:
+  void loadKernel();
+
   std::unique_ptr<at::DynamicLibrary> so_lib;
   void (*kernel)(uint32_t, void**) = nullptr;
 };
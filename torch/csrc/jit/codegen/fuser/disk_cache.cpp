@@ -0,0 +1,271 @@
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
+
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+namespace {
+
+std::atomic<int64_t> num_hits{0};
+std::atomic<int64_t> num_misses{0};
+std::atomic<int64_t> num_stores{0};
+
+std::mutex& dirMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Bump when the code the fusers emit, or the runtime functions it calls,
+// change in a way that makes earlier entries invalid.
+constexpr int kCacheFormatVersion = 1;
+
+// Identifies the library this file is part of, so that a different build of
+// PyTorch never uses the entries of another one, even with the same format
+// version.
+std::string buildIdentity() {
+  std::ostringstream id;
+  id << "kernel_cache " << kCacheFormatVersion;
+#ifndef _WIN32
+  Dl_info info;
+  struct stat st;
+  if (dladdr(reinterpret_cast<void*>(&buildIdentity), &info) != 0 &&
+      info.dli_fname && stat(info.dli_fname, &st) == 0) {
+    id << " " << info.dli_fname << " " << st.st_size << " " << st.st_mtime;
+  }
+#endif
+  return id.str();
+}
+
+// The key an entry is actually stored under.
+std::string versionedKey(const std::string& key) {
+  static const std::string identity = buildIdentity();
+  return identity + "\n" + key;
+}
+
+bool makeDir(const std::string& path) {
+#ifdef _WIN32
+  return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+  // Entries are dlopen'ed, so other users must not be able to write them.
+  return mkdir(path.c_str(), 0700) == 0 || errno == EEXIST;
+#endif
+}
+
+bool makeDirs(const std::string& path) {
+  for (size_t pos = path.find_first_of("/\\", 1); pos != std::string::npos;
+       pos = path.find_first_of("/\\", pos + 1)) {
+    makeDir(path.substr(0, pos));
+  }
+  return makeDir(path);
+}
+
+// Creates the directory if needed, and checks that only the current user can
+// write to it.
+bool prepareDir(const std::string& dir) {
+  if (!makeDirs(dir)) {
+    TORCH_WARN("Could not create the kernel cache directory ", dir);
+    return false;
+  }
+#ifndef _WIN32
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0 || st.st_uid != geteuid() ||
+      (st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+    TORCH_WARN(
+        "Not using the kernel cache directory ",
+        dir,
+        ": it must be owned by the current user and not writable by others");
+    return false;
+  }
+#endif
+  return true;
+}
+
+std::string& cacheDir() {
+  static std::string dir = []() -> std::string {
+    const char* env = std::getenv("PYTORCH_JIT_KERNEL_CACHE_DIR");
+    if (!env || !*env || !prepareDir(env)) {
+      return "";
+    }
+    return env;
+  }();
+  return dir;
+}
+
+// The entry names must not change between processes or builds, so this does
+// not use std::hash.
+uint64_t fnv1a(const std::string& s) {
+  uint64_t h = 14695981039346656037ull;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string entryPath(
+    const std::string& dir,
+    const std::string& key,
+    const std::string& suffix) {
+  char name[17];
+  snprintf(
+      name,
+      sizeof(name),
+      "%016llx",
+      static_cast<unsigned long long>(fnv1a(versionedKey(key))));
+  return dir + "/" + name + suffix;
+}
+
+c10::optional<std::string> readFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return c10::nullopt;
+  }
+  return std::string(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Writes `data` to a temporary file in the cache directory and renames it to
+// `path`, so that readers never see a partially written file.
+bool writeFileAtomic(const std::string& path, const std::string& data) {
+  static std::atomic<int> counter{0};
+  std::ostringstream tmp;
+#ifdef _WIN32
+  tmp << path << ".tmp." << _getpid() << "." << counter++;
+#else
+  tmp << path << ".tmp." << getpid() << "." << counter++;
+#endif
+  {
+    std::ofstream out(tmp.str(), std::ios::binary);
+    if (!out || !out.write(data.data(), data.size())) {
+      std::remove(tmp.str().c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp.str().c_str(), path.c_str()) != 0) {
+    // Another process may have stored the same entry first.
+    std::remove(tmp.str().c_str());
+    return readFile(path).has_value();
+  }
+  return true;
+}
+
+c10::optional<std::string> findEntry(
+    const std::string& key,
+    const std::string& suffix) {
+  std::string dir = getKernelCacheDir();
+  if (dir.empty()) {
+    return c10::nullopt;
+  }
+  std::string path = entryPath(dir, key, suffix);
+  auto stored_key = readFile(entryPath(dir, key, ".key"));
+  if (!stored_key || *stored_key != versionedKey(key)) {
+    num_misses++;
+    return c10::nullopt;
+  }
+  return path;
+}
+
+} // namespace
+
+void setKernelCacheDir(const std::string& dir) {
+  std::lock_guard<std::mutex> guard(dirMutex());
+  cacheDir() = !dir.empty() && prepareDir(dir) ? dir : "";
+}
+
+std::string getKernelCacheDir() {
+  std::lock_guard<std::mutex> guard(dirMutex());
+  return cacheDir();
+}
+
+bool kernelCacheEnabled() {
+  return !getKernelCacheDir().empty();
+}
+
+c10::optional<std::string> lookupCachedKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  auto path = findEntry(key, suffix);
+  if (!path) {
+    return c10::nullopt;
+  }
+  std::ifstream in(*path, std::ios::binary);
+  if (!in) {
+    num_misses++;
+    return c10::nullopt;
+  }
+  num_hits++;
+  return path;
+}
+
+c10::optional<std::string> loadCachedKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  auto path = findEntry(key, suffix);
+  if (!path) {
+    return c10::nullopt;
+  }
+  auto data = readFile(*path);
+  if (!data) {
+    num_misses++;
+    return c10::nullopt;
+  }
+  num_hits++;
+  return data;
+}
+
+void storeCachedKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data) {
+  std::string dir = getKernelCacheDir();
+  if (dir.empty()) {
+    return;
+  }
+  makeDirs(dir);
+  // The key goes last: an entry is only visible once its key is in place.
+  if (writeFileAtomic(entryPath(dir, key, suffix), data) &&
+      writeFileAtomic(entryPath(dir, key, ".key"), versionedKey(key))) {
+    num_stores++;
+  } else {
+    TORCH_WARN_ONCE("Could not write to the kernel cache in ", dir);
+  }
+}
+
+KernelCacheStats getKernelCacheStats() {
+  KernelCacheStats stats;
+  stats.hits = num_hits;
+  stats.misses = num_misses;
+  stats.stores = num_stores;
+  return stats;
+}
+
+void resetKernelCacheStats() {
+  num_hits = 0;
+  num_misses = 0;
+  num_stores = 0;
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
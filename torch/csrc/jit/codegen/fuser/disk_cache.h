@@ -0,0 +1,66 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// A persistent cache of compiled kernels, shared by the CPU fuser and the
+// TensorExpr LLVM backend so that a new process does not recompile the kernels
+// an earlier one already built.
+//
+// Entries are content addressed. The caller describes everything a compiled
+// object depends on (kernel source or IR, target CPU, compiler and flags) in a
+// key string, and the entry is named after a hash of that key. A copy of the
+// key is stored next to the entry and compared on lookup, so a hash collision
+// is a miss rather than a wrong kernel. Entries are written to a temporary
+// file and renamed into place, so several processes can share a directory.
+// Keys also include a cache format version and the identity of the PyTorch
+// library, so entries built by another version of PyTorch are never used.
+//
+// The cache is disabled until a directory is set, either with the
+// PYTORCH_JIT_KERNEL_CACHE_DIR environment variable or setKernelCacheDir().
+// Since entries are loaded as code, the directory must belong to the current
+// user and not be writable by others; otherwise the cache stays disabled.
+
+struct KernelCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t stores = 0;
+};
+
+// An empty `dir` disables the cache. The directory is created if needed,
+// accessible to the current user only.
+TORCH_API void setKernelCacheDir(const std::string& dir);
+TORCH_API std::string getKernelCacheDir();
+TORCH_API bool kernelCacheEnabled();
+
+// Returns the path of the entry for `key`, or nullopt if there is none.
+// Lookups made while the cache is disabled are not counted.
+TORCH_API c10::optional<std::string> lookupCachedKernel(
+    const std::string& key,
+    const std::string& suffix);
+
+// Returns the contents of the entry for `key`, or nullopt if there is none.
+TORCH_API c10::optional<std::string> loadCachedKernel(
+    const std::string& key,
+    const std::string& suffix);
+
+// Stores `data` as the entry for `key`. Failing to write the cache is not an
+// error: the kernel just gets compiled again next time.
+TORCH_API void storeCachedKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data);
+
+TORCH_API KernelCacheStats getKernelCacheStats();
+TORCH_API void resetKernelCacheStats();
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
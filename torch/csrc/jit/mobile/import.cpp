@@ -10,6 +10,7 @@
 
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // The import process to serialize the bytecode package.
@@ -251,9 +252,22 @@ c10::IValue BytecodeDeserializer::readArchive(
     }
   };
 
+  // Read all the tensors of the archive at once, so that compressed ones are
+  // decompressed in parallel.
+  std::unordered_map<std::string, at::DataPtr> records;
+  auto names = reader_->getRecordsInDirectory(archive_name);
+  auto tensor_records = reader_->getRecords(names);
+  for (size_t i = 0; i < names.size(); i++) {
+    records[names[i]] = std::move(std::get<0>(tensor_records[i]));
+  }
+
   auto read_record = [&](const std::string& name) {
     std::stringstream ss;
     ss << archive_name << "/" << name;
+    auto it = records.find(ss.str());
+    if (it != records.end() && it->second) {
+      return std::move(it->second);
+    }
     return std::get<0>(reader_->getRecord(ss.str()));
   };
 
@@ -278,8 +292,14 @@ mobile::Module _load_for_mobile(
 
 mobile::Module _load_for_mobile(
     const std::string& filename,
-    c10::optional<at::Device> device) {
-  std::unique_ptr<FileAdapter> rai = std::make_unique<FileAdapter>(filename);
+    c10::optional<at::Device> device,
+    bool use_mmap) {
+  std::unique_ptr<ReadAdapterInterface> rai;
+  if (use_mmap) {
+    rai = std::make_unique<MmapAdapter>(filename);
+  } else {
+    rai = std::make_unique<FileAdapter>(filename);
+  }
   auto module = _load_for_mobile(std::move(rai), device);
   return module;
 }
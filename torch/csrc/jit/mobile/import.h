@@ -5,20 +5,25 @@
 #include <memory>
 
 #include "caffe2/serialize/file_adapter.h"
+#include "caffe2/serialize/mmap_adapter.h"
 
 namespace torch {
 namespace jit {
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapAdapter;
 using caffe2::serialize::ReadAdapterInterface;
 
 TORCH_API mobile::Module _load_for_mobile(
     std::istream& in,
     c10::optional<at::Device> device = c10::nullopt);
 
+// If use_mmap is true, the file is memory-mapped and tensors stored
+// uncompressed share its pages copy-on-write instead of being copied.
 TORCH_API mobile::Module _load_for_mobile(
     const std::string& filename,
-    c10::optional<at::Device> device = c10::nullopt);
+    c10::optional<at::Device> device = c10::nullopt,
+    bool use_mmap = false);
 
 TORCH_API mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
@@ -1,6 +1,7 @@
 #include <torch/csrc/utils/pybind.h>
 
 #include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/codegen/fuser/interface.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/frontend/ir_emitter.h>
@@ -59,6 +60,7 @@
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
+#include <torch/csrc/jit/runtime/static/init.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
@@ -417,6 +419,20 @@ void initJITBindings(PyObject* module) {
             getExecutorMode() = profiling_flag;
             return oldState;
           })
+      .def(
+          "_jit_set_out_variant_mode",
+          [](bool enabled) {
+            bool oldState = getOutVariantMode();
+            getOutVariantMode() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_superinstruction_mode",
+          [](bool enabled) {
+            bool oldState = getSuperinstructionMode();
+            getSuperinstructionMode() = enabled;
+            return oldState;
+          })
       .def(
           "_jit_set_num_profiled_runs",
           [](size_t num) {
@@ -491,6 +507,33 @@ void initJITBindings(PyObject* module) {
             return getTECudaPointwiseBlockSize() = block_size;
           })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
+      .def(
+          "_jit_texpr_compile_stats",
+          []() {
+            auto stats = tensorexpr::getTECompileStats();
+            py::dict result;
+            result["kernels"] = stats.kernels;
+            result["compile_time_us"] = stats.compile_time_us;
+            result["arena_bytes"] = stats.arena_bytes;
+            result["interned_exprs"] = stats.interned_exprs;
+            return result;
+          })
+      .def("_jit_reset_texpr_compile_stats", &tensorexpr::resetTECompileStats)
+      .def(
+          "_jit_set_kernel_cache_dir",
+          [](const std::string& dir) { fuser::setKernelCacheDir(dir); })
+      .def("_jit_get_kernel_cache_dir", &fuser::getKernelCacheDir)
+      .def(
+          "_jit_kernel_cache_stats",
+          []() {
+            auto stats = fuser::getKernelCacheStats();
+            py::dict result;
+            result["hits"] = stats.hits;
+            result["misses"] = stats.misses;
+            result["stores"] = stats.stores;
+            return result;
+          })
+      .def("_jit_reset_kernel_cache_stats", &fuser::resetKernelCacheStats)
       .def(
           "_jit_fuser_get_fused_kernel_code",
           [](Graph& g, std::vector<at::Tensor> inps) {
@@ -603,6 +646,11 @@ void initJITBindings(PyObject* module) {
              const char* data,
              size_t size) { return self.writeRecord(name, data, size); })
       .def("write_end_of_file", &PyTorchStreamWriter::writeEndOfFile)
+      .def(
+          "set_compression",
+          &PyTorchStreamWriter::setCompression,
+          py::arg("level"),
+          py::arg("min_size") = caffe2::serialize::kMinSizeToCompress)
       .def(
           "write_record",
           [](PyTorchStreamWriter& self,
@@ -867,6 +915,7 @@ void initJITBindings(PyObject* module) {
   tracer::initPythonTracerBindings(module);
   initTreeViewBindings(module);
   initJitScriptBindings(module);
+  initStaticRuntimeBindings(module);
 
   setPrintHandler([](const std::string& str) {
     py::gil_scoped_acquire acquire;
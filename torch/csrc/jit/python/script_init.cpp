@@ -789,19 +789,25 @@ void initJitScriptBindings(PyObject* module) {
           "save",
           [](Module& m,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
-            m.save(filename, _extra_files);
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             int _compression_level = 0) {
+            ExportModule(
+                m, filename, _extra_files, false, _compression_level);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compression_level") = 0)
       .def(
           "save_to_buffer",
-          [](Module& m, const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+          [](Module& m,
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             int _compression_level = 0) {
             std::ostringstream buf;
-            m.save(buf, _extra_files);
+            ExportModule(m, buf, _extra_files, false, _compression_level);
             return py::bytes(buf.str());
           },
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compression_level") = 0)
       .def(
           "_save_for_mobile",
           [](Module& m,
@@ -952,7 +958,8 @@ void initJitScriptBindings(PyObject* module) {
           "save",
           [](const StrongFunctionPtr& self,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             int _compression_level = 0) {
             Module module("__torch__.PlaceholderModule");
             // [issue 27343]
             // Modules have 'training' attributes by default, but due to
@@ -963,23 +970,27 @@ void initJitScriptBindings(PyObject* module) {
             // be deleted.
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
-            module.save(filename, _extra_files);
+            ExportModule(
+                module, filename, _extra_files, false, _compression_level);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compression_level") = 0)
       .def(
           "save_to_buffer",
           [](const StrongFunctionPtr& self,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             int _compression_level = 0) {
             std::ostringstream buf;
             Module module("__torch__.PlaceholderModule");
             // see [issue 27343]
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
-            module.save(buf, _extra_files);
+            ExportModule(module, buf, _extra_files, false, _compression_level);
             return py::bytes(buf.str());
           },
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_compression_level") = 0)
       .def_property_readonly(
           "graph",
           [](const StrongFunctionPtr& self) { return self.function_->graph(); })
@@ -1161,7 +1172,8 @@ void initJitScriptBindings(PyObject* module) {
       [](std::shared_ptr<CompilationUnit> cu,
          const std::string& filename,
          py::object map_location,
-         ExtraFilesMap& extra_files) {
+         ExtraFilesMap& extra_files,
+         bool use_mmap) {
         c10::optional<at::Device> optional_device;
         if (!map_location.is(py::none())) {
           AT_ASSERT(THPDevice_Check(map_location.ptr()));
@@ -1169,7 +1181,7 @@ void initJitScriptBindings(PyObject* module) {
               reinterpret_cast<THPDevice*>(map_location.ptr())->device;
         }
         return import_ir_module(
-            std::move(cu), filename, optional_device, extra_files);
+            std::move(cu), filename, optional_device, extra_files, use_mmap);
       });
   m.def(
       "import_ir_module_from_buffer",
@@ -17,6 +17,7 @@ namespace jit {
 // T - index into the type table, used for guard instructions
 // S - index into object slots
 // C - index into code table
+// V - index into the out variant table, used for OP_OUT
 
 #define FORALL_OPCODES(_)                                                   \
   _(OP, "O") /* invoke operator X */                                        \
@@ -51,7 +52,16 @@ namespace jit {
   _(ISINSTANCE, "TI") /* check object is one of  types[X:X+N]  */           \
   _(TUPLE_SLICE, "II") /* slice tup[X:(X+N)] */                             \
   _(FORK, "CN") /* launch a thread to run code entry x with N inputs  */    \
-  _(WARN, "") /* emit a warning with line information */
+  _(WARN, "") /* emit a warning with line information */                   \
+  _(OP_OUT, "OV") /* invoke operator X, or its out variant N on a buffer */ \
+  /* superinstructions, only produced by CodeImpl for its own execution */  \
+  _(LOAD2, "RR") /* push registers X and N */                               \
+  _(MOVE2, "RR") /* push registers X and N, clearing both */                \
+  _(LOAD_MOVE, "RR") /* LOAD X, then MOVE N */                              \
+  _(MOVE_LOAD, "RR") /* MOVE X, then LOAD N */                              \
+  _(OP_STORE, "OR") /* invoke operator X, store its output to register N */ \
+  _(LOADC_OP, "OC") /* push the constant N, then invoke operator X */       \
+  _(OP_JF, "OP") /* invoke operator X, pop the result, if false, branch N */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
@@ -28,6 +28,7 @@ using torch::distributed::autograd::DistAutogradContainer;
 
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -349,6 +350,45 @@ struct WithCurrentNode {
   Node* old_value_;
 };
 
+// Returns the out= overload of `op` if `op` is a functional operator returning
+// a single fresh Tensor, e.g. `aten::add.out` for `aten::add.Tensor`: the
+// overload taking the same arguments followed by `*, Tensor(a!) out`.
+static std::shared_ptr<Operator> findOutVariant(const Operator& op) {
+  const FunctionSchema& schema = op.schema();
+  if (schema.is_vararg() || schema.is_mutable() ||
+      schema.returns().size() != 1 ||
+      schema.returns()[0].type()->kind() != TypeKind::TensorType ||
+      schema.returns()[0].alias_info()) {
+    return nullptr;
+  }
+  const auto& args = schema.arguments();
+  for (const auto& candidate :
+       getAllOperatorsFor(Symbol::fromQualString(schema.name()))) {
+    const FunctionSchema& out_schema = candidate->schema();
+    const auto& out_args = out_schema.arguments();
+    if (!candidate->hasOperation() || out_schema.is_vararg() ||
+        out_args.size() != args.size() + 1 ||
+        out_schema.returns().size() != 1) {
+      continue;
+    }
+    const Argument& out = out_args.back();
+    if (out.name() != "out" || !out.kwarg_only() ||
+        out.type()->kind() != TypeKind::TensorType || !out.alias_info() ||
+        !out.alias_info()->isWrite()) {
+      continue;
+    }
+    bool matches = true;
+    for (size_t i = 0; i < args.size() && matches; ++i) {
+      matches = args[i].name() == out_args[i].name() &&
+          *args[i].type() == *out_args[i].type();
+    }
+    if (matches) {
+      return candidate;
+    }
+  }
+  return nullptr;
+}
+
 // BailoutBlocks are used to temporarily store
 // instructions (typically, argument LOADs and TAIL_CALL)
 // generated for prim::BailOut nodes
@@ -359,6 +399,95 @@ struct BailoutBlock {
   std::vector<Instruction> instructions; // ends in a TAIL_CALL
 };
 
+// What the result of an operator depends on, for one of its inputs, apart
+// from the values of its tensors. Type promotion treats 0-dim tensors and
+// wrapped numbers differently from other tensors, and Python floats by their
+// kind only; the strides of the result follow those of the tensor inputs;
+// and arguments such as dim=, keepdim= or dtype= matter by their value.
+struct OutVariantInput {
+  enum class Kind { Tensor, Float, Value, Other };
+
+  static OutVariantInput of(const IValue& v) {
+    OutVariantInput input;
+    if (v.isTensor() && v.toTensor().defined()) {
+      const at::Tensor& t = v.toTensor();
+      input.kind = Kind::Tensor;
+      input.dtype = t.scalar_type();
+      input.device = t.device();
+      input.wrapped_number = t.unsafeGetTensorImpl()->is_wrapped_number();
+      input.sizes = t.sizes().vec();
+      input.strides = t.strides().vec();
+    } else if (v.isDouble()) {
+      input.kind = Kind::Float;
+    } else if (v.isTensor()) {
+      // An undefined tensor, i.e. an optional tensor that is not given.
+      input.kind = Kind::Value;
+    } else if (isValue(v)) {
+      input.kind = Kind::Value;
+      input.value = v;
+    }
+    return input;
+  }
+
+  static bool isValue(const IValue& v) {
+    return v.isNone() || v.isInt() || v.isBool() || v.isString() ||
+        v.isDevice() || v.isIntList() || v.isBoolList() || v.isDoubleList();
+  }
+
+  bool matches(const IValue& v) const {
+    switch (kind) {
+      case Kind::Tensor: {
+        if (!v.isTensor() || !v.toTensor().defined()) {
+          return false;
+        }
+        const at::Tensor& t = v.toTensor();
+        return t.scalar_type() == dtype && t.device() == device &&
+            t.unsafeGetTensorImpl()->is_wrapped_number() == wrapped_number &&
+            t.sizes().equals(sizes) && t.strides().equals(strides);
+      }
+      case Kind::Float:
+        return v.isDouble();
+      case Kind::Value:
+        if (v.isTensor()) {
+          return !v.toTensor().defined() && value.isNone();
+        }
+        return isValue(v) && v == value;
+      case Kind::Other:
+        return false;
+    }
+    return false;
+  }
+
+  // Inputs of other kinds, e.g. objects, never match, so the slot is not
+  // reused.
+  Kind kind = Kind::Other;
+  at::ScalarType dtype = at::kFloat;
+  at::Device device = at::kCPU;
+  bool wrapped_number = false;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  IValue value;
+};
+
+// State of an OP_OUT instruction that outlives a single run of its Code: the
+// out= overload of the operator, and the tensor the instruction produced last
+// time. Once nothing but the slot refers to that tensor, the next run passes
+// it as `out` instead of allocating a new one.
+struct OutVariantSlot {
+  OutVariantSlot(Operation out_op, size_t num_inputs)
+      : out_op(std::move(out_op)), num_inputs(num_inputs) {}
+
+  Operation out_op;
+  size_t num_inputs;
+  // Only ever try_lock'ed: runs of the same Code on other threads allocate
+  // instead of waiting for each other.
+  std::mutex mutex;
+  at::Tensor buffer;
+  // The inputs `buffer` was produced from, with the elements of tensor lists
+  // following their length.
+  std::vector<OutVariantInput> inputs;
+};
+
 struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions_;
@@ -368,9 +497,16 @@ struct CodeImpl {
   // instruction to be emitted?
   std::vector<Node*> instructions_source_;
 
+  // What the interpreter actually runs: instructions_ with common sequences
+  // fused into superinstructions (see fuseSuperinstructions). instructions_
+  // stays as emitted, since it is what gets exported and dumped.
+  std::vector<Instruction> run_instructions_;
+  std::vector<Node*> run_instructions_source_;
+
   std::vector<IValue> constant_table_;
   std::vector<Operation> operator_table_;
   std::vector<Function*> function_table_;
+  std::vector<std::unique_ptr<OutVariantSlot>> out_variant_table_;
   std::vector<std::unique_ptr<GraphFunction>> forked_functions_;
   std::vector<TypePtr> type_table_;
   std::vector<std::function<void(std::vector<IValue>&)>>
@@ -431,6 +567,7 @@ struct CodeImpl {
     // we deferred the emission of bailout blocks so they appear at the end
     // emit them now and patch up the jumps
     insertBailoutBlocks();
+    fuseSuperinstructions();
   }
 
   const std::vector<c10::IValue>& constant_table() const {
@@ -438,20 +575,23 @@ struct CodeImpl {
   }
 
   void request_bailout(size_t index) {
-    auto count = index;
-    for (size_t instr_index = 0; instr_index < instructions_.size();
-         instr_index++) {
-      if (instructions_[instr_index].op == GUARD ||
-          instructions_[instr_index].op == FAIL_GUARD) {
-        if (count-- == 0) {
-          // patching GUARD to FAIL_GUARD
-          instructions_[instr_index].op = FAIL_GUARD;
-          GRAPH_DEBUG(
-              "Added a bailout request for ",
-              index,
-              " at instruction ",
-              instr_index);
-          break;
+    // guards are never fused, so they appear in the same order in both
+    for (auto* instructions : {&instructions_, &run_instructions_}) {
+      auto count = index;
+      for (size_t instr_index = 0; instr_index < instructions->size();
+           instr_index++) {
+        Instruction& inst = (*instructions)[instr_index];
+        if (inst.op == GUARD || inst.op == FAIL_GUARD) {
+          if (count-- == 0) {
+            // patching GUARD to FAIL_GUARD
+            inst.op = FAIL_GUARD;
+            GRAPH_DEBUG(
+                "Added a bailout request for ",
+                index,
+                " at instruction ",
+                instr_index);
+            break;
+          }
         }
       }
     }
@@ -470,7 +610,7 @@ struct CodeImpl {
     instructions_source_.emplace_back(current_node_);
 
     // check that we didn't accidentally emit nodes out of topological order
-    if (op == OP) {
+    if (op == OP || op == OP_OUT) {
       if (last_inserted_op_ != nullptr && current_node_ != last_inserted_op_ &&
           current_node_->owningBlock() == last_inserted_op_->owningBlock()) {
         TORCH_INTERNAL_ASSERT(
@@ -490,6 +630,106 @@ struct CodeImpl {
     }
   }
 
+  static bool isJump(OpCode op) {
+    return op == JF || op == JMP || op == LOOP;
+  }
+
+  // Superinstruction for `a` immediately followed by `b`, if there is one.
+  // The branch offset of OP_JF is still the one of `b` at this point.
+  static c10::optional<Instruction> fusePair(
+      const Instruction& a,
+      const Instruction& b) {
+    auto fits = [](int64_t v) {
+      return v >= 0 && v <= std::numeric_limits<uint16_t>::max();
+    };
+    const bool a_load = a.op == LOAD || a.op == MOVE;
+    const bool b_load = b.op == LOAD || b.op == MOVE;
+    if (a_load && b_load && fits(b.X)) {
+      const OpCode op = a.op == LOAD ? (b.op == LOAD ? LOAD2 : LOAD_MOVE)
+                                     : (b.op == LOAD ? MOVE_LOAD : MOVE2);
+      return Instruction(op, a.X, b.X);
+    }
+    if (a.op == OP && b.op == STORE && fits(b.X)) {
+      return Instruction(OP_STORE, a.X, b.X);
+    }
+    if (a.op == LOADC && b.op == OP && fits(a.X)) {
+      return Instruction(LOADC_OP, b.X, a.X);
+    }
+    // the fused branch starts one instruction earlier than the JF did
+    if (a.op == OP && b.op == JF && fits(int64_t(b.X) + 1)) {
+      return Instruction(OP_JF, a.X, b.X);
+    }
+    return c10::nullopt;
+  }
+
+  // Builds run_instructions_ from instructions_ by fusing the pairs that
+  // dominate straight-line code -- loads feeding an operator, an operator
+  // storing its result, constants passed to operators, and comparisons
+  // feeding a branch -- into single superinstructions, which roughly halves
+  // the number of dispatches per operator. Pairs whose second instruction is
+  // a branch target are left alone, and branch offsets are recomputed for the
+  // shorter stream.
+  void fuseSuperinstructions() {
+    const size_t n = instructions_.size();
+    run_instructions_.clear();
+    run_instructions_source_.clear();
+    if (!getSuperinstructionMode()) {
+      run_instructions_ = instructions_;
+      run_instructions_source_ = instructions_source_;
+      return;
+    }
+
+    std::vector<bool> is_target(n + 1, false);
+    for (size_t i = 0; i < n; ++i) {
+      if (isJump(instructions_[i].op)) {
+        is_target.at(i + instructions_[i].X) = true;
+      }
+    }
+
+    // new_index[i] is where instructions_[i] starts in run_instructions_;
+    // jump_source[k] is the index in instructions_ of the branch that
+    // run_instructions_[k] performs, if any.
+    std::vector<size_t> new_index(n + 1);
+    std::vector<size_t> jump_source;
+    for (size_t i = 0; i < n;) {
+      new_index[i] = run_instructions_.size();
+      const Instruction& a = instructions_[i];
+      c10::optional<Instruction> fused;
+      if (i + 1 < n && !is_target[i + 1]) {
+        fused = fusePair(a, instructions_[i + 1]);
+      }
+      if (fused) {
+        // report errors at the operator, which is what can throw
+        const size_t source = a.op == LOADC ? i + 1 : i;
+        run_instructions_.push_back(*fused);
+        run_instructions_source_.push_back(instructions_source_[source]);
+        jump_source.push_back(fused->op == OP_JF ? i + 1 : n);
+        new_index[i + 1] = new_index[i];
+        i += 2;
+      } else {
+        run_instructions_.push_back(a);
+        run_instructions_source_.push_back(instructions_source_[i]);
+        jump_source.push_back(isJump(a.op) ? i : n);
+        i += 1;
+      }
+    }
+    new_index[n] = run_instructions_.size();
+
+    for (size_t k = 0; k < run_instructions_.size(); ++k) {
+      if (jump_source[k] == n) {
+        continue;
+      }
+      const size_t j = jump_source[k];
+      const int64_t offset = int64_t(new_index[j + instructions_[j].X]) - k;
+      Instruction& inst = run_instructions_[k];
+      if (inst.op == OP_JF) {
+        inst.N = offset;
+      } else {
+        inst.X = offset;
+      }
+    }
+  }
+
   void createBailoutBlock(size_t jf_index) {
     bailout_blocks_.emplace_back(BailoutBlock{jf_index});
     auto& bailout_instructions = bailout_blocks_.back().instructions;
@@ -551,8 +791,14 @@ struct CodeImpl {
   void emitOperator(Node* node) {
     emitLoadInputs(node->inputs());
     const Operator& op = node->getOperator();
+    std::shared_ptr<Operator> out_variant;
     if (op.hasOperation() && op.schema().is_vararg()) {
       insertInstruction(OPN, operator_table_.size(), node->inputs().size());
+    } else if (getOutVariantMode() && (out_variant = findOutVariant(op))) {
+      insertInstruction(
+          OP_OUT, operator_table_.size(), out_variant_table_.size());
+      out_variant_table_.emplace_back(std::make_unique<OutVariantSlot>(
+          out_variant->getOperation(), node->inputs().size()));
     } else {
       insertInstruction(OP, operator_table_.size());
     }
@@ -884,7 +1130,7 @@ struct CodeImpl {
   void dump(std::ostream& out, size_t i) const {
     out << i << " " << instructions_[i];
     if (instructions_[i].op == OP || instructions_[i].op == CALL ||
-        instructions_[i].op == OPN) {
+        instructions_[i].op == OPN || instructions_[i].op == OP_OUT) {
       out << " # " << *instructions_source_[i];
     } else {
       out << "\n";
@@ -899,6 +1145,24 @@ struct CodeImpl {
   }
 };
 
+// With GCC and Clang, runImpl dispatches with computed gotos: every handler
+// ends in its own indirect jump to the next handler, which branch predictors
+// track far better than the single indirect jump of a switch. Elsewhere it is
+// a plain switch in a loop.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define JIT_USE_COMPUTED_GOTO 1
+#define INST(op) label_##op
+#define INST_NEXT                 \
+  inst = af.instructions[af.pc];  \
+  goto* dispatch_table[inst.op]
+#define INST_DISPATCH goto* dispatch_table[inst.op];
+#else
+#define JIT_USE_COMPUTED_GOTO 0
+#define INST(op) case op
+#define INST_NEXT break
+#define INST_DISPATCH switch (inst.op)
+#endif
+
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
@@ -951,15 +1215,17 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     Instruction* instructions;
     IValue* constants;
     Operation* operators;
+    std::unique_ptr<OutVariantSlot>* out_variants;
     Function** functions;
     std::function<void(std::vector<IValue>&)>* profile_functions;
     TypePtr* types;
 
     ActiveFrame(const Frame& frame)
         : pc(frame.pc),
-          instructions(frame.function->instructions_.data()),
+          instructions(frame.function->run_instructions_.data()),
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
+          out_variants(frame.function->out_variant_table_.data()),
           functions(frame.function->function_table_.data()),
           profile_functions(frame.function->profile_function_table_.data()),
           types(frame.function->type_table_.data()) {}
@@ -1025,6 +1291,118 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     *af = ActiveFrame(frames.back());
   }
 
+  static bool anyRequiresGrad(at::ArrayRef<IValue> inputs) {
+    for (const IValue& v : inputs) {
+      if (v.isTensor()) {
+        if (v.toTensor().requires_grad()) {
+          return true;
+        }
+      } else if (v.isTensorList()) {
+        for (const at::Tensor& t : v.toTensorVector()) {
+          if (t.requires_grad()) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  template <typename F>
+  static bool forEachOutVariantInput(at::ArrayRef<IValue> inputs, F f) {
+    for (const IValue& v : inputs) {
+      if (v.isTensorList()) {
+        auto list = v.toTensorList();
+        if (!f(IValue(static_cast<int64_t>(list.size())))) {
+          return false;
+        }
+        for (const at::Tensor& t : list) {
+          if (!f(IValue(t))) {
+            return false;
+          }
+        }
+      } else if (!f(v)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static std::vector<OutVariantInput> outVariantInputs(
+      at::ArrayRef<IValue> inputs) {
+    std::vector<OutVariantInput> key;
+    forEachOutVariantInput(inputs, [&](const IValue& v) {
+      key.push_back(OutVariantInput::of(v));
+      return true;
+    });
+    return key;
+  }
+
+  static bool sameOutVariantInputs(
+      at::ArrayRef<IValue> inputs,
+      const std::vector<OutVariantInput>& key) {
+    size_t i = 0;
+    return forEachOutVariantInput(
+               inputs,
+               [&](const IValue& v) {
+                 return i < key.size() && key[i++].matches(v);
+               }) &&
+        i == key.size();
+  }
+
+  // The buffer may only be written if this slot holds the last reference to
+  // both the tensor and its storage, i.e. the previous output was dropped by
+  // the interpreter and by whoever it was returned to, with no views left.
+  static bool isReusable(const at::Tensor& buffer) {
+    return buffer.defined() && buffer.use_count() == 1 &&
+        buffer.weak_use_count() == 1 && buffer.has_storage() &&
+        buffer.storage().use_count() == 1;
+  }
+
+  // OP_OUT: run the out= variant on the tensor the slot kept from the previous
+  // run if it can be reused, otherwise run the functional operator `op` and
+  // keep its result for next time. Autograd does not support out=, so inputs
+  // that require grad always take the functional path, and nothing is kept.
+  // Buffers are only kept for CPU outputs: on other devices, reuse would
+  // have to be ordered with the streams the previous run's kernels used.
+  void runOutVariant(Stack& stack, Operation& op, OutVariantSlot& slot) {
+    auto inputs = last(stack, slot.num_inputs);
+    if (at::GradMode::is_enabled() && anyRequiresGrad(inputs)) {
+      op(stack);
+      return;
+    }
+
+    at::Tensor out;
+    {
+      std::unique_lock<std::mutex> lock(slot.mutex, std::try_to_lock);
+      if (lock.owns_lock() && isReusable(slot.buffer) &&
+          sameOutVariantInputs(inputs, slot.inputs)) {
+        out = std::move(slot.buffer);
+      }
+    }
+    if (out.defined()) {
+      stack.emplace_back(out);
+      slot.out_op(stack);
+      std::unique_lock<std::mutex> lock(slot.mutex, std::try_to_lock);
+      if (lock.owns_lock() && !slot.buffer.defined()) {
+        slot.buffer = std::move(out);
+      }
+      return;
+    }
+
+    auto key = outVariantInputs(inputs);
+    op(stack);
+    const IValue& result = stack.back();
+    if (!result.isTensor() || !result.toTensor().device().is_cpu()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(slot.mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      slot.buffer = result.toTensor();
+      slot.inputs = std::move(key);
+    }
+  }
+
   bool runImpl(Stack& stack) {
     // if we have never run before, then we might have to return the
     // stack when we suspend, record where it starts so we return the right
@@ -1039,70 +1417,113 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
 
     ActiveFrame af(frames.back());
+#if JIT_USE_COMPUTED_GOTO
+#define DISPATCH_LABEL(op, _) &&label_##op,
+    static void* dispatch_table[] = {FORALL_OPCODES(DISPATCH_LABEL)};
+#undef DISPATCH_LABEL
+#endif
     try {
       while (true) {
         // std::cout << "RUNNING ";
         // frames.back().function->dump(std::cout, af.pc);
         Instruction inst = af.instructions[af.pc];
-        switch (inst.op) {
-          case OP:
+        INST_DISPATCH {
+          INST(OP):
             af.operators[inst.X](stack);
             ++af.pc;
-            break;
-          case OPN:
+            INST_NEXT;
+          INST(OPN):
             stack.push_back(inst.N);
             af.operators[inst.X](stack);
             ++af.pc;
-            break;
-          case LOAD:
+            INST_NEXT;
+          INST(OP_OUT):
+            runOutVariant(stack, af.operators[inst.X], *af.out_variants[inst.N]);
+            ++af.pc;
+            INST_NEXT;
+          INST(OP_STORE):
+            af.operators[inst.X](stack);
+            reg(inst.N) = pop(stack);
+            ++af.pc;
+            INST_NEXT;
+          INST(LOADC_OP):
+            stack.emplace_back(af.constants[inst.N]);
+            af.operators[inst.X](stack);
+            ++af.pc;
+            INST_NEXT;
+          INST(OP_JF):
+            af.operators[inst.X](stack);
+            af.pc += (pop(stack).toBool()) ? 1 : inst.N;
+            INST_NEXT;
+          INST(LOAD):
             stack.emplace_back(reg(inst.X));
             ++af.pc;
-            break;
-          case MOVE:
+            INST_NEXT;
+          INST(LOAD2):
+            stack.emplace_back(reg(inst.X));
+            stack.emplace_back(reg(inst.N));
+            ++af.pc;
+            INST_NEXT;
+          INST(LOAD_MOVE):
+            stack.emplace_back(reg(inst.X));
+            stack.emplace_back(std::move(reg(inst.N)));
+            ++af.pc;
+            INST_NEXT;
+          INST(MOVE_LOAD):
             stack.emplace_back(std::move(reg(inst.X)));
+            stack.emplace_back(reg(inst.N));
             ++af.pc;
-            break;
-          case STORE:
+            INST_NEXT;
+          INST(MOVE2):
+            stack.emplace_back(std::move(reg(inst.X)));
+            stack.emplace_back(std::move(reg(inst.N)));
+            ++af.pc;
+            INST_NEXT;
+          INST(MOVE):
+            stack.emplace_back(std::move(reg(inst.X)));
+            ++af.pc;
+            INST_NEXT;
+          INST(STORE):
             reg(inst.X) = pop(stack);
             ++af.pc;
-            break;
-          case STOREN:
+            INST_NEXT;
+          INST(STOREN):
             for (size_t i = inst.N; i > 0; --i) {
               reg(inst.X + i - 1) = pop(stack);
             }
             ++af.pc;
-            break;
-          case DROP:
+            INST_NEXT;
+          INST(DROP):
             pop(stack);
             ++af.pc;
-            break;
-          case DROPR:
+            INST_NEXT;
+          INST(DROPR):
             reg(inst.X) = IValue();
             ++af.pc;
-            break;
-          case LOADC:
+            INST_NEXT;
+          INST(LOADC):
             stack.emplace_back(af.constants[inst.X]);
             ++af.pc;
-            break;
-          case GET_ATTR: {
+            INST_NEXT;
+          INST(GET_ATTR): {
             auto userObj = pop(stack).toObject();
             auto value = userObj->getSlot(inst.X);
             push(stack, std::move(value));
             ++af.pc;
-          } break;
-          case SET_ATTR: {
+          } INST_NEXT;
+          INST(SET_ATTR): {
             auto v = pop(stack);
             auto userObj = pop(stack).toObject();
             userObj->setSlot(inst.X, std::move(v));
             ++af.pc;
-          } break;
-          case JF:
+          } INST_NEXT;
+          INST(JF):
             af.pc += (pop(stack).toBool()) ? 1 : inst.X;
-            break;
-          case JMP:
+            INST_NEXT;
+          INST(JMP):
             af.pc += inst.X;
-            break;
-          case LOOP: {
+            INST_NEXT;
+          INST(LOOP): {
             // stack: iteration_count, max_iter, cond, loop_carried_deps...
             auto frame = stack.end() - (inst.N + 1);
             int64_t trip_count = frame[0].toInt();
@@ -1120,16 +1541,16 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               drop(stack, 3); // iteration_count, max_iter, cond
               af.pc += inst.X;
             }
-          } break;
-          case CALL: {
+          } INST_NEXT;
+          INST(CALL): {
             Function* fn = af.functions[inst.X];
             if (!fn->isGraphFunction()) {
               runBuiltinFunction(stack, fn, &af);
             } else {
               runGraphFunction(stack, fn, &af);
             }
-          } break;
-          case INTERFACE_CALL: {
+          } INST_NEXT;
+          INST(INTERFACE_CALL): {
             // note the hash table lookup to find the function
             // this can be more optimized if necessary, caching parts
             // of the hashing computation or storing the offset when
@@ -1151,12 +1572,12 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             } else {
               runGraphFunction(stack, function, &af);
             }
-          } break;
-          case RET:
+          } INST_NEXT;
+          INST(RET):
             if (frames.size() > 1) {
               leaveFrame();
               af = ActiveFrame(frames.back());
-              break;
+              INST_NEXT;
             }
             if (future_) {
               auto num_outputs = frames.back().function->n_outputs;
@@ -1168,7 +1589,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
             }
             return false;
-          case WAIT: {
+          INST(WAIT): {
             auto future = stack.back().toFuture();
             if (!future->completed()) {
               getOrCreateFuture();
@@ -1216,8 +1637,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             stack.pop_back();
             stack.emplace_back(future->value());
             ++af.pc;
-          } break;
-          case PROFILE_OP: {
+          } INST_NEXT;
+          INST(PROFILE_OP): {
             auto& frame_id_ref = frames.back().id;
             if (!frame_id_ref.has_value()) {
               frame_id_ref = Frame::num_frames++;
@@ -1226,18 +1647,18 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, c10::IValue{static_cast<int64_t>(*frame_id_ref)});
             callback(stack);
             ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case FAIL_GUARD: {
+          INST(FAIL_GUARD): {
             // patch FAIL_GUARD back to GUARD
             GRAPH_DEBUG(
                 "Bailout ", inst.X, " triggered via bailout_requests_!");
             af.instructions[af.pc].op = GUARD;
             push(stack, false);
             ++af.pc;
-            break;
+            INST_NEXT;
           }
-          case GUARD: {
+          INST(GUARD): {
             if (!stack.back().isTensor()) {
               // stack.back() is an Uninitialized IValue and this is a guard
               // on a block output. Uninitialized IValues are never used
@@ -1251,8 +1672,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               push(stack, comp);
             }
             ++af.pc;
-          } break;
-          case TAIL_CALL: {
+          } INST_NEXT;
+          INST(TAIL_CALL): {
             GRAPH_DEBUG("running TAIL_CALL for ", inst.X);
             af.functions[inst.X]->ensure_defined();
             size_t remaining_bailout_depth =
@@ -1275,46 +1696,46 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             leaveFrame();
             enterFrame(code, base_pointer);
             af = ActiveFrame(frames.back());
-          } break;
-          case LIST_UNPACK: {
+          } INST_NEXT;
+          INST(LIST_UNPACK): {
             listUnpack(stack, inst.X);
             ++af.pc;
-          } break;
-          case TUPLE_CONSTRUCT: {
+          } INST_NEXT;
+          INST(TUPLE_CONSTRUCT): {
             tupleConstruct(stack, inst.X);
             ++af.pc;
-          } break;
-          case TUPLE_SLICE: {
+          } INST_NEXT;
+          INST(TUPLE_SLICE): {
             tupleSlice(stack, inst.X, inst.X + inst.N);
             ++af.pc;
-          } break;
-          case NAMED_TUPLE_CONSTRUCT: {
+          } INST_NEXT;
+          INST(NAMED_TUPLE_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<TupleType>();
             namedTupleConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case LIST_CONSTRUCT: {
+          } INST_NEXT;
+          INST(LIST_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<ListType>();
             listConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case DICT_CONSTRUCT: {
+          } INST_NEXT;
+          INST(DICT_CONSTRUCT): {
             auto type = af.types[inst.X]->expect<DictType>();
             dictConstruct(stack, type, inst.N);
             ++af.pc;
-          } break;
-          case CREATE_OBJECT: {
+          } INST_NEXT;
+          INST(CREATE_OBJECT): {
             auto type = af.types[inst.X]->expect<ClassType>();
             createObject(stack, type);
             ++af.pc;
-          } break;
-          case ISINSTANCE: {
+          } INST_NEXT;
+          INST(ISINSTANCE): {
             at::ArrayRef<TypePtr> types(
                 af.types + inst.X, af.types + inst.X + inst.N);
             isinstance(stack, types);
             ++af.pc;
-          } break;
-          case FORK: {
+          } INST_NEXT;
+          INST(FORK): {
             // Move inputs to a separate stack
             Function* forked_fn = af.functions[inst.X];
             InterpreterState forked_interpreter(
@@ -1329,9 +1750,10 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             push(stack, forked_interpreter.getFuture());
             at::launch(std::move(continuation));
             ++af.pc;
-          } break;
-          case WARN: {
-            Node* node = frames.back().function->instructions_source_.at(af.pc);
+          } INST_NEXT;
+          INST(WARN): {
+            Node* node =
+                frames.back().function->run_instructions_source_.at(af.pc);
             auto range = node->sourceRange().source();
             if (range->filename()) {
               auto line = range->starting_line_no() +
@@ -1344,7 +1766,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               TORCH_WARN(pop(stack).toStringRef());
             }
             ++af.pc;
-          } break;
+          } INST_NEXT;
         }
       }
     } catch (std::exception& e) {
@@ -1367,7 +1789,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
         --pc;
       }
 
-      Node* node = frame.function->instructions_source_[pc];
+      Node* node = frame.function->run_instructions_source_[pc];
       if (node->callstack()) {
         for (const auto& p : (*node->callstack())->vec()) {
           entries.emplace_back(StackEntry{previous_fn_name, p.second});
@@ -1425,8 +1847,24 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   }
 };
 
+#undef JIT_USE_COMPUTED_GOTO
+#undef INST
+#undef INST_NEXT
+#undef INST_DISPATCH
+
 std::atomic<size_t> InterpreterStateImpl::Frame::num_frames;
 
+static std::atomic<bool> out_variant_mode{false};
+static std::atomic<bool> superinstruction_mode{true};
+
+std::atomic<bool>& getOutVariantMode() {
+  return out_variant_mode;
+}
+
+std::atomic<bool>& getSuperinstructionMode() {
+  return superinstruction_mode;
+}
+
 std::ostream& operator<<(std::ostream& out, const Code& code) {
   out << *code.pImpl->graph_ << "\n";
   code.pImpl->dump(out);
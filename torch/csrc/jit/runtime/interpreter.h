@@ -1,5 +1,6 @@
 #pragma once
 #include <c10/util/Optional.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -79,6 +80,17 @@ struct InterpreterState {
   friend struct InterpreterStateImpl;
 };
 
+// When set, Code emits OP_OUT for operators that have an out= overload, so
+// that steady-state runs write into the output they produced on the previous
+// run instead of allocating. Every such operator then keeps its last output
+// alive between runs, so this is off by default. Only affects Code created
+// afterwards.
+TORCH_API std::atomic<bool>& getOutVariantMode();
+
+// When set (the default), Code fuses common instruction sequences into
+// superinstructions before running them. Only affects Code created afterwards.
+TORCH_API std::atomic<bool>& getSuperinstructionMode();
+
 // Created by wait()
 struct Suspend : public std::exception {
   const char* what() const noexcept override {
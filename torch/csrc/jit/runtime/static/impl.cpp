@@ -0,0 +1,445 @@
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <ATen/core/grad_mode.h>
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/liveness.h>
+#include <torch/csrc/jit/runtime/vararg_functions.h>
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+constexpr size_t kArenaAlignment = 64;
+
+size_t alignedSize(size_t nbytes) {
+  return (nbytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+void prepareGraph(std::shared_ptr<Graph>& graph) {
+  Inline(*graph);
+  ConstantPropagation(graph);
+  EliminateDeadCode(graph);
+  for (Node* n : graph->nodes()) {
+    TORCH_CHECK(
+        n->blocks().empty(),
+        "StaticRuntime only supports straight-line graphs, but found ",
+        n->kind().toQualString());
+  }
+}
+
+} // namespace
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<const IValue*> inputs,
+    std::vector<IValue*> outputs)
+    : node_(node), inputs_(std::move(inputs)), outputs_(std::move(outputs)) {
+  out_fn_ = getOutVariant(node);
+  if (out_fn_) {
+    return;
+  }
+  // The interpreter emits dedicated instructions for these instead of looking
+  // up an operator.
+  const size_t num_inputs = node->inputs().size();
+  switch (node->kind()) {
+    case prim::GetAttr: {
+      const auto slot = node->input()->type()->expect<ClassType>()
+                            ->getAttributeSlot(node->s(attr::name));
+      op_ = [slot](Stack& stack) {
+        auto obj = pop(stack).toObject();
+        push(stack, obj->getSlot(slot));
+        return 0;
+      };
+    } break;
+    case prim::ListConstruct: {
+      auto type = node->output()->type()->expect<ListType>();
+      op_ = [type, num_inputs](Stack& stack) {
+        listConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    } break;
+    case prim::ListUnpack: {
+      const size_t num_outputs = node->outputs().size();
+      op_ = [num_outputs](Stack& stack) {
+        listUnpack(stack, num_outputs);
+        return 0;
+      };
+    } break;
+    case prim::TupleConstruct: {
+      auto type = node->output()->type()->expect<TupleType>();
+      if (type->name().has_value()) {
+        op_ = [type, num_inputs](Stack& stack) {
+          namedTupleConstruct(stack, type, num_inputs);
+          return 0;
+        };
+      } else {
+        op_ = [num_inputs](Stack& stack) {
+          tupleConstruct(stack, num_inputs);
+          return 0;
+        };
+      }
+    } break;
+    case prim::DictConstruct: {
+      auto type = node->output()->type()->expect<DictType>();
+      op_ = [type, num_inputs](Stack& stack) {
+        dictConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    } break;
+    default:
+      TORCH_CHECK(
+          node->maybeOperator(),
+          "StaticRuntime does not support ",
+          node->kind().toQualString());
+      op_ = node->getOperation();
+  }
+}
+
+void ProcessedNode::run(Stack& stack) {
+  if (out_fn_) {
+    out_fn_(this);
+    return;
+  }
+  for (const IValue* input : inputs_) {
+    stack.push_back(*input);
+  }
+  op_(stack);
+  TORCH_INTERNAL_ASSERT(stack.size() == outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    *outputs_[i] = std::move(stack[i]);
+  }
+  stack.clear();
+}
+
+// Lays out the tensors written by out variants in one arena. Each tensor is
+// live from the node that produces it to the last use of it or of anything
+// that may alias it; tensors with disjoint live ranges can share bytes.
+//
+// Sizes are only known once the graph has run, so the plan is (re)computed
+// after a run in which a managed tensor allocated memory outside its slot:
+// the first run, or one whose input shapes needed more memory than before.
+// Planning then points every managed storage at its slot, and since the
+// TensorImpls stay in their registers, the next runs' out= kernels resize them
+// in place without touching the allocator.
+class MemoryPlanner {
+ public:
+  struct ManagedTensor {
+    IValue* reg;
+    size_t begin;
+    size_t end;
+    size_t nbytes;
+    size_t offset;
+  };
+
+  explicit MemoryPlanner(std::vector<ManagedTensor> tensors)
+      : tensors_(std::move(tensors)) {}
+
+  void update() {
+    bool replan = false;
+    char* base = static_cast<char*>(arena_.get());
+    for (auto& t : tensors_) {
+      c10::StorageImpl* storage = managedStorage(t);
+      if (!storage) {
+        continue;
+      }
+      const size_t nbytes = storage->capacity();
+      if (nbytes > t.nbytes) {
+        t.nbytes = nbytes;
+        replan = true;
+      } else if (nbytes > 0 && storage->data() != base + t.offset) {
+        replan = true;
+      }
+    }
+    if (replan) {
+      plan();
+    }
+  }
+
+  size_t num_managed() const {
+    return tensors_.size();
+  }
+
+  size_t arena_bytes() const {
+    return arena_bytes_;
+  }
+
+ private:
+  static c10::StorageImpl* managedStorage(const ManagedTensor& t) {
+    if (!t.reg->isTensor()) {
+      return nullptr;
+    }
+    const auto& tensor = t.reg->toTensor();
+    if (!tensor.defined() || !tensor.has_storage() ||
+        !tensor.device().is_cpu()) {
+      return nullptr;
+    }
+    return tensor.storage().unsafeGetStorageImpl();
+  }
+
+  void plan() {
+    std::vector<size_t> order(tensors_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return tensors_[a].nbytes > tensors_[b].nbytes;
+    });
+
+    // Greedy first fit, largest tensors first.
+    std::vector<size_t> placed;
+    std::vector<std::pair<size_t, size_t>> busy;
+    size_t total = 0;
+    for (size_t i : order) {
+      auto& t = tensors_[i];
+      if (t.nbytes == 0) {
+        continue;
+      }
+      const size_t size = alignedSize(t.nbytes);
+      busy.clear();
+      for (size_t j : placed) {
+        const auto& other = tensors_[j];
+        if (other.begin <= t.end && t.begin <= other.end) {
+          busy.emplace_back(
+              other.offset, other.offset + alignedSize(other.nbytes));
+        }
+      }
+      std::sort(busy.begin(), busy.end());
+      size_t offset = 0;
+      for (const auto& range : busy) {
+        if (offset + size <= range.first) {
+          break;
+        }
+        offset = std::max(offset, range.second);
+      }
+      t.offset = offset;
+      total = std::max(total, offset + size);
+      placed.push_back(i);
+    }
+
+    arena_ = c10::GetCPUAllocator()->allocate(total);
+    arena_bytes_ = total;
+    char* base = static_cast<char*>(arena_.get());
+    for (const auto& t : tensors_) {
+      c10::StorageImpl* storage = managedStorage(t);
+      if (!storage || storage->capacity() == 0) {
+        continue;
+      }
+      // The arena owns the memory; the storage only borrows its slot.
+      storage->set_data_ptr(
+          at::DataPtr(base + t.offset, at::Device(at::DeviceType::CPU)));
+      storage->set_numel(t.nbytes / storage->itemsize());
+    }
+  }
+
+  std::vector<ManagedTensor> tensors_;
+  at::DataPtr arena_;
+  size_t arena_bytes_ = 0;
+};
+
+StaticRuntime::StaticRuntime(
+    std::shared_ptr<Graph> graph,
+    const StaticRuntimeOptions& opts)
+    : graph_(graph->copy()) {
+  prepareGraph(graph_);
+  init(opts, c10::nullopt);
+}
+
+StaticRuntime::StaticRuntime(
+    const Module& module,
+    const StaticRuntimeOptions& opts) {
+  Module frozen = freeze_module(module);
+  graph_ = frozen.get_method("forward").graph()->copy();
+  prepareGraph(graph_);
+  c10::optional<IValue> self;
+  if (graph_->inputs().at(0)->uses().empty()) {
+    graph_->eraseInput(0);
+  } else {
+    self = frozen._ivalue();
+  }
+  init(opts, std::move(self));
+}
+
+StaticRuntime::~StaticRuntime() = default;
+
+void StaticRuntime::init(
+    const StaticRuntimeOptions& opts,
+    c10::optional<IValue> self) {
+  std::unordered_map<const Value*, size_t> reg_of;
+  auto assign = [&](const Value* v) { reg_of.emplace(v, reg_of.size()); };
+  for (Value* v : graph_->inputs()) {
+    assign(v);
+  }
+  for (Node* n : graph_->nodes()) {
+    for (Value* v : n->outputs()) {
+      assign(v);
+    }
+  }
+  // ProcessedNodes point into registers_, so it must not grow from here on.
+  registers_.resize(reg_of.size());
+  std::vector<bool> persistent(registers_.size(), false);
+
+  size_t first_input = 0;
+  if (self) {
+    registers_[0] = std::move(*self);
+    persistent[0] = true;
+    first_input = 1;
+  }
+  for (size_t i = first_input; i < graph_->inputs().size(); ++i) {
+    input_regs_.push_back(reg_of.at(graph_->inputs()[i]));
+  }
+  for (Value* v : graph_->outputs()) {
+    output_regs_.push_back(reg_of.at(v));
+  }
+
+  std::vector<Node*> processed;
+  for (Node* n : graph_->nodes()) {
+    if (n->kind() == prim::Constant) {
+      const size_t reg = reg_of.at(n->output());
+      registers_[reg] = *toIValue(n->output());
+      persistent[reg] = true;
+      continue;
+    }
+    std::vector<const IValue*> inputs;
+    for (Value* v : n->inputs()) {
+      inputs.push_back(&registers_[reg_of.at(v)]);
+    }
+    std::vector<IValue*> outputs;
+    for (Value* v : n->outputs()) {
+      outputs.push_back(&registers_[reg_of.at(v)]);
+    }
+    nodes_.emplace_back(n, std::move(inputs), std::move(outputs));
+    processed.push_back(n);
+  }
+
+  if (opts.optimize_memory) {
+    AliasDb alias_db(graph_);
+    std::unordered_map<const Value*, size_t> def;
+    std::unordered_map<const Value*, size_t> last_use;
+    auto liveness = BuildLivenessSets(graph_);
+    size_t index = 0;
+    for (Node* n : graph_->nodes()) {
+      for (Value* v : n->outputs()) {
+        def[v] = index;
+      }
+      // Liveness sets are live-in sets, so they include the node's inputs.
+      for (Value* v : liveness[n]) {
+        last_use[v] = index;
+      }
+      ++index;
+    }
+    auto lastUse = [&](Value* v) {
+      auto it = last_use.find(v);
+      return it == last_use.end() ? def.at(v) : std::max(def.at(v), it->second);
+    };
+
+    std::vector<MemoryPlanner::ManagedTensor> managed;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      if (!nodes_[i].has_out_variant()) {
+        continue;
+      }
+      for (Value* v : processed[i]->outputs()) {
+        if (!v->type()->isSubtypeOf(TensorType::get()) ||
+            alias_db.mayContainAlias(v, graph_->outputs())) {
+          continue;
+        }
+        size_t end = lastUse(v);
+        for (Node* n = processed[i]->next(); n != graph_->return_node();
+             n = n->next()) {
+          for (Value* w : n->outputs()) {
+            if (alias_db.mayContainAlias(v, w)) {
+              end = std::max(end, lastUse(w));
+            }
+          }
+        }
+        const size_t reg = reg_of.at(v);
+        managed.push_back({&registers_[reg], def.at(v), end, 0, 0});
+        persistent[reg] = true;
+      }
+    }
+    planner_ = std::make_unique<MemoryPlanner>(std::move(managed));
+  }
+
+  for (size_t reg = 0; reg < registers_.size(); ++reg) {
+    if (!persistent[reg]) {
+      transient_regs_.push_back(reg);
+    }
+  }
+}
+
+c10::IValue StaticRuntime::run(std::vector<c10::IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "Expected ",
+      input_regs_.size(),
+      " inputs, but got ",
+      inputs.size());
+  std::lock_guard<std::mutex> guard(run_mutex_);
+  at::AutoGradMode no_grad(false);
+  stack_.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    registers_[input_regs_[i]] = std::move(inputs[i]);
+  }
+
+  for (auto& node : nodes_) {
+    node.run(stack_);
+  }
+
+  IValue output;
+  if (output_regs_.size() == 1) {
+    output = registers_[output_regs_[0]];
+  } else {
+    std::vector<IValue> outputs;
+    outputs.reserve(output_regs_.size());
+    for (size_t reg : output_regs_) {
+      outputs.push_back(registers_[reg]);
+    }
+    output = c10::ivalue::Tuple::create(std::move(outputs));
+  }
+
+  for (size_t reg : transient_regs_) {
+    registers_[reg] = IValue();
+  }
+  if (planner_) {
+    planner_->update();
+  }
+  return output;
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  std::vector<IValue> ivalues(inputs.begin(), inputs.end());
+  IValue output = run(std::move(ivalues));
+  if (output.isTensor()) {
+    return {output.toTensor()};
+  }
+  TORCH_CHECK(
+      output.isTuple(),
+      "Expected the graph to return a Tensor or a tuple of Tensors");
+  std::vector<at::Tensor> outputs;
+  for (const auto& elem : output.toTuple()->elements()) {
+    outputs.push_back(elem.toTensor());
+  }
+  return outputs;
+}
+
+size_t StaticRuntime::num_managed_tensors() const {
+  std::lock_guard<std::mutex> guard(run_mutex_);
+  return planner_ ? planner_->num_managed() : 0;
+}
+
+size_t StaticRuntime::managed_bytes() const {
+  std::lock_guard<std::mutex> guard(run_mutex_);
+  return planner_ ? planner_->arena_bytes() : 0;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <c10/core/Allocator.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+struct TORCH_API StaticRuntimeOptions {
+  // Place the tensors produced by out variants in a single arena whose layout
+  // is planned from their live ranges and reused across runs.
+  bool optimize_memory = true;
+};
+
+// A node of the graph bound to the registers holding its inputs and outputs.
+// Nodes with a registered out variant (see ops.h) call the ATen kernel
+// directly; everything else goes through the node's boxed Operation.
+class TORCH_API ProcessedNode {
+ public:
+  ProcessedNode(
+      Node* node,
+      std::vector<const IValue*> inputs,
+      std::vector<IValue*> outputs);
+
+  void run(Stack& stack);
+
+  Node* node() const {
+    return node_;
+  }
+
+  const IValue& Input(size_t i) const {
+    return *inputs_[i];
+  }
+
+  IValue& Output(size_t i) {
+    return *outputs_[i];
+  }
+
+  bool has_out_variant() const {
+    return static_cast<bool>(out_fn_);
+  }
+
+ private:
+  Node* node_;
+  std::vector<const IValue*> inputs_;
+  std::vector<IValue*> outputs_;
+  OutVariantFn out_fn_;
+  Operation op_;
+};
+
+class MemoryPlanner;
+
+// StaticRuntime runs a straight-line TorchScript graph, typically the forward
+// of a frozen module used for inference, without going through the
+// interpreter. Every value of the graph gets a register, constants are
+// materialized once at construction, and nodes are executed in order directly
+// on the registers.
+//
+// Intermediate tensors produced by out variants keep their TensorImpl across
+// runs. After the first run their sizes are known, and the MemoryPlanner lays
+// them out in a single arena so that tensors whose live ranges do not overlap
+// share memory. Later runs write into that arena without allocating. Inputs
+// whose shapes change are still handled: a kernel that needs more memory
+// allocates it, and the arena is re-planned after that run.
+//
+// Graphs with control flow, and modules that are still in training mode, are
+// rejected. Autograd is disabled while running.
+//
+// Runs share the registers and the arena, so concurrent calls to run() on the
+// same StaticRuntime are serialized. Use one StaticRuntime per thread to run
+// a graph concurrently.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(
+      std::shared_ptr<Graph> graph,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  // Freezes `module` and runs its forward method. `inputs` passed to run()
+  // do not include `self`.
+  explicit StaticRuntime(
+      const Module& module,
+      const StaticRuntimeOptions& opts = StaticRuntimeOptions());
+
+  ~StaticRuntime();
+
+  C10_DISABLE_COPY_AND_ASSIGN(StaticRuntime);
+
+  // Returns the graph output, or a tuple of them when there are several.
+  c10::IValue run(std::vector<c10::IValue> inputs);
+
+  // Convenience overload for graphs whose outputs are tensors, or a tuple of
+  // tensors.
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  const std::vector<ProcessedNode>& nodes() const {
+    return nodes_;
+  }
+
+  // Number of tensors placed in the arena, and the arena size in bytes.
+  size_t num_managed_tensors() const;
+  size_t managed_bytes() const;
+
+ private:
+  // `self`, if given, is bound to the first graph input.
+  void init(const StaticRuntimeOptions& opts, c10::optional<IValue> self);
+
+  std::shared_ptr<Graph> graph_;
+
+  std::vector<IValue> registers_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // Registers dropped at the end of every run.
+  std::vector<size_t> transient_regs_;
+  std::vector<ProcessedNode> nodes_;
+  Stack stack_;
+  std::unique_ptr<MemoryPlanner> planner_;
+  mutable std::mutex run_mutex_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,30 @@
+#include <torch/csrc/jit/runtime/static/init.h>
+
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+void initStaticRuntimeBindings(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<StaticRuntime, std::shared_ptr<StaticRuntime>>(m, "StaticRuntime")
+      .def(
+          "run",
+          py::overload_cast<const std::vector<at::Tensor>&>(
+              &StaticRuntime::run),
+          py::call_guard<py::gil_scoped_release>())
+      .def("num_managed_tensors", &StaticRuntime::num_managed_tensors)
+      .def("managed_bytes", &StaticRuntime::managed_bytes)
+      .def_property_readonly("graph", &StaticRuntime::graph);
+  m.def(
+       "_jit_to_static_runtime",
+       [](const std::shared_ptr<Graph>& g) {
+         return std::make_shared<StaticRuntime>(g);
+       })
+      .def("_jit_to_static_runtime", [](const Module& module) {
+        return std::make_shared<StaticRuntime>(module);
+      });
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,174 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+std::unordered_map<Symbol, OutVariantCreator>& outVariantRegistry() {
+  static std::unordered_map<Symbol, OutVariantCreator> registry;
+  return registry;
+}
+
+template <typename Functional, typename Out>
+void runOutVariant(ProcessedNode* p, Functional functional, Out out_fn) {
+  if (p->Output(0).isNone()) {
+    p->Output(0) = functional();
+  } else {
+    auto out = p->Output(0).toTensor();
+    out_fn(out);
+  }
+}
+
+#define REGISTER_OUT_VARIANT(name, id, creator) \
+  RegisterOutVariant out_variant_##id(name, creator)
+
+#define UNARY_OUT_VARIANT(op)                                              \
+  REGISTER_OUT_VARIANT(aten::op, op, [](Node* n) -> OutVariantFn {         \
+    if (!n->matches("aten::" #op "(Tensor self) -> Tensor")) {             \
+      return nullptr;                                                      \
+    }                                                                      \
+    return [](ProcessedNode* p) {                                          \
+      auto self = p->Input(0).toTensor();                                  \
+      runOutVariant(                                                       \
+          p,                                                               \
+          [&]() { return at::op(self); },                                  \
+          [&](at::Tensor& out) { at::op##_out(out, self); });              \
+    };                                                                     \
+  })
+
+#define BINARY_ALPHA_OUT_VARIANT(op)                                       \
+  REGISTER_OUT_VARIANT(aten::op, op, [](Node* n) -> OutVariantFn {         \
+    if (!n->matches("aten::" #op                                           \
+                    ".Tensor(Tensor self, Tensor other, *, Scalar "        \
+                    "alpha=1) -> Tensor")) {                               \
+      return nullptr;                                                      \
+    }                                                                      \
+    return [](ProcessedNode* p) {                                          \
+      auto self = p->Input(0).toTensor();                                  \
+      auto other = p->Input(1).toTensor();                                 \
+      auto alpha = p->Input(2).toScalar();                                 \
+      runOutVariant(                                                       \
+          p,                                                               \
+          [&]() { return at::op(self, other, alpha); },                    \
+          [&](at::Tensor& out) { at::op##_out(out, self, other, alpha); }); \
+    };                                                                     \
+  })
+
+#define BINARY_OUT_VARIANT(op, schema)                                     \
+  REGISTER_OUT_VARIANT(aten::op, op, [](Node* n) -> OutVariantFn {         \
+    if (!n->matches(schema)) {                                             \
+      return nullptr;                                                      \
+    }                                                                      \
+    return [](ProcessedNode* p) {                                          \
+      auto self = p->Input(0).toTensor();                                  \
+      auto other = p->Input(1).toTensor();                                 \
+      runOutVariant(                                                       \
+          p,                                                               \
+          [&]() { return at::op(self, other); },                           \
+          [&](at::Tensor& out) { at::op##_out(out, self, other); });       \
+    };                                                                     \
+  })
+
+BINARY_ALPHA_OUT_VARIANT(add);
+BINARY_ALPHA_OUT_VARIANT(sub);
+BINARY_OUT_VARIANT(mul, "aten::mul.Tensor(Tensor self, Tensor other) -> Tensor");
+BINARY_OUT_VARIANT(div, "aten::div.Tensor(Tensor self, Tensor other) -> Tensor");
+BINARY_OUT_VARIANT(mm, "aten::mm(Tensor self, Tensor mat2) -> Tensor");
+BINARY_OUT_VARIANT(bmm, "aten::bmm(Tensor self, Tensor mat2) -> Tensor");
+// No matmul: matmul_out set_()s `out` to a fresh result for most shapes,
+// which would move the tensor out of the arena on every run.
+
+UNARY_OUT_VARIANT(sigmoid);
+UNARY_OUT_VARIANT(tanh);
+UNARY_OUT_VARIANT(exp);
+UNARY_OUT_VARIANT(log);
+UNARY_OUT_VARIANT(sqrt);
+
+REGISTER_OUT_VARIANT(aten::addmm, addmm, [](Node* n) -> OutVariantFn {
+  if (!n->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p) {
+    auto self = p->Input(0).toTensor();
+    auto mat1 = p->Input(1).toTensor();
+    auto mat2 = p->Input(2).toTensor();
+    auto beta = p->Input(3).toScalar();
+    auto alpha = p->Input(4).toScalar();
+    runOutVariant(
+        p,
+        [&]() { return at::addmm(self, mat1, mat2, beta, alpha); },
+        [&](at::Tensor& out) {
+          at::addmm_out(out, self, mat1, mat2, beta, alpha);
+        });
+  };
+});
+
+// relu has no out= overload; clamp_min computes the same thing.
+REGISTER_OUT_VARIANT(aten::relu, relu, [](Node* n) -> OutVariantFn {
+  if (!n->matches("aten::relu(Tensor self) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p) {
+    auto self = p->Input(0).toTensor();
+    runOutVariant(
+        p,
+        [&]() { return at::relu(self); },
+        [&](at::Tensor& out) { at::clamp_min_out(out, self, 0); });
+  };
+});
+
+REGISTER_OUT_VARIANT(aten::leaky_relu, leaky_relu, [](Node* n) -> OutVariantFn {
+  if (!n->matches(
+          "aten::leaky_relu(Tensor self, Scalar negative_slope=0.01) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p) {
+    auto self = p->Input(0).toTensor();
+    auto negative_slope = p->Input(1).toScalar();
+    runOutVariant(
+        p,
+        [&]() { return at::leaky_relu(self, negative_slope); },
+        [&](at::Tensor& out) { at::leaky_relu_out(out, self, negative_slope); });
+  };
+});
+
+REGISTER_OUT_VARIANT(aten::cat, cat, [](Node* n) -> OutVariantFn {
+  if (!n->matches("aten::cat(Tensor[] tensors, int dim=0) -> Tensor")) {
+    return nullptr;
+  }
+  return [](ProcessedNode* p) {
+    auto tensors = p->Input(0).toTensorVector();
+    auto dim = p->Input(1).toInt();
+    runOutVariant(
+        p,
+        [&]() { return at::cat(tensors, dim); },
+        [&](at::Tensor& out) { at::cat_out(out, tensors, dim); });
+  };
+});
+
+} // namespace
+
+RegisterOutVariant::RegisterOutVariant(
+    Symbol kind,
+    OutVariantCreator creator) {
+  outVariantRegistry().emplace(kind, std::move(creator));
+}
+
+OutVariantFn getOutVariant(Node* n) {
+  auto& registry = outVariantRegistry();
+  auto it = registry.find(n->kind());
+  if (it == registry.end()) {
+    return nullptr;
+  }
+  return it->second(n);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <functional>
+
+namespace torch {
+namespace jit {
+
+class ProcessedNode;
+
+// Runs a node of the static runtime straight from its registers. If the output
+// register already holds a tensor from a previous run, the kernel writes into
+// it with the op's out= variant, which keeps its storage (and its place in the
+// memory plan). Otherwise the functional op allocates a new one.
+using OutVariantFn = std::function<void(ProcessedNode*)>;
+
+// Returns an empty function if `n` has no out variant in the static runtime.
+using OutVariantCreator = std::function<OutVariantFn(Node*)>;
+
+struct TORCH_API RegisterOutVariant {
+  RegisterOutVariant(Symbol kind, OutVariantCreator creator);
+};
+
+TORCH_API OutVariantFn getOutVariant(Node* n);
+
+} // namespace jit
+} // namespace torch
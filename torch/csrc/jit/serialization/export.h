@@ -53,23 +53,30 @@ TORCH_API std::string pretty_print_onnx(
     const std::map<std::string, int>& custom_opsets = {},
     bool add_node_names = true);
 
+// If compression_level is between 1 and 10, records of at least
+// caffe2::serialize::kMinSizeToCompress bytes (tensors included) are
+// deflated at that level when it makes them smaller. Loading decompresses
+// them in parallel; uncompressed records can still be memory-mapped.
 TORCH_API void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    int compression_level = 0);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    int compression_level = 0);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    int compression_level = 0);
 
 // Write the bytes of a pickle archive and the tensors referenced inside that
 // archive
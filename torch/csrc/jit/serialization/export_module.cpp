@@ -55,10 +55,15 @@ c10::IValue getFunctionTuple(const Function& func) {
   std::vector<std::string> method_names;
   for (size_t i = 0; i < instructions_copy.size(); ++i) {
     Instruction ins = instructions_copy[i];
-    if (ins.op == OP || ins.op == OPN) {
+    if (ins.op == OP || ins.op == OPN || ins.op == OP_OUT) {
       auto node = code.instructions_source()[i];
       opnames.emplace_back(node->schema().operator_name());
     }
+    // The lite interpreter keeps no state across runs to reuse outputs from,
+    // so OP_OUT is exported as a plain OP on the functional operator.
+    if (ins.op == OP_OUT) {
+      instructions_copy[i] = Instruction(OP, ins.X, 0);
+    }
     // CALL nodes at this point represent built-in (i.e. non-Graph)
     // functions that were not inlined. Here we convert the CALL
     // instructions for these functions into INTERFACE_CALL instructions
@@ -172,8 +177,12 @@ class ScriptModuleSerializer {
   void serialize(
       const Module& module,
       const ExtraFilesMap& extra_files,
-      bool bytecode_format) {
+      bool bytecode_format,
+      int compression_level = 0) {
     C10_LOG_API_USAGE_ONCE("torch.script.save");
+    if (compression_level > 0) {
+      writer_.setCompression(compression_level);
+    }
     writeExtraFiles(module, extra_files);
     // Serialize the model object
     writeArchive("data", module._ivalue());
@@ -326,31 +335,34 @@ void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    int compression_level) {
   ScriptModuleSerializer serializer(
       [&](const void* buf, size_t nbytes) -> size_t {
         out.write(static_cast<const char*>(buf), nbytes);
         return !out ? 0 : nbytes;
       });
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compression_level);
 }
 
 void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    int compression_level) {
   ScriptModuleSerializer serializer(filename);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compression_level);
 }
 
 void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    int compression_level) {
   ScriptModuleSerializer serializer(writer_func);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, compression_level);
 }
 
 } // namespace jit
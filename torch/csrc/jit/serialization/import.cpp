@@ -15,6 +15,7 @@
 #include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_adapter.h"
 
 #include <ATen/ATen.h>
 
@@ -28,6 +29,7 @@ namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -79,9 +81,22 @@ IValue readArchiveAndTensors(
     return len;
   };
 
+  // Read all the tensors of the archive at once, so that compressed ones are
+  // decompressed in parallel.
+  std::unordered_map<std::string, at::DataPtr> records;
+  auto names = stream_reader.getRecordsInDirectory(archive_name);
+  auto tensor_records = stream_reader.getRecords(names);
+  for (size_t i = 0; i < names.size(); i++) {
+    records[names[i]] = std::move(std::get<0>(tensor_records[i]));
+  }
+
   std::string archive_name_plus_slash = archive_name + "/";
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
+    auto it = records.find(ss);
+    if (it != records.end() && it->second) {
+      return std::move(it->second);
+    }
     return std::get<0>(stream_reader.getRecord(ss));
   };
 
@@ -226,8 +241,15 @@ Module import_ir_module(
     std::shared_ptr<CompilationUnit> cu,
     const std::string& filename,
     c10::optional<at::Device> device,
-    ExtraFilesMap& extra_files) {
-  auto reader = torch::make_unique<PyTorchStreamReader>(filename);
+    ExtraFilesMap& extra_files,
+    bool use_mmap) {
+  std::unique_ptr<PyTorchStreamReader> reader;
+  if (use_mmap) {
+    reader = torch::make_unique<PyTorchStreamReader>(
+        std::make_unique<MmapAdapter>(filename));
+  } else {
+    reader = torch::make_unique<PyTorchStreamReader>(filename);
+  }
   ScriptModuleDeserializer deserializer(std::move(cu), std::move(reader));
   return deserializer.deserialize(device, extra_files);
 }
@@ -254,8 +276,14 @@ Module load(
 Module load(
     const std::string& filename,
     c10::optional<at::Device> device,
-    ExtraFilesMap& extra_files) {
-  std::unique_ptr<FileAdapter> rai = std::make_unique<FileAdapter>(filename);
+    ExtraFilesMap& extra_files,
+    bool use_mmap) {
+  std::unique_ptr<ReadAdapterInterface> rai;
+  if (use_mmap) {
+    rai = std::make_unique<MmapAdapter>(filename);
+  } else {
+    rai = std::make_unique<FileAdapter>(filename);
+  }
   auto module = load(std::move(rai), device, extra_files);
   return module;
 }
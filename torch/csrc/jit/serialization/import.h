@@ -18,11 +18,16 @@ namespace jit {
 
 static ExtraFilesMap default_extra_files;
 
+/// If `use_mmap` is true, the file is mapped copy-on-write instead of read,
+/// and CPU tensors stored uncompressed point directly into the mapping. This
+/// avoids a copy of every tensor and lets the OS page weights in on demand,
+/// at the cost of keeping the file mapped for as long as any of them lives.
 TORCH_API Module import_ir_module(
     std::shared_ptr<CompilationUnit> cu,
     const std::string& filename,
     c10::optional<c10::Device> device = c10::nullopt,
-    ExtraFilesMap& extra_files = default_extra_files);
+    ExtraFilesMap& extra_files = default_extra_files,
+    bool use_mmap = false);
 
 TORCH_API Module import_ir_module(
     std::shared_ptr<CompilationUnit> cu,
@@ -50,10 +55,15 @@ TORCH_API Module load(
 /// The file stored at the location given in `filename` must contain a
 /// serialized `Module`, exported either via `ScriptModule.save()` in
 /// Python or `torch::jit::ExportModule` in C++.
+///
+/// If `use_mmap` is true, the file is memory-mapped and the CPU tensors of the
+/// module share its pages copy-on-write instead of being read into fresh
+/// memory; see `import_ir_module`.
 TORCH_API Module load(
     const std::string& filename,
     c10::optional<c10::Device> device = c10::nullopt,
-    ExtraFilesMap& extra_files = default_extra_files);
+    ExtraFilesMap& extra_files = default_extra_files,
+    bool use_mmap = false);
 
 /// Loads a serialized `Module` from the given `rai`.
 ///
@@ -65,14 +65,26 @@ void HashProvider::visit(const Max* v) {
   CACHE_GUARD();
   v->lhs()->accept(this);
   v->rhs()->accept(this);
-  putHash(v, hash_combine(hashOf(v->lhs()), "Mx", hashOf(v->rhs())));
+  putHash(
+      v,
+      hash_combine(
+          hashOf(v->lhs()),
+          "Mx",
+          hashOf(v->rhs()),
+          (int)v->propagate_nans()));
 }
 
 void HashProvider::visit(const Min* v) {
   CACHE_GUARD();
   v->lhs()->accept(this);
   v->rhs()->accept(this);
-  putHash(v, hash_combine(hashOf(v->lhs()), "Mn", hashOf(v->rhs())));
+  putHash(
+      v,
+      hash_combine(
+          hashOf(v->lhs()),
+          "Mn",
+          hashOf(v->rhs()),
+          (int)v->propagate_nans()));
 }
 
 void HashProvider::visit(const And* v) {
@@ -221,7 +233,11 @@ void HashProvider::visit(const For* v) {
   v->stop()->accept(this);
 
   SimplifierHashType hash = hash_combine(
-      "for", hashOf(v->var()), hashOf(v->start()), hashOf(v->stop()));
+      "for",
+      hashOf(v->var()),
+      hashOf(v->start()),
+      hashOf(v->stop()),
+      v->loop_options().ToString());
   if (v->body()) {
     v->body()->accept(this);
     hash = hash_combine(hash, hashOf(v->body()));
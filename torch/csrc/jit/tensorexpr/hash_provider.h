@@ -62,6 +62,12 @@ class TORCH_API HashProvider : public IRVisitor {
     return exprToHash_.find(e) != exprToHash_.end();
   }
 
+  // Drops the memoized hash of `e`, which must be done before its memory is
+  // reused for another node.
+  void clearHash(const KernelScopedObject* e) {
+    exprToHash_.erase(e);
+  }
+
   void visit(const Add* v) override;
   void visit(const Sub* v) override;
   void visit(const Mul* v) override;
@@ -9,19 +9,11 @@ namespace torch {
 namespace jit {
 namespace tensorexpr {
 
-template <typename Op>
-static const Expr* mutate_binary_op(
-    const BinaryOpNode<Op>* v,
-    IRMutator* mutator,
-    bool option = false) {
-  const Expr* lhs = v->lhs();
-  const Expr* rhs = v->rhs();
-  const Expr* lhs_new = lhs->accept_mutator(mutator);
-  const Expr* rhs_new = rhs->accept_mutator(mutator);
-  if (lhs == lhs_new && rhs == rhs_new) {
-    return v;
-  }
-  IRNodeType expr_type = v->expr_type();
+static const Expr* newBinaryOp(
+    IRNodeType expr_type,
+    const Expr* lhs_new,
+    const Expr* rhs_new,
+    bool option) {
   switch (expr_type) {
     case IRNodeType::kAdd:
       return new Add(lhs_new, rhs_new);
@@ -52,6 +44,21 @@ static const Expr* mutate_binary_op(
   }
 }
 
+template <typename Op>
+static const Expr* mutate_binary_op(
+    const BinaryOpNode<Op>* v,
+    IRMutator* mutator,
+    bool option = false) {
+  const Expr* lhs = v->lhs();
+  const Expr* rhs = v->rhs();
+  const Expr* lhs_new = lhs->accept_mutator(mutator);
+  const Expr* rhs_new = rhs->accept_mutator(mutator);
+  if (lhs == lhs_new && rhs == rhs_new) {
+    return v;
+  }
+  return internExpr(newBinaryOp(v->expr_type(), lhs_new, rhs_new, option));
+}
+
 const Expr* IRMutator::mutate(const Add* v) {
   return mutate_binary_op(v, this);
 }
@@ -113,13 +120,13 @@ const Expr* IRMutator::mutate(const CompareSelect* v) {
       retval2 == retval2_new) {
     return v;
   }
-  return CompareSelect::make(
-             ExprHandle(lhs_new),
-             ExprHandle(rhs_new),
-             ExprHandle(retval1_new),
-             ExprHandle(retval2_new),
-             v->compare_select_op())
-      .node();
+  return internExpr(CompareSelect::make(
+                        ExprHandle(lhs_new),
+                        ExprHandle(rhs_new),
+                        ExprHandle(retval1_new),
+                        ExprHandle(retval2_new),
+                        v->compare_select_op())
+                        .node());
 }
 
 // NOLINTNEXTLINE
@@ -136,7 +143,7 @@ const Expr* IRMutator::mutate(const Cast* v) {
   if (src_value_new == v->src_value()) {
     return v;
   }
-  return new Cast(v->dtype(), src_value_new);
+  return internExpr(new Cast(v->dtype(), src_value_new));
 }
 
 const Expr* IRMutator::mutate(const Var* v) {
@@ -180,7 +187,7 @@ const Expr* IRMutator::mutate(const Ramp* v) {
   if (base == base_new && stride == stride_new) {
     return v;
   }
-  return new Ramp(base_new, stride_new, v->lanes());
+  return internExpr(new Ramp(base_new, stride_new, v->lanes()));
 }
 
 const Expr* IRMutator::mutate(const Load* v) {
@@ -216,7 +223,7 @@ const Expr* IRMutator::mutate(const Broadcast* v) {
   if (value == value_new) {
     return v;
   }
-  return new Broadcast(value_new, lanes);
+  return internExpr(new Broadcast(value_new, lanes));
 }
 
 const Expr* IRMutator::mutate(const IfThenElse* v) {
@@ -389,7 +389,8 @@ class TORCH_API PolynomialTransformer : public IRMutator {
     const Expr* node = v;
 
     if (lhs != lhs_new || rhs != rhs_new) {
-      node = newBinaryOpOfType(v->expr_type(), lhs_new, rhs_new, option);
+      node = internExpr(
+          newBinaryOpOfType(v->expr_type(), lhs_new, rhs_new, option));
     }
 
     // Can only fold if both sides are constant.
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <ATen/Parallel.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
@@ -7,6 +8,9 @@
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
 
+#include <atomic>
+#include <chrono>
+
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
 
@@ -30,10 +34,62 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+static std::atomic<int64_t> te_compiled_kernels{0};
+static std::atomic<int64_t> te_compile_time_us{0};
+static std::atomic<int64_t> te_arena_bytes{0};
+static std::atomic<int64_t> te_interned_exprs{0};
+
+TensorExprCompileStats getTECompileStats() {
+  TensorExprCompileStats stats;
+  stats.kernels = te_compiled_kernels;
+  stats.compile_time_us = te_compile_time_us;
+  stats.arena_bytes = te_arena_bytes;
+  stats.interned_exprs = te_interned_exprs;
+  return stats;
+}
+
+void resetTECompileStats() {
+  te_compiled_kernels = 0;
+  te_compile_time_us = 0;
+  te_arena_bytes = 0;
+  te_interned_exprs = 0;
+}
+
+static int64_t elapsedUs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
 
+// Returns the number of times the innermost statements of the loop nest rooted
+// at `f` execute, or -1 if it is not known at compile time.
+static int64_t loopNestSize(For* f) {
+  auto start = dynamic_cast<const IntImm*>(f->start());
+  auto stop = dynamic_cast<const IntImm*>(f->stop());
+  if (!start || !stop) {
+    return -1;
+  }
+  int64_t inner = 1;
+  if (tensorexpr::Block* body = dynamic_cast<tensorexpr::Block*>(f->body())) {
+    int64_t sum = 0;
+    for (Stmt* s : body->stmts()) {
+      if (For* f2 = dynamic_cast<For*>(s)) {
+        int64_t size = loopNestSize(f2);
+        if (size < 0) {
+          return -1;
+        }
+        sum += size;
+      }
+    }
+    inner = std::max<int64_t>(sum, 1);
+  }
+  return std::max(stop->value() - start->value(), 0) * inner;
+}
+
 static at::ScalarType tensorType(Tensor* t) {
   return static_cast<at::ScalarType>(t->body()->dtype().scalar_type());
 }
@@ -1110,6 +1166,42 @@ void TensorExprKernel::lowerToBackend(BackendType backendType) {
         l.vectorize(split2);
       }
     }
+
+    // Distribute large loop nests over the intra-op thread pool. The outer
+    // loops of an output tensor range over its elements, so their iterations
+    // are independent. Kernels drawing random numbers stay serial to keep the
+    // generator's sequence deterministic.
+    std::vector<For*> outerLoops;
+    if (For* rootF = dynamic_cast<For*>(l.root_stmt())) {
+      outerLoops.push_back(rootF);
+    } else if (Block* body = dynamic_cast<Block*>(l.root_stmt())) {
+      for (Stmt* s : body->stmts()) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          outerLoops.push_back(f);
+        }
+      }
+    }
+    for (For* f : outerLoops) {
+      if (hasRandom_ || loopNestSize(f) < at::internal::GRAIN_SIZE) {
+        continue;
+      }
+      // Skip over degenerate outer dimensions.
+      while (true) {
+        auto start = dynamic_cast<const IntImm*>(f->start());
+        auto stop = dynamic_cast<const IntImm*>(f->stop());
+        Block* body = dynamic_cast<Block*>(f->body());
+        if (!start || !stop || stop->value() - start->value() != 1 || !body ||
+            body->nstmts() != 1) {
+          break;
+        }
+        For* inner = dynamic_cast<For*>(body->stmts().front());
+        if (!inner) {
+          break;
+        }
+        f = inner;
+      }
+      l.setParallel(f);
+    }
   }
 
   l.prepareForCodegen();
@@ -1270,7 +1362,12 @@ void TensorExprKernel::pickAndCheckBackendType(
   if (backendType_ == kUninitialized) {
     backendType_ = backendType;
     device_ = device;
+    auto start = std::chrono::steady_clock::now();
     lowerToBackend(backendType);
+    te_compile_time_us += elapsedUs(start);
+    te_compiled_kernels++;
+    te_arena_bytes += kernelArena_.bytes_allocated();
+    te_interned_exprs += kernelArena_.num_interned();
   } else if (backendType_ != backendType) {
     // TODO: if we have to support muliptole backends with the same subgraph,
     // we need to add kernel caching.
@@ -1428,11 +1525,13 @@ void TensorExprKernel::compile() {
 
 TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
     : graph_(subgraph), code_(subgraph, "") {
+  auto start = std::chrono::steady_clock::now();
   try {
     compile();
   } catch (...) {
     fallback_ = true;
   }
+  te_compile_time_us += elapsedUs(start);
 }
 
 void TensorExprKernel::run(Stack& stack) {
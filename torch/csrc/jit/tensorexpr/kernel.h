@@ -224,6 +224,20 @@ TORCH_API int& getTECudaPointwiseLoopLevels();
 TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
 
+// Counters for the cost of building TensorExpr kernels, cumulative over all
+// kernels since the last reset. The time covers building the tensor
+// expressions from the graph and lowering them to a backend; the arena bytes
+// and interned expressions are those of the kernels lowered so far.
+struct TensorExprCompileStats {
+  int64_t kernels = 0;
+  int64_t compile_time_us = 0;
+  int64_t arena_bytes = 0;
+  int64_t interned_exprs = 0;
+};
+
+TORCH_API TensorExprCompileStats getTECompileStats();
+TORCH_API void resetTECompileStats();
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -4,21 +4,28 @@
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
 #include <memory>
+#include <sstream>
+#include <unordered_set>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
+#include <torch/csrc/jit/codegen/fuser/disk_cache.h>
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
+#include <torch/csrc/jit/tensorexpr/hash_provider.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
+#include <torch/csrc/jit/tensorexpr/ir_visitor.h>
 #include <torch/csrc/jit/tensorexpr/types.h>
 
 #define DEBUG_PRINT 0
@@ -56,6 +63,9 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  std::string emitObject();
+  void emitSerialFor(const For* v, llvm::Value* start, llvm::Value* stop);
+  void emitParallelFor(const For* v, llvm::Value* start, llvm::Value* stop);
 
  public:
   LLVMCodeGenImpl(
@@ -206,6 +216,36 @@ llvm::JITTargetAddress LLVMCodeGenImpl::getKernelAddress() const {
   return kernelAddress_;
 }
 
+// Describes everything the object code of a kernel depends on, for the kernel
+// disk cache: the LLVM version, the target CPU, the signature and the IR. The
+// cache itself adds the PyTorch build, which covers the lowering and the
+// runtime functions the kernel calls.
+static std::string diskCacheKey(
+    Stmt* stmt,
+    const std::vector<CodeGen::BufferArg>& args,
+    Dtype dtype,
+    const llvm::orc::JITTargetMachineBuilder& JTMB) {
+  std::ostringstream key;
+  key << "llvm_codegen " << LLVM_VERSION_STRING << "\n"
+      << JTMB.getTargetTriple().str() << " "
+      << llvm::sys::getHostCPUName().str() << " "
+      << JTMB.getFeatures().getString() << "\n"
+      << "ir_hash " << HashProvider().hash(stmt)._h << "\n";
+
+  // Print the arguments and the body with the same printer, so that the
+  // names of the arguments match their uses.
+  IRPrinter printer(key);
+  key << dtype << " kernel(";
+  for (const auto& arg : args) {
+    key << arg.dtype() << (arg.isVar() ? " " : "* ");
+    arg.var()->accept(&printer);
+    key << ", ";
+  }
+  key << ")\n";
+  stmt->accept(&printer);
+  return key.str();
+}
+
 LLVMCodeGenImpl::LLVMCodeGenImpl(
     Stmt* stmt,
     const std::vector<CodeGen::BufferArg>& args,
@@ -229,6 +269,19 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   TM_ = llvm::cantFail(JTMB.createTargetMachine());
 
   jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>();
+
+  std::string cacheKey;
+  if (fuser::kernelCacheEnabled()) {
+    cacheKey = diskCacheKey(stmt, args, dtype, JTMB);
+    if (auto obj = fuser::loadCachedKernel(cacheKey, ".o")) {
+      cantFail(
+          jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(*obj)));
+      kernelAddress_ = cantFail(jit_->findSymbol("wrapper").getAddress());
+      USE_TRIGGER(llvm_codegen_created);
+      return;
+    }
+  }
+
   module_ = std::make_unique<llvm::Module>("pytorch", getContext());
   module_->setDataLayout(cantFail(JTMB.getDefaultDataLayoutForTarget()));
   module_->setTargetTriple(JTMB.getTargetTriple().str());
@@ -257,8 +310,14 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   emitWrapper(params);
   emitKernel(stmt, params);
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  if (!cacheKey.empty()) {
+    std::string obj = emitObject();
+    fuser::storeCachedKernel(cacheKey, ".o", obj);
+    cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(obj)));
+  } else {
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  }
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
 
@@ -335,7 +394,7 @@ void LLVMCodeGenImpl::emitKernel(
 #if DEBUG_PRINT
   llvm::errs() << *module_;
 #endif
-  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+  if (llvm::verifyModule(*module_, &llvm::outs())) {
     throw std::runtime_error("Function verification failed");
   }
   optimize(*module_);
@@ -355,6 +414,21 @@ void LLVMCodeGenImpl::emitKernel(
 #endif
 }
 
+std::string LLVMCodeGenImpl::emitObject() {
+  llvm::SmallVector<char, 0> objBuffer;
+  llvm::raw_svector_ostream objStream(objBuffer);
+  llvm::legacy::PassManager PM;
+  if (TM_->addPassesToEmitFile(
+          PM,
+          objStream,
+          nullptr,
+          llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile)) {
+    throw std::runtime_error("Target does not support emitting object files");
+  }
+  PM.run(*module_);
+  return std::string(objBuffer.begin(), objBuffer.end());
+}
+
 // TODO: The binary ops are copypasta.
 
 void LLVMCodeGenImpl::visit(const Add* v) {
@@ -910,6 +984,18 @@ void LLVMCodeGenImpl::visit(const For* v) {
   v->stop()->accept(this);
   auto stop = this->value_;
 
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v, start, stop);
+  } else {
+    emitSerialFor(v, start, stop);
+  }
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
+void LLVMCodeGenImpl::emitSerialFor(
+    const For* v,
+    llvm::Value* start,
+    llvm::Value* stop) {
   // Create block for loop condition test.
   auto preheader = irb_.GetInsertBlock();
   auto condBlock = llvm::BasicBlock::Create(getContext(), "cond", fn_);
@@ -942,9 +1028,161 @@ void LLVMCodeGenImpl::visit(const For* v) {
   irb_.CreateBr(condBlock);
   idx->addIncoming(inc, body);
 
-  // Exit the loop.
+  // Exit the loop. The index is not visible past it, and sibling loops may
+  // reuse the same Var.
   irb_.SetInsertPoint(exit);
-  value_ = llvm::ConstantInt::get(IntTy_, 0);
+  varToVal_.erase(v->var());
+}
+
+namespace {
+
+// Collects the Vars referenced by a statement, in order of first use.
+class VarCollector : public IRVisitor {
+ public:
+  std::vector<const Var*> collect(const Stmt* s) {
+    s->accept(this);
+    return vars_;
+  }
+
+ private:
+  void visit(const Var* v) override {
+    if (seen_.insert(v).second) {
+      vars_.push_back(v);
+    }
+  }
+
+  std::unordered_set<const Var*> seen_;
+  std::vector<const Var*> vars_;
+};
+
+} // namespace
+
+// A parallel loop is outlined into a function running a range of its
+// iterations, which is handed to nnc_parallel_for together with the values
+// the body uses from the enclosing function:
+//
+//   void parallel_body(int begin, int end, T0 v0, T1 v1, ...);
+//   void parallel_body_wrapper(int begin, int end, void** args);
+//
+// The wrapper unpacks `args` the same way the kernel wrapper does: pointers
+// are passed directly, scalars through a pointer to their value. Pointer
+// arguments of the kernel keep their noalias attribute in parallel_body, so
+// the outlined loops vectorize as well as the serial ones.
+void LLVMCodeGenImpl::emitParallelFor(
+    const For* v,
+    llvm::Value* start,
+    llvm::Value* stop) {
+  std::vector<const Var*> captured;
+  std::vector<llvm::Value*> capturedVals;
+  for (const Var* var : VarCollector().collect(v->body())) {
+    if (varToArg_.count(var)) {
+      captured.push_back(var);
+      capturedVals.push_back(fn_->arg_begin() + varToArg_.at(var));
+    } else if (varToVal_.count(var)) {
+      captured.push_back(var);
+      capturedVals.push_back(varToVal_.at(var));
+    }
+  }
+
+  auto voidTy = llvm::Type::getVoidTy(getContext());
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto voidPtrPtrTy = voidPtrTy->getPointerTo();
+
+  std::vector<llvm::Type*> bodyParams = {IntTy_, IntTy_};
+  for (auto val : capturedVals) {
+    bodyParams.push_back(val->getType());
+  }
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(voidTy, bodyParams, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+  for (size_t i = 0; i < capturedVals.size(); i++) {
+    auto arg = llvm::dyn_cast<llvm::Argument>(capturedVals[i]);
+    if (arg && arg->hasNoAliasAttr()) {
+      bodyFn->addParamAttr(i + 2, llvm::Attribute::NoAlias);
+    }
+  }
+
+  auto wrapperTy =
+      llvm::FunctionType::get(voidTy, {IntTy_, IntTy_, voidPtrPtrTy}, false);
+  auto wrapper = llvm::Function::Create(
+      wrapperTy,
+      llvm::Function::PrivateLinkage,
+      "parallel_body_wrapper",
+      module_.get());
+
+  // Pack the captured values. The slots live in the entry block so that a
+  // parallel loop nested in a serial one does not grow the stack.
+  llvm::IRBuilder<> entryIrb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().getFirstInsertionPt());
+  llvm::Value* argv = llvm::ConstantPointerNull::get(voidPtrPtrTy);
+  if (!capturedVals.empty()) {
+    argv = entryIrb.CreateAlloca(
+        voidPtrTy, llvm::ConstantInt::get(IntTy_, capturedVals.size()));
+    for (size_t i = 0; i < capturedVals.size(); i++) {
+      llvm::Value* val = capturedVals[i];
+      llvm::Value* arg = nullptr;
+      if (val->getType()->isPointerTy()) {
+        arg = irb_.CreatePointerCast(val, voidPtrTy);
+      } else {
+        auto slot = entryIrb.CreateAlloca(val->getType());
+        irb_.CreateStore(val, slot);
+        arg = irb_.CreatePointerCast(slot, voidPtrTy);
+      }
+      irb_.CreateStore(
+          arg, irb_.CreateGEP(argv, llvm::ConstantInt::getSigned(IntTy_, i)));
+    }
+  }
+
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          voidTy,
+          {wrapperTy->getPointerTo(), IntTy_, IntTy_, voidPtrPtrTy},
+          false));
+  irb_.CreateCall(parallelFor, {wrapper, start, stop, argv});
+
+  llvm::IRBuilderBase::InsertPointGuard guard(irb_);
+
+  // Emit the wrapper.
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", wrapper));
+  std::vector<llvm::Value*> wrappedArgs = {
+      wrapper->arg_begin(), wrapper->arg_begin() + 1};
+  for (size_t i = 0; i < capturedVals.size(); i++) {
+    llvm::Type* type = capturedVals[i]->getType();
+    auto argp = irb_.CreateGEP(
+        wrapper->arg_begin() + 2, llvm::ConstantInt::getSigned(IntTy_, i));
+    if (type->isPointerTy()) {
+      wrappedArgs.push_back(
+          irb_.CreatePointerCast(irb_.CreateLoad(argp), type));
+    } else {
+      auto p =
+          irb_.CreatePointerCast(irb_.CreateLoad(argp), type->getPointerTo());
+      wrappedArgs.push_back(irb_.CreateLoad(p));
+    }
+  }
+  irb_.CreateCall(bodyFn, wrappedArgs);
+  irb_.CreateRetVoid();
+
+  // Emit the body, with the captured Vars bound to its parameters.
+  llvm::Function* outerFn = fn_;
+  auto outerArgs = std::move(varToArg_);
+  auto outerVals = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+  for (size_t i = 0; i < captured.size(); i++) {
+    varToVal_.emplace(captured[i], bodyFn->arg_begin() + 2 + i);
+  }
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  emitSerialFor(v, fn_->arg_begin(), fn_->arg_begin() + 1);
+  irb_.CreateRetVoid();
+
+  fn_ = outerFn;
+  varToArg_ = std::move(outerArgs);
+  varToVal_ = std::move(outerVals);
 }
 
 void LLVMCodeGenImpl::visit(const Block* v) {
@@ -984,6 +1222,28 @@ void LLVMCodeGenImpl::emitMaskedStore(
   irb_.SetInsertPoint(tailblock);
 }
 
+template <typename Op>
+static bool isAccumulationInto(const Expr* e, const Buf* buf) {
+  auto op = dynamic_cast<const Op*>(e);
+  if (!op) {
+    return false;
+  }
+  for (const Expr* operand : {op->lhs(), op->rhs()}) {
+    auto load = dynamic_cast<const Load*>(operand);
+    if (load && load->buf() == buf) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if `v` stores `buf[...] op x` back to `buf`, which is how
+// reductions are lowered.
+static bool isAccumulation(const Store* v) {
+  return isAccumulationInto<Add>(v->value(), v->buf()) ||
+      isAccumulationInto<Mul>(v->value(), v->buf());
+}
+
 void LLVMCodeGenImpl::visit(const Store* v) {
   if (v->value()->dtype().lanes() == 1) {
     v->base_handle()->accept(this);
@@ -993,6 +1253,15 @@ void LLVMCodeGenImpl::visit(const Store* v) {
     v->value()->accept(this);
     auto val = this->value_;
 
+    // Let LLVM reassociate floating point accumulations, so that the loop
+    // vectorizer can turn reductions into vector partial sums.
+    if (isAccumulation(v)) {
+      auto op = llvm::dyn_cast<llvm::BinaryOperator>(val);
+      if (op && op->getType()->isFPOrFPVectorTy()) {
+        op->setHasAllowReassoc(true);
+      }
+    }
+
     auto* maskimm = dynamic_cast<const IntImm*>(v->mask());
     if (maskimm && maskimm->value() == 1) {
       emitUnmaskedStore(base, idx, val);
@@ -2,6 +2,7 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <sleef.h>
 #include <algorithm>
@@ -9,6 +10,19 @@
 #include <string>
 #include <vector>
 
+// Runtime entry point for loops marked parallel. `body` is the outlined loop
+// body generated by LLVMCodeGen: it runs iterations [begin, end) of the loop
+// with the values it captured from the kernel packed in `args`.
+static void nnc_parallel_for(
+    void (*body)(int32_t, int32_t, void**),
+    int32_t start,
+    int32_t stop,
+    void** args) {
+  at::parallel_for(start, stop, 1, [&](int64_t begin, int64_t end) {
+    body(static_cast<int32_t>(begin), static_cast<int32_t>(end), args);
+  });
+}
+
 namespace llvm {
 namespace orc {
 
@@ -77,6 +91,11 @@ class TORCH_API PytorchLLVMJITImpl {
         *Mangle("remainderf"),
         {llvm::pointerToJITTargetAddress(&remainderf), {}}));
 
+    // Runtime support for parallel loops
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("nnc_parallel_for"),
+        {llvm::pointerToJITTargetAddress(&nnc_parallel_for), {}}));
+
     // FP32 Sleef functions -- SSE
     cantFail(LLJ->defineAbsolute(
         *Mangle("Sleef_acosf4"),
@@ -425,6 +444,10 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  Error addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+    return LLJ->addObjectFile(std::move(Obj));
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -443,6 +466,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+Error PytorchLLVMJIT::addObjectFile(std::unique_ptr<MemoryBuffer> Obj) {
+  return impl_->addObjectFile(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
@@ -310,6 +310,14 @@ class Vectorizer : public IRMutator {
 
   Stmt* mutate(const Store* v) override {
     const Buf* buf = v->buf();
+    // A store to an address that does not depend on the vectorized loop
+    // variable is an accumulation (a reduction over that loop). Turning it
+    // into a vector store would keep only the last lane; leave the loop scalar
+    // and let the backend vectorize the reduction instead.
+    if (v->flat_index()->accept_mutator(this) == v->flat_index() &&
+        v->value()->accept_mutator(this) != v->value()) {
+      throw std::runtime_error("Can't vectorize a reduction!");
+    }
     std::vector<const Expr*> inputs = {v->flat_index(), v->value(), v->mask()};
     return try_vectorize(v, inputs, [&]() {
       return Store::make(
@@ -1124,6 +1132,10 @@ void LoopNest::setGPUThreadIndex(For* f, int thread_index) {
   f->set_gpu_thread_index(thread_index);
 }
 
+void LoopNest::setParallel(For* f) {
+  f->set_parallel();
+}
+
 Stmt* LoopNest::getLoopBodyFor(Tensor* t) const {
   return tensor_to_stmt_.at(t);
 }
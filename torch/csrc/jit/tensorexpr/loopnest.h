@@ -43,6 +43,11 @@ class TORCH_API LoopNest {
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
 
+  // Marks `f` as a parallel loop. On CPU, the LLVM backend distributes its
+  // iterations over ATen's intra-op thread pool; the caller is responsible for
+  // the iterations being independent.
+  void setParallel(For* f);
+
   // Insert a temporary computation of statement S in the scope of loop AT.
   // S is assumed to be a Store or a Block containing a Store. Along with the
   // computation itself, this transformation inserts Alloc/Free statements for
@@ -1,5 +1,16 @@
 #include <torch/csrc/jit/tensorexpr/mem_arena.h>
 
+#include <torch/csrc/jit/tensorexpr/hash_provider.h>
+#include <torch/csrc/jit/tensorexpr/ir.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
 namespace torch {
 namespace jit {
 namespace tensorexpr {
@@ -8,12 +19,259 @@ namespace {
 // Define in an anonymous namespace to hide this symbol from other compilation
 // units
 thread_local KernelArena* current_arena = nullptr;
+
+constexpr size_t kSlabSize = 64 * 1024;
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+size_t roundUp(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+bool isInternable(const Expr* e) {
+  if (e->isConstant()) {
+    return true;
+  }
+  switch (e->expr_type()) {
+    case kAdd:
+    case kSub:
+    case kMul:
+    case kDiv:
+    case kMod:
+    case kMax:
+    case kMin:
+    case kAnd:
+    case kOr:
+    case kLshift:
+    case kRshift:
+    case kXor:
+    case kCompareSelect:
+    case kCast:
+    case kBroadcast:
+    case kRamp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool equals(const Expr* a, const Expr* b);
+
+// Operands match if they are the same node, or if both are pure expressions
+// with the same structure. Leaves such as immediates are not interned when
+// they are created, so two copies of an expression rarely share operands.
+// Variables and other impure nodes only match themselves.
+bool operandEquals(const Expr* a, const Expr* b) {
+  if (a == b) {
+    return true;
+  }
+  return isInternable(a) && isInternable(b) && equals(a, b);
+}
+
+template <class Op>
+bool binaryOpEquals(const Expr* a, const Expr* b) {
+  auto x = static_cast<const Op*>(a);
+  auto y = static_cast<const Op*>(b);
+  return operandEquals(x->lhs(), y->lhs()) &&
+      operandEquals(x->rhs(), y->rhs());
+}
+
+template <class Op>
+bool minMaxEquals(const Expr* a, const Expr* b) {
+  return static_cast<const Op*>(a)->propagate_nans() ==
+      static_cast<const Op*>(b)->propagate_nans() &&
+      binaryOpEquals<Op>(a, b);
+}
+
+bool immediateEquals(const Expr* a, const Expr* b) {
+#define TYPE_CASE(Type, Name)                                 \
+  if (auto x = dynamic_cast<const Name##Imm*>(a)) {           \
+    auto y = dynamic_cast<const Name##Imm*>(b);               \
+    if (!y) {                                                 \
+      return false;                                           \
+    }                                                         \
+    /* Compare the bits, so that 0 and -0 differ. */          \
+    Type u = x->value();                                      \
+    Type v = y->value();                                      \
+    return std::memcmp(&u, &v, sizeof(Type)) == 0;            \
+  }
+  AT_FORALL_SCALAR_TYPES_AND2(Bool, Half, TYPE_CASE);
+#undef TYPE_CASE
+  return false;
+}
+
+// Whether two internable nodes are the same expression. Only called for
+// nodes with the same hash.
+bool equals(const Expr* a, const Expr* b) {
+  if (a->expr_type() != b->expr_type() || a->dtype() != b->dtype()) {
+    return false;
+  }
+  switch (a->expr_type()) {
+    case kPrimitive:
+      return immediateEquals(a, b);
+    case kAdd:
+      return binaryOpEquals<Add>(a, b);
+    case kSub:
+      return binaryOpEquals<Sub>(a, b);
+    case kMul:
+      return binaryOpEquals<Mul>(a, b);
+    case kDiv:
+      return binaryOpEquals<Div>(a, b);
+    case kMod:
+      return binaryOpEquals<Mod>(a, b);
+    case kMax:
+      return minMaxEquals<Max>(a, b);
+    case kMin:
+      return minMaxEquals<Min>(a, b);
+    case kAnd:
+      return binaryOpEquals<And>(a, b);
+    case kOr:
+      return binaryOpEquals<Or>(a, b);
+    case kLshift:
+      return binaryOpEquals<Lshift>(a, b);
+    case kRshift:
+      return binaryOpEquals<Rshift>(a, b);
+    case kXor:
+      return binaryOpEquals<Xor>(a, b);
+    case kCompareSelect: {
+      auto x = static_cast<const CompareSelect*>(a);
+      auto y = static_cast<const CompareSelect*>(b);
+      return x->compare_select_op() == y->compare_select_op() &&
+          operandEquals(x->lhs(), y->lhs()) &&
+          operandEquals(x->rhs(), y->rhs()) &&
+          operandEquals(x->ret_val1(), y->ret_val1()) &&
+          operandEquals(x->ret_val2(), y->ret_val2());
+    }
+    case kCast:
+      return operandEquals(
+          static_cast<const Cast*>(a)->src_value(),
+          static_cast<const Cast*>(b)->src_value());
+    case kBroadcast: {
+      auto x = static_cast<const Broadcast*>(a);
+      auto y = static_cast<const Broadcast*>(b);
+      return x->lanes() == y->lanes() && operandEquals(x->value(), y->value());
+    }
+    case kRamp: {
+      auto x = static_cast<const Ramp*>(a);
+      auto y = static_cast<const Ramp*>(b);
+      return x->lanes() == y->lanes() && operandEquals(x->base(), y->base()) &&
+          operandEquals(x->stride(), y->stride());
+    }
+    default:
+      return false;
+  }
+}
 } // namespace
 
+// The hash-consing table of an arena. The HashProvider memoizes the hash of
+// every node it has seen, so interning a node whose children are already
+// interned only hashes the node itself.
+class ExprInterner {
+ public:
+  const Expr* lookupOrInsert(const Expr* e) {
+    // The structural hash leaves out the dtype of most nodes, as it follows
+    // from their operands, but an interned node must match exactly.
+    SimplifierHashType h = hasher_.hash_combine(
+        hasher_.hash(e), (int)e->expr_type(), e->dtype());
+    // Different expressions can have the same hash, so the hash only finds
+    // the candidates.
+    auto& bucket = exprs_[h];
+    for (const Expr* candidate : bucket) {
+      if (equals(candidate, e)) {
+        return candidate;
+      }
+    }
+    bucket.push_back(e);
+    return e;
+  }
+
+  void forget(const Expr* e) {
+    hasher_.clearHash(e);
+  }
+
+ private:
+  HashProvider hasher_;
+  std::unordered_map<SimplifierHashType, std::vector<const Expr*>> exprs_;
+};
+
+KernelArena::KernelArena() {}
+
 KernelArena::~KernelArena() {
   for (KernelScopedObject* p : kernel_objects_) {
-    delete p;
+    p->~KernelScopedObject();
+  }
+  for (char* slab : slabs_) {
+    std::free(slab);
+  }
+}
+
+void* KernelArena::allocate(size_t size) {
+  size = roundUp(size);
+  if (size > kSlabSize / 4) {
+    // Large objects get a slab of their own, so that they do not waste the
+    // rest of the current one.
+    char* slab = static_cast<char*>(std::malloc(size));
+    if (!slab) {
+      throw std::bad_alloc();
+    }
+    slabs_.push_back(slab);
+    bytes_allocated_ += size;
+    last_alloc_ = nullptr;
+    return slab;
+  }
+  if (static_cast<size_t>(slab_end_ - slab_ptr_) < size) {
+    char* slab = static_cast<char*>(std::malloc(kSlabSize));
+    if (!slab) {
+      throw std::bad_alloc();
+    }
+    slabs_.push_back(slab);
+    bytes_allocated_ += kSlabSize;
+    slab_ptr_ = slab;
+    slab_end_ = slab + kSlabSize;
+  }
+  void* p = slab_ptr_;
+  slab_ptr_ += size;
+  last_alloc_ = p;
+  return p;
+}
+
+void KernelArena::forget(void* p) {
+  // Objects are nearly always deleted right after being created, when their
+  // constructor throws, so search from the back.
+  auto it = std::find_if(
+      kernel_objects_.rbegin(),
+      kernel_objects_.rend(),
+      [p](KernelScopedObject* o) { return static_cast<void*>(o) == p; });
+  if (it != kernel_objects_.rend()) {
+    kernel_objects_.erase(std::next(it).base());
+  }
+}
+
+void KernelArena::releaseIfLast(const KernelScopedObject* p) {
+  if (kernel_objects_.empty() || kernel_objects_.back() != p ||
+      last_alloc_ != static_cast<const void*>(p)) {
+    return;
   }
+  kernel_objects_.pop_back();
+  const_cast<KernelScopedObject*>(p)->~KernelScopedObject(); // NOLINT
+  slab_ptr_ = static_cast<char*>(last_alloc_);
+  last_alloc_ = nullptr;
+}
+
+const Expr* KernelArena::intern(const Expr* e) {
+  if (!isInternable(e)) {
+    return e;
+  }
+  if (!interner_) {
+    interner_.reset(new ExprInterner());
+  }
+  const Expr* canonical = interner_->lookupOrInsert(e);
+  if (canonical != e) {
+    num_interned_++;
+    // The memory of `e` may be reused, so its memoized hash must go too.
+    interner_->forget(e);
+    releaseIfLast(e);
+  }
+  return canonical;
 }
 
 KernelScopedObject::KernelScopedObject() {
@@ -21,6 +279,23 @@ KernelScopedObject::KernelScopedObject() {
   kernel->kernel_objects_.push_back(this);
 }
 
+void* KernelScopedObject::operator new(size_t size) {
+  KernelArena* kernel = KernelArena::GetCurrentKernelArena();
+  if (!kernel) {
+    throw std::runtime_error(
+        "Tensor expressions can only be created inside a KernelScope");
+  }
+  return kernel->allocate(size);
+}
+
+void KernelScopedObject::operator delete(void* p) {
+  // The memory belongs to the arena and is freed along with it.
+  KernelArena* kernel = KernelArena::GetCurrentKernelArena();
+  if (kernel) {
+    kernel->forget(p);
+  }
+}
+
 void KernelArena::SetCurrentKernelArena(KernelArena* new_kernel_arena) {
   current_arena = new_kernel_arena;
 }
@@ -1,28 +1,78 @@
 #pragma once
 #include <torch/csrc/WindowsTorchApiMacro.h>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace torch {
 namespace jit {
 namespace tensorexpr {
 
+class Expr;
+class ExprInterner;
 class KernelScopedObject;
 
 // An arena that manages all the underlying kernel-scoped objects.
-class KernelArena {
+//
+// Objects are bump-allocated from large slabs owned by the arena, so building
+// and transforming IR does not go through malloc for every node, and nodes
+// created together sit next to each other in memory. The arena runs the
+// destructors of its objects and frees the slabs when it is destroyed.
+class TORCH_API KernelArena {
  public:
   static KernelArena* GetCurrentKernelArena();
   static void SetCurrentKernelArena(KernelArena* new_arena);
-  TORCH_API KernelArena() {}
-  TORCH_API ~KernelArena();
+  KernelArena();
+  ~KernelArena();
+
+  // Hash-consing of immutable expressions: returns an expression of this
+  // arena structurally equal to `e` if there is one, and `e` otherwise, using
+  // HashProvider for the structural hash. If `e` was the last object allocated
+  // it is released when an equal expression is found, so `e` must not be used
+  // after this call; use the returned expression instead.
+  //
+  // Only pure expressions are interned (arithmetic, comparisons, casts,
+  // broadcasts, ramps and immediates); anything else is returned as is.
+  const Expr* intern(const Expr* e);
+
+  // Bytes of slab memory held by the arena.
+  size_t bytes_allocated() const {
+    return bytes_allocated_;
+  }
+
+  // Number of expressions intern() replaced by an existing one.
+  size_t num_interned() const {
+    return num_interned_;
+  }
 
  private:
   KernelArena(const KernelArena&) = delete;
   KernelArena& operator=(const KernelArena&) = delete;
   friend class KernelScopedObject;
+
+  void* allocate(size_t size);
+  // Removes an object destroyed outside of the arena from its object list.
+  void forget(void* p);
+  // Destroys `p` and returns its memory to the slab if it is the last object
+  // allocated.
+  void releaseIfLast(const KernelScopedObject* p);
+
   std::vector<KernelScopedObject*> kernel_objects_; // owned
+  std::vector<char*> slabs_; // owned
+  char* slab_ptr_ = nullptr;
+  char* slab_end_ = nullptr;
+  void* last_alloc_ = nullptr;
+  size_t bytes_allocated_ = 0;
+  size_t num_interned_ = 0;
+  std::unique_ptr<ExprInterner> interner_;
 };
 
+// Interns `e` in the current arena, see KernelArena::intern. Call it right
+// after creating `e`, before anything else holds on to it.
+inline const Expr* internExpr(const Expr* e) {
+  return KernelArena::GetCurrentKernelArena()->intern(e);
+}
+
 // A RAII convenience wrapper on top of a kernel.
 // It either creates or takes an existing Kernel and sets it as the current
 // Kernel. When this object is destroyed, the previous Kernel is set as current,
@@ -43,13 +93,18 @@ class KernelScope {
 };
 
 // The base object managed by the Kernel.
-// The object must be created through "new", and when the Kernel is destroyed,
-// All its registered objects are destroyed through "delete".
+// The object must be created through "new", which allocates it in the current
+// Kernel. When the Kernel is destroyed, all its registered objects are
+// destroyed. Deleting an object explicitly is allowed but does not free its
+// memory before the Kernel goes away.
 class TORCH_API KernelScopedObject {
  public:
   KernelScopedObject();
   virtual ~KernelScopedObject() = default;
 
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
+
  private:
   KernelScopedObject(const KernelScopedObject&) = delete;
   KernelScopedObject& operator=(const KernelScopedObject&) = delete;
@@ -20,6 +20,7 @@ from . import (
 )
 from . import ReduceOp
 from . import PrefixStore
+from . import ProcessGroupShm
 
 
 _MPI_AVAILABLE = True
@@ -45,8 +46,8 @@ except ImportError:
 
 class Backend(object):
     """
-    An enum-like class of available backends: GLOO, NCCL, MPI, and other registered
-    backends.
+    An enum-like class of available backends: GLOO, NCCL, MPI, SHM, and other
+    registered backends.
 
     The values of this class are lowercase strings, e.g., ``"gloo"``. They can
     be accessed as attributes, e.g., ``Backend.NCCL``.
@@ -64,6 +65,7 @@ class Backend(object):
     GLOO = "gloo"
     NCCL = "nccl"
     MPI = "mpi"
+    SHM = "shm"
     TCP = "tcp"
 
     def __new__(cls, name):
@@ -77,7 +79,7 @@ class Backend(object):
                              "on CPU tensors.")
         elif value == Backend.UNDEFINED:
             raise ValueError("Invalid backend: '{}'".format(name))
-        elif value != Backend.GLOO and value != Backend.NCCL and value != Backend.MPI:
+        elif value not in (Backend.GLOO, Backend.NCCL, Backend.MPI, Backend.SHM):
             value = name
         return value
 
@@ -346,7 +348,7 @@ def init_process_group(backend,
     Arguments:
         backend (str or Backend): The backend to use. Depending on
             build-time configurations, valid values include ``mpi``, ``gloo``,
-            and ``nccl``. This field should be given as a lowercase string
+            ``nccl``, and ``shm``. This field should be given as a lowercase string
             (e.g., ``"gloo"``), which can also be accessed via
             :class:`Backend` attributes (e.g., ``Backend.GLOO``). If using
             multiple processes per machine with ``nccl`` backend, each process
@@ -365,7 +367,7 @@ def init_process_group(backend,
                                 Mutually exclusive with ``init_method``.
         timeout (timedelta, optional): Timeout for operations executed against
             the process group. Default value equals 30 minutes.
-            This is applicable for the ``gloo`` backend. For ``nccl``, this is
+            This is applicable for the ``gloo`` and ``shm`` backends. For ``nccl``, this is
             applicable only if the environment variable ``NCCL_BLOCKING_WAIT``
             is set to 1.
         group_name (str, optional, deprecated): Group name.
@@ -514,6 +516,14 @@ def _new_process_group_helper(world_size,
                 timeout)
             _pg_map[pg] = (Backend.NCCL, store)
             _pg_names[pg] = group_name
+        elif backend == Backend.SHM:
+            pg = ProcessGroupShm(
+                prefix_store,
+                rank,
+                world_size,
+                timeout=timeout)
+            _pg_map[pg] = (Backend.SHM, store)
+            _pg_names[pg] = group_name
         else:
             pg = getattr(Backend, backend.upper())(
                 prefix_store,
@@ -1730,9 +1740,10 @@ def new_group(ranks=None, timeout=default_pg_timeout, backend=None):
         ranks (list[int]): List of ranks of group members.
         timeout (timedelta, optional): Timeout for operations executed against
             the process group. Default value equals 30 minutes.
-            This is only applicable for the ``gloo`` backend.
+            This is only applicable for the ``gloo`` and ``shm`` backends.
         backend (str or Backend, optional): The backend to use. Depending on
-            build-time configurations, valid values are ``gloo`` and ``nccl``.
+            build-time configurations, valid values are ``gloo``, ``nccl``,
+            and ``shm``.
             By default uses the same backend as the global group. This field
             should be given as a lowercase string (e.g., ``"gloo"``), which can
             also be accessed via :class:`Backend` attributes (e.g.,
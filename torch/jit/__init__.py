@@ -87,7 +87,7 @@ def optimized_execution(should_optimize):
 DEFAULT_EXTRA_FILES_MAP = torch._C.ExtraFilesMap()
 
 
-def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP, compression_level=0):
     """
         Save an offline version of this module for use in a separate process. The saved
         module serializes all of the methods, submodules, parameters, and attributes of this
@@ -106,6 +106,10 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             f: A file-like object (has to implement write and flush) or a string
                containing a file name.
             _extra_files: Map from filename to contents which will be stored as part of 'f'.
+            compression_level: If between 1 (fastest) and 10 (smallest), records of at
+               least 4 KiB, tensors included, are deflated at that level when it makes
+               them smaller. :func:`torch.jit.load <torch.jit.load>` decompresses them
+               in parallel. Records left uncompressed can still be loaded with ``mmap``.
 
         .. warning::
             If you are using Python 2, ``torch.jit.save`` does NOT support :any:`StringIO.StringIO`
@@ -142,12 +146,12 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             torch.jit.save(m, 'scriptmodule.pt', _extra_files=extra_files)
     """
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        m.save(f, _extra_files=_extra_files)
+        m.save(f, _extra_files=_extra_files, _compression_level=compression_level)
     else:
-        ret = m.save_to_buffer(_extra_files=_extra_files)
+        ret = m.save_to_buffer(_extra_files=_extra_files, _compression_level=compression_level)
         f.write(ret)
 
-def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP, mmap=False):
     r"""
         Load a :class:`ScriptModule` or :class:`ScriptFunction` previously
         saved with :func:`torch.jit.save <torch.jit.save>`
@@ -164,6 +168,11 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             _extra_files (dictionary of filename to content): The extra
                 filenames given in the map would be loaded and their content
                 would be stored in the provided map.
+            mmap (bool): If ``True``, ``f`` (which must be a file name) is
+                memory-mapped instead of read, and CPU tensors share its
+                pages copy-on-write. Loading is then nearly free and the
+                weights are only read from disk when used, but the file stays
+                mapped for as long as any of them is alive.
 
         Returns:
             A :class:`ScriptModule` object.
@@ -224,8 +233,10 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
 
     cu = torch._C.CompilationUnit()
     if isinstance(f, str) or isinstance(f, pathlib.Path):
-        cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files)
+        cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files, mmap)
     else:
+        if mmap:
+            raise ValueError("mmap=True requires f to be a file name")
         cpp_module = torch._C.import_ir_module_from_buffer(cu, f.read(), map_location, _extra_files)
 
     # TODO: Pretty sure this approach loses ConstSequential status and such
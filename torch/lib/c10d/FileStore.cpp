@@ -334,4 +334,46 @@ void FileStore::wait(
   }
 }
 
+void FileStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  // Appends all entries under a single lock of the file.
+  std::unique_lock<std::mutex> l(activeFileOpLock_);
+  File file(path_, O_RDWR | O_CREAT, timeout_);
+  auto lock = file.lockExclusive();
+  file.seek(0, SEEK_END);
+  for (size_t i = 0; i < keys.size(); i++) {
+    file.write(regularPrefix_ + keys[i]);
+    file.write(values[i]);
+  }
+}
+
+std::vector<uint8_t> FileStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expected,
+    const std::vector<uint8_t>& desired) {
+  std::string regKey = regularPrefix_ + key;
+  std::unique_lock<std::mutex> l(activeFileOpLock_);
+  File file(path_, O_RDWR | O_CREAT, timeout_);
+  auto lock = file.lockExclusive();
+  pos_ = refresh(file, pos_, cache_);
+
+  auto it = cache_.find(regKey);
+  const auto current =
+      it == cache_.end() ? std::vector<uint8_t>() : it->second;
+  if (current != expected) {
+    return current;
+  }
+  file.seek(0, SEEK_END);
+  file.write(regKey);
+  file.write(desired);
+  return desired;
+}
+
 } // namespace c10d
@@ -87,4 +87,41 @@ bool HashStore::check(const std::vector<std::string>& keys) {
   return true;
 }
 
+void HashStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  std::unique_lock<std::mutex> lock(m_);
+  for (size_t i = 0; i < keys.size(); i++) {
+    map_[keys[i]] = values[i];
+  }
+  cv_.notify_all();
+}
+
+std::vector<uint8_t> HashStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expected,
+    const std::vector<uint8_t>& desired) {
+  std::unique_lock<std::mutex> lock(m_);
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    if (!expected.empty()) {
+      return {};
+    }
+    map_[key] = desired;
+    cv_.notify_all();
+    return desired;
+  }
+  if (it->second == expected) {
+    it->second = desired;
+    cv_.notify_all();
+  }
+  return it->second;
+}
+
 } // namespace c10d
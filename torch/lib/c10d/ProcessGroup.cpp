@@ -3,6 +3,25 @@
 #include <c10/util/Logging.h>
 
 namespace c10d {
+namespace {
+
+void completeFuture(
+    const c10::intrusive_ptr<c10::ivalue::Future>& future,
+    const std::exception_ptr& exception) {
+  if (!exception) {
+    future->markCompleted();
+    return;
+  }
+  try {
+    std::rethrow_exception(exception);
+  } catch (const std::exception& e) {
+    future->setError(e.what());
+  } catch (...) {
+    future->setError("Work failed with an unknown exception.");
+  }
+}
+
+} // namespace
 
 ProcessGroup::Work::~Work() {}
 
@@ -48,12 +67,33 @@ void ProcessGroup::Work::abort() {
   TORCH_CHECK(false, "ProcessGroup::Work::abort not implemented.")
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroup::Work::getFuture() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (future_) {
+    return future_;
+  }
+  future_ = c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+  auto future = future_;
+  // If the work finished before the future was created, `finish` didn't
+  // see it, so complete it here.
+  if (completed_) {
+    auto exception = exception_;
+    lock.unlock();
+    completeFuture(future, exception);
+  }
+  return future;
+}
+
 void ProcessGroup::Work::finish(std::exception_ptr exception) {
   std::unique_lock<std::mutex> lock(mutex_);
   completed_ = true;
   exception_ = exception;
+  auto future = future_;
   lock.unlock();
   cv_.notify_all();
+  if (future) {
+    completeFuture(future, exception);
+  }
 }
 
 ProcessGroup::ProcessGroup(int rank, int size) : rank_(rank), size_(size) {
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
 
 #include <c10d/Types.hpp>
 
@@ -87,6 +88,17 @@ class ProcessGroup {
 
     virtual void abort();
 
+    // Returns a future that is completed, without a value, when this work
+    // completes, or that holds its error if it fails. Callbacks added to the
+    // future run on the thread that completes the work.
+    //
+    // The default implementation relies on the work completing through
+    // `finish`. Work objects that track completion differently must
+    // override this function, and throw if they have no way to complete a
+    // future (e.g. Gloo send/recv and MPI work, which only complete when
+    // waited on).
+    virtual c10::intrusive_ptr<c10::ivalue::Future> getFuture();
+
    protected:
     void finish(std::exception_ptr exception = nullptr);
 
@@ -94,6 +106,7 @@ class ProcessGroup {
     std::condition_variable cv_;
     bool completed_ = false;
     std::exception_ptr exception_;
+    c10::intrusive_ptr<c10::ivalue::Future> future_;
   };
 
   explicit ProcessGroup(int rank, int size);
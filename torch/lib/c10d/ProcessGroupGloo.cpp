@@ -7,6 +7,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -354,6 +356,12 @@ void ProcessGroupGloo::SendWork::abort() {
   buffer_->abortWaitSend();
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupGloo::SendWork::
+    getFuture() {
+  throw std::runtime_error(
+      "ProcessGroupGloo::SendWork::getFuture is not supported");
+}
+
 ProcessGroupGloo::RecvWork::RecvWork(
     at::Tensor& tensor,
     std::unique_ptr<::gloo::transport::UnboundBuffer> buffer)
@@ -387,8 +395,16 @@ void ProcessGroupGloo::RecvWork::abort() {
   buffer_->abortWaitRecv();
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupGloo::RecvWork::
+    getFuture() {
+  throw std::runtime_error(
+      "ProcessGroupGloo::RecvWork::getFuture is not supported");
+}
+
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      hierarchicalAllreduce(false) {}
 
 namespace {
 
@@ -533,6 +549,10 @@ ProcessGroupGloo::ProcessGroupGloo(
     contexts_.push_back(std::move(context));
   }
 
+  if (options.hierarchicalAllreduce) {
+    initializeHierarchy(store, options);
+  }
+
   // Every worker thread stores the AsyncWork object it's currently
   // working on in the workInProgress_ vector. It must have size equal
   // to the number of workers such that they can simply index into it
@@ -563,6 +583,87 @@ ProcessGroupGloo::~ProcessGroupGloo() {
   }
 }
 
+void ProcessGroupGloo::initializeHierarchy(
+    const std::shared_ptr<Store>& store,
+    Options& options) {
+  auto hostname = options.hostname;
+  if (hostname.empty()) {
+    std::array<char, 256> buffer{};
+    if (gethostname(buffer.data(), buffer.size() - 1) != 0) {
+      throw std::system_error(errno, std::system_category());
+    }
+    hostname = buffer.data();
+  }
+
+  // Every process publishes its host and reads those of the others, in a
+  // single request.
+  const std::string prefix = "hierarchy/";
+  store->set(
+      prefix + std::to_string(rank_),
+      std::vector<uint8_t>(hostname.begin(), hostname.end()));
+  std::vector<std::string> keys;
+  for (int i = 0; i < size_; i++) {
+    keys.push_back(prefix + std::to_string(i));
+  }
+  std::vector<std::string> hosts;
+  for (const auto& value : store->multiGet(keys)) {
+    hosts.emplace_back(value.begin(), value.end());
+  }
+
+  // Hosts are ordered by their lowest rank, and the processes on a host by
+  // their rank. Every process computes the same topology.
+  std::vector<std::string> hostOrder;
+  std::unordered_map<std::string, std::vector<int>> ranksByHost;
+  for (int i = 0; i < size_; i++) {
+    auto& ranks = ranksByHost[hosts[i]];
+    if (ranks.empty()) {
+      hostOrder.push_back(hosts[i]);
+    }
+    ranks.push_back(i);
+  }
+  const auto localSize = ranksByHost[hostOrder[0]].size();
+  for (const auto& host : hostOrder) {
+    if (ranksByHost[host].size() != localSize) {
+      TORCH_WARN(
+          "ProcessGroupGloo: hosts run different numbers of processes, ",
+          "falling back to the flat allreduce.");
+      return;
+    }
+  }
+  if (hostOrder.size() == 1 || localSize == 1) {
+    return;
+  }
+
+  const auto& localRanks = ranksByHost[hosts[rank_]];
+  const int localRank =
+      std::find(localRanks.begin(), localRanks.end(), rank_) -
+      localRanks.begin();
+  const int hostIndex =
+      std::find(hostOrder.begin(), hostOrder.end(), hosts[rank_]) -
+      hostOrder.begin();
+  for (size_t i = 0; i < options.devices.size(); i++) {
+    auto localContext = std::make_shared<::gloo::rendezvous::Context>(
+        localRank, static_cast<int>(localSize));
+    auto localStore = ::gloo::rendezvous::PrefixStore(
+        prefix + "local/" + std::to_string(hostIndex) + "/" +
+            std::to_string(i),
+        *store_);
+    localContext->setTimeout(options.timeout);
+    localContext->connectFullMesh(localStore, options.devices[i]);
+    localContexts_.push_back(std::move(localContext));
+
+    auto crossContext = std::make_shared<::gloo::rendezvous::Context>(
+        hostIndex, static_cast<int>(hostOrder.size()));
+    auto crossStore = ::gloo::rendezvous::PrefixStore(
+        prefix + "cross/" + std::to_string(localRank) + "/" +
+            std::to_string(i),
+        *store_);
+    crossContext->setTimeout(options.timeout);
+    crossContext->connectFullMesh(crossStore, options.devices[i]);
+    crossContexts_.push_back(std::move(crossContext));
+  }
+}
+
 uint32_t ProcessGroupGloo::nextTag() {
   return collectiveCounter_++;
 }
@@ -835,6 +936,94 @@ class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
   }
 };
 
+// Note [Hierarchical allreduce]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A flat allreduce sends every byte of the tensor over the network from
+// every process, even when several processes share a host. The
+// hierarchical allreduce splits the tensor into one chunk per process on
+// the host (local rank), and:
+//
+//  1. reduces every chunk onto the process that owns it, within the host;
+//  2. allreduces every chunk among the processes that own it on every host;
+//  3. allgathers the chunks within the host.
+//
+// Only step 2 goes over the network, and each process sends one chunk
+// instead of the whole tensor, so the traffic through the NICs of a host
+// is divided by the number of processes on it. Steps 1 and 3 use
+// connections between processes on the same host, which don't leave it.
+//
+// The hosts and the local ranks are discovered through the store when the
+// process group is created. It requires every host to run the same number
+// of processes, more than one host, and more than one process per host.
+// Otherwise, and for tensors with fewer elements than processes per host,
+// the flat allreduce is used.
+class AsyncHierarchicalAllreduceWork : public AsyncAllreduceWork {
+ public:
+  AsyncHierarchicalAllreduceWork(
+      const std::shared_ptr<gloo::Context>& localContext,
+      const std::shared_ptr<gloo::Context>& crossContext,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(crossContext, inputs, reduceOp, tag),
+        localContext(localContext) {}
+
+  std::shared_ptr<gloo::Context> localContext;
+
+  void run() override {
+    const auto& scalarType = inputs[0].scalar_type();
+    const auto fn = getFunction(scalarType, reduceOp);
+    auto flat = inputs[0].contiguous().view({-1});
+
+    // Combine the inputs of this process first.
+    for (size_t i = 1; i < inputs.size(); i++) {
+      auto input = inputs[i].contiguous();
+      fn(flat.data_ptr(), flat.data_ptr(), input.data_ptr(), flat.numel());
+    }
+
+    const auto localSize = localContext->size;
+    const auto localRank = localContext->rank;
+    std::vector<size_t> counts(localSize);
+    std::vector<at::Tensor> chunks;
+    int64_t offset = 0;
+    for (int i = 0; i < localSize; i++) {
+      counts[i] = flat.numel() / localSize + (i < flat.numel() % localSize);
+      chunks.push_back(flat.narrow(0, offset, counts[i]));
+      offset += counts[i];
+    }
+
+    // 1. Reduce every chunk onto its owner within the host.
+    for (int i = 0; i < localSize; i++) {
+      gloo::ReduceOptions opts(localContext);
+      opts.setRoot(i);
+      opts.setTag(tag);
+      opts.setReduceFunction(fn);
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, chunks[i]);
+      gloo::reduce(opts);
+    }
+
+    // 2. Allreduce the chunk owned by this process across hosts.
+    std::vector<at::Tensor> owned = {chunks[localRank]};
+    allreduce(owned);
+
+    // 3. Allgather the chunks within the host.
+    {
+      auto input = chunks[localRank].clone();
+      gloo::AllgathervOptions opts(localContext);
+      opts.setTag(tag);
+      GENERATE_ALL_TYPES(scalarType, setInput, opts, input);
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, flat, counts);
+      gloo::allgatherv(opts);
+    }
+
+    for (auto& tensor : inputs) {
+      if (tensor.data_ptr() != flat.data_ptr()) {
+        tensor.copy_(flat.view_as(tensor));
+      }
+    }
+  }
+};
+
 class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncSparseAllreduceWork(
@@ -1267,7 +1456,18 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   auto tag = nextTag();
   auto context = getContext(tag);
   if (device.type() == at::kCPU) {
-    if (layout == c10::kStrided) {
+    // See Note [Hierarchical allreduce].
+    const auto hierarchical = !localContexts_.empty() &&
+        inputs[0].numel() >= localContexts_[0]->size;
+    if (layout == c10::kStrided && hierarchical) {
+      const auto index = tag % localContexts_.size();
+      work = std::make_shared<AsyncHierarchicalAllreduceWork>(
+          localContexts_[index],
+          crossContexts_[index],
+          inputs,
+          opts.reduceOp,
+          tag);
+    } else if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceWork>(
           std::move(context), inputs, opts.reduceOp, tag);
     } else if (layout == c10::kSparse) {
@@ -100,6 +100,10 @@ class ProcessGroupGloo : public ProcessGroup {
 
     void abort() override;
 
+    // Point-to-point work completes only when waited on, so there is no
+    // thread that could complete a future.
+    c10::intrusive_ptr<c10::ivalue::Future> getFuture() override;
+
    protected:
     at::Tensor tensor_;
     std::unique_ptr<::gloo::transport::UnboundBuffer> buffer_;
@@ -117,6 +121,10 @@ class ProcessGroupGloo : public ProcessGroup {
 
     void abort() override;
 
+    // Point-to-point work completes only when waited on, so there is no
+    // thread that could complete a future.
+    c10::intrusive_ptr<c10::ivalue::Future> getFuture() override;
+
    protected:
     at::Tensor tensor_;
     std::unique_ptr<::gloo::transport::UnboundBuffer> buffer_;
@@ -129,6 +137,15 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Allreduce dense CPU tensors hierarchically, see Note [Hierarchical
+    // allreduce]. All processes in the group must use the same value.
+    bool hierarchicalAllreduce;
+
+    // Identifies the host of this process for the hierarchical allreduce.
+    // Processes that can reach each other without going through the network
+    // must use the same value. Defaults to the hostname.
+    std::string hostname;
   };
 
   // Helper functions to create a new device object.
@@ -245,6 +262,17 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // For the hierarchical allreduce, one context per device connecting the
+  // processes on this host (local), and one connecting the processes with
+  // the same local rank on every host (cross). Both are empty if the
+  // hierarchical allreduce is disabled, or if the topology doesn't allow it.
+  std::vector<std::shared_ptr<::gloo::Context>> localContexts_;
+  std::vector<std::shared_ptr<::gloo::Context>> crossContexts_;
+
+  // Discovers which processes share a host through the store and connects
+  // the hierarchical allreduce contexts.
+  void initializeHierarchy(const std::shared_ptr<Store>& store, Options& options);
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
@@ -228,6 +228,12 @@ void ProcessGroupMPI::AsyncWork::abort() {
   TORCH_CHECK(false, "ProcessGroupMPI::AsyncWork::abort not implemented.")
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupMPI::AsyncWork::
+    getFuture() {
+  throw std::runtime_error(
+      "ProcessGroupMPI::AsyncWork::getFuture is not supported");
+}
+
 void ProcessGroupMPI::AsyncWork::populateException() {
   std::array<char, MPI_MAX_ERROR_STRING> buf;
   int len = buf.size();
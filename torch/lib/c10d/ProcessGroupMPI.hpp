@@ -92,6 +92,10 @@ class ProcessGroupMPI : public ProcessGroup {
 
     void abort() override;
 
+    // An MPI request completes only when polled or waited on, so there is no
+    // thread that could complete a future.
+    c10::intrusive_ptr<c10::ivalue::Future> getFuture() override;
+
    protected:
     void populateException();
 
@@ -253,6 +253,14 @@ bool ProcessGroupNCCL::WorkNCCL::wait() {
   return true;
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ProcessGroupNCCL::WorkNCCL::
+    getFuture() {
+  synchronize();
+  auto future = c10::make_intrusive<c10::ivalue::Future>(c10::NoneType::get());
+  future->markCompleted();
+  return future;
+}
+
 void ProcessGroupNCCL::WorkNCCL::abort() {
   TORCH_CHECK(false, "ProcessGroupNCCL::WorkNCCL::abort not implemented.");
 }
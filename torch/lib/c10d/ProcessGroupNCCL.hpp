@@ -77,6 +77,11 @@ class ProcessGroupNCCL : public ProcessGroup {
     // completion.
     void synchronize() override;
 
+    // Same as calling synchronize(), after which the returned future is
+    // already completed: work queued on the current streams is sequenced
+    // after the NCCL work.
+    c10::intrusive_ptr<c10::ivalue::Future> getFuture() override;
+
     // Helper function that checks if the NCCL kernels have finished
     // execution on the GPUs
     bool finishedGPUExecution();
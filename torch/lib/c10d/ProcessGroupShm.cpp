@@ -0,0 +1,909 @@
+#include <c10d/ProcessGroupShm.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+
+namespace c10d {
+
+namespace {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Iterations a thread busy waits before it starts yielding.
+constexpr size_t kSpinCount = 1000;
+
+struct MessageHeader {
+  int64_t tag;
+  uint64_t bytes;
+};
+
+size_t roundUp(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+ProcessGroupShm::Options validateOptions(ProcessGroupShm::Options options) {
+  if (options.bufferSize == 0) {
+    throw std::invalid_argument(
+        "ProcessGroupShm: buffer size must be positive");
+  }
+  if (options.channelSize == 0) {
+    throw std::invalid_argument(
+        "ProcessGroupShm: channel size must be positive");
+  }
+  options.bufferSize = roundUp(options.bufferSize, kCacheLineSize);
+  options.channelSize = roundUp(options.channelSize, kCacheLineSize);
+  return options;
+}
+
+std::chrono::milliseconds getTimeout(
+    std::chrono::milliseconds timeout,
+    std::chrono::milliseconds defaultTimeout) {
+  return timeout == kUnsetTimeout ? defaultTimeout : timeout;
+}
+
+// Views `numel` elements of shared memory as a tensor like `like`.
+at::Tensor view(uint8_t* data, int64_t numel, const at::Tensor& like) {
+  return at::from_blob(data, {numel}, like.options());
+}
+
+void reduceInto(at::Tensor& result, const at::Tensor& other, ReduceOp op) {
+  switch (op) {
+    case ReduceOp::SUM:
+      result.add_(other);
+      break;
+    case ReduceOp::PRODUCT:
+      result.mul_(other);
+      break;
+    case ReduceOp::MIN:
+      at::min_out(result, result, other);
+      break;
+    case ReduceOp::MAX:
+      at::max_out(result, result, other);
+      break;
+    case ReduceOp::BAND:
+      at::bitwise_and_out(result, result, other);
+      break;
+    case ReduceOp::BOR:
+      at::bitwise_or_out(result, result, other);
+      break;
+    case ReduceOp::BXOR:
+      at::bitwise_xor_out(result, result, other);
+      break;
+    case ReduceOp::UNUSED:
+      break;
+  }
+}
+
+// Copies between a buffer and a ring buffer of `capacity` bytes, at the
+// given position of the stream that goes through it.
+void copyToRing(
+    uint8_t* ring,
+    size_t capacity,
+    uint64_t position,
+    const uint8_t* data,
+    size_t length) {
+  const auto offset = position % capacity;
+  const auto first = std::min(length, capacity - offset);
+  std::memcpy(ring + offset, data, first);
+  std::memcpy(ring, data + first, length - first);
+}
+
+void copyFromRing(
+    const uint8_t* ring,
+    size_t capacity,
+    uint64_t position,
+    uint8_t* data,
+    size_t length) {
+  const auto offset = position % capacity;
+  const auto first = std::min(length, capacity - offset);
+  std::memcpy(data, ring + offset, first);
+  std::memcpy(data + first, ring, length - first);
+}
+
+} // namespace
+
+// A POSIX shared memory segment, mapped into this process.
+class ProcessGroupShm::Segment {
+ public:
+  // Creates a segment with a unique name.
+  explicit Segment(size_t size) : size_(size), owner_(true) {
+    static std::atomic<uint64_t> counter(0);
+    std::random_device device;
+    int fd = -1;
+    for (;;) {
+      name_ = "/c10d_shm_" + std::to_string(getpid()) + "_" +
+          std::to_string(counter++) + "_" + std::to_string(device());
+      fd = shm_open(
+          name_.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+      if (fd != -1 || errno != EEXIST) {
+        break;
+      }
+    }
+    SYSCHECK_ERR_RETURN_NEG1(fd);
+    map(fd);
+  }
+
+  // Opens a segment created by another process.
+  Segment(const std::string& name, size_t size)
+      : name_(name), size_(size), owner_(false) {
+    int fd = -1;
+    SYSCHECK_ERR_RETURN_NEG1(fd = shm_open(name_.c_str(), O_RDWR, 0));
+    map(fd);
+  }
+
+  ~Segment() {
+    munmap(data_, size_);
+    unlink();
+  }
+
+  // Removes the name of the segment, if this process created it. The
+  // memory stays mapped.
+  void unlink() {
+    if (owner_) {
+      shm_unlink(name_.c_str());
+      owner_ = false;
+    }
+  }
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  uint8_t* data() const {
+    return data_;
+  }
+
+ private:
+  void map(int fd) {
+    if (owner_) {
+      auto rv = ftruncate(fd, size_);
+      if (rv == -1) {
+        auto error = errno;
+        ::close(fd);
+        shm_unlink(name_.c_str());
+        throw std::system_error(error, std::system_category());
+      }
+#ifndef __APPLE__
+      // ftruncate only sets the size of the segment; its pages are
+      // allocated on first touch, so a full /dev/shm would surface as a
+      // SIGBUS in the middle of a collective. Allocate them now instead.
+      rv = posix_fallocate(fd, 0, size_);
+      if (rv != 0) {
+        ::close(fd);
+        shm_unlink(name_.c_str());
+        throw std::runtime_error(
+            "ProcessGroupShm: unable to allocate " + std::to_string(size_) +
+            " bytes of shared memory for segment " + name_ + ": " +
+            std::strerror(rv) +
+            ". Every process needs bufferSize + worldSize * channelSize "
+            "bytes; make /dev/shm larger or reduce these options.");
+      }
+#endif
+    }
+    auto ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto error = errno;
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+      unlink();
+      throw std::system_error(error, std::system_category());
+    }
+    data_ = static_cast<uint8_t*>(ptr);
+  }
+
+  std::string name_;
+  size_t size_;
+  bool owner_;
+  uint8_t* data_ = nullptr;
+};
+
+// Barrier state, in the segment of rank 0. The last process to arrive
+// resets the count and bumps the generation, which the others wait for.
+struct ProcessGroupShm::Control {
+  alignas(kCacheLineSize) std::atomic<uint32_t> arrived{0};
+  alignas(kCacheLineSize) std::atomic<uint32_t> generation{0};
+};
+
+// Single producer, single consumer ring buffer, followed in shared memory
+// by its data. `head` and `tail` count the bytes written and read since
+// the start, so the buffer is full when they are `channelSize` apart.
+struct ProcessGroupShm::Channel {
+  alignas(kCacheLineSize) std::atomic<uint64_t> head{0};
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail{0};
+
+  uint8_t* data() {
+    return reinterpret_cast<uint8_t*>(this) + sizeof(Channel);
+  }
+};
+
+// A send or recv in progress. On the wire, a message is its header
+// followed by the contents of the tensor.
+struct ProcessGroupShm::Message {
+  std::shared_ptr<WorkShm> work;
+  bool isSend;
+  int peer;
+  int tag;
+  // Contiguous tensor the contents are read from or written to.
+  at::Tensor tensor;
+  // Tensor to copy the contents to once received, if not `tensor`.
+  at::Tensor output;
+  MessageHeader header;
+  // Bytes of the message, header included, moved so far.
+  size_t offset = 0;
+  std::string error;
+
+  bool done() const {
+    return offset >= sizeof(MessageHeader) &&
+        offset == sizeof(MessageHeader) + header.bytes;
+  }
+};
+
+ProcessGroupShm::Options::Options()
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      bufferSize(1 << 20),
+      channelSize(1 << 18) {}
+
+ProcessGroupShm::ProcessGroupShm(
+    const std::shared_ptr<Store>& store,
+    int rank,
+    int size,
+    Options options)
+    : ProcessGroup(rank, size),
+      options_(validateOptions(options)),
+      control_(nullptr),
+      stop_(false),
+      p2pStop_(false),
+      sends_(size),
+      recvs_(size) {
+  const auto segmentSize = sizeof(Control) + options_.bufferSize +
+      size_ * (sizeof(Channel) + options_.channelSize);
+
+  // Create the segment of this process and initialize it before any other
+  // process can find it.
+  segments_.resize(size_);
+  segments_[rank_] = std::unique_ptr<Segment>(new Segment(segmentSize));
+  new (segments_[rank_]->data()) Control();
+  for (int i = 0; i < size_; i++) {
+    new (&channel(i, rank_)) Channel();
+  }
+  const auto& name = segments_[rank_]->name();
+  store->set(
+      "shm/" + std::to_string(rank_),
+      std::vector<uint8_t>(name.begin(), name.end()));
+
+  std::vector<std::string> names;
+  for (int i = 0; i < size_; i++) {
+    names.push_back("shm/" + std::to_string(i));
+  }
+  const auto values = store->multiGet(names);
+  for (int i = 0; i < size_; i++) {
+    if (i == rank_) {
+      continue;
+    }
+    segments_[i] = std::unique_ptr<Segment>(new Segment(
+        std::string(values[i].begin(), values[i].end()), segmentSize));
+  }
+
+  // Once every process has mapped every segment, the names aren't needed
+  // anymore. Removing them now means the memory is freed when the last
+  // process exits, however it exits.
+  std::vector<std::string> keys;
+  store->set("shm/mapped/" + std::to_string(rank_), {1});
+  for (int i = 0; i < size_; i++) {
+    keys.push_back("shm/mapped/" + std::to_string(i));
+  }
+  store->wait(keys);
+  segments_[rank_]->unlink();
+
+  control_ = reinterpret_cast<Control*>(segments_[0]->data());
+  workerThread_ = std::thread(&ProcessGroupShm::runLoop, this);
+  p2pThread_ = std::thread(&ProcessGroupShm::runP2PLoop, this);
+}
+
+ProcessGroupShm::~ProcessGroupShm() {
+  std::unique_lock<std::mutex> lock(queueMutex_);
+  queueConsumeCV_.wait(lock, [&] { return queue_.empty(); });
+  stop_ = true;
+  lock.unlock();
+  queueProduceCV_.notify_all();
+  workerThread_.join();
+
+  std::unique_lock<std::mutex> p2pLock(p2pMutex_);
+  p2pStop_ = true;
+  p2pLock.unlock();
+  p2pCV_.notify_all();
+  p2pThread_.join();
+
+  // Sends and receives that never completed fail.
+  for (auto* messages : {&sends_, &recvs_}) {
+    for (auto& queue : *messages) {
+      for (auto& message : queue) {
+        message->work->finish(std::make_exception_ptr(std::runtime_error(
+            "ProcessGroupShm destroyed with pending send or recv")));
+      }
+    }
+  }
+}
+
+uint8_t* ProcessGroupShm::buffer(int rank) {
+  return segments_[rank]->data() + sizeof(Control);
+}
+
+ProcessGroupShm::Channel& ProcessGroupShm::channel(int srcRank, int dstRank) {
+  auto data = segments_[dstRank]->data() + sizeof(Control) +
+      options_.bufferSize +
+      srcRank * (sizeof(Channel) + options_.channelSize);
+  return *reinterpret_cast<Channel*>(data);
+}
+
+void ProcessGroupShm::sharedBarrier(Deadline deadline) {
+  const auto generation = control_->generation.load(std::memory_order_acquire);
+  if (control_->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<uint32_t>(size_)) {
+    control_->arrived.store(0, std::memory_order_relaxed);
+    control_->generation.fetch_add(1, std::memory_order_acq_rel);
+    return;
+  }
+  for (size_t i = 0;
+       control_->generation.load(std::memory_order_acquire) == generation;
+       i++) {
+    if (i < kSpinCount) {
+      continue;
+    }
+    std::this_thread::yield();
+    if (i % kSpinCount == 0 && std::chrono::steady_clock::now() > deadline) {
+      throw std::runtime_error(
+          "ProcessGroupShm: timed out waiting for other processes");
+    }
+  }
+}
+
+void ProcessGroupShm::runLoop() {
+  std::unique_lock<std::mutex> lock(queueMutex_);
+
+  while (!stop_) {
+    if (queue_.empty()) {
+      queueProduceCV_.wait(lock);
+      continue;
+    }
+
+    auto entry = std::move(queue_.front());
+    queue_.pop_front();
+
+    lock.unlock();
+    queueConsumeCV_.notify_one();
+
+    try {
+      entry.first();
+      entry.second->finish();
+    } catch (...) {
+      entry.second->finish(std::current_exception());
+    }
+
+    lock.lock();
+  }
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::enqueue(
+    std::function<void(Deadline)> fn,
+    std::chrono::milliseconds timeout) {
+  auto work = std::make_shared<WorkShm>();
+  // The timeout starts when the collective does, not when it is queued.
+  auto run = [fn, timeout]() {
+    fn(std::chrono::steady_clock::now() + timeout);
+  };
+  std::unique_lock<std::mutex> lock(queueMutex_);
+  queue_.emplace_back(std::move(run), work);
+  lock.unlock();
+  queueProduceCV_.notify_one();
+  return work;
+}
+
+void ProcessGroupShm::runReduce(
+    at::Tensor tensor,
+    ReduceOp op,
+    int root,
+    Deadline deadline) {
+  auto flat = tensor.contiguous().view({-1});
+  auto data = static_cast<uint8_t*>(flat.data_ptr());
+  const auto numel = flat.numel();
+  const auto elementSize = flat.element_size();
+  const int64_t chunkSize = options_.bufferSize / elementSize;
+  const auto output = root < 0 || root == rank_;
+
+  for (int64_t offset = 0; offset < numel; offset += chunkSize) {
+    const auto length = std::min(chunkSize, numel - offset);
+    std::memcpy(
+        buffer(rank_), data + offset * elementSize, length * elementSize);
+    sharedBarrier(deadline);
+
+    // Every process reduces its slice of the chunk, from the buffers of
+    // all processes into the buffer of rank 0.
+    const auto begin = length * rank_ / size_;
+    const auto end = length * (rank_ + 1) / size_;
+    if (end > begin) {
+      auto result = view(buffer(0) + begin * elementSize, end - begin, flat);
+      for (int i = 1; i < size_; i++) {
+        reduceInto(
+            result,
+            view(buffer(i) + begin * elementSize, end - begin, flat),
+            op);
+      }
+    }
+    sharedBarrier(deadline);
+
+    if (output) {
+      std::memcpy(
+          data + offset * elementSize, buffer(0), length * elementSize);
+    }
+    // The buffers are reused by the next chunk.
+    sharedBarrier(deadline);
+  }
+
+  if (output && flat.data_ptr() != tensor.data_ptr()) {
+    tensor.copy_(flat.view_as(tensor));
+  }
+}
+
+void ProcessGroupShm::runBroadcast(
+    at::Tensor tensor,
+    int root,
+    Deadline deadline) {
+  auto flat = tensor.contiguous();
+  auto data = static_cast<uint8_t*>(flat.data_ptr());
+  const size_t bytes = flat.numel() * flat.element_size();
+
+  for (size_t offset = 0; offset < bytes; offset += options_.bufferSize) {
+    const auto length = std::min(options_.bufferSize, bytes - offset);
+    if (rank_ == root) {
+      std::memcpy(buffer(root), data + offset, length);
+    }
+    sharedBarrier(deadline);
+    if (rank_ != root) {
+      std::memcpy(data + offset, buffer(root), length);
+    }
+    sharedBarrier(deadline);
+  }
+
+  if (rank_ != root && flat.data_ptr() != tensor.data_ptr()) {
+    tensor.copy_(flat);
+  }
+}
+
+void ProcessGroupShm::runAllgather(
+    std::vector<at::Tensor> outputs,
+    at::Tensor input,
+    Deadline deadline) {
+  auto flatInput = input.contiguous();
+  auto inputData = static_cast<uint8_t*>(flatInput.data_ptr());
+  const size_t bytes = flatInput.numel() * flatInput.element_size();
+  std::vector<at::Tensor> flatOutputs;
+  for (const auto& output : outputs) {
+    flatOutputs.push_back(output.contiguous());
+  }
+
+  for (size_t offset = 0; offset < bytes; offset += options_.bufferSize) {
+    const auto length = std::min(options_.bufferSize, bytes - offset);
+    std::memcpy(buffer(rank_), inputData + offset, length);
+    sharedBarrier(deadline);
+    for (int i = 0; i < size_; i++) {
+      auto outputData = static_cast<uint8_t*>(flatOutputs[i].data_ptr());
+      std::memcpy(outputData + offset, buffer(i), length);
+    }
+    sharedBarrier(deadline);
+  }
+
+  for (size_t i = 0; i < outputs.size(); i++) {
+    if (flatOutputs[i].data_ptr() != outputs[i].data_ptr()) {
+      outputs[i].copy_(flatOutputs[i]);
+    }
+  }
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::broadcast: " + msg);
+  };
+
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+  assertRootTensor(invalidArgument, opts.rootTensor, tensors.size());
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+
+  auto tensor = tensors[0];
+  const auto root = opts.rootRank;
+  return enqueue(
+      [this, tensor, root](Deadline deadline) {
+        runBroadcast(tensor, root, deadline);
+      },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::allreduce: " + msg);
+  };
+
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  if (opts.reduceOp == ReduceOp::UNUSED) {
+    invalidArgument("unsupported reduce operation");
+  }
+
+  auto tensor = tensors[0];
+  const auto op = opts.reduceOp;
+  return enqueue(
+      [this, tensor, op](Deadline deadline) {
+        runReduce(tensor, op, -1, deadline);
+      },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::allreduce_coalesced(
+    std::vector<at::Tensor>& /* unused */,
+    const AllreduceCoalescedOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupShm does not support allreduce_coalesced");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::reduce(
+    std::vector<at::Tensor>& tensors,
+    const ReduceOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::reduce: " + msg);
+  };
+
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+  assertRootTensor(invalidArgument, opts.rootTensor, tensors.size());
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  if (opts.reduceOp == ReduceOp::UNUSED) {
+    invalidArgument("unsupported reduce operation");
+  }
+
+  auto tensor = tensors[0];
+  const auto op = opts.reduceOp;
+  const auto root = opts.rootRank;
+  return enqueue(
+      [this, tensor, op, root](Deadline deadline) {
+        runReduce(tensor, op, root, deadline);
+      },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::allgather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const AllgatherOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::allgather: " + msg);
+  };
+
+  assertSingleElementInput(invalidArgument, inputs);
+  assertDense(invalidArgument, inputs);
+  assertCPU(invalidArgument, inputs);
+  if (outputs.size() != 1) {
+    invalidArgument("requires a single-element output list");
+  }
+  if (outputs[0].size() != static_cast<size_t>(size_)) {
+    invalidArgument(
+        "invalid output tensor list at index 0 (expected length " +
+        std::to_string(size_) + ", got " +
+        std::to_string(outputs[0].size()) + ")");
+  }
+  assertTypeAndSizesMatch(
+      invalidArgument, outputs[0], inputs[0].options(), inputs[0].sizes());
+
+  auto output = outputs[0];
+  auto input = inputs[0];
+  return enqueue(
+      [this, output, input](Deadline deadline) {
+        runAllgather(output, input, deadline);
+      },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::allgather_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::allgather_base: " + msg);
+  };
+
+  assertDense(invalidArgument, {outputBuffer, inputBuffer});
+  assertCPU(invalidArgument, {outputBuffer, inputBuffer});
+  if (outputBuffer.scalar_type() != inputBuffer.scalar_type()) {
+    invalidArgument("output and input must have the same type");
+  }
+  if (!outputBuffer.is_contiguous()) {
+    invalidArgument("output must be contiguous");
+  }
+  if (outputBuffer.numel() != inputBuffer.numel() * size_) {
+    invalidArgument("output must be world size times larger than input");
+  }
+
+  // Every process writes to its slice of the output.
+  std::vector<at::Tensor> outputs;
+  auto flat = outputBuffer.view({-1});
+  for (int i = 0; i < size_; i++) {
+    outputs.push_back(
+        flat.narrow(0, i * inputBuffer.numel(), inputBuffer.numel()));
+  }
+  auto input = inputBuffer;
+  return enqueue(
+      [this, outputs, input](Deadline deadline) {
+        runAllgather(outputs, input, deadline);
+      },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::gather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const GatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupShm does not support gather");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ScatterOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupShm does not support scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::reduce_scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ReduceScatterOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupShm does not support reduce_scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::barrier(
+    const BarrierOptions& opts) {
+  return enqueue(
+      [this](Deadline deadline) { sharedBarrier(deadline); },
+      getTimeout(opts.timeout, options_.timeout));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::send(
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
+    int tag) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::send: " + msg);
+  };
+
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  if (dstRank < 0 || dstRank >= size_) {
+    invalidArgument("invalid destination rank: " + std::to_string(dstRank));
+  }
+
+  auto message = std::unique_ptr<Message>(new Message());
+  message->work = std::make_shared<WorkShm>();
+  message->isSend = true;
+  message->peer = dstRank;
+  message->tag = tag;
+  message->tensor = tensors[0].contiguous();
+  message->header.tag = tag;
+  message->header.bytes =
+      message->tensor.numel() * message->tensor.element_size();
+  auto work = message->work;
+
+  std::unique_lock<std::mutex> lock(p2pMutex_);
+  sends_[dstRank].push_back(std::move(message));
+  lock.unlock();
+  p2pCV_.notify_one();
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::recv(
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
+    int tag) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupShm::recv: " + msg);
+  };
+
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  if (srcRank < 0 || srcRank >= size_) {
+    invalidArgument("invalid source rank: " + std::to_string(srcRank));
+  }
+
+  auto message = std::unique_ptr<Message>(new Message());
+  message->work = std::make_shared<RecvWork>(srcRank);
+  message->isSend = false;
+  message->peer = srcRank;
+  message->tag = tag;
+  message->tensor = tensors[0].contiguous();
+  if (message->tensor.data_ptr() != tensors[0].data_ptr()) {
+    message->output = tensors[0];
+  }
+  auto work = message->work;
+
+  std::unique_lock<std::mutex> lock(p2pMutex_);
+  recvs_[srcRank].push_back(std::move(message));
+  lock.unlock();
+  p2pCV_.notify_one();
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupShm::recvAnysource(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupShm does not support recvAnysource");
+}
+
+bool ProcessGroupShm::progressSend(Message& message) {
+  auto& channel = this->channel(rank_, message.peer);
+  const auto capacity = options_.channelSize;
+  const auto head = channel.head.load(std::memory_order_relaxed);
+  const auto tail = channel.tail.load(std::memory_order_acquire);
+  auto space = capacity - (head - tail);
+  size_t written = 0;
+
+  while (space > 0 && !message.done()) {
+    const uint8_t* data;
+    size_t length;
+    if (message.offset < sizeof(MessageHeader)) {
+      data = reinterpret_cast<const uint8_t*>(&message.header) + message.offset;
+      length = sizeof(MessageHeader) - message.offset;
+    } else {
+      const auto offset = message.offset - sizeof(MessageHeader);
+      data = static_cast<const uint8_t*>(message.tensor.data_ptr()) + offset;
+      length = message.header.bytes - offset;
+    }
+    length = std::min(length, space);
+    copyToRing(channel.data(), capacity, head + written, data, length);
+    message.offset += length;
+    written += length;
+    space -= length;
+  }
+
+  channel.head.store(head + written, std::memory_order_release);
+  return written > 0;
+}
+
+bool ProcessGroupShm::progressRecv(Message& message) {
+  auto& channel = this->channel(message.peer, rank_);
+  const auto capacity = options_.channelSize;
+  const auto head = channel.head.load(std::memory_order_acquire);
+  const auto tail = channel.tail.load(std::memory_order_relaxed);
+  auto available = head - tail;
+  size_t read = 0;
+
+  while (available > 0 && !message.done()) {
+    size_t length;
+    if (message.offset < sizeof(MessageHeader)) {
+      length = std::min(sizeof(MessageHeader) - message.offset, available);
+      copyFromRing(
+          channel.data(),
+          capacity,
+          tail + read,
+          reinterpret_cast<uint8_t*>(&message.header) + message.offset,
+          length);
+    } else {
+      const auto offset = message.offset - sizeof(MessageHeader);
+      length = std::min(message.header.bytes - offset, available);
+      // The contents of a message that doesn't match are skipped, so that
+      // the next one can still be received.
+      if (message.error.empty()) {
+        copyFromRing(
+            channel.data(),
+            capacity,
+            tail + read,
+            static_cast<uint8_t*>(message.tensor.data_ptr()) + offset,
+            length);
+      }
+    }
+    message.offset += length;
+    read += length;
+    available -= length;
+
+    if (message.offset == sizeof(MessageHeader)) {
+      const uint64_t expected =
+          message.tensor.numel() * message.tensor.element_size();
+      if (message.header.tag != message.tag) {
+        message.error = "ProcessGroupShm::recv: expected tag " +
+            std::to_string(message.tag) + " from rank " +
+            std::to_string(message.peer) + ", got " +
+            std::to_string(message.header.tag);
+      } else if (message.header.bytes != expected) {
+        message.error = "ProcessGroupShm::recv: expected " +
+            std::to_string(expected) + " bytes from rank " +
+            std::to_string(message.peer) + ", got " +
+            std::to_string(message.header.bytes);
+      }
+    }
+  }
+
+  channel.tail.store(tail + read, std::memory_order_release);
+  return read > 0;
+}
+
+void ProcessGroupShm::runP2PLoop() {
+  std::unique_lock<std::mutex> lock(p2pMutex_);
+  std::vector<Message*> active;
+  size_t idle = 0;
+
+  while (!p2pStop_) {
+    // Only this thread removes messages, so the oldest one of every peer
+    // can be progressed without holding the lock.
+    active.clear();
+    for (int i = 0; i < size_; i++) {
+      if (!sends_[i].empty()) {
+        active.push_back(sends_[i].front().get());
+      }
+      if (!recvs_[i].empty()) {
+        active.push_back(recvs_[i].front().get());
+      }
+    }
+    if (active.empty()) {
+      p2pCV_.wait(lock);
+      continue;
+    }
+    lock.unlock();
+
+    bool progressed = false;
+    for (auto* message : active) {
+      progressed |= message->isSend ? progressSend(*message)
+                                    : progressRecv(*message);
+    }
+
+    lock.lock();
+    for (auto* queues : {&sends_, &recvs_}) {
+      for (auto& queue : *queues) {
+        if (queue.empty() || !queue.front()->done()) {
+          continue;
+        }
+        auto message = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        if (!message->error.empty()) {
+          message->work->finish(
+              std::make_exception_ptr(std::runtime_error(message->error)));
+        } else {
+          try {
+            if (message->output.defined()) {
+              message->output.copy_(message->tensor);
+            }
+            message->work->finish();
+          } catch (...) {
+            message->work->finish(std::current_exception());
+          }
+        }
+        lock.lock();
+      }
+    }
+
+    // Back off when the peers aren't keeping up, to not burn a core while
+    // waiting for a message that may take long to arrive.
+    idle = progressed ? 0 : idle + 1;
+    if (idle > 2 * kSpinCount) {
+      p2pCV_.wait_for(lock, std::chrono::microseconds(100));
+    } else if (idle > kSpinCount) {
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+    }
+  }
+}
+
+} // namespace c10d
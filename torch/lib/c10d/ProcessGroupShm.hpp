@@ -0,0 +1,213 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+#include <c10d/Store.hpp>
+#include <c10d/Types.hpp>
+#include <c10d/Utils.hpp>
+
+namespace c10d {
+
+// ProcessGroupShm implements c10d bindings for processes that run on the
+// same host, through POSIX shared memory instead of sockets.
+//
+// Every process creates a shared memory segment and maps the segments of
+// all other processes, which it finds through the store. A segment holds:
+//
+//  - a buffer of `Options::bufferSize` bytes, where the process puts its
+//    part of a collective. Larger tensors are processed in chunks of this
+//    size. The processes synchronize through a barrier in the segment of
+//    rank 0;
+//  - one ring buffer of `Options::channelSize` bytes per process, that
+//    the process writes messages to the owner of the segment into.
+//
+// This is not a zero-copy or single-copy transport: tensors live in private
+// memory, so every message or chunk of a collective is copied twice, into
+// shared memory by the sender and out of it by the receivers. Contiguous
+// tensors are copied straight between their storage and shared memory,
+// without further staging buffers.
+//
+// The segments are allocated in full when they are created, and there are
+// `size * size` channels in total, so the group needs about
+// `size * (bufferSize + size * channelSize)` bytes of /dev/shm. Creating the
+// group fails if they can't be allocated.
+//
+// The segments are unlinked as soon as all processes have mapped them, so
+// nothing is left behind in /dev/shm when processes exit, even abnormally.
+//
+// Like the other process groups, collectives must be called in the same
+// order on all processes. They run one at a time on a worker thread. Sends
+// and receives run on a separate thread and are matched in order between
+// every pair of processes; their tags must match. If a collective times
+// out, the group is left in an undefined state and must not be used
+// anymore.
+//
+// Only CPU tensors are supported, and only a single tensor per call.
+class ProcessGroupShm : public ProcessGroup {
+ public:
+  class WorkShm : public ProcessGroup::Work {
+   protected:
+    friend class ProcessGroupShm;
+  };
+
+  class RecvWork : public WorkShm {
+   public:
+    explicit RecvWork(int srcRank) : srcRank_(srcRank) {}
+
+    int sourceRank() const override {
+      return srcRank_;
+    }
+
+   protected:
+    const int srcRank_;
+  };
+
+  struct Options {
+    explicit Options();
+
+    std::chrono::milliseconds timeout;
+
+    // Bytes of shared memory each process contributes to a collective at
+    // a time.
+    size_t bufferSize;
+
+    // Bytes of the ring buffer between every pair of processes, used by
+    // send and recv. Larger messages are streamed through it.
+    size_t channelSize;
+  };
+
+  ProcessGroupShm(
+      const std::shared_ptr<Store>& store,
+      int rank,
+      int size,
+      Options options = Options());
+
+  virtual ~ProcessGroupShm();
+
+  std::shared_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ protected:
+  class Segment;
+  struct Control;
+  struct Channel;
+  struct Message;
+
+  using Deadline = std::chrono::steady_clock::time_point;
+
+  // Runs `fn` on the worker thread, in the order collectives are called.
+  std::shared_ptr<ProcessGroup::Work> enqueue(
+      std::function<void(Deadline)> fn,
+      std::chrono::milliseconds timeout);
+
+  void runLoop();
+  void runP2PLoop();
+
+  // Collectives, run on the worker thread. `runReduce` reduces into the
+  // tensor of `root`, or of all processes if `root` is negative.
+  void runReduce(at::Tensor tensor, ReduceOp op, int root, Deadline deadline);
+  void runBroadcast(at::Tensor tensor, int root, Deadline deadline);
+  void runAllgather(
+      std::vector<at::Tensor> outputs,
+      at::Tensor input,
+      Deadline deadline);
+
+  // Moves as many bytes of the message as the channel allows. Returns true
+  // if it moved any.
+  bool progressSend(Message& message);
+  bool progressRecv(Message& message);
+
+  // Waits until all processes have called it.
+  void sharedBarrier(Deadline deadline);
+
+  uint8_t* buffer(int rank);
+  Channel& channel(int srcRank, int dstRank);
+
+  const Options options_;
+
+  std::vector<std::unique_ptr<Segment>> segments_;
+  Control* control_;
+
+  bool stop_;
+
+  std::mutex queueMutex_;
+  std::condition_variable queueProduceCV_;
+  std::condition_variable queueConsumeCV_;
+  std::deque<std::pair<std::function<void()>, std::shared_ptr<WorkShm>>>
+      queue_;
+  std::thread workerThread_;
+
+  // Sends and receives in progress, in order, per peer.
+  std::mutex p2pMutex_;
+  std::condition_variable p2pCV_;
+  bool p2pStop_;
+  std::vector<std::deque<std::unique_ptr<Message>>> sends_;
+  std::vector<std::deque<std::unique_ptr<Message>>> recvs_;
+  std::thread p2pThread_;
+};
+
+} // namespace c10d
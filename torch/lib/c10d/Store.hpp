@@ -38,6 +38,24 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched versions of get and set, which stores can implement with a
+  // single round trip. The defaults call get and set for every key.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Atomically sets the value of `key` to `desired` if it currently is
+  // `expected`, where a missing key compares equal to an empty value.
+  // Returns the value of the key after the call, which is `desired` if and
+  // only if the exchange happened (or `desired` was already there).
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expected,
+      const std::vector<uint8_t>& desired);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
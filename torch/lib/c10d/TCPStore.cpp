@@ -1,47 +1,362 @@
 #include <c10d/TCPStore.hpp>
 
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <system_error>
 
 namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_GET,
+  MULTI_SET,
+  COMPARE_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+constexpr size_t kNumShards = 64;
+constexpr size_t kMaxDefaultThreads = 4;
+
+// Waits for sockets to become readable, with epoll where it is available.
+// Closed sockets count as readable.
+class Poller {
+ public:
+  Poller();
+  ~Poller();
+
+  void add(int fd);
+  void remove(int fd);
+
+  // Blocks until some of the sockets are readable and returns them.
+  std::vector<int> wait();
+
+ private:
+#ifdef __linux__
+  int epollFd_;
+#else
+  std::vector<struct pollfd> fds_;
+#endif
+};
+
+#ifdef __linux__
+
+Poller::Poller() {
+  SYSCHECK_ERR_RETURN_NEG1(epollFd_ = ::epoll_create1(EPOLL_CLOEXEC));
+}
+
+Poller::~Poller() {
+  ::close(epollFd_);
+}
+
+void Poller::add(int fd) {
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event));
+}
+
+void Poller::remove(int fd) {
+  struct epoll_event event = {};
+  SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, &event));
+}
+
+std::vector<int> Poller::wait() {
+  std::array<struct epoll_event, 64> events;
+  int count;
+  SYSCHECK_ERR_RETURN_NEG1(
+      count = ::epoll_wait(epollFd_, events.data(), events.size(), -1));
+  std::vector<int> fds(count);
+  for (int i = 0; i < count; i++) {
+    fds[i] = events[i].data.fd;
+  }
+  return fds;
+}
+
+#else
+
+Poller::Poller() {}
+
+Poller::~Poller() {}
+
+void Poller::add(int fd) {
+  fds_.push_back({.fd = fd, .events = POLLIN});
+}
+
+void Poller::remove(int fd) {
+  fds_.erase(
+      std::remove_if(
+          fds_.begin(),
+          fds_.end(),
+          [fd](const struct pollfd& pfd) { return pfd.fd == fd; }),
+      fds_.end());
+}
+
+std::vector<int> Poller::wait() {
+  for (auto& pfd : fds_) {
+    pfd.revents = 0;
+  }
+  SYSCHECK_ERR_RETURN_NEG1(::poll(fds_.data(), fds_.size(), -1));
+  std::vector<int> fds;
+  for (const auto& pfd : fds_) {
+    if (pfd.revents != 0) {
+      fds.push_back(pfd.fd);
+    }
+  }
+  return fds;
+}
+
+#endif
+
 } // anonymous namespace
 
+// A connection to the daemon. Only the worker thread that owns the
+// connection reads from it, but any worker thread may write to it, to wake
+// it up when a key it waits on is set. Writes happen under the mutex, and
+// stop once the connection is closed, since its socket number may then be
+// reused by a new connection.
+struct TCPStoreDaemon::Client {
+  explicit Client(int socket) : socket(socket) {}
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ::close(socket);
+    closed = true;
+  }
+
+  const int socket;
+  std::mutex mutex;
+  bool closed = false;
+};
+
+struct TCPStoreDaemon::Shard {
+  // A client waiting on a number of keys, which gets its reply once all of
+  // them are set.
+  struct Waiter {
+    // Called once per awaited key that is set.
+    void keyReady() const;
+
+    std::shared_ptr<Client> client;
+    std::shared_ptr<std::atomic<size_t>> remaining;
+    // The keys whose values to reply with, for GET and MULTI_GET. WAIT,
+    // which leaves it null, is replied to with STOP_WAITING.
+    std::shared_ptr<const std::vector<std::string>> keys;
+    TCPStoreDaemon* daemon;
+  };
+
+  // Removes and returns the clients waiting on the key, which has just been
+  // set. The caller holds the mutex, and wakes them up once it released it.
+  std::vector<Waiter> takeWaiters(const std::string& key) {
+    std::vector<Waiter> result;
+    auto it = waiters.find(key);
+    if (it != waiters.end()) {
+      result = std::move(it->second);
+      waiters.erase(it);
+    }
+    return result;
+  }
+
+  std::mutex mutex;
+  std::unordered_map<std::string, std::vector<uint8_t>> data;
+  // From key -> the clients waiting on it
+  std::unordered_map<std::string, std::vector<Waiter>> waiters;
+};
+
+void TCPStoreDaemon::Shard::Waiter::keyReady() const {
+  if (--*remaining > 0) {
+    return;
+  }
+  // Keys are never removed, so the values are still there.
+  std::vector<std::vector<uint8_t>> values;
+  if (keys) {
+    values = daemon->getValues(*keys);
+  }
+  std::lock_guard<std::mutex> lock(client->mutex);
+  if (client->closed) {
+    return;
+  }
+  try {
+    if (keys) {
+      for (size_t i = 0; i < values.size(); i++) {
+        tcputil::sendVector<uint8_t>(
+            client->socket, values[i], (i != values.size() - 1));
+      }
+    } else {
+      tcputil::sendValue<WaitResponseType>(
+          client->socket, WaitResponseType::STOP_WAITING);
+    }
+  } catch (...) {
+    // The worker thread that owns the connection closes it once it notices
+    // the error.
+  }
+}
+
+class TCPStoreDaemon::WorkerThread {
+ public:
+  WorkerThread(TCPStoreDaemon& daemon, int controlFd)
+      : daemon_(daemon), controlFd_(controlFd) {
+    if (pipe(wakeupPipeFd_.data()) == -1) {
+      throw std::runtime_error(
+          "Failed to create the wakeup pipe of a TCPStoreDaemon thread");
+    }
+    thread_ = std::thread(&WorkerThread::run, this);
+  }
+
+  ~WorkerThread() {
+    thread_.join();
+    for (auto& it : clients_) {
+      it.second->close();
+    }
+    for (auto socket : newSockets_) {
+      ::close(socket);
+    }
+    for (auto fd : wakeupPipeFd_) {
+      ::close(fd);
+    }
+  }
+
+  // Hands a new connection over to the thread.
+  void addClient(int socket) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      newSockets_.push_back(socket);
+    }
+    char byte = 0;
+    SYSCHECK_ERR_RETURN_NEG1(::write(wakeupPipeFd_[1], &byte, 1));
+  }
+
+ private:
+  void run() {
+    Poller poller;
+    poller.add(controlFd_);
+    poller.add(wakeupPipeFd_[0]);
+    while (true) {
+      for (int fd : poller.wait()) {
+        // The control pipe is closed when the daemon stops.
+        if (fd == controlFd_) {
+          return;
+        }
+        if (fd == wakeupPipeFd_[0]) {
+          std::array<char, 64> bytes;
+          SYSCHECK_ERR_RETURN_NEG1(
+              ::read(wakeupPipeFd_[0], bytes.data(), bytes.size()));
+          std::vector<int> sockets;
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sockets.swap(newSockets_);
+          }
+          for (int socket : sockets) {
+            clients_[socket] = std::make_shared<Client>(socket);
+            poller.add(socket);
+          }
+          continue;
+        }
+
+        auto it = clients_.find(fd);
+        if (it == clients_.end()) {
+          continue;
+        }
+        try {
+          daemon_.query(it->second);
+        } catch (...) {
+          // There was an error when processing query. Probably an exception
+          // occurred in recv/send what would indicate that socket on the
+          // other side has been closed. If the closing was due to normal
+          // exit, then the store should continue executing. Otherwise, if it
+          // was different exception, other connections will get an
+          // exception once they try to use the store. We will go ahead and
+          // close this connection whenever we hit an exception here.
+          poller.remove(fd);
+          it->second->close();
+          removeWaiters(*it->second);
+          clients_.erase(it);
+        }
+      }
+    }
+  }
+
+  // Removes all the tracking state of a closed connection.
+  void removeWaiters(const Client& client) {
+    for (auto& shard : daemon_.shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      for (auto it = shard->waiters.begin(); it != shard->waiters.end();) {
+        auto& waiters = it->second;
+        waiters.erase(
+            std::remove_if(
+                waiters.begin(),
+                waiters.end(),
+                [&](const Shard::Waiter& waiter) {
+                  return waiter.client.get() == &client;
+                }),
+            waiters.end());
+        if (waiters.empty()) {
+          it = shard->waiters.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
+
+  TCPStoreDaemon& daemon_;
+  const int controlFd_;
+  std::array<int, 2> wakeupPipeFd_{{-1, -1}};
+
+  std::mutex mutex_;
+  std::vector<int> newSockets_;
+
+  // Only accessed by the thread.
+  std::unordered_map<int, std::shared_ptr<Client>> clients_;
+
+  std::thread thread_;
+};
+
 // TCPStoreDaemon class methods
-// Simply start the daemon thread
-TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
+// Start the worker threads and the thread accepting connections
+TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket, size_t numThreads)
     : storeListenSocket_(storeListenSocket) {
-  // Use control pipe to signal instance destruction to the daemon thread.
+  if (numThreads == 0) {
+    numThreads = std::min<size_t>(
+        std::max<size_t>(std::thread::hardware_concurrency(), 1),
+        kMaxDefaultThreads);
+  }
+  for (size_t i = 0; i < kNumShards; i++) {
+    shards_.emplace_back(new Shard());
+  }
+  // Use control pipe to signal instance destruction to the daemon threads.
   if (pipe(controlPipeFd_.data()) == -1) {
     throw std::runtime_error(
         "Failed to create the control pipe to start the "
         "TCPStoreDaemon run");
   }
+  for (size_t i = 0; i < numThreads; i++) {
+    workerThreads_.emplace_back(new WorkerThread(*this, controlPipeFd_[0]));
+  }
   daemonThread_ = std::thread(&TCPStoreDaemon::run, this);
 }
 
 TCPStoreDaemon::~TCPStoreDaemon() {
   // Stop the run
   stop();
-  // Join the thread
+  // Join the threads, which closes the sockets they own
   join();
-  // Close unclosed sockets
-  for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
-  }
+  workerThreads_.clear();
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
     if (fd != -1) {
@@ -60,29 +375,14 @@ void TCPStoreDaemon::run() {
   // Push the read end of the pipe to signal the stopping of the daemon run
   fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
 
-  // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
+  // accept the connections and hand them over to the worker threads
+  while (true) {
+    for (auto& fd : fds) {
+      fd.revents = 0;
     }
 
     SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
 
-    // TCPStore's listening socket has an event and it should now be able to
-    // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
-      }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
-    }
     // The pipe receives an event which tells us to shutdown the daemon
     if (fds[1].revents != 0) {
       // Will be POLLUP when the pipe is closed
@@ -93,57 +393,21 @@ void TCPStoreDaemon::run() {
             "Unexpected poll revent on the control pipe's reading fd: " +
                 std::to_string(fds[1].revents));
       }
-      finished = true;
       break;
     }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
-        continue;
-      }
-
-      // Now query the socket that has the event
-      try {
-        query(fds[fdIdx].fd);
-      } catch (...) {
-        // There was an error when processing query. Probably an exception
-        // occurred in recv/send what would indicate that socket on the other
-        // side has been closed. If the closing was due to normal exit, then
-        // the store should continue executing. Otherwise, if it was different
-        // exception, other connections will get an exception once they try to
-        // use the store. We will go ahead and close this connection whenever
-        // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
-        continue;
+    // TCPStore's listening socket has an event and it should now be able to
+    // accept new connections.
+    if (fds[0].revents != 0) {
+      if (fds[0].revents ^ POLLIN) {
+        throw std::system_error(
+            ECONNABORTED,
+            std::system_category(),
+            "Unexpected poll revent on the master's listening socket: " +
+                std::to_string(fds[0].revents));
       }
+      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+      workerThreads_[nextWorkerThread_]->addClient(sockFd);
+      nextWorkerThread_ = (nextWorkerThread_ + 1) % workerThreads_.size();
     }
   }
 }
@@ -159,111 +423,216 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait, multi get and multi set
 // type of query | number of args | size of arg1 | arg1 | ...
-void TCPStoreDaemon::query(int socket) {
+void TCPStoreDaemon::query(const std::shared_ptr<Client>& client) {
   QueryType qt;
-  tcputil::recvBytes<QueryType>(socket, &qt, 1);
+  tcputil::recvBytes<QueryType>(client->socket, &qt, 1);
 
   if (qt == QueryType::SET) {
-    setHandler(socket);
+    setHandler(*client);
 
   } else if (qt == QueryType::ADD) {
-    addHandler(socket);
+    addHandler(*client);
 
   } else if (qt == QueryType::GET) {
-    getHandler(socket);
+    getHandler(client);
 
   } else if (qt == QueryType::CHECK) {
-    checkHandler(socket);
+    checkHandler(*client);
 
   } else if (qt == QueryType::WAIT) {
-    waitHandler(socket);
+    waitHandler(client);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(client);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(*client);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(*client);
 
   } else {
     throw std::runtime_error("Unexpected query type");
   }
 }
 
-void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
-  auto socketsToWait = waitingSockets_.find(key);
-  if (socketsToWait != waitingSockets_.end()) {
-    for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
-        tcputil::sendValue<WaitResponseType>(
-            socket, WaitResponseType::STOP_WAITING);
-      }
-    }
-    waitingSockets_.erase(socketsToWait);
-  }
+TCPStoreDaemon::Shard& TCPStoreDaemon::shard(const std::string& key) {
+  return *shards_[std::hash<std::string>()(key) % shards_.size()];
 }
 
-void TCPStoreDaemon::setHandler(int socket) {
-  std::string key = tcputil::recvString(socket);
-  tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
-  // On "set", wake up all clients that have been waiting
-  wakeupWaitingClients(key);
+void TCPStoreDaemon::setKey(
+    const std::string& key,
+    std::vector<uint8_t> value) {
+  std::vector<Shard::Waiter> waiters;
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.data[key] = std::move(value);
+    waiters = shard.takeWaiters(key);
+  }
+  // Wake up all clients that have been waiting, outside of the lock.
+  for (const auto& waiter : waiters) {
+    waiter.keyReady();
+  }
 }
 
-void TCPStoreDaemon::addHandler(int socket) {
-  std::string key = tcputil::recvString(socket);
-  int64_t addVal = tcputil::recvValue<int64_t>(socket);
+void TCPStoreDaemon::setHandler(Client& client) {
+  std::string key = tcputil::recvString(client.socket);
+  setKey(key, tcputil::recvVector<uint8_t>(client.socket));
+}
 
-  if (tcpStore_.find(key) != tcpStore_.end()) {
-    auto buf = reinterpret_cast<const char*>(tcpStore_[key].data());
-    auto len = tcpStore_[key].size();
-    addVal += std::stoll(std::string(buf, len));
+void TCPStoreDaemon::addHandler(Client& client) {
+  std::string key = tcputil::recvString(client.socket);
+  int64_t addVal = tcputil::recvValue<int64_t>(client.socket);
+
+  std::vector<Shard::Waiter> waiters;
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.data.find(key);
+    if (it != shard.data.end()) {
+      auto buf = reinterpret_cast<const char*>(it->second.data());
+      auto len = it->second.size();
+      addVal += std::stoll(std::string(buf, len));
+    }
+    auto addValStr = std::to_string(addVal);
+    shard.data[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
+    waiters = shard.takeWaiters(key);
   }
-  auto addValStr = std::to_string(addVal);
-  tcpStore_[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
   // Now send the new value
-  tcputil::sendValue<int64_t>(socket, addVal);
+  {
+    std::lock_guard<std::mutex> lock(client.mutex);
+    tcputil::sendValue<int64_t>(client.socket, addVal);
+  }
   // On "add", wake up all clients that have been waiting
-  wakeupWaitingClients(key);
+  for (const auto& waiter : waiters) {
+    waiter.keyReady();
+  }
 }
 
-void TCPStoreDaemon::getHandler(int socket) const {
-  std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
-  tcputil::sendVector<uint8_t>(socket, data);
+// GET and MULTI_GET wait for their keys, so that a client needs a single
+// round trip for a key that another client has yet to set.
+void TCPStoreDaemon::getHandler(const std::shared_ptr<Client>& client) {
+  std::vector<std::string> keys{tcputil::recvString(client->socket)};
+  replyWhenSet(client, std::move(keys), /* sendValues */ true);
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
+void TCPStoreDaemon::checkHandler(Client& client) {
   SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  tcputil::recvBytes<SizeType>(client.socket, &nargs, 1);
   std::vector<std::string> keys(nargs);
   for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+    keys[i] = tcputil::recvString(client.socket);
   }
   // Now we have received all the keys
-  if (checkKeys(keys)) {
-    tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
-  } else {
-    tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::NOT_READY);
-  }
+  auto response = checkKeys(keys) ? CheckResponseType::READY
+                                  : CheckResponseType::NOT_READY;
+  std::lock_guard<std::mutex> lock(client.mutex);
+  tcputil::sendValue<CheckResponseType>(client.socket, response);
 }
 
-void TCPStoreDaemon::waitHandler(int socket) {
+void TCPStoreDaemon::waitHandler(const std::shared_ptr<Client>& client) {
+  replyWhenSet(client, recvKeys(*client), /* sendValues */ false);
+}
+
+void TCPStoreDaemon::multiGetHandler(const std::shared_ptr<Client>& client) {
+  replyWhenSet(client, recvKeys(*client), /* sendValues */ true);
+}
+
+std::vector<std::string> TCPStoreDaemon::recvKeys(Client& client) {
   SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  tcputil::recvBytes<SizeType>(client.socket, &nargs, 1);
   std::vector<std::string> keys(nargs);
   for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+    keys[i] = tcputil::recvString(client.socket);
   }
-  if (checkKeys(keys)) {
-    tcputil::sendValue<WaitResponseType>(
-        socket, WaitResponseType::STOP_WAITING);
-  } else {
-    for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
+  return keys;
+}
+
+void TCPStoreDaemon::replyWhenSet(
+    const std::shared_ptr<Client>& client,
+    std::vector<std::string> keys,
+    bool sendValues) {
+  // The keys are looked up one shard at a time, and other threads may set
+  // them meanwhile. Counting one more key than awaited makes sure the client
+  // is only replied to once all of them have been looked up.
+  auto sharedKeys =
+      std::make_shared<const std::vector<std::string>>(std::move(keys));
+  Shard::Waiter waiter{
+      client,
+      std::make_shared<std::atomic<size_t>>(sharedKeys->size() + 1),
+      sendValues ? sharedKeys : nullptr,
+      this};
+  for (const auto& key : *sharedKeys) {
+    auto& shard = this->shard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    if (shard.data.count(key) > 0) {
+      lock.unlock();
+      waiter.keyReady();
+    } else {
+      shard.waiters[key].push_back(waiter);
     }
-    keysAwaited_[socket] = keys.size();
   }
+  waiter.keyReady();
 }
 
-bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
+std::vector<std::vector<uint8_t>> TCPStoreDaemon::getValues(
+    const std::vector<std::string>& keys) {
+  std::vector<std::vector<uint8_t>> values(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto& shard = this->shard(keys[i]);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    values[i] = shard.data.at(keys[i]);
+  }
+  return values;
+}
+
+void TCPStoreDaemon::multiSetHandler(Client& client) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(client.socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(client.socket);
+    setKey(key, tcputil::recvVector<uint8_t>(client.socket));
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(Client& client) {
+  std::string key = tcputil::recvString(client.socket);
+  auto expected = tcputil::recvVector<uint8_t>(client.socket);
+  auto desired = tcputil::recvVector<uint8_t>(client.socket);
+
+  std::vector<uint8_t> current;
+  std::vector<Shard::Waiter> waiters;
+  {
+    auto& shard = this->shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.data.find(key);
+    if (it != shard.data.end()) {
+      current = it->second;
+    }
+    // A missing key compares equal to an empty value.
+    if (current == expected) {
+      current = desired;
+      shard.data[key] = std::move(desired);
+      waiters = shard.takeWaiters(key);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(client.mutex);
+    tcputil::sendVector<uint8_t>(client.socket, current);
+  }
+  for (const auto& waiter : waiters) {
+    waiter.keyReady();
+  }
+}
+
+bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) {
   return std::all_of(keys.begin(), keys.end(), [this](const std::string& s) {
-    return tcpStore_.count(s) > 0;
+    auto& shard = this->shard(s);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.data.count(s) > 0;
   });
 }
 
@@ -346,7 +715,8 @@ std::vector<uint8_t> TCPStore::get(const std::string& key) {
 }
 
 std::vector<uint8_t> TCPStore::getHelper_(const std::string& key) {
-  waitHelper_({key}, timeout_);
+  // The daemon replies once the key is set.
+  setReceiveTimeout_(timeout_);
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::GET);
   tcputil::sendString(storeSocket_, key);
   return tcputil::recvVector<uint8_t>(storeSocket_);
@@ -397,9 +767,7 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
-void TCPStore::waitHelper_(
-    const std::vector<std::string>& keys,
-    const std::chrono::milliseconds& timeout) {
+void TCPStore::setReceiveTimeout_(const std::chrono::milliseconds& timeout) {
   // Set the socket timeout if there is a wait timeout
   if (timeout != kNoTimeout) {
     struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
@@ -411,6 +779,12 @@ void TCPStore::waitHelper_(
         reinterpret_cast<char*>(&timeoutTV),
         sizeof(timeoutTV)));
   }
+}
+
+void TCPStore::waitHelper_(
+    const std::vector<std::string>& keys,
+    const std::chrono::milliseconds& timeout) {
+  setReceiveTimeout_(timeout);
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
   SizeType nkeys = keys.size();
   tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
@@ -423,6 +797,59 @@ void TCPStore::waitHelper_(
   }
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  // The daemon replies once all keys are set.
+  setReceiveTimeout_(timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values[i] = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    std::string regKey = regularPrefix_ + keys[i];
+    tcputil::sendString(storeSocket_, regKey, true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expected,
+    const std::vector<uint8_t>& desired) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expected, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desired);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 PortType TCPStore::getPort() {
   return tcpStorePort_;
 }
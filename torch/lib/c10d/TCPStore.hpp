@@ -3,42 +3,67 @@
 #include <memory>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <c10d/Store.hpp>
 #include <c10d/Utils.hpp>
 
 namespace c10d {
 
+// TCPStoreDaemon serves the store from a thread that accepts connections
+// and a few worker threads that handle queries. Every connection belongs to
+// one worker thread, which watches its connections with epoll (poll on
+// platforms without it). The keys are spread over shards with a lock each,
+// so worker threads only contend when they touch keys of the same shard.
 class TCPStoreDaemon {
  public:
-  explicit TCPStoreDaemon(int storeListenSocket);
+  // Uses `numThreads` worker threads, or one per core up to a few if it is
+  // zero.
+  explicit TCPStoreDaemon(int storeListenSocket, size_t numThreads = 0);
   ~TCPStoreDaemon();
 
   void join();
 
  protected:
+  struct Client;
+  struct Shard;
+  class WorkerThread;
+
   void run();
   void stop();
 
-  void query(int socket);
-
-  void setHandler(int socket);
-  void addHandler(int socket);
-  void getHandler(int socket) const;
-  void checkHandler(int socket) const;
-  void waitHandler(int socket);
-
-  bool checkKeys(const std::vector<std::string>& keys) const;
-  void wakeupWaitingClients(const std::string& key);
+  void query(const std::shared_ptr<Client>& client);
+
+  void setHandler(Client& client);
+  void addHandler(Client& client);
+  void getHandler(const std::shared_ptr<Client>& client);
+  void checkHandler(Client& client);
+  void waitHandler(const std::shared_ptr<Client>& client);
+  void multiGetHandler(const std::shared_ptr<Client>& client);
+  void multiSetHandler(Client& client);
+  void compareSetHandler(Client& client);
+
+  Shard& shard(const std::string& key);
+
+  // Sets the key and wakes up the clients waiting on it.
+  void setKey(const std::string& key, std::vector<uint8_t> value);
+  bool checkKeys(const std::vector<std::string>& keys);
+  std::vector<std::string> recvKeys(Client& client);
+  // Replies to the client once all the keys are set, with their values if
+  // `sendValues`, or with STOP_WAITING otherwise.
+  void replyWhenSet(
+      const std::shared_ptr<Client>& client,
+      std::vector<std::string> keys,
+      bool sendValues);
+  // Returns the values of keys that are set.
+  std::vector<std::vector<uint8_t>> getValues(
+      const std::vector<std::string>& keys);
 
   std::thread daemonThread_;
-  std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
-  // From key -> the list of sockets waiting on it
-  std::unordered_map<std::string, std::vector<int>> waitingSockets_;
-  // From socket -> number of keys awaited
-  std::unordered_map<int, size_t> keysAwaited_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<std::unique_ptr<WorkerThread>> workerThreads_;
+  size_t nextWorkerThread_ = 0;
 
-  std::vector<int> sockets_;
   int storeListenSocket_;
   std::vector<int> controlPipeFd_{-1, -1};
 };
@@ -69,6 +94,18 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expected,
+      const std::vector<uint8_t>& desired) override;
+
   // Waits for all workers to join.
   void waitForWorkers();
 
@@ -81,6 +118,7 @@ class TCPStore : public Store {
   void waitHelper_(
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout);
+  void setReceiveTimeout_(const std::chrono::milliseconds& timeout);
 
   bool isServer_;
   int storeSocket_ = -1;
@@ -109,6 +109,69 @@ void testHelper(const std::string& prefix = "") {
   }
 }
 
+void testBatchOperations(const std::string& prefix = "") {
+  const auto numThreads = 16;
+  const auto numWorkers = numThreads + 1;
+
+  auto serverTCPStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1",
+      0,
+      numWorkers,
+      true,
+      std::chrono::seconds(30),
+      /* wait */ false);
+  c10d::PrefixStore serverStore(prefix, serverTCPStore);
+
+  // Every thread publishes a key in a batch with a few others, elects a
+  // leader with compareSet, and reads all the keys back at once, which
+  // waits for the other threads.
+  std::vector<std::thread> threads;
+  std::vector<std::string> keys;
+  std::vector<std::string> leaders(numThreads);
+  for (auto i = 0; i < numThreads; i++) {
+    keys.push_back("rank_" + std::to_string(i));
+  }
+  for (auto i = 0; i < numThreads; i++) {
+    threads.push_back(std::thread([&, i] {
+      auto clientTCPStore = std::make_shared<c10d::TCPStore>(
+          "127.0.0.1", serverTCPStore->getPort(), numWorkers, false);
+      c10d::PrefixStore clientStore(prefix, clientTCPStore);
+      std::string value = "value_" + std::to_string(i);
+      clientStore.multiSet(
+          {keys[i], "extra_" + std::to_string(i)},
+          {std::vector<uint8_t>(value.begin(), value.end()),
+           std::vector<uint8_t>()});
+      auto leader = clientStore.compareSet(
+          "leader", {}, std::vector<uint8_t>(value.begin(), value.end()));
+      leaders[i] = std::string(leader.begin(), leader.end());
+      auto values = clientStore.multiGet(keys);
+      for (auto j = 0; j < numThreads; j++) {
+        EXPECT_EQ(
+            std::string(values[j].begin(), values[j].end()),
+            "value_" + std::to_string(j));
+      }
+    }));
+  }
+  serverTCPStore->waitForWorkers();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // All threads agree on the leader.
+  for (auto i = 0; i < numThreads; i++) {
+    EXPECT_EQ(leaders[i], leaders[0]);
+  }
+  c10d::test::check(serverStore, "leader", leaders[0]);
+
+  // compareSet only succeeds with the current value.
+  std::vector<uint8_t> current(leaders[0].begin(), leaders[0].end());
+  std::vector<uint8_t> other = {'x'};
+  EXPECT_EQ(serverStore.compareSet("leader", other, other), current);
+  EXPECT_EQ(serverStore.compareSet("leader", current, other), other);
+  EXPECT_TRUE(serverStore.compareSet("missing", other, other).empty());
+  EXPECT_FALSE(serverStore.check({"missing"}));
+}
+
 TEST(TCPStoreTest, testHelper) {
   testHelper();
 }
@@ -116,3 +179,11 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testBatchOperations) {
+  testBatchOperations();
+}
+
+TEST(TCPStoreTest, testBatchOperationsPrefix) {
+  testBatchOperations("testPrefix");
+}
@@ -377,7 +377,8 @@ class DistributedDataParallel(Module):
             parameters,
             list(reversed(bucket_indices)),
             self.process_group,
-            expect_sparse_gradient)
+            expect_sparse_gradient,
+            self.bucket_bytes_cap)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -435,7 +436,81 @@ class DistributedDataParallel(Module):
         finally:
             self.require_backward_grad_sync = old_require_backward_grad_sync
 
+    def register_comm_hook(self, state, hook):
+        r"""
+        Registers a communication hook, which replaces the allreduce that
+        averages the gradients of each bucket across processes, for example
+        to compress them before they are sent.
+
+        :attr:`hook` is called as ``hook(state, bucket)`` once the gradients
+        of a bucket are ready, where ``bucket`` is a
+        :class:`torch.distributed.GradBucket`. ``bucket.tensors`` holds the
+        flattened gradients, one tensor per model replica, already divided by
+        the world size, so summing them across processes averages them. The
+        hook kicks off communication and returns a ``torch._C.Future``, such
+        as the one of an asynchronous collective (:meth:`Work.get_future`).
+        If the value of the future is a list of tensors, they are taken as
+        the averaged gradients. Otherwise, the hook must have averaged
+        ``bucket.tensors`` in place once the future completes.
+
+        Buckets are passed to the hook in the same order on every process.
+        Buckets that hold a sparse gradient are always allreduced.
+
+        The hook can be registered only once, before the first backward pass.
+
+        Arguments:
+            state (object): Passed to the hook, for example to keep state
+                across iterations.
+            hook (callable): The hook.
+
+        Example::
+
+            >>> def allreduce_hook(process_group, bucket):
+            ...     return process_group.allreduce(bucket.tensors).get_future()
+            >>> ddp.register_comm_hook(process_group, allreduce_hook)
+        """
+        self.reducer._register_comm_hook(state, hook)
+
+    def register_builtin_comm_hook(self, comm_hook_type, **kwargs):
+        r"""
+        Registers one of the communication hooks implemented in C++, which
+        compress the gradients before they are sent:
+
+        * ``'fp16'``: allreduces the gradients in half precision.
+        * ``'topk'``: sends only the fraction ``ratio`` of the gradients of
+          each bucket with the largest magnitude. What is not sent is added
+          to the gradients of the next iteration (error feedback).
+        * ``'powersgd'``: approximates every gradient with two or more
+          dimensions, viewed as a matrix, by a product of two matrices of
+          rank ``matrix_approximation_rank`` (PowerSGD). It also uses error
+          feedback. The initial approximation is drawn from a generator
+          seeded with ``seed`` (default: 0), which must be the same on every
+          process.
+
+        See :meth:`register_comm_hook` for the restrictions that apply.
+
+        Example::
+
+            >>> ddp.register_builtin_comm_hook('powersgd', matrix_approximation_rank=4)
+        """
+        if comm_hook_type == 'fp16':
+            hook = dist._FP16CompressHook(self.process_group, **kwargs)
+        elif comm_hook_type == 'topk':
+            hook = dist._TopKCompressHook(self.process_group, **kwargs)
+        elif comm_hook_type == 'powersgd':
+            hook = dist._PowerSGDHook(self.process_group, **kwargs)
+        else:
+            raise ValueError(
+                "Unknown communication hook type: {}".format(comm_hook_type))
+        self.reducer._register_comm_hook(hook)
+
     def forward(self, *inputs, **kwargs):
+        # The buckets are rebuilt once, in the order in which the gradients
+        # were ready in the first backward pass. This is a collective, so it
+        # must happen at the same point on every process.
+        if torch.is_grad_enabled() and self.require_backward_grad_sync:
+            self.reducer._rebuild_buckets()
+
         if self.require_forward_param_sync:
             self._sync_params()
 